@@ -1,6 +1,9 @@
 
 #include <iostream>
 #include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
 
 #include "foundation/platform/platform_factory.h"
 #include "foundation/graphics/viewport.h"
@@ -8,24 +11,59 @@
 #include "foundation/input/mouse.h"
 #include "libraries/picopng/picopng.h"
 #include "runtime/editor/editor_facility.h"
+#include "runtime/editor/offline_renderer.h"
+#include "runtime/editor/batch_renderer.h"
+#include "runtime/editor/packer/packer_batch.h"
+#include "runtime/editor/utilities/editor_utils.h"
+#include "runtime/emulation/cpumos6510_verifier.h"
+#include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/emulation/sid/multisidrenderer.h"
+#include "libraries/residfp/resample/TwoPassSincResampler.h"
+#include "runtime/environmentdefines.h"
 #include "utils/event.h"
 #include "utils/delegate.h"
 #include "utils/utilities.h"
 #include "utils/keyhookstore.h"
 #include "utils/configfile.h"
 #include "utils/config/configtypes.h"
+#include "utils/frame_statistics.h"
+#include "utils/c64file.h"
+#include "libraries/ghc/fs_std.h"
 
 using namespace Foundation;
 using namespace Editor;
 
 // Forward declaration
 void Run(IPlatform& inPlatform, int inArgc, char* inArgv[]);
+int RunHeadless(int inArgc, char* inArgv[]);
+int RunHeadlessBatch(int inArgc, char* inArgv[]);
+int RunHeadlessBenchmark(int inArgc, char* inArgv[]);
+int RunHeadlessBenchmarkResampler(int inArgc, char* inArgv[]);
+int RunHeadlessVerifyCPU(int inArgc, char* inArgv[]);
+int RunHeadlessProfileRastertime(int inArgc, char* inArgv[]);
+int RunHeadlessPackBatch(int inArgc, char* inArgv[]);
 void BuildResource();
 
 // Functions
 int main(int inArgc, char* inArgv[])
 {
 	//BuildResource();
+
+	// Render songs to files without opening a window, if requested
+	if (inArgc > 1 && std::string(inArgv[1]) == "--render")
+		return RunHeadless(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--render-batch")
+		return RunHeadlessBatch(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--benchmark-cpu")
+		return RunHeadlessBenchmark(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--benchmark-resampler")
+		return RunHeadlessBenchmarkResampler(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--verify-cpu")
+		return RunHeadlessVerifyCPU(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--profile-rastertime")
+		return RunHeadlessProfileRastertime(inArgc, inArgv);
+	if (inArgc > 1 && std::string(inArgv[1]) == "--pack-batch")
+		return RunHeadlessPackBatch(inArgc, inArgv);
     
 	// Initialize SDL
 	const int sdl_init_result = SDL_Init(SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_VIDEO);
@@ -89,8 +127,16 @@ void Run(IPlatform& inPlatform, int inArgc, char* inArgv[])
 	// Ticking test
 	unsigned int last_tick = SDL_GetTicks();
 
-	const unsigned int updates_per_second = 30;
-	const unsigned int target_frame_time = 1000 / updates_per_second;
+	// The editor is updated when input arrives, when it is about to change by itself (f.ex. a blinking cursor) and during playback,
+	// where it follows the display refresh rate. In between, the main loop sleeps until either is due.
+	const unsigned int min_update_time = std::max(1000u / static_cast<unsigned int>(viewport.GetDisplayRefreshRate()), 1u);
+	unsigned int ticks_to_next_update = 0;
+
+	// Frame time statistics
+	const bool print_frame_statistics = Utility::GetSingleConfigurationValue<Utility::Config::ConfigValueInt>(configFile, "Editor.FrameStatistics", 0) != 0;
+	Utility::FrameStatistics frame_statistics(1000.0);
+
+	const double performance_counter_ticks_per_millisecond = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
 
 	// Listen for SDL events
 	SDL_Event event;
@@ -101,6 +147,25 @@ void Run(IPlatform& inPlatform, int inArgc, char* inArgv[])
 
 	while (!editor.IsDone() && !force_quit)
 	{
+		// Wait for the next update. Input wakes the loop up early, but not sooner than the minimum update time after the last
+		// update, so a stream of mouse motion events does not drive the editor at the rate of the mouse.
+		const Uint64 wait_start = SDL_GetPerformanceCounter();
+
+		if (SDL_GetTicks() - last_tick < ticks_to_next_update)
+		{
+			const unsigned int ticks_since_update = SDL_GetTicks() - last_tick;
+
+			if (ticks_since_update < min_update_time)
+				SDL_Delay(min_update_time - ticks_since_update);
+
+			const unsigned int ticks_waited = SDL_GetTicks() - last_tick;
+
+			if (ticks_waited < ticks_to_next_update)
+				SDL_WaitEventTimeout(nullptr, static_cast<int>(ticks_to_next_update - ticks_waited));
+		}
+
+		const Uint64 update_start = SDL_GetPerformanceCounter();
+
 		// Get tick count and maintain delta time
 		const unsigned int tick = SDL_GetTicks();
 		const int delta_tick = tick - last_tick;
@@ -141,7 +206,14 @@ void Run(IPlatform& inPlatform, int inArgc, char* inArgv[])
 				case SDL_WINDOWEVENT_FOCUS_LOST:
 					keyboard.Flush();
 					break;
+				case SDL_WINDOWEVENT_EXPOSED:
+					viewport.RequestRender();
+					break;
 				}
+				break;
+			case SDL_RENDER_TARGETS_RESET:
+				viewport.RequestRender();
+				break;
 			}
 		}
 
@@ -173,13 +245,24 @@ void Run(IPlatform& inPlatform, int inArgc, char* inArgv[])
 		}
 
 		// Update editor
-		editor.Update(keyboard, mouse, delta_tick);
+		const bool rendered = editor.Update(keyboard, mouse, delta_tick);
+
+		// Schedule the next update. Keep updating at the minimum update time while playing, or while a mouse button is held down,
+		// as the editor scrolls and drags by itself then.
+		const bool is_mouse_button_down = mouse.IsButtonDown(Mouse::Left) || mouse.IsButtonDown(Mouse::Middle) || mouse.IsButtonDown(Mouse::Right);
+
+		if (editor.IsPlaybackActive() || is_mouse_button_down)
+			ticks_to_next_update = min_update_time;
+		else
+			ticks_to_next_update = std::max(static_cast<unsigned int>(std::max(editor.GetTicksToNextUpdate(), 0)), min_update_time);
 
-		// Yield the process, if it is required
-		const unsigned int ticks_passed = SDL_GetTicks() - tick;
+		// Collect frame time statistics
+		const Uint64 update_end = SDL_GetPerformanceCounter();
+		const double wait_time = static_cast<double>(update_start - wait_start) / performance_counter_ticks_per_millisecond;
+		const double frame_time = static_cast<double>(update_end - update_start) / performance_counter_ticks_per_millisecond;
 
-		if (ticks_passed < target_frame_time)
-			SDL_Delay(target_frame_time - ticks_passed);
+		if (frame_statistics.AddFrame(wait_time, frame_time, rendered) && print_frame_statistics)
+			std::cout << frame_statistics.GetSummaryText() << std::endl;
 
 		// Refresh last tick
 		last_tick = tick;
@@ -192,6 +275,490 @@ void Run(IPlatform& inPlatform, int inArgc, char* inArgv[])
 
 
 
+Emulation::SIDConfiguration GetHeadlessSIDConfiguration(IPlatform& inPlatform)
+{
+	std::vector<std::string> valid_configuration_sections;
+	valid_configuration_sections.push_back("default");
+	valid_configuration_sections.push_back(inPlatform.GetName());
+
+	Utility::ConfigFile configFile(inPlatform, inPlatform.Storage_GetConfigHomePath() + "config.ini", valid_configuration_sections);
+
+	// Use the same emulation settings as the editor
+	const bool sid_use_table_cache = Utility::GetSingleConfigurationValue<Utility::Config::ConfigValueInt>(configFile, "Sound.Emulation.TableCache", 1) != 0;
+	Emulation::SIDProxy::SetTableCacheFolder(sid_use_table_cache ? inPlatform.Storage_GetConfigHomePath() : std::string());
+
+	Emulation::SIDConfiguration sid_configuration;
+
+	const bool sid_use_resample = Utility::GetSingleConfigurationValue<Utility::Config::ConfigValueInt>(configFile, "Sound.Emulation.Resample", 1) != 0;
+	sid_configuration.m_eSampleMethod = sid_use_resample ? Emulation::SID_SAMPLE_METHOD_RESAMPLE_INTERPOLATE : Emulation::SID_SAMPLE_METHOD_INTERPOLATE;
+	sid_configuration.m_eModel = Emulation::SID_MODEL_8580;
+
+	return sid_configuration;
+}
+
+
+std::vector<Emulation::SIDChipSetup> GetHeadlessSIDChipSetups(IPlatform& inPlatform)
+{
+	std::vector<std::string> valid_configuration_sections;
+	valid_configuration_sections.push_back("default");
+	valid_configuration_sections.push_back(inPlatform.GetName());
+
+	Utility::ConfigFile configFile(inPlatform, inPlatform.Storage_GetConfigHomePath() + "config.ini", valid_configuration_sections);
+
+	// Use the same SID chips as the editor
+	const std::vector<int> sid_addresses = Utility::GetConfigurationValues<Utility::Config::ConfigValueInt>(configFile, "Sound.Emulation.SIDAddresses", { 0xd400 });
+	const std::vector<int> sid_pannings = Utility::GetConfigurationValues<Utility::Config::ConfigValueInt>(configFile, "Sound.Emulation.SIDPanning", { 50 });
+
+	return Emulation::MultiSIDRenderer::CreateChipSetups(sid_addresses, sid_pannings);
+}
+
+
+WaveFileWriter::SampleFormat GetHeadlessSampleFormat(int inArgc, char* inArgv[], int inArgumentIndex)
+{
+	const std::string sample_format_name = inArgc > inArgumentIndex ? Utility::StringToLowerCase(inArgv[inArgumentIndex]) : "16";
+
+	if (sample_format_name == "24")
+		return WaveFileWriter::SampleFormat::PCM24;
+	if (sample_format_name == "float")
+		return WaveFileWriter::SampleFormat::Float32;
+
+	return WaveFileWriter::SampleFormat::PCM16;
+}
+
+
+unsigned int GetHeadlessUnsignedArgument(int inArgc, char* inArgv[], int inArgumentIndex, unsigned int inDefault)
+{
+	return inArgc > inArgumentIndex ? static_cast<unsigned int>(std::max(std::atoi(inArgv[inArgumentIndex]), 0)) : inDefault;
+}
+
+
+int RunHeadless(int inArgc, char* inArgv[])
+{
+	// Usage: --render <input.sf2> <output.wav|output.raw> [frame count] [16|24|float]
+	if (inArgc < 4)
+	{
+		std::cout << "Usage: " << inArgv[0] << " --render <input.sf2> <output.wav|output.raw> [frame count] [16|24|float]" << std::endl;
+		std::cout << "Without a frame count (or with a frame count of 0), the song is rendered until it reaches its loop point." << std::endl;
+		return -1;
+	}
+
+	const std::string input_path_and_filename = inArgv[2];
+	const std::string output_path_and_filename = inArgv[3];
+	const unsigned int max_frame_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 4, 0);
+	const WaveFileWriter::SampleFormat sample_format = GetHeadlessSampleFormat(inArgc, inArgv, 5);
+
+	const bool is_raw_output = output_path_and_filename.size() >= 4 && Utility::StringToLowerCase(output_path_and_filename.substr(output_path_and_filename.size() - 4)) == ".raw";
+	const OfflineRenderer::OutputFormat output_format = is_raw_output ? OfflineRenderer::OutputFormat::Raw : OfflineRenderer::OutputFormat::Wave;
+
+	// The platform is created without initializing SDL video or audio. It is only used for file access and threading primitives.
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = -1;
+
+	{
+		OfflineRenderer renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform));
+		OfflineRenderer::Result render_result;
+
+		if (!renderer.Load(input_path_and_filename))
+			std::cout << renderer.GetErrorMessage() << std::endl;
+		else if (!renderer.Render(output_path_and_filename, output_format, sample_format, max_frame_count, render_result))
+			std::cout << renderer.GetErrorMessage() << std::endl;
+		else
+		{
+			const double render_time = std::max(render_result.m_RenderTimeInSeconds, 0.000001);
+			const double frames_per_second = static_cast<double>(render_result.m_FrameCount) / render_time;
+
+			std::cout << "Rendered " << render_result.m_FrameCount << " frames (" << render_result.m_SampleCount << " samples) to " << output_path_and_filename << std::endl;
+			std::cout << (render_result.m_ReachedSongEnd ? "Stopped at the loop point of the song" : "Stopped at the requested frame count") << std::endl;
+			std::cout << "Time: " << render_time << "s, " << frames_per_second << " frames per second, " << (frames_per_second / EMULATION_FRAMES_PER_SECOND_PAL) << "x real time" << std::endl;
+
+			result = 0;
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
+int RunHeadlessBatch(int inArgc, char* inArgv[])
+{
+	// Usage: --render-batch <input directory> <output directory> [thread count] [frame count] [16|24|float]
+	if (inArgc < 4)
+	{
+		std::cout << "Usage: " << inArgv[0] << " --render-batch <input directory> <output directory> [thread count] [frame count] [16|24|float]" << std::endl;
+		std::cout << "Renders all .sf2 and .prg files in the input directory to wave files. The thread count defaults to the number of cores." << std::endl;
+		return -1;
+	}
+
+	const unsigned int thread_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 4, static_cast<unsigned int>(SDL_GetCPUCount()));
+	const unsigned int max_frame_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 5, 0);
+	const WaveFileWriter::SampleFormat sample_format = GetHeadlessSampleFormat(inArgc, inArgv, 6);
+
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = -1;
+
+	{
+		const std::vector<BatchRenderer::Job> jobs = BatchRenderer::CollectJobs(inArgv[2], inArgv[3], OfflineRenderer::OutputFormat::Wave);
+
+		if (jobs.empty())
+			std::cout << "No .sf2 or .prg files found in: " << inArgv[2] << std::endl;
+		else
+		{
+			BatchRenderer batch_renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform), OfflineRenderer::OutputFormat::Wave, sample_format, max_frame_count);
+			batch_renderer.Render(jobs, std::max(thread_count, 1u));
+
+			const std::vector<BatchRenderer::JobResult>& job_results = batch_renderer.GetResults();
+
+			unsigned int success_count = 0;
+			unsigned long long total_frame_count = 0;
+
+			for (size_t i = 0; i < jobs.size(); ++i)
+			{
+				const BatchRenderer::JobResult& job_result = job_results[i];
+
+				if (job_result.m_Success)
+				{
+					std::cout << jobs[i].m_InputPathAndFilename << ": " << job_result.m_Result.m_FrameCount << " frames" << std::endl;
+
+					++success_count;
+					total_frame_count += job_result.m_Result.m_FrameCount;
+				}
+				else
+					std::cout << jobs[i].m_InputPathAndFilename << ": " << job_result.m_ErrorMessage << std::endl;
+			}
+
+			const double render_time = std::max(batch_renderer.GetRenderTimeInSeconds(), 0.000001);
+			const double frames_per_second = static_cast<double>(total_frame_count) / render_time;
+
+			std::cout << "Rendered " << success_count << " of " << jobs.size() << " files on " << std::min<size_t>(std::max(thread_count, 1u), jobs.size()) << " threads" << std::endl;
+			std::cout << "Time: " << render_time << "s, " << frames_per_second << " frames per second, " << (frames_per_second / EMULATION_FRAMES_PER_SECOND_PAL) << "x real time" << std::endl;
+
+			result = success_count == jobs.size() ? 0 : -1;
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
+int RunHeadlessBenchmark(int inArgc, char* inArgv[])
+{
+	// Usage: --benchmark-cpu <input.sf2> [frame count]
+	if (inArgc < 3)
+	{
+		std::cout << "Usage: " << inArgv[0] << " --benchmark-cpu <input.sf2> [frame count]" << std::endl;
+		std::cout << "Runs the driver update of the song for a number of frames (default 50000) on each execution core of the CPU, without emulating the SID, and reports the emulation speed." << std::endl;
+		return -1;
+	}
+
+	const std::string input_path_and_filename = inArgv[2];
+	const unsigned int frame_count = std::max(GetHeadlessUnsignedArgument(inArgc, inArgv, 3, 50000), 1u);
+
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = 0;
+
+	{
+		OfflineRenderer renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform));
+
+		const std::pair<Emulation::CPUmos6510::ExecutionCore, const char*> execution_cores[] =
+		{
+			{ Emulation::CPUmos6510::ExecutionCore::Reference, "Reference core" },
+			{ Emulation::CPUmos6510::ExecutionCore::Fast, "Fast core" }
+		};
+
+		for (const auto& execution_core : execution_cores)
+		{
+			OfflineRenderer::BenchmarkResult benchmark_result;
+
+			// Reload the song, so that both cores start from the same memory
+			if (!renderer.Load(input_path_and_filename) || !renderer.BenchmarkDriverUpdate(frame_count, execution_core.first, benchmark_result))
+			{
+				std::cout << renderer.GetErrorMessage() << std::endl;
+				result = -1;
+				break;
+			}
+
+			const double time_in_microseconds = std::max(benchmark_result.m_TimeInSeconds, 0.000001) * 1000000.0;
+			const double cycles_per_microsecond = static_cast<double>(benchmark_result.m_CycleCount) / time_in_microseconds;
+			const double cycles_per_frame = static_cast<double>(benchmark_result.m_CycleCount) / static_cast<double>(benchmark_result.m_FrameCount);
+
+			std::cout << execution_core.second << ":" << std::endl;
+			std::cout << "  Ran " << benchmark_result.m_FrameCount << " driver updates, " << benchmark_result.m_CycleCount << " cycles (" << cycles_per_frame << " cycles per update)" << std::endl;
+			std::cout << "  Time: " << (time_in_microseconds / 1000.0) << "ms, " << (time_in_microseconds / static_cast<double>(benchmark_result.m_FrameCount)) << "us per update" << std::endl;
+			std::cout << "  Speed: " << cycles_per_microsecond << " cycles per us, " << (cycles_per_microsecond * 1000000.0 / EMULATION_CYCLES_PER_SECOND_PAL) << "x the speed of a PAL 6510" << std::endl;
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
+int RunHeadlessBenchmarkResampler(int inArgc, char* inArgv[])
+{
+	// Usage: --benchmark-resampler [seconds]
+	const unsigned int seconds = std::max(GetHeadlessUnsignedArgument(inArgc, inArgv, 2, 10), 1u);
+
+	std::cout << "Resamples " << seconds << " seconds of SID output from the PAL clock to 44100 Hz with each convolution kernel the CPU supports, and reports the speed." << std::endl;
+
+	// A sweeping sawtooth mixed with noise, in the range of the output of the SID, one value per cycle
+	const unsigned int input_count = seconds * EMULATION_CYCLES_PER_SECOND_PAL;
+	std::vector<short> input(input_count);
+
+	unsigned int noise = 0x7ffff8;
+	unsigned int phase = 0;
+
+	for (unsigned int i = 0; i < input_count; ++i)
+	{
+		noise = ((noise << 1) | (((noise >> 22) ^ (noise >> 17)) & 1)) & 0x7fffff;
+		phase += 0x100 + ((i >> 10) & 0x3fff);
+
+		input[i] = static_cast<short>(static_cast<int>(phase >> 17) - 0x4000 + static_cast<int>(noise & 0xfff) - 0x800);
+	}
+
+	const reSIDfp::SincResampler::ConvolutionKernel kernels[] =
+	{
+		reSIDfp::SincResampler::ConvolutionKernel::SCALAR,
+		reSIDfp::SincResampler::ConvolutionKernel::SSE2,
+		reSIDfp::SincResampler::ConvolutionKernel::AVX2,
+		reSIDfp::SincResampler::ConvolutionKernel::NEON
+	};
+
+	std::vector<short> reference_output;
+	int result = 0;
+
+	for (reSIDfp::SincResampler::ConvolutionKernel kernel : kernels)
+	{
+		const char* kernel_name = reSIDfp::SincResampler::getKernelName(kernel);
+
+		if (!reSIDfp::SincResampler::isKernelSupported(kernel))
+		{
+			std::cout << kernel_name << ": not supported" << std::endl;
+			continue;
+		}
+
+		// Set up as the SID does it for resampling
+		std::unique_ptr<reSIDfp::TwoPassSincResampler> resampler(reSIDfp::TwoPassSincResampler::create(EMULATION_CYCLES_PER_SECOND_PAL, 44100.0, 20000.0, kernel));
+		resampler->reset();
+
+		std::vector<short> output;
+		output.reserve(seconds * 44100 + 1);
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		for (short sample : input)
+		{
+			if (resampler->input(sample))
+				output.push_back(static_cast<short>(resampler->output()));
+		}
+
+		const double time_in_seconds = std::max(static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency()), 0.000001);
+		const double samples_per_second = static_cast<double>(output.size()) / time_in_seconds;
+
+		if (reference_output.empty())
+			reference_output = output;
+
+		const bool is_exact = output == reference_output;
+
+		if (!is_exact)
+			result = -1;
+
+		std::cout << kernel_name << (kernel == reSIDfp::SincResampler::getBestKernel() ? " (used)" : "") << ":" << std::endl;
+		std::cout << "  Time: " << (time_in_seconds * 1000.0) << "ms, " << samples_per_second << " samples per second, " << (samples_per_second / 44100.0) << "x real time" << std::endl;
+		std::cout << "  Output: " << output.size() << " samples, " << (is_exact ? "the same as the scalar kernel" : "DIFFERENT from the scalar kernel") << std::endl;
+	}
+
+
+	return result;
+}
+
+
+int RunHeadlessVerifyCPU(int inArgc, char* inArgv[])
+{
+	// Usage: --verify-cpu [input.sf2 ...]
+	const unsigned int iterations_per_opcode = 4096;
+	const unsigned int frame_count = 3000;
+
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = 0;
+
+	{
+		Emulation::CPUmos6510Verifier verifier(platform);
+
+		if (verifier.VerifyInstructions(iterations_per_opcode, 0x5f2u))
+			std::cout << "Instructions: OK, " << verifier.GetInstructionCount() << " instructions compared" << std::endl;
+		else
+		{
+			std::cout << "Instructions: " << verifier.GetErrorMessage() << std::endl;
+			result = -1;
+		}
+
+		OfflineRenderer renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform));
+
+		for (int i = 2; i < inArgc; ++i)
+		{
+			const bool success = renderer.Load(inArgv[i]) && renderer.VerifyExecutionCores(frame_count);
+
+			std::cout << inArgv[i] << ": " << (success ? "OK" : renderer.GetErrorMessage()) << std::endl;
+
+			if (!success)
+				result = -1;
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
+int RunHeadlessProfileRastertime(int inArgc, char* inArgv[])
+{
+	// Usage: --profile-rastertime <input.sf2> [output.csv] [frame count]
+	if (inArgc < 3)
+	{
+		std::cout << "Usage: " << inArgv[0] << " --profile-rastertime <input.sf2> [output.csv] [frame count]" << std::endl;
+		std::cout << "Reports the rastertime of the driver update over the whole song, including where it loops, and optionally writes the rastertime of every frame to a CSV file." << std::endl;
+		return -1;
+	}
+
+	const std::string input_path_and_filename = inArgv[2];
+	const std::string csv_path_and_filename = inArgc > 3 ? inArgv[3] : "";
+	const unsigned int max_frame_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 4, 0);
+
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = -1;
+
+	{
+		OfflineRenderer renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform));
+		RastertimeProfiler::Profile profile;
+
+		if (!renderer.Load(input_path_and_filename) || !renderer.ProfileRastertime(max_frame_count, profile))
+			std::cout << renderer.GetErrorMessage() << std::endl;
+		else
+		{
+			std::cout << RastertimeProfiler::GetReport(profile, false) << std::endl;
+			std::cout << "Time: " << (profile.m_TimeInSeconds * 1000.0) << "ms" << std::endl;
+
+			result = 0;
+
+			if (!csv_path_and_filename.empty())
+			{
+				if (RastertimeProfiler::WriteCSV(csv_path_and_filename, profile))
+					std::cout << "Wrote " << profile.m_FrameCount << " frames to " << csv_path_and_filename << std::endl;
+				else
+				{
+					std::cout << "Could not write to file: " << csv_path_and_filename << std::endl;
+					result = -1;
+				}
+			}
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
+int RunHeadlessPackBatch(int inArgc, char* inArgv[])
+{
+	// Usage: --pack-batch <input.sf2> <output directory> <address>[,<address>...] [thread count] [frame count]
+	if (inArgc < 5)
+	{
+		std::cout << "Usage: " << inArgv[0] << " --pack-batch <input.sf2> <output directory> <address>[,<address>...] [thread count] [frame count]" << std::endl;
+		std::cout << "Packs the song at each of the hexadecimal addresses, i.e. \"0x1000,0x8000\", and plays every packed file through the whole song to verify" << std::endl;
+		std::cout << "that it writes the same to the SID as the song. Only verified files are written. The thread count defaults to the number of cores." << std::endl;
+		return -1;
+	}
+
+	const std::string input_path_and_filename = inArgv[2];
+	const std::string output_directory = inArgv[3];
+	const unsigned int thread_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 5, static_cast<unsigned int>(SDL_GetCPUCount()));
+	const unsigned int max_frame_count = GetHeadlessUnsignedArgument(inArgc, inArgv, 6, 0);
+
+	std::vector<unsigned short> destination_addresses;
+
+	std::stringstream address_list(inArgv[4]);
+	std::string address_text;
+
+	while (std::getline(address_list, address_text, ','))
+	{
+		const std::string trimmed_address_text = Utility::TrimString(address_text);
+		const char* digits = trimmed_address_text.c_str();
+
+		if (trimmed_address_text.size() > 2 && Utility::StringToLowerCase(trimmed_address_text.substr(0, 2)) == "0x")
+			digits += 2;
+		else if (trimmed_address_text.size() > 1 && trimmed_address_text[0] == '$')
+			digits += 1;
+
+		char* digits_end = nullptr;
+		const unsigned long address = std::strtoul(digits, &digits_end, 16);
+
+		if (digits_end == digits || *digits_end != 0 || address > 0xffff)
+		{
+			std::cout << "Not a valid address: " << address_text << std::endl;
+			return -1;
+		}
+
+		destination_addresses.push_back(static_cast<unsigned short>(address));
+	}
+
+	IPlatform* platform = Foundation::CreatePlatform();
+
+	int result = -1;
+
+	{
+		OfflineRenderer renderer(platform, GetHeadlessSIDConfiguration(*platform), GetHeadlessSIDChipSetups(*platform));
+		PackerBatch packer_batch(platform, GetHeadlessSIDConfiguration(*platform));
+
+		if (!renderer.Load(input_path_and_filename) || !renderer.Pack(destination_addresses, std::max(thread_count, 1u), max_frame_count, packer_batch))
+			std::cout << renderer.GetErrorMessage() << std::endl;
+		else
+		{
+			std::error_code error_code;
+			fs::create_directories(fs::path(output_directory), error_code);
+
+			const std::string stem = fs::path(input_path_and_filename).stem().string();
+			unsigned int verified_count = 0;
+
+			for (const PackerBatch::Result& pack_result : packer_batch.GetResults())
+			{
+				std::cout << PackerBatch::GetReport(pack_result, false) << std::endl;
+
+				if (!pack_result.m_IsVerified)
+					continue;
+
+				const std::string output_path_and_filename = (fs::path(output_directory) / (stem + "_" + EditorUtils::ConvertToHexValue(pack_result.m_DestinationAddress, false) + ".prg")).string();
+
+				if (Utility::WriteFile(output_path_and_filename, pack_result.m_PackedData))
+					++verified_count;
+				else
+					std::cout << "Could not write to file: " << output_path_and_filename << std::endl;
+			}
+
+			std::cout << "Wrote " << verified_count << " of " << destination_addresses.size() << " packed files, verified on " << std::min<size_t>(std::max(thread_count, 1u), destination_addresses.size()) << " threads" << std::endl;
+			std::cout << "Time: " << (packer_batch.GetBuildTimeInSeconds() * 1000.0) << "ms" << std::endl;
+
+			result = verified_count == destination_addresses.size() ? 0 : -1;
+		}
+	}
+
+	delete platform;
+
+	return result;
+}
+
+
 void BuildResource()
 {
 	//Utility::MakeBinaryResourceIncludeFile("logo_test.png", "data_logo.h", "data_logo", "Resource");
@@ -42,6 +42,16 @@ namespace Foundation
 			return *this;
 		}
 
+		bool operator==(const Point& inOtherPoint) const
+		{
+			return m_X == inOtherPoint.m_X && m_Y == inOtherPoint.m_Y;
+		}
+
+		bool operator!=(const Point& inOtherPoint) const
+		{
+			return !(*this == inOtherPoint);
+		}
+
 		int m_X;
 		int m_Y;
 	};
@@ -11,6 +11,8 @@ namespace Foundation
 		, m_Position({ inX, inY })
 		, m_Dimensions({ inWidth, inHeight })
 		, m_Enabled(false)
+		, m_HasDrawn(false)
+		, m_RenderRequired(true)
 	{
 		m_Surface = SDL_CreateRGBSurface(0, inWidth, inHeight, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
 		FOUNDATION_ASSERT(m_Surface);
@@ -29,6 +31,9 @@ namespace Foundation
 
 	void DrawField::SetEnable(bool inEnable)
 	{
+		if (m_Enabled != inEnable)
+			m_RenderRequired = true;
+
 		m_Enabled = inEnable;
 	}
 
@@ -47,7 +52,27 @@ namespace Foundation
 	void DrawField::End()
 	{
 		SDL_UnlockSurface(m_Surface);
-		SDL_UpdateTexture(m_Texture, nullptr, m_Surface->pixels, m_Surface->pitch);
+
+		// Only upload the surface if it was drawn to since the last upload
+		if (m_HasDrawn)
+		{
+			SDL_UpdateTexture(m_Texture, nullptr, m_Surface->pixels, m_Surface->pitch);
+
+			m_HasDrawn = false;
+			m_RenderRequired = true;
+		}
+	}
+
+
+	bool DrawField::IsRenderRequired() const
+	{
+		return m_RenderRequired;
+	}
+
+
+	void DrawField::Render()
+	{
+		m_RenderRequired = false;
 
 		if (m_Enabled)
 		{
@@ -77,6 +102,9 @@ namespace Foundation
 
 	void DrawField::SetPosition(const Point& inPosition)
 	{
+		if (m_Position != inPosition)
+			m_RenderRequired = true;
+
 		m_Position = inPosition;
 	}
 
@@ -84,6 +112,7 @@ namespace Foundation
 	void DrawField::Clear(const Color& inColor)
 	{
 		FOUNDATION_ASSERT(m_Surface != nullptr);
+		m_HasDrawn = true;
 
 		const unsigned int color = m_Viewport.GetPalette().GetColorARGB(inColor);
 		unsigned char* buffer = static_cast<unsigned char*>(m_Surface->pixels);
@@ -101,6 +130,7 @@ namespace Foundation
 	void DrawField::DrawDot(const Color& inColor, int inX, int inY)
 	{
 		FOUNDATION_ASSERT(m_Surface != nullptr);
+		m_HasDrawn = true;
 
 		if (m_Dimensions.Contains({ inX, inY }))
 		{
@@ -116,6 +146,7 @@ namespace Foundation
 	void DrawField::DrawLine(const Color& inColor, int inX1, int inY1, int inX2, int inY2)
 	{
 		FOUNDATION_ASSERT(m_Surface != nullptr);
+		m_HasDrawn = true;
 
 		const int lenX = abs(inX1 - inX2);
 		const int lenY = abs(inY1 - inY2);
@@ -189,6 +220,8 @@ namespace Foundation
 
 	void DrawField::DrawBox(const Color& inColor, int inTopLeftX1, int inTopLeftY1, int inWidth, int inHeight)
 	{
+		m_HasDrawn = true;
+
 		unsigned char* buffer = static_cast<unsigned char*>(m_Surface->pixels);
 		const unsigned int color = m_Viewport.GetPalette().GetColorARGB(inColor);
 
@@ -225,6 +258,8 @@ namespace Foundation
 
 	void DrawField::DrawVerticalLine(const Color& inColor, int inX, int inY1, int inY2)
 	{
+		m_HasDrawn = true;
+
 		unsigned char* buffer = static_cast<unsigned char*>(m_Surface->pixels);
 		const unsigned int color = m_Viewport.GetPalette().GetColorARGB(inColor);
 
@@ -255,6 +290,8 @@ namespace Foundation
 
 	void DrawField::DrawHorizontalLine(const Color& inColor, int inX1, int inX2, int inY)
 	{
+		m_HasDrawn = true;
+
 		unsigned char* buffer = static_cast<unsigned char*>(m_Surface->pixels);
 		const unsigned int color = m_Viewport.GetPalette().GetColorARGB(inColor);
 
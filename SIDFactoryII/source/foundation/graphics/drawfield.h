@@ -23,6 +23,9 @@ namespace Foundation
 		void Begin() override;
 		void End() override;
 
+		bool IsRenderRequired() const override;
+		void Render() override;
+
 		const Extent& GetDimensions() const;
 		const Point& GetPosition() const;
 		void SetPosition(const Point& inPosition);
@@ -38,6 +41,8 @@ namespace Foundation
 
 	private:
 		bool m_Enabled;
+		bool m_HasDrawn;
+		bool m_RenderRequired;
 
 		const Viewport& m_Viewport;
 
@@ -11,6 +11,7 @@ namespace Foundation
 		: m_Viewport(inViewport)
 		, m_Renderer(inRenderer)
 		, m_Position({ 0, 0 })
+		, m_RenderRequired(true)
 	{
 		FOUNDATION_ASSERT(inSurface != nullptr);
 		m_Image = SDL_CreateTextureFromSurface(inRenderer, inSurface);
@@ -40,6 +41,9 @@ namespace Foundation
 
 	void Image::SetPosition(const Foundation::Point& inPosition)
 	{
+		if (m_Position != inPosition)
+			m_RenderRequired = true;
+
 		m_Position = inPosition;
 	}
 
@@ -52,6 +56,20 @@ namespace Foundation
 
 	void Image::End()
 	{
+		// Nothing to do
+	}
+
+
+	bool Image::IsRenderRequired() const
+	{
+		return m_RenderRequired;
+	}
+
+
+	void Image::Render()
+	{
+		m_RenderRequired = false;
+
 		if (m_Image != nullptr)
 		{
 			SDL_Rect rect;
@@ -23,6 +23,9 @@ namespace Foundation
 		void Begin() override;
 		void End() override;
 
+		bool IsRenderRequired() const override;
+		void Render() override;
+
 		Foundation::Extent GetDimensions() const;
 		Foundation::Point GetPosition() const;
 
@@ -36,6 +39,8 @@ namespace Foundation
 		int m_Width;
 		int m_Height;
 
+		bool m_RenderRequired;
+
 		SDL_Renderer* m_Renderer;
 		SDL_Texture* m_Image;
 	};
@@ -12,5 +12,8 @@ namespace Foundation
 
 		virtual void Begin() = 0;
 		virtual void End() = 0;
+
+		virtual bool IsRenderRequired() const = 0;		// True, if the content, position or visibility changed since it was last rendered
+		virtual void Render() = 0;
 	};
 }
\ No newline at end of file
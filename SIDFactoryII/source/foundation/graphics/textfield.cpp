@@ -6,8 +6,77 @@
 #include "SDL.h"
 #include "foundation/base/assert.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTFIELD_GLYPH_BLIT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define TEXTFIELD_GLYPH_BLIT_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Foundation
 {
+	namespace
+	{
+		// Expands glyph rows of 8 pixels (one bit per pixel, most significant bit leftmost) to 32 bit pixels in either the
+		// foreground or the background color. A glyph without data is drawn in the background color only.
+		void BlitGlyph(unsigned int* outDestination, int inDestinationPitch, const unsigned char* inGlyphData, int inRowCount, unsigned int inForeground, unsigned int inBackground)
+		{
+#if defined(TEXTFIELD_GLYPH_BLIT_SSE2)
+			const __m128i foreground = _mm_set1_epi32(static_cast<int>(inForeground));
+			const __m128i background = _mm_set1_epi32(static_cast<int>(inBackground));
+			const __m128i bits_left = _mm_set_epi32(0x10, 0x20, 0x40, 0x80);
+			const __m128i bits_right = _mm_set_epi32(0x01, 0x02, 0x04, 0x08);
+
+			for (int i = 0; i < inRowCount; ++i)
+			{
+				const __m128i data = _mm_set1_epi32(inGlyphData != nullptr ? inGlyphData[i] : 0);
+				const __m128i mask_left = _mm_cmpeq_epi32(_mm_and_si128(data, bits_left), bits_left);
+				const __m128i mask_right = _mm_cmpeq_epi32(_mm_and_si128(data, bits_right), bits_right);
+
+				__m128i* destination = reinterpret_cast<__m128i*>(outDestination);
+
+				_mm_storeu_si128(destination, _mm_or_si128(_mm_and_si128(mask_left, foreground), _mm_andnot_si128(mask_left, background)));
+				_mm_storeu_si128(destination + 1, _mm_or_si128(_mm_and_si128(mask_right, foreground), _mm_andnot_si128(mask_right, background)));
+
+				outDestination = reinterpret_cast<unsigned int*>(reinterpret_cast<char*>(outDestination) + inDestinationPitch);
+			}
+#elif defined(TEXTFIELD_GLYPH_BLIT_NEON)
+			const uint32x4_t foreground = vdupq_n_u32(inForeground);
+			const uint32x4_t background = vdupq_n_u32(inBackground);
+			const uint32_t bits_left_values[4] = { 0x80, 0x40, 0x20, 0x10 };
+			const uint32_t bits_right_values[4] = { 0x08, 0x04, 0x02, 0x01 };
+			const uint32x4_t bits_left = vld1q_u32(bits_left_values);
+			const uint32x4_t bits_right = vld1q_u32(bits_right_values);
+
+			for (int i = 0; i < inRowCount; ++i)
+			{
+				const uint32x4_t data = vdupq_n_u32(inGlyphData != nullptr ? inGlyphData[i] : 0);
+
+				vst1q_u32(outDestination, vbslq_u32(vtstq_u32(data, bits_left), foreground, background));
+				vst1q_u32(outDestination + 4, vbslq_u32(vtstq_u32(data, bits_right), foreground, background));
+
+				outDestination = reinterpret_cast<unsigned int*>(reinterpret_cast<char*>(outDestination) + inDestinationPitch);
+			}
+#else
+			// Select between the colors with a mask instead of a branch per pixel
+			const unsigned int difference = inForeground ^ inBackground;
+
+			for (int i = 0; i < inRowCount; ++i)
+			{
+				const unsigned int data = inGlyphData != nullptr ? inGlyphData[i] : 0;
+
+				for (int j = 0; j < 8; ++j)
+					outDestination[j] = inBackground ^ (difference & (0u - ((data >> (7 - j)) & 1u)));
+
+				outDestination = reinterpret_cast<unsigned int*>(reinterpret_cast<char*>(outDestination) + inDestinationPitch);
+			}
+#endif
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------------------------
+
 	void TextColoring::SetForegroundColor(Color inColor)
 	{
 		m_ForegroundColor = Color(static_cast<unsigned short>(inColor) & 0xff);
@@ -110,6 +179,9 @@ namespace Foundation
 		, m_ResolutionX(inWidth * font_width)
 		, m_ResolutionY(inHeight * font_height)
 		, m_Enabled(false)
+		, m_RequiresFullUpload(true)
+		, m_UploadedByteCount(0)
+		, m_RenderRequired(true)
 	{
 		m_Surface = SDL_CreateRGBSurface(0, m_ResolutionX, m_ResolutionY, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
 		FOUNDATION_ASSERT(m_Surface);
@@ -122,6 +194,7 @@ namespace Foundation
 		m_ScreenCharacterCellBuffer = new char[cell_buffer_size];
 		m_ScreenColorCellBuffer = new unsigned short[cell_buffer_size];
 		m_ScreenDirtyCell.Resize(cell_buffer_size);
+		m_DirtyRowSpans.resize(m_Dimensions.m_Height, { 0, 0 });
 
 		memset(m_ScreenCharacterCellBuffer, 0, cell_buffer_size);
 		memset(m_ScreenColorCellBuffer, 0, cell_buffer_size * sizeof(unsigned short));
@@ -138,6 +211,9 @@ namespace Foundation
 
 	void TextField::SetEnable(bool inEnabled)
 	{
+		if (m_Enabled != inEnabled)
+			m_RenderRequired = true;
+
 		m_Enabled = inEnabled;
 	}
 
@@ -154,12 +230,15 @@ namespace Foundation
 		int x = (m_Viewport.GetClientWidth() - m_ResolutionX) >> 1;
 		int y = (m_Viewport.GetClientHeight() - m_ResolutionY) >> 1;
 
-		m_Position = { x, y };
+		SetPosition({ x, y });
 	}
 
 
 	void TextField::SetPosition(const Point& inPosition)
 	{
+		if (m_Position != inPosition)
+			m_RenderRequired = true;
+
 		m_Position = inPosition;
 	}
 
@@ -208,8 +287,24 @@ namespace Foundation
 		ReflectToRenderSurface();
 
 		SDL_UnlockSurface(m_Surface);
-		SDL_UpdateTexture(m_Texture, nullptr, m_Surface->pixels, m_Surface->pitch);
+		UploadDirtyRowSpans();
+
+		if (m_UploadedByteCount > 0)
+			m_RenderRequired = true;
+	}
 
+
+	bool TextField::IsRenderRequired() const
+	{
+		return m_RenderRequired;
+	}
+
+
+	void TextField::Render()
+	{
+		m_RenderRequired = false;
+
+		// The texture keeps its content from the last upload, so it is copied to the renderer even if nothing was uploaded
 		if (m_Enabled)
 		{
 			SDL_Rect rect;
@@ -223,6 +318,63 @@ namespace Foundation
 		}
 	}
 
+
+	unsigned int TextField::GetUploadedByteCount() const
+	{
+		return m_UploadedByteCount;
+	}
+
+
+	void TextField::UploadDirtyRowSpans()
+	{
+		m_UploadedByteCount = 0;
+
+		if (m_RequiresFullUpload)
+		{
+			SDL_UpdateTexture(m_Texture, nullptr, m_Surface->pixels, m_Surface->pitch);
+
+			m_UploadedByteCount = static_cast<unsigned int>(m_ResolutionX * m_ResolutionY) << 2;
+			m_RequiresFullUpload = false;
+
+			return;
+		}
+
+		// Upload a rectangle per run of rows with the same dirty span. A full clear, or a column of changes, ends up as a single upload.
+		int cy = 0;
+
+		while (cy < m_Dimensions.m_Height)
+		{
+			const DirtyRowSpan& span = m_DirtyRowSpans[cy];
+
+			if (span.m_Begin == span.m_End)
+			{
+				++cy;
+				continue;
+			}
+
+			int row_count = 1;
+
+			while (cy + row_count < m_Dimensions.m_Height
+				&& m_DirtyRowSpans[cy + row_count].m_Begin == span.m_Begin
+				&& m_DirtyRowSpans[cy + row_count].m_End == span.m_End)
+				++row_count;
+
+			SDL_Rect rect;
+
+			rect.x = span.m_Begin * font_width;
+			rect.y = cy * font_height;
+			rect.w = (span.m_End - span.m_Begin) * font_width;
+			rect.h = row_count * font_height;
+
+			const void* pixels = static_cast<const char*>(m_Surface->pixels) + rect.y * m_Surface->pitch + (rect.x << 2);
+			SDL_UpdateTexture(m_Texture, &rect, pixels, m_Surface->pitch);
+
+			m_UploadedByteCount += static_cast<unsigned int>(rect.w * rect.h) << 2;
+
+			cy += row_count;
+		}
+	}
+
 	//------------------------------------------------------------------------------------------------------------------------------------------------
 
 	void TextField::Clear()
@@ -704,49 +856,53 @@ namespace Foundation
 		m_CursorLast = m_Cursor;
 
 		// Reflect to screen
+		static_assert(font_width == 8 && font_pitch == 1, "The glyph blitter expects glyphs of one byte per row");
+
 		int char_index = 0;
 		int out_y = 0;
 
 		const Palette& palette = m_Viewport.GetPalette();
 
+		// Neighbouring cells mostly share the same coloring, so the palette look up is only done when it changes
+		unsigned short last_character_coloring = 0;
+		unsigned int last_color_foreground = palette.GetColorARGB(Color(0));
+		unsigned int last_color_background = palette.GetColorARGB(Color(0));
+
 		for (int cy = 0; cy < m_Dimensions.m_Height; ++cy)
 		{
 			int out_x = 0;
 
+			DirtyRowSpan& span = m_DirtyRowSpans[cy];
+			span = { m_Dimensions.m_Width, 0 };
+
+			const bool is_cursor_row = m_Cursor.IsEnabled() && cy >= m_Cursor.m_Y && cy < m_Cursor.m_Y + m_Cursor.m_Height;
+			unsigned int* row_pixels = reinterpret_cast<unsigned int*>(static_cast<char*>(m_Surface->pixels) + out_y * m_Surface->pitch);
+
 			for (int cx = 0; cx < m_Dimensions.m_Width; ++cx)
 			{
 				if (m_ScreenDirtyCell[char_index])
 				{
-					unsigned int character_index = static_cast<unsigned int>(m_ScreenCharacterCellBuffer[char_index]) * font_pitch * font_height;
+					if (cx < span.m_Begin)
+						span.m_Begin = cx;
+					span.m_End = cx + 1;
 
-                    const bool in_valid_character = (character_index < sizeof(Resource::data_characters) - (font_width * font_pitch));
+					const unsigned int character_index = static_cast<unsigned int>(m_ScreenCharacterCellBuffer[char_index]) * font_pitch * font_height;
+					const bool in_valid_character = (character_index < sizeof(Resource::data_characters) - (font_width * font_pitch));
 
 					const unsigned short character_coloring = m_ScreenColorCellBuffer[char_index];
-					const Color ForegroundColor = Color(character_coloring & 0x00ff);
-					const Color BackgroundColor = Color(character_coloring >> 8);
-					const bool is_cursor = m_Cursor.IsEnabled() && m_Cursor.IsPositionInside(cx, cy);
-					const unsigned int color_foreground = !is_cursor ? palette.GetColorARGB(ForegroundColor) : palette.GetColorARGB(BackgroundColor);
-					const unsigned int color_background = !is_cursor ? palette.GetColorARGB(BackgroundColor) : palette.GetColorARGB(ForegroundColor);
 
-					for (int i = 0; i < font_height; ++i)
+					if (character_coloring != last_character_coloring)
 					{
-						unsigned int* dest = (unsigned int*)((const char*)m_Surface->pixels + (out_x << 2) + (out_y + i) * m_Surface->pitch);
-
-						for (int j = 0; j < font_pitch; ++j)
-						{
-                            unsigned char data = in_valid_character ? Resource::data_characters[character_index++] : 0;
-							unsigned int pixel_offset = j << 3;
-
-							*(dest + pixel_offset + 0) = data & 0x80 ? color_foreground : color_background;
-							*(dest + pixel_offset + 1) = data & 0x40 ? color_foreground : color_background;
-							*(dest + pixel_offset + 2) = data & 0x20 ? color_foreground : color_background;
-							*(dest + pixel_offset + 3) = data & 0x10 ? color_foreground : color_background;
-							*(dest + pixel_offset + 4) = data & 0x08 ? color_foreground : color_background;
-							*(dest + pixel_offset + 5) = data & 0x04 ? color_foreground : color_background;
-							*(dest + pixel_offset + 6) = data & 0x02 ? color_foreground : color_background;
-							*(dest + pixel_offset + 7) = data & 0x01 ? color_foreground : color_background;
-						}
+						last_character_coloring = character_coloring;
+						last_color_foreground = palette.GetColorARGB(Color(character_coloring & 0x00ff));
+						last_color_background = palette.GetColorARGB(Color(character_coloring >> 8));
 					}
+
+					const bool is_cursor = is_cursor_row && cx >= m_Cursor.m_X && cx < m_Cursor.m_X + m_Cursor.m_Width;
+					const unsigned int color_foreground = !is_cursor ? last_color_foreground : last_color_background;
+					const unsigned int color_background = !is_cursor ? last_color_background : last_color_foreground;
+
+					BlitGlyph(row_pixels + out_x, m_Surface->pitch, in_valid_character ? &Resource::data_characters[character_index] : nullptr, font_height, color_foreground, color_background);
 				}
 
 				++char_index;
@@ -754,6 +910,9 @@ namespace Foundation
 				out_x += font_width;
 			}
 
+			if (span.m_End == 0)
+				span.m_Begin = 0;
+
 			out_y += font_height;
 		}
 
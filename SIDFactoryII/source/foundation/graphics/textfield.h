@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "SDL.h"
 
 #include "foundation/graphics/color.h"
@@ -79,6 +80,9 @@ namespace Foundation
 		void Begin() override;
 		void End() override;
 
+		bool IsRenderRequired() const override;
+		void Render() override;
+
 		void Clear();
 		void Clear(int inX, int inY, int inWidth, int inHeight);
 		void Clear(const Rect& inRect);
@@ -111,11 +115,21 @@ namespace Foundation
 
 		void ReflectToRenderSurface();
 
+		unsigned int GetUploadedByteCount() const;		// Bytes uploaded to the texture in the last frame
+
 		static const int font_width = 8;
 		static const int font_height = 16;
 		static const int font_pitch = 1;
 
 	private:
+		struct DirtyRowSpan
+		{
+			int m_Begin;		// First dirty cell in the row
+			int m_End;			// One past the last dirty cell in the row, equal to m_Begin if nothing in the row is dirty
+		};
+
+		void UploadDirtyRowSpans();
+
 		bool m_Enabled;
 
 		Point m_Position;
@@ -134,6 +148,11 @@ namespace Foundation
 		unsigned short* m_ScreenColorCellBuffer;
 
 		Utility::BitArray m_ScreenDirtyCell;
+		std::vector<DirtyRowSpan> m_DirtyRowSpans;
+
+		bool m_RequiresFullUpload;
+		unsigned int m_UploadedByteCount;
+		bool m_RenderRequired;
 
 		Cursor m_Cursor;
 		Cursor m_CursorLast;
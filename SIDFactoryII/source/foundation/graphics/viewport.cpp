@@ -20,6 +20,7 @@ namespace Foundation
         , m_ShowOverlay(false)
 		, m_Caption(inCaption)
 		, m_FadeValue(0.0f)
+		, m_RenderRequired(true)
 	{
 		m_Window = SDL_CreateWindow(inCaption.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, m_ClientResolutionX, m_ClientResolutionY, SDL_WINDOW_SHOWN);
 		FOUNDATION_ASSERT(m_Window != nullptr);
@@ -66,6 +67,7 @@ namespace Foundation
 	{
 		m_ClientX = inClientPosition.m_X;
 		m_ClientY = inClientPosition.m_Y;
+		m_RenderRequired = true;
 	}
 
 
@@ -101,11 +103,30 @@ namespace Foundation
 	void Viewport::SetWindowSize(const Extent& inSize)
 	{
 		SDL_SetWindowSize(m_Window, inSize.m_Width, inSize.m_Height);
+		m_RenderRequired = true;
+	}
+
+
+	int Viewport::GetDisplayRefreshRate() const
+	{
+		// Assume a common refresh rate, if the display does not report it
+		const int default_refresh_rate = 60;
+
+		const int display_index = SDL_GetWindowDisplayIndex(m_Window);
+		SDL_DisplayMode display_mode;
+
+		if (display_index < 0 || SDL_GetCurrentDisplayMode(display_index, &display_mode) != 0 || display_mode.refresh_rate <= 0)
+			return default_refresh_rate;
+
+		return display_mode.refresh_rate;
 	}
 
 
 	void Viewport::SetFadeValue(float inFadeValue)
 	{
+		if (m_FadeValue != inFadeValue)
+			m_RenderRequired = true;
+
 		m_FadeValue = inFadeValue;
 	}
 
@@ -124,6 +145,9 @@ namespace Foundation
 
 	void Viewport::ShowOverlay(bool inShowOverlay)
 	{
+		if (m_ShowOverlay != inShowOverlay)
+			m_RenderRequired = true;
+
 		m_ShowOverlay = inShowOverlay;
 	}
 
@@ -151,32 +175,51 @@ namespace Foundation
 		overlay.m_Texture = SDL_CreateTextureFromSurface(m_Renderer, surface);
 		overlay.m_Rect = inImageRect;
 
+		m_RenderRequired = true;
+
 		SDL_FreeSurface(surface);
 	}
 
 
 	void Viewport::Begin()
 	{
+		for (auto managed_resource : m_ManagedResources)
+			managed_resource->Begin();
+	}
+
+
+	bool Viewport::End()
+	{
+		for (auto managed_resource : m_ManagedResources)
+		{
+			managed_resource->End();
+
+			if (managed_resource->IsRenderRequired())
+				m_RenderRequired = true;
+		}
+
+		// Leave the window as it is, if nothing changed. This saves redrawing and presenting, which may wait for the display.
+		if (!m_RenderRequired)
+			return false;
+
+		m_RenderRequired = false;
+
 		if(m_RenderTarget != nullptr)
 			SDL_SetRenderTarget(m_Renderer, m_RenderTarget);
 
 		SDL_SetRenderDrawColor(m_Renderer, 0, 0, 0, 255);
 		SDL_RenderClear(m_Renderer);
 
-		for (auto text_field : m_ManagedResources)
-			text_field->Begin();
-	}
-
-
-	void Viewport::End()
-	{
-		for (auto text_field : m_ManagedResources)
-			text_field->End();
+		for (auto managed_resource : m_ManagedResources)
+			managed_resource->Render();
 
 		if (m_RenderTarget != nullptr)
 		{
 			SDL_SetRenderTarget(m_Renderer, nullptr);
 
+			// Clear the window as well, it is not necessarily preserved after presenting
+			SDL_RenderClear(m_Renderer);
+
 			if (m_ShowOverlay)
 			{
 				for (const auto& overlay : m_OverlayList)
@@ -210,6 +253,14 @@ namespace Foundation
 		}
 
 		SDL_RenderPresent(m_Renderer);
+
+		return true;
+	}
+
+
+	void Viewport::RequestRender()
+	{
+		m_RenderRequired = true;
 	}
 
 
@@ -289,6 +340,8 @@ namespace Foundation
 				m_ManagedResources.erase(it);
 				delete inManaged;
 
+				m_RenderRequired = true;
+
 				return;
 			}
 
@@ -35,6 +35,8 @@ namespace Foundation
 		Extent GetWindowSize() const;
 		void SetWindowSize(const Extent& inSize);
 
+		int GetDisplayRefreshRate() const;
+
 		void SetFadeValue(float inFadeValue);
 		void SetAdditionTitleInfo(const std::string& inAdditionTitleInfo);
 
@@ -42,7 +44,9 @@ namespace Foundation
 		void SetOverlayPNG(int inIndex, void* inData, const Rect& inImageRect);
 
 		void Begin();
-		void End();
+		bool End();					// Returns true, if anything changed and the window was redrawn
+
+		void RequestRender();		// Redraws the window on the next End, even if nothing changed (f.ex. if the window was exposed)
 
 		TextField* CreateTextField(unsigned inWidth, unsigned int inHeight, int inX, int inY);
 		DrawField* CreateDrawField(unsigned inWidth, unsigned int inHeight, int inX, int inY);
@@ -74,6 +78,7 @@ namespace Foundation
 
 		bool m_ShowOverlay;
 		float m_FadeValue;
+		bool m_RenderRequired;
 
 		Palette m_Palette;
 
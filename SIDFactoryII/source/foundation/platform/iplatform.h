@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -7,6 +8,8 @@ namespace Foundation
 {
 	// Forward declaration
 	class IMutex;
+	class IThread;
+	class ISemaphore;
 
 	class IPlatform
 	{
@@ -17,6 +20,10 @@ namespace Foundation
 		virtual ~IPlatform() { }
 
 		virtual std::shared_ptr<IMutex> CreateMutex() = 0;
+		virtual std::shared_ptr<ISemaphore> CreateSemaphore(unsigned int inInitialValue) = 0;
+
+		// Create a thread, that starts executing the thread function immediately. Destroying the thread will join it.
+		virtual std::shared_ptr<IThread> CreateThread(const std::string& inName, const std::function<void()>& inThreadFunction) = 0;
 
 		virtual const std::string& GetName() const = 0;
         
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Foundation
+{
+	class ISemaphore
+	{
+	protected:
+		ISemaphore() { }
+	public:
+		virtual ~ISemaphore() { }
+
+		ISemaphore(const ISemaphore& inOther) = delete;
+		ISemaphore(const ISemaphore&& inOther) = delete;
+
+		virtual void Wait() = 0;
+		virtual bool WaitTimeout(unsigned int inMilliseconds) = 0;		// Returns false if the wait timed out
+		virtual void Post() = 0;
+	};
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace Foundation
+{
+	class IThread
+	{
+	protected:
+		IThread() { }
+	public:
+		virtual ~IThread() { }
+
+		IThread(const IThread& inOther) = delete;
+		IThread(const IThread&& inOther) = delete;
+
+		virtual void Join() = 0;					// Blocks until the thread function has returned
+		virtual bool IsJoined() const = 0;
+	};
+}
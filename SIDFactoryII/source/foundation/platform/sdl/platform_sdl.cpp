@@ -1,5 +1,7 @@
 #include "platform_sdl.h"
 #include "mutex_sdl.h"
+#include "semaphore_sdl.h"
+#include "thread_sdl.h"
 
 #include "foundation/base/assert.h"
 
@@ -14,6 +16,12 @@ using namespace fs;
 #undef CreateMutex
 #endif
 
+#ifdef CreateSemaphore
+#define __UNDEF_CREATESEMAPHORE
+#pragma push_macro("CreateSemaphore")
+#undef CreateSemaphore
+#endif
+
 namespace Foundation
 {
 	PlatformSDL::PlatformSDL(const std::string& inName)
@@ -38,6 +46,16 @@ namespace Foundation
 		return std::shared_ptr<IMutex>(new MutexSDL());
 	}
 
+	std::shared_ptr<ISemaphore> PlatformSDL::CreateSemaphore(unsigned int inInitialValue)
+	{
+		return std::shared_ptr<ISemaphore>(new SemaphoreSDL(inInitialValue));
+	}
+
+	std::shared_ptr<IThread> PlatformSDL::CreateThread(const std::string& inName, const std::function<void()>& inThreadFunction)
+	{
+		return std::shared_ptr<IThread>(new ThreadSDL(inName, inThreadFunction));
+	}
+
 	//---------------------------------------------------------------------------------------
 
 }
@@ -46,3 +64,8 @@ namespace Foundation
 #pragma pop_macro("CreateMutex")
 #undef __UNDEF_CREATEMUTEX
 #endif //__PUSHED_CREATEMUTEX
+
+#ifdef __UNDEF_CREATESEMAPHORE
+#pragma pop_macro("CreateSemaphore")
+#undef __UNDEF_CREATESEMAPHORE
+#endif //__UNDEF_CREATESEMAPHORE
@@ -16,6 +16,8 @@ namespace Foundation
 
 		const std::string& GetName() const override;
 		std::shared_ptr<IMutex> CreateMutex() override;
+		std::shared_ptr<ISemaphore> CreateSemaphore(unsigned int inInitialValue) override;
+		std::shared_ptr<IThread> CreateThread(const std::string& inName, const std::function<void()>& inThreadFunction) override;
 
 	private:
 		std::string m_Name;
@@ -0,0 +1,29 @@
+#include "semaphore_sdl.h"
+
+namespace Foundation
+{
+	SemaphoreSDL::SemaphoreSDL(unsigned int inInitialValue)
+	{
+		m_Semaphore = SDL_CreateSemaphore(inInitialValue);
+	}
+
+	SemaphoreSDL::~SemaphoreSDL()
+	{
+		SDL_DestroySemaphore(m_Semaphore);
+	}
+
+	void SemaphoreSDL::Wait()
+	{
+		SDL_SemWait(m_Semaphore);
+	}
+
+	bool SemaphoreSDL::WaitTimeout(unsigned int inMilliseconds)
+	{
+		return SDL_SemWaitTimeout(m_Semaphore, inMilliseconds) == 0;
+	}
+
+	void SemaphoreSDL::Post()
+	{
+		SDL_SemPost(m_Semaphore);
+	}
+}
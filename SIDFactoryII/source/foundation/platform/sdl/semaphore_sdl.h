@@ -0,0 +1,24 @@
+#pragma once
+
+#include "foundation/platform/isemaphore.h"
+#include "SDL.h"
+
+namespace Foundation
+{
+	class SemaphoreSDL final : public ISemaphore
+	{
+		friend class PlatformSDL;
+
+	protected:
+		SemaphoreSDL(unsigned int inInitialValue);
+	public:
+		virtual ~SemaphoreSDL();
+
+		virtual void Wait() override;
+		virtual bool WaitTimeout(unsigned int inMilliseconds) override;
+		virtual void Post() override;
+
+	private:
+		SDL_sem* m_Semaphore;
+	};
+}
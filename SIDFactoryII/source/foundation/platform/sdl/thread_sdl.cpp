@@ -0,0 +1,41 @@
+#include "thread_sdl.h"
+#include "foundation/base/assert.h"
+
+namespace Foundation
+{
+	ThreadSDL::ThreadSDL(const std::string& inName, const std::function<void()>& inThreadFunction)
+		: m_ThreadFunction(inThreadFunction)
+	{
+		FOUNDATION_ASSERT(m_ThreadFunction);
+		m_Thread = SDL_CreateThread(&ThreadSDL::ThreadFunction, inName.c_str(), this);
+	}
+
+	ThreadSDL::~ThreadSDL()
+	{
+		Join();
+	}
+
+	void ThreadSDL::Join()
+	{
+		if (m_Thread != nullptr)
+		{
+			SDL_WaitThread(m_Thread, nullptr);
+			m_Thread = nullptr;
+		}
+	}
+
+	bool ThreadSDL::IsJoined() const
+	{
+		return m_Thread == nullptr;
+	}
+
+	int ThreadSDL::ThreadFunction(void* inUserData)
+	{
+		FOUNDATION_ASSERT(inUserData != nullptr);
+
+		ThreadSDL* thread = static_cast<ThreadSDL*>(inUserData);
+		thread->m_ThreadFunction();
+
+		return 0;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "foundation/platform/ithread.h"
+#include "SDL.h"
+#include <functional>
+#include <string>
+
+namespace Foundation
+{
+	class ThreadSDL final : public IThread
+	{
+		friend class PlatformSDL;
+
+	protected:
+		ThreadSDL(const std::string& inName, const std::function<void()>& inThreadFunction);
+	public:
+		virtual ~ThreadSDL();
+
+		virtual void Join() override;
+		virtual bool IsJoined() const override;
+
+	private:
+		static int ThreadFunction(void* inUserData);
+
+		std::function<void()> m_ThreadFunction;
+		SDL_Thread* m_Thread;
+	};
+}
@@ -14,9 +14,10 @@ namespace Foundation
 			audio_stream_instance->m_StreamFeeder->FeedPCM(static_cast<void*>(inStream), inByteCount);
 	}
 
-	AudioStream::AudioStream(unsigned int inFrequency, unsigned int inBitDepth, unsigned int inBufferDuration, IAudioStreamFeeder* inStreamFeeder)
+	AudioStream::AudioStream(unsigned int inFrequency, unsigned int inBitDepth, unsigned int inChannelCount, unsigned int inBufferDuration, IAudioStreamFeeder* inStreamFeeder)
 		: m_Frequency(inFrequency)
 		, m_BitDepth(inBitDepth)
+		, m_ChannelCount(inChannelCount)
 		, m_BufferDuration(inBufferDuration)
 		, m_StreamFeeder(inStreamFeeder)
 	{
@@ -42,7 +43,7 @@ namespace Foundation
 
 		audio_spec.callback = &AudioStream::AudioCallback;
 		audio_spec.userdata = this;
-		audio_spec.channels = 1;
+		audio_spec.channels = static_cast<unsigned char>(inChannelCount);
 		audio_spec.format = inBitDepth == 16 ? AUDIO_S16LSB : AUDIO_U8;
 		audio_spec.freq = inFrequency;
 		audio_spec.samples = static_cast<unsigned short>(buffer_size_power_of_two);
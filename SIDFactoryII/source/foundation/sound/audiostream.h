@@ -19,6 +19,7 @@ namespace Foundation
 
 		virtual unsigned int GetBytesFed() const = 0;								// Returns number of bytes of data fed to the stream!
 		virtual unsigned int GetFeedCount() const = 0;								// Returns the number of times feed procedure as been called
+		virtual unsigned int GetUnderrunCount() const = 0;							// Returns the number of times the feeder had too little data ready for the stream
 
 		virtual void PreFeedPCM(void* inBuffer, unsigned int inByteCount) = 0;		// Called when pre feeding the buffer before starting it
 		virtual void FeedPCM(void* inBuffer, unsigned int inByteCount) = 0;			// Called when ever the stream needs more data while running
@@ -27,7 +28,8 @@ namespace Foundation
 	class AudioStream final
 	{
 	public:
-		AudioStream(unsigned int inFrequency, unsigned int inBitDepth, unsigned int inBufferDuration, IAudioStreamFeeder* inStreamFeeder);
+		// Stereo samples are fed interleaved, left first
+		AudioStream(unsigned int inFrequency, unsigned int inBitDepth, unsigned int inChannelCount, unsigned int inBufferDuration, IAudioStreamFeeder* inStreamFeeder);
 		~AudioStream();
 
 		void Start();
@@ -36,6 +38,7 @@ namespace Foundation
 	private:
 		unsigned int m_Frequency;
 		unsigned int m_BitDepth;
+		unsigned int m_ChannelCount;
 		unsigned int m_BufferDuration;
 
 		IAudioStreamFeeder* m_StreamFeeder;
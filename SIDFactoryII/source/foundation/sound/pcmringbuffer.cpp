@@ -0,0 +1,96 @@
+#include "pcmringbuffer.h"
+#include "foundation/base/assert.h"
+
+#include <string.h>
+
+namespace Foundation
+{
+	PCMRingBuffer::PCMRingBuffer(unsigned int inMinimumCapacity)
+		: m_ReadPosition(0)
+		, m_WritePosition(0)
+	{
+		FOUNDATION_ASSERT(inMinimumCapacity > 0);
+
+		m_Capacity = 1;
+		while (m_Capacity < inMinimumCapacity)
+			m_Capacity <<= 1;
+
+		m_CapacityMask = m_Capacity - 1;
+		m_Buffer = new short[m_Capacity];
+
+		memset(m_Buffer, 0, m_Capacity * sizeof(short));
+	}
+
+	PCMRingBuffer::~PCMRingBuffer()
+	{
+		delete[] m_Buffer;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	unsigned int PCMRingBuffer::GetAvailableForWrite() const
+	{
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_acquire);
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_relaxed);
+
+		return m_Capacity - (write_position - read_position);
+	}
+
+	unsigned int PCMRingBuffer::Write(const short* inSamples, unsigned int inSampleCount)
+	{
+		FOUNDATION_ASSERT(inSamples != nullptr);
+
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_acquire);
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_relaxed);
+
+		const unsigned int available = m_Capacity - (write_position - read_position);
+		const unsigned int sample_count = inSampleCount < available ? inSampleCount : available;
+
+		// Copy in up to two runs, split where the buffer wraps
+		const unsigned int offset = write_position & m_CapacityMask;
+		const unsigned int first_run = sample_count < m_Capacity - offset ? sample_count : m_Capacity - offset;
+
+		memcpy(m_Buffer + offset, inSamples, first_run * sizeof(short));
+		memcpy(m_Buffer, inSamples + first_run, (sample_count - first_run) * sizeof(short));
+
+		m_WritePosition.store(write_position + sample_count, std::memory_order_release);
+
+		return sample_count;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	unsigned int PCMRingBuffer::GetAvailableForRead() const
+	{
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_acquire);
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_relaxed);
+
+		return write_position - read_position;
+	}
+
+	unsigned int PCMRingBuffer::Read(short* outSamples, unsigned int inSampleCount)
+	{
+		FOUNDATION_ASSERT(outSamples != nullptr);
+
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_acquire);
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_relaxed);
+
+		const unsigned int available = write_position - read_position;
+		const unsigned int sample_count = inSampleCount < available ? inSampleCount : available;
+
+		const unsigned int offset = read_position & m_CapacityMask;
+		const unsigned int first_run = sample_count < m_Capacity - offset ? sample_count : m_Capacity - offset;
+
+		memcpy(outSamples, m_Buffer + offset, first_run * sizeof(short));
+		memcpy(outSamples + first_run, m_Buffer, (sample_count - first_run) * sizeof(short));
+
+		m_ReadPosition.store(read_position + sample_count, std::memory_order_release);
+
+		return sample_count;
+	}
+
+	void PCMRingBuffer::Flush()
+	{
+		m_ReadPosition.store(m_WritePosition.load(std::memory_order_acquire), std::memory_order_release);
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+
+namespace Foundation
+{
+	// Single producer, single consumer ring buffer of 16 bit PCM samples. The producer and the consumer may
+	// run on separate threads without any locking, as long as there's only one of each.
+	class PCMRingBuffer final
+	{
+	public:
+		PCMRingBuffer(unsigned int inMinimumCapacity);		// Capacity is rounded up to the nearest power of two
+		~PCMRingBuffer();
+
+		PCMRingBuffer(const PCMRingBuffer& inOther) = delete;
+
+		unsigned int GetCapacity() const { return m_Capacity; }
+
+		// Producer
+		unsigned int GetAvailableForWrite() const;
+		unsigned int Write(const short* inSamples, unsigned int inSampleCount);
+
+		// Consumer
+		unsigned int GetAvailableForRead() const;
+		unsigned int Read(short* outSamples, unsigned int inSampleCount);
+		void Flush();
+
+	private:
+		unsigned int m_Capacity;
+		unsigned int m_CapacityMask;
+
+		short* m_Buffer;
+
+		// Read and write positions are free running, and only masked when accessing the buffer
+		std::atomic<unsigned int> m_ReadPosition;
+		std::atomic<unsigned int> m_WritePosition;
+	};
+}
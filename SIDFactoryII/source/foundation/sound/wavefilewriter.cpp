@@ -0,0 +1,316 @@
+#include "wavefilewriter.h"
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/isemaphore.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+#include <string.h>
+
+namespace Foundation
+{
+	namespace
+	{
+		const unsigned int BufferByteSize = 0x40000;
+
+		// Wave header layout. The float format carries an extension size field in the format chunk and a fact chunk, as the format requires for non PCM data.
+		const unsigned int RIFFSizeOffset = 4;
+		const unsigned int FactSampleCountOffset = 46;
+
+		void AppendTag(std::vector<unsigned char>& outData, const char* inTag)
+		{
+			outData.insert(outData.end(), inTag, inTag + 4);
+		}
+
+		void AppendWord(std::vector<unsigned char>& outData, unsigned short inValue)
+		{
+			outData.push_back(static_cast<unsigned char>(inValue & 0xff));
+			outData.push_back(static_cast<unsigned char>(inValue >> 8));
+		}
+
+		void AppendLong(std::vector<unsigned char>& outData, unsigned int inValue)
+		{
+			AppendWord(outData, static_cast<unsigned short>(inValue & 0xffff));
+			AppendWord(outData, static_cast<unsigned short>(inValue >> 16));
+		}
+
+		void PatchLong(FILE* inFile, unsigned int inOffset, unsigned int inValue)
+		{
+			std::vector<unsigned char> data;
+			AppendLong(data, inValue);
+
+			fseek(inFile, static_cast<long>(inOffset), SEEK_SET);
+			fwrite(&data[0], 1, data.size(), inFile);
+		}
+	}
+
+
+	WaveFileWriter::WaveFileWriter(IPlatform* inPlatform, unsigned int inSampleRate, unsigned short inChannelCount, SampleFormat inSampleFormat, bool inWriteHeader)
+		: m_Platform(inPlatform)
+		, m_SampleRate(inSampleRate)
+		, m_ChannelCount(inChannelCount)
+		, m_SampleFormat(inSampleFormat)
+		, m_WriteHeader(inWriteHeader)
+		, m_File(nullptr)
+		, m_SampleCount(0)
+		, m_FillBufferIndex(0)
+		, m_FillByteCount(0)
+		, m_WriteBufferIndex(0)
+		, m_WriteByteCount(0)
+		, m_WriteError(false)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+		FOUNDATION_ASSERT(inChannelCount > 0);
+
+		// Round the buffer size down to whole sample frames, so a frame is never split between two buffers
+		const unsigned int bytes_per_frame = GetBytesPerSample(inSampleFormat) * inChannelCount;
+		const unsigned int buffer_size = (BufferByteSize / bytes_per_frame) * bytes_per_frame;
+
+		m_Buffers[0].resize(buffer_size);
+		m_Buffers[1].resize(buffer_size);
+	}
+
+	WaveFileWriter::~WaveFileWriter()
+	{
+		Close();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool WaveFileWriter::Open(const std::string& inPathAndFilename)
+	{
+		FOUNDATION_ASSERT(m_File == nullptr);
+
+		m_File = fopen(inPathAndFilename.c_str(), "wb");
+
+		if (m_File == nullptr)
+			return false;
+
+		m_SampleCount = 0;
+		m_FillBufferIndex = 0;
+		m_FillByteCount = 0;
+		m_WriteError = false;
+
+		// Write the header with zero sizes. They are patched, when the file is closed.
+		if (m_WriteHeader)
+		{
+			const std::vector<unsigned char> header = CreateHeader();
+			m_WriteError = fwrite(&header[0], 1, header.size(), m_File) != header.size();
+		}
+
+		// The writer thread starts out idle
+		m_BufferReady = m_Platform->CreateSemaphore(0);
+		m_BufferFree = m_Platform->CreateSemaphore(1);
+		m_WriterThread = m_Platform->CreateThread("SF2 Wave Writer", [this]() { WriterThread(); });
+
+		return true;
+	}
+
+
+	bool WaveFileWriter::Close()
+	{
+		if (m_File == nullptr)
+			return false;
+
+		if (m_FillByteCount > 0)
+			SubmitFillBuffer();
+
+		// Wait for the last buffer to be written, and stop the writer thread
+		m_BufferFree->Wait();
+		m_WriteByteCount = 0;
+		m_BufferReady->Post();
+
+		m_WriterThread->Join();
+		m_WriterThread = nullptr;
+		m_BufferReady = nullptr;
+		m_BufferFree = nullptr;
+
+		// Patch the sizes in the header
+		if (m_WriteHeader && !m_WriteError)
+		{
+			const unsigned int header_size = static_cast<unsigned int>(CreateHeader().size());
+			const unsigned int data_size = m_SampleCount * GetBytesPerSample(m_SampleFormat);
+
+			PatchLong(m_File, RIFFSizeOffset, header_size - 8 + data_size);
+			PatchLong(m_File, header_size - 4, data_size);
+
+			if (m_SampleFormat == SampleFormat::Float32)
+				PatchLong(m_File, FactSampleCountOffset, m_SampleCount / m_ChannelCount);
+		}
+
+		const bool success = !m_WriteError && fclose(m_File) == 0;
+		m_File = nullptr;
+
+		return success;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool WaveFileWriter::IsOpen() const
+	{
+		return m_File != nullptr;
+	}
+
+	bool WaveFileWriter::IsInErrorState() const
+	{
+		return m_WriteError;
+	}
+
+	unsigned int WaveFileWriter::GetSampleCount() const
+	{
+		return m_SampleCount;
+	}
+
+	unsigned int WaveFileWriter::GetBytesPerSample(SampleFormat inSampleFormat)
+	{
+		switch (inSampleFormat)
+		{
+		case SampleFormat::PCM16:
+			return 2;
+		case SampleFormat::PCM24:
+			return 3;
+		case SampleFormat::Float32:
+			return 4;
+		}
+
+		FOUNDATION_ASSERT(false);
+		return 2;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void WaveFileWriter::Write(const short* inSamples, unsigned int inSampleCount)
+	{
+		FOUNDATION_ASSERT(m_File != nullptr);
+
+		const unsigned int bytes_per_sample = GetBytesPerSample(m_SampleFormat);
+
+		while (inSampleCount > 0)
+		{
+			std::vector<unsigned char>& buffer = m_Buffers[m_FillBufferIndex];
+
+			const unsigned int room = static_cast<unsigned int>(buffer.size() - m_FillByteCount) / bytes_per_sample;
+			const unsigned int count = inSampleCount < room ? inSampleCount : room;
+
+			unsigned char* destination = &buffer[m_FillByteCount];
+
+			// Samples are stored little endian, regardless of the host
+			switch (m_SampleFormat)
+			{
+			case SampleFormat::PCM16:
+				for (unsigned int i = 0; i < count; ++i)
+				{
+					const unsigned short value = static_cast<unsigned short>(inSamples[i]);
+
+					*destination++ = static_cast<unsigned char>(value & 0xff);
+					*destination++ = static_cast<unsigned char>(value >> 8);
+				}
+				break;
+			case SampleFormat::PCM24:
+				for (unsigned int i = 0; i < count; ++i)
+				{
+					const unsigned short value = static_cast<unsigned short>(inSamples[i]);
+
+					*destination++ = 0;
+					*destination++ = static_cast<unsigned char>(value & 0xff);
+					*destination++ = static_cast<unsigned char>(value >> 8);
+				}
+				break;
+			case SampleFormat::Float32:
+				for (unsigned int i = 0; i < count; ++i)
+				{
+					const float value = static_cast<float>(inSamples[i]) / 32768.0f;
+
+					unsigned int bits;
+					memcpy(&bits, &value, sizeof(bits));
+
+					*destination++ = static_cast<unsigned char>(bits & 0xff);
+					*destination++ = static_cast<unsigned char>((bits >> 8) & 0xff);
+					*destination++ = static_cast<unsigned char>((bits >> 16) & 0xff);
+					*destination++ = static_cast<unsigned char>(bits >> 24);
+				}
+				break;
+			}
+
+			m_FillByteCount += count * bytes_per_sample;
+			m_SampleCount += count;
+
+			inSamples += count;
+			inSampleCount -= count;
+
+			if (m_FillByteCount + bytes_per_sample > buffer.size())
+				SubmitFillBuffer();
+		}
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void WaveFileWriter::SubmitFillBuffer()
+	{
+		// Wait for the writer thread to be done with the other buffer, and hand this one over
+		m_BufferFree->Wait();
+
+		m_WriteBufferIndex = m_FillBufferIndex;
+		m_WriteByteCount = m_FillByteCount;
+
+		m_FillBufferIndex ^= 1;
+		m_FillByteCount = 0;
+
+		m_BufferReady->Post();
+	}
+
+
+	void WaveFileWriter::WriterThread()
+	{
+		while (true)
+		{
+			m_BufferReady->Wait();
+
+			if (m_WriteByteCount == 0)
+				break;
+
+			if (!m_WriteError)
+				m_WriteError = fwrite(&m_Buffers[m_WriteBufferIndex][0], 1, m_WriteByteCount, m_File) != m_WriteByteCount;
+
+			m_BufferFree->Post();
+		}
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	std::vector<unsigned char> WaveFileWriter::CreateHeader() const
+	{
+		const bool is_float = m_SampleFormat == SampleFormat::Float32;
+		const unsigned int bytes_per_sample = GetBytesPerSample(m_SampleFormat);
+
+		std::vector<unsigned char> header;
+
+		AppendTag(header, "RIFF");
+		AppendLong(header, 0);
+		AppendTag(header, "WAVE");
+
+		AppendTag(header, "fmt ");
+		AppendLong(header, is_float ? 18 : 16);
+		AppendWord(header, is_float ? 3 : 1);								// 1 = PCM, 3 = IEEE float
+		AppendWord(header, m_ChannelCount);
+		AppendLong(header, m_SampleRate);
+		AppendLong(header, m_SampleRate * m_ChannelCount * bytes_per_sample);	// Byte rate
+		AppendWord(header, static_cast<unsigned short>(m_ChannelCount * bytes_per_sample));	// Block align
+		AppendWord(header, static_cast<unsigned short>(bytes_per_sample * 8));
+
+		if (is_float)
+		{
+			AppendWord(header, 0);											// Extension size
+
+			AppendTag(header, "fact");
+			AppendLong(header, 4);
+
+			FOUNDATION_ASSERT(header.size() == FactSampleCountOffset);
+			AppendLong(header, 0);
+		}
+
+		AppendTag(header, "data");
+		AppendLong(header, 0);
+
+		return header;
+	}
+}
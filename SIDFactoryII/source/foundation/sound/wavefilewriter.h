@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+	class ISemaphore;
+	class IThread;
+
+	// Streams 16 bit PCM samples to a wave file (or a headerless raw file), converting them to the requested sample format on the way.
+	// Samples are collected in one of two large buffers, while the other is written to disk on a background thread, so the caller
+	// only waits on the disk if it produces samples faster than they can be written.
+	class WaveFileWriter final
+	{
+	public:
+		enum class SampleFormat : int
+		{
+			PCM16,
+			PCM24,
+			Float32
+		};
+
+		WaveFileWriter(IPlatform* inPlatform, unsigned int inSampleRate, unsigned short inChannelCount, SampleFormat inSampleFormat, bool inWriteHeader);
+		~WaveFileWriter();		// Closes the file, if it is still open
+
+		WaveFileWriter(const WaveFileWriter& inOther) = delete;
+
+		bool Open(const std::string& inPathAndFilename);
+		bool Close();
+
+		bool IsOpen() const;
+		bool IsInErrorState() const;
+
+		void Write(const short* inSamples, unsigned int inSampleCount);
+
+		unsigned int GetSampleCount() const;
+
+		static unsigned int GetBytesPerSample(SampleFormat inSampleFormat);
+
+	private:
+		void SubmitFillBuffer();
+		void WriterThread();
+
+		std::vector<unsigned char> CreateHeader() const;
+
+		IPlatform* m_Platform;
+
+		const unsigned int m_SampleRate;
+		const unsigned short m_ChannelCount;
+		const SampleFormat m_SampleFormat;
+		const bool m_WriteHeader;
+
+		FILE* m_File;
+		unsigned int m_SampleCount;
+
+		std::vector<unsigned char> m_Buffers[2];
+		unsigned int m_FillBufferIndex;
+		unsigned int m_FillByteCount;
+
+		// Handed over to the writer thread through the semaphores. A byte count of 0 tells the writer thread to stop.
+		unsigned int m_WriteBufferIndex;
+		unsigned int m_WriteByteCount;
+		std::atomic<bool> m_WriteError;
+
+		std::shared_ptr<ISemaphore> m_BufferReady;
+		std::shared_ptr<ISemaphore> m_BufferFree;
+		std::shared_ptr<IThread> m_WriterThread;
+	};
+}
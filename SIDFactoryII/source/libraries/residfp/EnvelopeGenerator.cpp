@@ -167,4 +167,50 @@ void EnvelopeGenerator::writeSUSTAIN_RELEASE(unsigned char sustain_release)
     }
 }
 
+void EnvelopeGenerator::getState(EnvelopeGeneratorState& state) const
+{
+    state.lfsr = lfsr;
+    state.rate = rate;
+    state.exponential_counter = exponential_counter;
+    state.exponential_counter_period = exponential_counter_period;
+    state.new_exponential_counter_period = new_exponential_counter_period;
+    state.state_pipeline = state_pipeline;
+    state.envelope_pipeline = envelope_pipeline;
+    state.exponential_pipeline = exponential_pipeline;
+    state.state = this->state;
+    state.next_state = next_state;
+    state.counter_enabled = counter_enabled;
+    state.gate = gate;
+    state.resetLfsr = resetLfsr;
+    state.envelope_counter = envelope_counter;
+    state.attack = attack;
+    state.decay = decay;
+    state.sustain = sustain;
+    state.release = release;
+    state.env3 = env3;
+}
+
+void EnvelopeGenerator::setState(const EnvelopeGeneratorState& state)
+{
+    lfsr = state.lfsr;
+    rate = state.rate;
+    exponential_counter = state.exponential_counter;
+    exponential_counter_period = state.exponential_counter_period;
+    new_exponential_counter_period = state.new_exponential_counter_period;
+    state_pipeline = state.state_pipeline;
+    envelope_pipeline = state.envelope_pipeline;
+    exponential_pipeline = state.exponential_pipeline;
+    this->state = static_cast<State>(state.state);
+    next_state = static_cast<State>(state.next_state);
+    counter_enabled = state.counter_enabled;
+    gate = state.gate;
+    resetLfsr = state.resetLfsr;
+    envelope_counter = state.envelope_counter;
+    attack = state.attack;
+    decay = state.decay;
+    sustain = state.sustain;
+    release = state.release;
+    env3 = state.env3;
+}
+
 } // namespace reSIDfp
@@ -25,6 +25,7 @@
 #define ENVELOPEGENERATOR_H
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 
 namespace reSIDfp
 {
@@ -207,6 +208,12 @@ public:
      * @return envelope counter
      */
     unsigned char readENV() const { return env3; }
+
+    /**
+     * Get and set the emulation state.
+     */
+    void getState(EnvelopeGeneratorState& state) const;
+    void setState(const EnvelopeGeneratorState& state);
 };
 
 } // namespace reSIDfp
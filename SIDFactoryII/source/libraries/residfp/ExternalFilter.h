@@ -24,6 +24,7 @@
 #define EXTERNALFILTER_H
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 
 namespace reSIDfp
 {
@@ -82,6 +83,9 @@ public:
      * SID reset.
      */
     void reset();
+
+    void getState(ExternalFilterState& state) const { state.Vlp = Vlp; state.Vhp = Vhp; }
+    void setState(const ExternalFilterState& state) { Vlp = state.Vlp; Vhp = state.Vhp; }
 };
 
 } // namespace reSIDfp
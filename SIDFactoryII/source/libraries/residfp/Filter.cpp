@@ -87,4 +87,50 @@ void Filter::writeMODE_VOL(unsigned char mode_vol)
     updatedMixing();
 }
 
+void Filter::getState(FilterState& state) const
+{
+    state.currentGain = currentGain;
+    state.currentMixer = currentMixer;
+    state.currentSummer = currentSummer;
+    state.currentResonance = currentResonance;
+    state.Vhp = Vhp;
+    state.Vbp = Vbp;
+    state.Vlp = Vlp;
+    state.ve = ve;
+    state.fc = fc;
+    state.filt1 = filt1;
+    state.filt2 = filt2;
+    state.filt3 = filt3;
+    state.filtE = filtE;
+    state.voice3off = voice3off;
+    state.hp = hp;
+    state.bp = bp;
+    state.lp = lp;
+    state.vol = vol;
+    state.filt = filt;
+}
+
+void Filter::setState(const FilterState& state)
+{
+    currentGain = state.currentGain;
+    currentMixer = state.currentMixer;
+    currentSummer = state.currentSummer;
+    currentResonance = state.currentResonance;
+    Vhp = state.Vhp;
+    Vbp = state.Vbp;
+    Vlp = state.Vlp;
+    ve = state.ve;
+    fc = state.fc;
+    filt1 = state.filt1;
+    filt2 = state.filt2;
+    filt3 = state.filt3;
+    filtE = state.filtE;
+    voice3off = state.voice3off;
+    hp = state.hp;
+    bp = state.bp;
+    lp = state.lp;
+    vol = state.vol;
+    filt = state.filt;
+}
+
 } // namespace reSIDfp
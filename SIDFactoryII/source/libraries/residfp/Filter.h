@@ -23,6 +23,8 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include "SIDState.h"
+
 namespace reSIDfp
 {
 
@@ -170,6 +172,12 @@ public:
     void writeMODE_VOL(unsigned char mode_vol);
 
     virtual void input(int input) = 0;
+
+    /**
+     * Get and set the emulation state.
+     */
+    virtual void getState(FilterState& state) const;
+    virtual void setState(const FilterState& state);
 };
 
 } // namespace reSIDfp
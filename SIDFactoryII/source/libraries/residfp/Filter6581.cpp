@@ -72,4 +72,20 @@ void Filter6581::setFilterCurve(double curvePosition)
     updatedCenterFrequency();
 }
 
+void Filter6581::getState(FilterState& state) const
+{
+    Filter::getState(state);
+
+    hpIntegrator->getState(state.hpIntegrator);
+    bpIntegrator->getState(state.bpIntegrator);
+}
+
+void Filter6581::setState(const FilterState& state)
+{
+    Filter::setState(state);
+
+    hpIntegrator->setState(state.hpIntegrator);
+    bpIntegrator->setState(state.bpIntegrator);
+}
+
 } // namespace reSIDfp
@@ -98,4 +98,20 @@ void Filter8580::setFilterCurve(double curvePosition)
     bpIntegrator->setV(cp);
 }
 
+void Filter8580::getState(FilterState& state) const
+{
+    Filter::getState(state);
+
+    hpIntegrator->getState(state.hpIntegrator);
+    bpIntegrator->getState(state.bpIntegrator);
+}
+
+void Filter8580::setState(const FilterState& state)
+{
+    Filter::setState(state);
+
+    hpIntegrator->setState(state.hpIntegrator);
+    bpIntegrator->setState(state.bpIntegrator);
+}
+
 } // namespace reSIDfp
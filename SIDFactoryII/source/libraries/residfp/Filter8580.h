@@ -344,6 +344,9 @@ public:
      * @param curvePosition 0 .. 1, where 0 sets center frequency high ("light") and 1 sets it low ("dark"), default is 0.5
      */
     void setFilterCurve(double curvePosition);
+
+    void getState(FilterState& state) const override;
+    void setState(const FilterState& state) override;
 };
 
 } // namespace reSIDfp
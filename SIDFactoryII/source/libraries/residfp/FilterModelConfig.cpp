@@ -24,9 +24,11 @@
 
 #include <cmath>
 #include <cassert>
+#include <mutex>
 
 #include "Integrator.h"
 #include "OpAmp.h"
+#include "TableCache.h"
 
 namespace reSIDfp
 {
@@ -46,6 +48,9 @@ inline double log1p(double x)
 
 const unsigned int OPAMP_SIZE = 33;
 
+/// Raised whenever the way the lookup tables are solved for changes, so that cached tables are not used.
+const unsigned int TABLE_VERSION = 1;
+
 /**
  * This is the SID 6581 op-amp voltage transfer function, measured on
  * CAP1B/CAP1A on a chip marked MOS 6581R4AR 0687 14.
@@ -91,8 +96,13 @@ const Spline::Point opamp_voltage[OPAMP_SIZE] =
 
 std::unique_ptr<FilterModelConfig> FilterModelConfig::instance(nullptr);
 
+/// Guards the creation of the instance, as filters may be created on several threads at once.
+std::mutex Instance6581_Lock;
+
 FilterModelConfig* FilterModelConfig::getInstance()
 {
+    std::lock_guard<std::mutex> lock(Instance6581_Lock);
+
     if (!instance.get())
     {
         instance.reset(new FilterModelConfig());
@@ -124,6 +134,97 @@ FilterModelConfig::FilterModelConfig() :
 {
     dac.kinkedDac(MOS6581);
 
+    for (int i = 0; i < 5; i++)
+    {
+        summer[i] = new unsigned short[(2 + i) << 16];
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        mixer[i] = new unsigned short[(i == 0) ? 1 : i << 16];
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        gain[i] = new unsigned short[1 << 16];
+    }
+
+    // Solving for the tables takes a good part of a second, so they are
+    // only solved for if they are not in the table cache already.
+    const std::vector<TableCache::Table> tables = getTables();
+
+    if (!TableCache::load("filter6581", getFingerprint(), tables))
+    {
+        buildTables();
+        TableCache::save("filter6581", getFingerprint(), tables);
+    }
+}
+
+FilterModelConfig::~FilterModelConfig()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        delete [] summer[i];
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        delete [] mixer[i];
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        delete [] gain[i];
+    }
+}
+
+std::vector<TableCache::Table> FilterModelConfig::getTables()
+{
+    std::vector<TableCache::Table> tables;
+
+    for (int i = 0; i < 5; i++)
+    {
+        tables.push_back({ summer[i], ((2 + i) << 16) * sizeof(unsigned short) });
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        tables.push_back({ mixer[i], ((i == 0) ? 1 : i << 16) * sizeof(unsigned short) });
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        tables.push_back({ gain[i], (1 << 16) * sizeof(unsigned short) });
+    }
+
+    tables.push_back({ vcr_kVg, sizeof(vcr_kVg) });
+    tables.push_back({ vcr_n_Ids_term, sizeof(vcr_n_Ids_term) });
+    tables.push_back({ opamp_rev, sizeof(opamp_rev) });
+
+    return tables;
+}
+
+uint64_t FilterModelConfig::getFingerprint() const
+{
+    TableCache::Fingerprint fingerprint(TABLE_VERSION);
+
+    fingerprint.add(opamp_voltage, sizeof(opamp_voltage));
+    fingerprint.add(C);
+    fingerprint.add(Vdd);
+    fingerprint.add(Vth);
+    fingerprint.add(Ut);
+    fingerprint.add(k);
+    fingerprint.add(uCox);
+    fingerprint.add(WL_vcr);
+    fingerprint.add(vmin);
+    fingerprint.add(vmax);
+    fingerprint.add(N16);
+
+    return fingerprint.value();
+}
+
+void FilterModelConfig::buildTables()
+{
     // Convert op-amp voltage transfer to 16 bit values.
 
     Spline::Point scaled_voltage[OPAMP_SIZE];
@@ -164,7 +265,6 @@ FilterModelConfig::FilterModelConfig() :
         const int size = idiv << 16;
         const double n = idiv;
         opampModel.reset();
-        summer[i] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -186,7 +286,6 @@ FilterModelConfig::FilterModelConfig() :
         const int size = (i == 0) ? 1 : i << 16;
         const double n = i * 8.0 / 6.0;
         opampModel.reset();
-        mixer[i] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -207,7 +306,6 @@ FilterModelConfig::FilterModelConfig() :
         const int size = 1 << 16;
         const double n = n8 / 8.0;
         opampModel.reset();
-        gain[n8] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -265,24 +363,6 @@ FilterModelConfig::FilterModelConfig() :
     }
 }
 
-FilterModelConfig::~FilterModelConfig()
-{
-    for (int i = 0; i < 5; i++)
-    {
-        delete [] summer[i];
-    }
-
-    for (int i = 0; i < 8; i++)
-    {
-        delete [] mixer[i];
-    }
-
-    for (int i = 0; i < 16; i++)
-    {
-        delete [] gain[i];
-    }
-}
-
 unsigned short* FilterModelConfig::getDAC(double adjustment) const
 {
     const double dac_zero = getDacZero(adjustment);
@@ -27,6 +27,7 @@
 
 #include "Dac.h"
 #include "Spline.h"
+#include "TableCache.h"
 
 //#include "sidcxx11.h"
 
@@ -105,6 +106,21 @@ private:
 private:
     double getDacZero(double adjustment) const { return dac_zero + (1. - adjustment); }
 
+    /**
+     * Solve for the op-amp and VCR lookup tables.
+     */
+    void buildTables();
+
+    /**
+     * The lookup tables, as stored in the table cache.
+     */
+    std::vector<TableCache::Table> getTables();
+
+    /**
+     * Fingerprint of the parameters the lookup tables are solved from.
+     */
+    uint64_t getFingerprint() const;
+
     FilterModelConfig();
     ~FilterModelConfig();
 
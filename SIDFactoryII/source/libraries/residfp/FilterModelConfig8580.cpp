@@ -23,9 +23,11 @@
 #include "FilterModelConfig8580.h"
 
 #include <cassert>
+#include <mutex>
 
 #include "Integrator8580.h"
 #include "OpAmp.h"
+#include "TableCache.h"
 
 namespace reSIDfp
 {
@@ -80,6 +82,9 @@ const double resGain[16] =
 
 const unsigned int OPAMP_SIZE = 21;
 
+/// Raised whenever the way the lookup tables are solved for changes, so that cached tables are not used.
+const unsigned int TABLE_VERSION = 1;
+
 /**
  * This is the SID 8580 op-amp voltage transfer function, measured on
  * CAP1B/CAP1A on a chip marked CSG 8580R5 1690 25.
@@ -111,8 +116,13 @@ const Spline::Point opamp_voltage[OPAMP_SIZE] =
 
 std::unique_ptr<FilterModelConfig8580> FilterModelConfig8580::instance(nullptr);
 
+/// Guards the creation of the instance, as filters may be created on several threads at once.
+std::mutex Instance8580_Lock;
+
 FilterModelConfig8580* FilterModelConfig8580::getInstance()
 {
+    std::lock_guard<std::mutex> lock(Instance8580_Lock);
+
     if (!instance.get())
     {
         instance.reset(new FilterModelConfig8580());
@@ -135,6 +145,93 @@ FilterModelConfig8580::FilterModelConfig8580() :
     denorm(vmax - vmin),
     norm(1.0 / denorm),
     N16(norm * ((1 << 16) - 1))
+{
+    for (int i = 0; i < 5; i++)
+    {
+        summer[i] = new unsigned short[(2 + i) << 16];
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        mixer[i] = new unsigned short[(i == 0) ? 1 : i << 16];
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        gain_vol[i] = new unsigned short[1 << 16];
+        gain_res[i] = new unsigned short[1 << 16];
+    }
+
+    // Solving for the tables takes a good part of a second, so they are
+    // only solved for if they are not in the table cache already.
+    const std::vector<TableCache::Table> tables = getTables();
+
+    if (!TableCache::load("filter8580", getFingerprint(), tables))
+    {
+        buildTables();
+        TableCache::save("filter8580", getFingerprint(), tables);
+    }
+}
+
+FilterModelConfig8580::~FilterModelConfig8580()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        delete [] summer[i];
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        delete [] mixer[i];
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        delete [] gain_vol[i];
+        delete [] gain_res[i];
+    }
+}
+
+std::vector<TableCache::Table> FilterModelConfig8580::getTables()
+{
+    std::vector<TableCache::Table> tables;
+
+    for (int i = 0; i < 5; i++)
+    {
+        tables.push_back({ summer[i], ((2 + i) << 16) * sizeof(unsigned short) });
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        tables.push_back({ mixer[i], ((i == 0) ? 1 : i << 16) * sizeof(unsigned short) });
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        tables.push_back({ gain_vol[i], (1 << 16) * sizeof(unsigned short) });
+        tables.push_back({ gain_res[i], (1 << 16) * sizeof(unsigned short) });
+    }
+
+    tables.push_back({ opamp_rev, sizeof(opamp_rev) });
+
+    return tables;
+}
+
+uint64_t FilterModelConfig8580::getFingerprint() const
+{
+    TableCache::Fingerprint fingerprint(TABLE_VERSION);
+
+    fingerprint.add(opamp_voltage, sizeof(opamp_voltage));
+    fingerprint.add(resGain, sizeof(resGain));
+    fingerprint.add(Vddt);
+    fingerprint.add(vmin);
+    fingerprint.add(vmax);
+    fingerprint.add(N16);
+
+    return fingerprint.value();
+}
+
+void FilterModelConfig8580::buildTables()
 {
     // Convert op-amp voltage transfer to 16 bit values.
 
@@ -175,7 +272,6 @@ FilterModelConfig8580::FilterModelConfig8580() :
         const int size = idiv << 16;
         const double n = idiv;
         opampModel.reset();
-        summer[i] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -197,7 +293,6 @@ FilterModelConfig8580::FilterModelConfig8580() :
         const int size = (i == 0) ? 1 : i << 16;
         const double n = i * 8.0 / 6.0;
         opampModel.reset();
-        mixer[i] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -217,7 +312,6 @@ FilterModelConfig8580::FilterModelConfig8580() :
         const int size = 1 << 16;
         const double n = n8 / 8.0;
         opampModel.reset();
-        gain_vol[n8] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -237,7 +331,6 @@ FilterModelConfig8580::FilterModelConfig8580() :
     {
         const int size = 1 << 16;
         opampModel.reset();
-        gain_res[n8] = new unsigned short[size];
 
         for (int vi = 0; vi < size; vi++)
         {
@@ -249,25 +342,6 @@ FilterModelConfig8580::FilterModelConfig8580() :
     }
 }
 
-FilterModelConfig8580::~FilterModelConfig8580()
-{
-    for (int i = 0; i < 5; i++)
-    {
-        delete [] summer[i];
-    }
-
-    for (int i = 0; i < 8; i++)
-    {
-        delete [] mixer[i];
-    }
-
-    for (int i = 0; i < 16; i++)
-    {
-        delete [] gain_vol[i];
-        delete [] gain_res[i];
-    }
-}
-
 std::unique_ptr<Integrator8580> FilterModelConfig8580::buildIntegrator()
 {
     return std::unique_ptr<Integrator8580>(new Integrator8580(opamp_rev, Vth, denorm, C, uCox, vmin, N16));
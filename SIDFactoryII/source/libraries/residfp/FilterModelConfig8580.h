@@ -26,6 +26,7 @@
 #include <memory>
 
 #include "Spline.h"
+#include "TableCache.h"
 
 //#include "sidcxx11.h"
 #define HAVE_CXX11
@@ -83,6 +84,21 @@ private:
     unsigned short opamp_rev[1 << 16];
 
 private:
+    /**
+     * Solve for the op-amp lookup tables.
+     */
+    void buildTables();
+
+    /**
+     * The lookup tables, as stored in the table cache.
+     */
+    std::vector<TableCache::Table> getTables();
+
+    /**
+     * Fingerprint of the parameters the lookup tables are solved from.
+     */
+    uint64_t getFingerprint() const;
+
     FilterModelConfig8580();
     ~FilterModelConfig8580();
 
@@ -27,6 +27,7 @@
 #include <cassert>
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 
 namespace reSIDfp
 {
@@ -179,6 +180,9 @@ public:
     void setVw(unsigned short Vw) { Vddt_Vw_2 = ((kVddt - Vw) * (kVddt - Vw)) >> 1; }
 
     int solve(int vi);
+
+    void getState(IntegratorState& state) const { state.Vddt_Vw_2 = Vddt_Vw_2; state.n_dac = 0; state.vx = vx; state.vc = vc; }
+    void setState(const IntegratorState& state) { Vddt_Vw_2 = state.Vddt_Vw_2; vx = state.vx; vc = state.vc; }
 };
 
 } // namespace reSIDfp
@@ -27,6 +27,7 @@
 #include <cassert>
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 
 namespace reSIDfp
 {
@@ -105,6 +106,9 @@ public:
     }
 
     int solve(int vi) const;
+
+    void getState(IntegratorState& state) const { state.Vddt_Vw_2 = 0; state.n_dac = n_dac; state.vx = vx; state.vc = vc; }
+    void setState(const IntegratorState& state) { n_dac = state.n_dac; vx = state.vx; vc = state.vc; }
 };
 
 } // namespace reSIDfp
@@ -399,4 +399,75 @@ void SID::clockSilent(unsigned int cycles)
     }
 }
 
+void SID::clockNoOutput(unsigned int cycles)
+{
+    ageBusValue(cycles);
+
+    while (cycles != 0)
+    {
+        unsigned int delta_t = std::min(nextVoiceSync, cycles);
+
+        if (delta_t > 0)
+        {
+            for (unsigned int i = 0; i < delta_t; i++)
+            {
+                // clock waveform generators
+                voice[0]->wave()->clock();
+                voice[1]->wave()->clock();
+                voice[2]->wave()->clock();
+
+                // clock envelope generators
+                voice[0]->envelope()->clock();
+                voice[1]->envelope()->clock();
+                voice[2]->envelope()->clock();
+
+                // clock the filters, dropping the output
+                output();
+            }
+
+            cycles -= delta_t;
+            nextVoiceSync -= delta_t;
+        }
+
+        if (nextVoiceSync == 0)
+        {
+            voiceSync(true);
+        }
+    }
+}
+
+void SID::getState(SIDState& state) const
+{
+    for (int i = 0; i < 3; i++)
+    {
+        voice[i]->wave()->getState(state.waveformGenerator[i]);
+        voice[i]->envelope()->getState(state.envelopeGenerator[i]);
+    }
+
+    filter6581->getState(state.filter6581);
+    filter8580->getState(state.filter8580);
+    externalFilter->getState(state.externalFilter);
+
+    state.busValueTtl = busValueTtl;
+    state.nextVoiceSync = nextVoiceSync;
+    state.busValue = busValue;
+}
+
+void SID::setState(const SIDState& state)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        voice[i]->wave()->setState(state.waveformGenerator[i]);
+        voice[i]->envelope()->setState(state.envelopeGenerator[i]);
+    }
+
+    filter6581->setState(state.filter6581);
+    filter8580->setState(state.filter8580);
+    externalFilter->setState(state.externalFilter);
+
+    busValueTtl = state.busValueTtl;
+    nextVoiceSync = state.nextVoiceSync;
+    busValue = state.busValue;
+}
+
 } // namespace reSIDfp
@@ -26,6 +26,7 @@
 #include <memory>
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 
 //#include "sidcxx11.h"
 
@@ -246,6 +247,31 @@ public:
      */
     void clockSilent(unsigned int cycles);
 
+    /**
+     * Clock SID forward without producing audio, but otherwise exactly
+     * as clock() does. Unlike clockSilent(), all of the envelopes and
+     * the filters are emulated, so the audio-producing clock() can
+     * continue from the state this leaves.
+     *
+     * @param cycles c64 clocks to clock.
+     */
+    void clockNoOutput(unsigned int cycles);
+
+    /**
+     * Get the emulation state of the chip.
+     *
+     * @param state receives the state
+     */
+    void getState(SIDState& state) const;
+
+    /**
+     * Restore a state, taken from a SID set up with the same chip model.
+     * The resampler keeps its state.
+     *
+     * @param state the state to restore
+     */
+    void setState(const SIDState& state);
+
     /**
      * Set filter curve parameter for 6581 model.
      *
@@ -0,0 +1,131 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SIDSTATE_H
+#define SIDSTATE_H
+
+namespace reSIDfp
+{
+
+/**
+ * The emulation state of the SID components, which changes while the chip is clocked
+ * or written to. Everything that follows from the chip model and the sampling
+ * parameters is left out, so a state can only be restored to a SID that has been
+ * set up with the same chip model. The state of the resampler is not included.
+ *
+ * The table pointers refer to the tables shared by all SID instances of a chip model.
+ */
+struct WaveformGeneratorState
+{
+    short* wave;
+    unsigned int pw;
+    unsigned int shift_register;
+    int shift_pipeline;
+    unsigned int ring_msb_mask;
+    unsigned int no_noise;
+    unsigned int noise_output;
+    unsigned int no_noise_or_noise_output;
+    unsigned int no_pulse;
+    unsigned int pulse_output;
+    unsigned int waveform;
+    int floating_output_ttl;
+    unsigned int waveform_output;
+    unsigned int accumulator;
+    unsigned int freq;
+    unsigned int tri_saw_pipeline;
+    unsigned int osc3;
+    int shift_register_reset;
+    bool test;
+    bool sync;
+    bool msb_rising;
+};
+
+struct EnvelopeGeneratorState
+{
+    unsigned int lfsr;
+    unsigned int rate;
+    unsigned int exponential_counter;
+    unsigned int exponential_counter_period;
+    unsigned int new_exponential_counter_period;
+    unsigned int state_pipeline;
+    unsigned int envelope_pipeline;
+    unsigned int exponential_pipeline;
+    int state;
+    int next_state;
+    bool counter_enabled;
+    bool gate;
+    bool resetLfsr;
+    unsigned char envelope_counter;
+    unsigned char attack;
+    unsigned char decay;
+    unsigned char sustain;
+    unsigned char release;
+    unsigned char env3;
+};
+
+struct IntegratorState
+{
+    unsigned int Vddt_Vw_2;
+    unsigned short n_dac;
+    int vx;
+    int vc;
+};
+
+struct FilterState
+{
+    unsigned short* currentGain;
+    unsigned short* currentMixer;
+    unsigned short* currentSummer;
+    unsigned short* currentResonance;
+    int Vhp;
+    int Vbp;
+    int Vlp;
+    int ve;
+    unsigned int fc;
+    bool filt1, filt2, filt3, filtE;
+    bool voice3off;
+    bool hp, bp, lp;
+    unsigned char vol;
+    unsigned char filt;
+
+    IntegratorState hpIntegrator;
+    IntegratorState bpIntegrator;
+};
+
+struct ExternalFilterState
+{
+    int Vlp;
+    int Vhp;
+};
+
+struct SIDState
+{
+    WaveformGeneratorState waveformGenerator[3];
+    EnvelopeGeneratorState envelopeGenerator[3];
+    FilterState filter6581;
+    FilterState filter8580;
+    ExternalFilterState externalFilter;
+
+    int busValueTtl;
+    unsigned int nextVoiceSync;
+    unsigned char busValue;
+};
+
+} // namespace reSIDfp
+
+#endif
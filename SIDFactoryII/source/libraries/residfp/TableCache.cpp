@@ -0,0 +1,210 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "TableCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace reSIDfp
+{
+
+namespace
+{
+
+const char MAGIC[8] = { 'R', 'S', 'F', 'P', 'T', 'A', 'B', 'L' };
+
+/// Raised whenever the layout of the files changes.
+const uint32_t FORMAT_VERSION = 1;
+
+const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+struct Header
+{
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t tableCount;
+    uint64_t fingerprint;
+    uint64_t size;
+};
+
+std::string DIRECTORY;
+
+/// Guards DIRECTORY, as SIDs may be created on several threads at once.
+std::mutex DIRECTORY_Lock;
+
+std::string getPath(const char* name)
+{
+    std::lock_guard<std::mutex> lock(DIRECTORY_Lock);
+
+    if (DIRECTORY.empty())
+        return std::string();
+
+    return DIRECTORY + "residfp_" + name + ".bin";
+}
+
+/**
+ * Checksum of the table contents. The tables are hashed a word at a time,
+ * as a byte at a time would take about as long as reading the file.
+ */
+uint64_t checksum(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+        hash ^= hash >> 29;
+    }
+
+    for (; size > 0; size--, bytes++)
+    {
+        hash = (hash ^ *bytes) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint64_t getTotalSize(const std::vector<TableCache::Table>& tables)
+{
+    uint64_t size = 0;
+
+    for (const TableCache::Table& table : tables)
+    {
+        size += table.size;
+    }
+
+    return size;
+}
+
+} // namespace
+
+TableCache::Fingerprint::Fingerprint(unsigned int version) :
+    hash(FNV_OFFSET)
+{
+    add(version);
+}
+
+void TableCache::Fingerprint::add(const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+void TableCache::setDirectory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(DIRECTORY_Lock);
+
+    DIRECTORY = directory;
+}
+
+bool TableCache::load(const char* name, uint64_t fingerprint, const std::vector<Table>& tables)
+{
+    const std::string path = getPath(name);
+
+    if (path.empty())
+        return false;
+
+    FILE* file = std::fopen(path.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    Header header;
+    bool isValid = std::fread(&header, sizeof(header), 1, file) == 1
+        && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.formatVersion == FORMAT_VERSION
+        && header.tableCount == tables.size()
+        && header.fingerprint == fingerprint
+        && header.size == getTotalSize(tables);
+
+    uint64_t hash = FNV_OFFSET;
+
+    for (size_t i = 0; isValid && i < tables.size(); i++)
+    {
+        isValid = std::fread(tables[i].data, 1, tables[i].size, file) == tables[i].size;
+        hash = checksum(hash, tables[i].data, tables[i].size);
+    }
+
+    uint64_t storedHash;
+    isValid = isValid
+        && std::fread(&storedHash, sizeof(storedHash), 1, file) == 1
+        && storedHash == hash
+        && std::fgetc(file) == EOF;
+
+    std::fclose(file);
+
+    return isValid;
+}
+
+bool TableCache::save(const char* name, uint64_t fingerprint, const std::vector<Table>& tables)
+{
+    const std::string path = getPath(name);
+
+    if (path.empty())
+        return false;
+
+    const std::string temporaryPath = path + ".tmp";
+
+    FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+
+    if (file == nullptr)
+        return false;
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.formatVersion = FORMAT_VERSION;
+    header.tableCount = static_cast<uint32_t>(tables.size());
+    header.fingerprint = fingerprint;
+    header.size = getTotalSize(tables);
+
+    bool isWritten = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    uint64_t hash = FNV_OFFSET;
+
+    for (size_t i = 0; isWritten && i < tables.size(); i++)
+    {
+        isWritten = std::fwrite(tables[i].data, 1, tables[i].size, file) == tables[i].size;
+        hash = checksum(hash, tables[i].data, tables[i].size);
+    }
+
+    isWritten = isWritten && std::fwrite(&hash, sizeof(hash), 1, file) == 1;
+    isWritten = (std::fclose(file) == 0) && isWritten;
+
+    // Renaming onto an existing file fails on some platforms, so the old file is removed first
+    if (isWritten)
+    {
+        std::remove(path.c_str());
+        isWritten = std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+    if (!isWritten)
+        std::remove(temporaryPath.c_str());
+
+    return isWritten;
+}
+
+} // namespace reSIDfp
@@ -0,0 +1,106 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef TABLECACHE_H
+#define TABLECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace reSIDfp
+{
+
+/**
+ * Keeps lookup tables in files, so that the tables the filter models and
+ * the waveform calculator solve for need only be calculated once, rather
+ * than every time the first SID is created.
+ *
+ * Each file holds the tables of one model, stored with a fingerprint of
+ * the parameters they were calculated from and a checksum of their contents.
+ * A file that does not match the fingerprint, or is damaged, is not used;
+ * the tables are then calculated and the file is written anew.
+ *
+ * Caching is off until a directory is set.
+ */
+class TableCache
+{
+public:
+    /**
+     * A table to load or save, as a block of memory.
+     */
+    struct Table
+    {
+        void* data;
+        size_t size;
+    };
+
+    /**
+     * Hashes the parameters a set of tables is calculated from.
+     * The version should be raised whenever the calculation changes.
+     */
+    class Fingerprint
+    {
+    private:
+        uint64_t hash;
+
+    public:
+        explicit Fingerprint(unsigned int version);
+
+        void add(const void* data, size_t size);
+        void add(double value) { add(&value, sizeof(value)); }
+        void add(float value) { add(&value, sizeof(value)); }
+        void add(unsigned int value) { add(&value, sizeof(value)); }
+
+        uint64_t value() const { return hash; }
+    };
+
+public:
+    /**
+     * Set the directory to keep the table files in, including the trailing
+     * path separator. An empty directory turns caching off.
+     */
+    static void setDirectory(const std::string& directory);
+
+    /**
+     * Fill the tables from the file with the given name.
+     *
+     * @param name the name of the file, without directory or extension
+     * @param fingerprint the fingerprint of the parameters of the tables
+     * @param tables the tables to fill, in the order they were saved
+     * @return true if all tables were filled, false if they must be calculated
+     */
+    static bool load(const char* name, uint64_t fingerprint, const std::vector<Table>& tables);
+
+    /**
+     * Save the tables to the file with the given name. The file is written
+     * under a temporary name and then renamed, so that a file that is loaded
+     * is never one that is half written.
+     *
+     * @param name the name of the file, without directory or extension
+     * @param fingerprint the fingerprint of the parameters of the tables
+     * @param tables the tables to save
+     * @return true if the file was written
+     */
+    static bool save(const char* name, uint64_t fingerprint, const std::vector<Table>& tables);
+};
+
+} // namespace reSIDfp
+
+#endif
@@ -23,9 +23,14 @@
 
 #include <cmath>
 
+#include "TableCache.h"
+
 namespace reSIDfp
 {
 
+/// Raised whenever the way the waveform tables are calculated changes, so that cached tables are not used.
+const unsigned int TABLE_VERSION = 1;
+
 WaveformCalculator* WaveformCalculator::getInstance()
 {
     static WaveformCalculator instance;
@@ -174,6 +179,8 @@ matrix_t* WaveformCalculator::buildTable(ChipModel model)
 {
     const CombinedWaveformConfig* cfgArray = config[model == MOS6581 ? 0 : 1];
 
+    std::lock_guard<std::mutex> lock(CACHE_Lock);
+
     cw_cache_t::iterator lb = CACHE.lower_bound(cfgArray);
 
     if (lb != CACHE.end() && !(CACHE.key_comp()(cfgArray, lb->first)))
@@ -183,6 +190,17 @@ matrix_t* WaveformCalculator::buildTable(ChipModel model)
 
     matrix_t wftable(8, 4096);
 
+    const char* cacheName = model == MOS6581 ? "waveform6581" : "waveform8580";
+    const std::vector<TableCache::Table> tables = { { wftable[0], wftable.length() * sizeof(short) } };
+
+    TableCache::Fingerprint fingerprint(TABLE_VERSION);
+    fingerprint.add(cfgArray, sizeof(config[0]));
+
+    if (TableCache::load(cacheName, fingerprint.value(), tables))
+    {
+        return &(CACHE.insert(lb, cw_cache_t::value_type(cfgArray, wftable))->second);
+    }
+
     for (unsigned int idx = 0; idx < 1 << 12; idx++)
     {
         wftable[0][idx] = 0xfff;
@@ -195,6 +213,8 @@ matrix_t* WaveformCalculator::buildTable(ChipModel model)
         wftable[7][idx] = calculateCombinedWaveform(cfgArray[3], 7, idx);
     }
 
+    TableCache::save(cacheName, fingerprint.value(), tables);
+
     return &(CACHE.insert(lb, cw_cache_t::value_type(cfgArray, wftable))->second);
 }
 
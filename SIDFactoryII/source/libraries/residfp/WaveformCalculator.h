@@ -23,6 +23,7 @@
 #define WAVEFORMCALCULATOR_h
 
 #include <map>
+#include <mutex>
 
 #include "siddefs-fp.h"
 #include "array.h"
@@ -97,6 +98,9 @@ private:
 private:
     cw_cache_t CACHE;
 
+    /// Guards CACHE, as SIDs may be created on several threads at once.
+    std::mutex CACHE_Lock;
+
     WaveformCalculator() {}
 
 public:
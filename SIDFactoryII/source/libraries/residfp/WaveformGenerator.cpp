@@ -296,4 +296,54 @@ void WaveformGenerator::reset()
     floating_output_ttl = 0;
 }
 
+void WaveformGenerator::getState(WaveformGeneratorState& state) const
+{
+    state.wave = wave;
+    state.pw = pw;
+    state.shift_register = shift_register;
+    state.shift_pipeline = shift_pipeline;
+    state.ring_msb_mask = ring_msb_mask;
+    state.no_noise = no_noise;
+    state.noise_output = noise_output;
+    state.no_noise_or_noise_output = no_noise_or_noise_output;
+    state.no_pulse = no_pulse;
+    state.pulse_output = pulse_output;
+    state.waveform = waveform;
+    state.floating_output_ttl = floating_output_ttl;
+    state.waveform_output = waveform_output;
+    state.accumulator = accumulator;
+    state.freq = freq;
+    state.tri_saw_pipeline = tri_saw_pipeline;
+    state.osc3 = osc3;
+    state.shift_register_reset = shift_register_reset;
+    state.test = test;
+    state.sync = sync;
+    state.msb_rising = msb_rising;
+}
+
+void WaveformGenerator::setState(const WaveformGeneratorState& state)
+{
+    wave = state.wave;
+    pw = state.pw;
+    shift_register = state.shift_register;
+    shift_pipeline = state.shift_pipeline;
+    ring_msb_mask = state.ring_msb_mask;
+    no_noise = state.no_noise;
+    noise_output = state.noise_output;
+    no_noise_or_noise_output = state.no_noise_or_noise_output;
+    no_pulse = state.no_pulse;
+    pulse_output = state.pulse_output;
+    waveform = state.waveform;
+    floating_output_ttl = state.floating_output_ttl;
+    waveform_output = state.waveform_output;
+    accumulator = state.accumulator;
+    freq = state.freq;
+    tri_saw_pipeline = state.tri_saw_pipeline;
+    osc3 = state.osc3;
+    shift_register_reset = state.shift_register_reset;
+    test = state.test;
+    sync = state.sync;
+    msb_rising = state.msb_rising;
+}
+
 } // namespace reSIDfp
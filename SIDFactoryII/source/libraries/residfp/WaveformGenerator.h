@@ -24,6 +24,7 @@
 #define WAVEFORMGENERATOR_H
 
 #include "siddefs-fp.h"
+#include "SIDState.h"
 #include "array.h"
 
 //#include "sidcxx11.h"
@@ -279,6 +280,12 @@ public:
      * Read sync value.
      */
     bool readSync() const { return sync; }
+
+    /**
+     * Get and set the emulation state.
+     */
+    void getState(WaveformGeneratorState& state) const;
+    void setState(const WaveformGeneratorState& state);
 };
 
 } // namespace reSIDfp
@@ -21,6 +21,8 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include <cstdint>
+
 /**
  * Counter.
  */
@@ -37,29 +39,43 @@ public:
 
 /**
  * Reference counted pointer to matrix wrapper, for use with standard containers.
+ * The data starts at an address aligned for SIMD loads of up to 256 bits.
  */
 template<typename T>
 class matrix
 {
+public:
+    static const unsigned int ALIGNMENT = 32;
+
 private:
+    static_assert(ALIGNMENT % sizeof(T) == 0, "The alignment must be a whole number of elements");
+
+    T* storage;
     T* data;
     counter* count;
     const unsigned int x, y;
 
+    static T* align(T* p)
+    {
+        return reinterpret_cast<T*>((reinterpret_cast<std::uintptr_t>(p) + ALIGNMENT - 1) & ~static_cast<std::uintptr_t>(ALIGNMENT - 1));
+    }
+
 public:
     matrix(unsigned int x, unsigned int y) :
-        data(new T[x * y]),
+        storage(new T[x * y + ALIGNMENT / sizeof(T)]),
+        data(align(storage)),
         count(new counter()),
         x(x),
         y(y) {}
 
     matrix(const matrix& p) :
+        storage(p.storage),
         data(p.data),
         count(p.count),
         x(p.x),
         y(p.y) { count->increase(); }
 
-    ~matrix() { if (count->decrease() == 0) { delete count; delete [] data; } }
+    ~matrix() { if (count->decrease() == 0) { delete count; delete [] storage; } }
 
     unsigned int length() const { return x * y; }
 
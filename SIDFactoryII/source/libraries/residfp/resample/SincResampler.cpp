@@ -28,6 +28,7 @@
 #include <iostream>
 #include <sstream>
 #include <limits>
+#include <mutex>
 
 #include "../siddefs-fp.h"
 
@@ -35,8 +36,26 @@
 #  include "config.h"
 #endif
 
-#ifdef HAVE_MMINTRIN_H
-#  include <mmintrin.h>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define HAVE_X86_KERNELS
+#  include <emmintrin.h>
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#  define HAVE_NEON_KERNEL
+#  include <arm_neon.h>
+#endif
+
+// The x86 kernels are compiled for their instruction sets one function at a time, so the rest of the code
+// keeps running on any CPU. Which of them may run is decided when the resampler is created.
+#if defined(HAVE_X86_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+#  define TARGET_SSE2 __attribute__((target("sse2")))
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define TARGET_SSE2
+#  define TARGET_AVX2
 #endif
 
 namespace reSIDfp
@@ -47,6 +66,10 @@ typedef std::map<std::string, matrix_t> fir_cache_t;
 /// Cache for the expensive FIR table computation results.
 fir_cache_t FIR_CACHE;
 
+/// Guards FIR_CACHE, as resamplers may be created on several threads at once.
+/// Tables are never removed from the cache, so they can be read without holding the lock.
+std::mutex FIR_CACHE_Lock;
+
 /// Maximum error acceptable in I0 is 1e-6, or ~96 dB.
 const double I0E = 1e-6;
 
@@ -81,41 +104,179 @@ double I0(double x)
 
 /**
  * Calculate convolution with sample and sinc.
+ * The kernels differ only in how many products they sum up at a time. As the sums are
+ * integer sums, the order they are summed up in does not matter, and the results are exact.
  *
  * @param a sample buffer input
  * @param b sinc buffer
- * @param bLength length of the sinc buffer
- * @return convolved result
+ * @param bLength length of the sinc buffer, a multiple of FIR_PADDING for the SIMD kernels
+ * @return convolved result, before scaling
  */
-int convolve(const short* a, const short* b, int bLength)
+int convolveScalar(const short* a, const short* b, int bLength)
+{
+    int out = 0;
+
+    for (int i = 0; i < bLength; i++)
+    {
+        out += *a++ * *b++;
+    }
+
+    return out;
+}
+
+#ifdef HAVE_X86_KERNELS
+TARGET_SSE2 int convolveSSE2(const short* a, const short* b, int bLength)
 {
-#ifdef HAVE_MMINTRIN_H
-    __m64 acc = _mm_setzero_si64();
+    __m128i acc = _mm_setzero_si128();
+
+    for (int i = 0; i < bLength; i += 8)
+    {
+        const __m128i tmp = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_load_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm_add_epi32(acc, tmp);
+    }
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return _mm_cvtsi128_si32(acc);
+}
 
-    const int n = bLength / 4;
+TARGET_AVX2 int convolveAVX2(const short* a, const short* b, int bLength)
+{
+    __m256i acc = _mm256_setzero_si256();
 
-    for (int i = 0; i < n; i++)
+    for (int i = 0; i < bLength; i += 16)
     {
-        const __m64 tmp = _mm_madd_pi16(*(__m64*)a, *(__m64*)b);
-        acc = _mm_add_pi16(acc, tmp);
-        a += 4;
-        b += 4;
+        const __m256i tmp = _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), _mm256_load_si256(reinterpret_cast<const __m256i*>(b + i)));
+        acc = _mm256_add_epi32(acc, tmp);
     }
 
-    int out = _mm_cvtsi64_si32(acc) + _mm_cvtsi64_si32(_mm_srli_si64(acc, 32));
-    _mm_empty();
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return _mm_cvtsi128_si32(sum);
+}
 
-    bLength &= 3;
+/**
+ * Check the CPU, and the operating system for saving the AVX registers, for the instruction sets of the kernels.
+ */
+bool hasSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
 #else
-    int out = 0;
+    return __builtin_cpu_supports("sse2") != 0;
 #endif
+}
 
-    for (int i = 0; i < bLength; i++)
+bool hasAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+
+    const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+    const bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+    if (!hasOSXSAVE || !hasAVX || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+#ifdef HAVE_NEON_KERNEL
+int convolveNEON(const short* a, const short* b, int bLength)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+
+    for (int i = 0; i < bLength; i += 8)
     {
-        out += *a++ * *b++;
+        const int16x8_t va = vld1q_s16(a + i);
+        const int16x8_t vb = vld1q_s16(b + i);
+
+        acc = vmlal_s16(acc, vget_low_s16(va), vget_low_s16(vb));
+        acc = vmlal_s16(acc, vget_high_s16(va), vget_high_s16(vb));
+    }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vaddvq_s32(acc);
+#else
+    const int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#endif
+}
+#endif
+
+SincResampler::ConvolutionKernel SincResampler::getBestKernel()
+{
+    static const ConvolutionKernel bestKernel = []()
+    {
+        const ConvolutionKernel kernels[] = { ConvolutionKernel::AVX2, ConvolutionKernel::SSE2, ConvolutionKernel::NEON };
+
+        for (ConvolutionKernel kernel : kernels)
+        {
+            if (isKernelSupported(kernel))
+                return kernel;
+        }
+
+        return ConvolutionKernel::SCALAR;
+    }();
+
+    return bestKernel;
+}
+
+bool SincResampler::isKernelSupported(ConvolutionKernel kernel)
+{
+    switch (kernel)
+    {
+    case ConvolutionKernel::SCALAR:
+        return true;
+#ifdef HAVE_X86_KERNELS
+    case ConvolutionKernel::SSE2:
+        return hasSSE2();
+    case ConvolutionKernel::AVX2:
+        return hasAVX2();
+#endif
+#ifdef HAVE_NEON_KERNEL
+    case ConvolutionKernel::NEON:
+        return true;
+#endif
+    default:
+        return false;
     }
+}
 
-    return (out + (1 << 14)) >> 15;
+const char* SincResampler::getKernelName(ConvolutionKernel kernel)
+{
+    switch (kernel)
+    {
+    case ConvolutionKernel::SCALAR:
+        return "Scalar";
+    case ConvolutionKernel::SSE2:
+        return "SSE2";
+    case ConvolutionKernel::AVX2:
+        return "AVX2";
+    case ConvolutionKernel::NEON:
+        return "NEON";
+    default:
+        return "Unknown";
+    }
 }
 
 int SincResampler::fir(int subcycle)
@@ -127,7 +288,7 @@ int SincResampler::fir(int subcycle)
     // Find firN most recent samples, plus one extra in case the FIR wraps.
     int sampleStart = sampleIndex - firN + RINGSIZE - 1;
 
-    const int v1 = convolve(sample + sampleStart, (*firTable)[firTableFirst], firN);
+    const int v1 = (convolve(sample + sampleStart, (*firTable)[firTableFirst], convolveLength) + (1 << 14)) >> 15;
 
     // Use next FIR table, wrap around to first FIR table using
     // previous sample.
@@ -137,14 +298,14 @@ int SincResampler::fir(int subcycle)
         ++sampleStart;
     }
 
-    const int v2 = convolve(sample + sampleStart, (*firTable)[firTableFirst], firN);
+    const int v2 = (convolve(sample + sampleStart, (*firTable)[firTableFirst], convolveLength) + (1 << 14)) >> 15;
 
     // Linear interpolation between the sinc tables yields good
     // approximation for the exact value.
     return v1 + (firTableOffset * (v2 - v1) >> 10);
 }
 
-SincResampler::SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency) :
+SincResampler::SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, ConvolutionKernel kernel) :
     sampleIndex(0),
     cyclesPerSample(static_cast<int>(clockFrequency / samplingFrequency * 1024.)),
     sampleOffset(0),
@@ -180,6 +341,8 @@ SincResampler::SincResampler(double clockFrequency, double samplingFrequency, do
         // Check whether the sample ring buffer would overflow.
         assert(firN < RINGSIZE);
 
+        firNPadded = (firN + FIR_PADDING - 1) & ~(FIR_PADDING - 1);
+
         // Error is bounded by err < 1.234 / L^2, so L = sqrt(1.234 / (2^-16)) = sqrt(1.234 * 2^16).
         firRES = static_cast<int>(ceil(sqrt(1.234 * (1 << BITS)) / cyclesPerSampleD));
 
@@ -192,6 +355,9 @@ SincResampler::SincResampler(double clockFrequency, double samplingFrequency, do
     std::ostringstream o;
     o << firN << "," << firRES << "," << cyclesPerSampleD;
     const std::string firKey = o.str();
+
+    std::lock_guard<std::mutex> lock(FIR_CACHE_Lock);
+
     fir_cache_t::iterator lb = FIR_CACHE.lower_bound(firKey);
 
     // The FIR computation is expensive and we set sampling parameters often, but
@@ -202,8 +368,8 @@ SincResampler::SincResampler(double clockFrequency, double samplingFrequency, do
     }
     else
     {
-        // Allocate memory for FIR tables.
-        matrix_t tempTable(firRES, firN);
+        // Allocate memory for FIR tables. Each table starts aligned, and is padded with zeroes.
+        matrix_t tempTable(firRES, firNPadded);
         firTable = &(FIR_CACHE.insert(lb, fir_cache_t::value_type(firKey, tempTable))->second);
 
         // The cutoff frequency is midway through the transition band, in effect the same as nyquist.
@@ -228,8 +394,40 @@ SincResampler::SincResampler(double clockFrequency, double samplingFrequency, do
 
                 (*firTable)[i][j] = static_cast<short>(scale * sincWt * kaiserXt);
             }
+
+            for (int j = firN; j < firNPadded; j++)
+            {
+                (*firTable)[i][j] = 0;
+            }
         }
     }
+
+    // Pick the convolution kernel. The scalar kernel skips the padding.
+    assert(isKernelSupported(kernel));
+
+    switch (kernel)
+    {
+#ifdef HAVE_X86_KERNELS
+    case ConvolutionKernel::SSE2:
+        convolve = &convolveSSE2;
+        convolveLength = firNPadded;
+        break;
+    case ConvolutionKernel::AVX2:
+        convolve = &convolveAVX2;
+        convolveLength = firNPadded;
+        break;
+#endif
+#ifdef HAVE_NEON_KERNEL
+    case ConvolutionKernel::NEON:
+        convolve = &convolveNEON;
+        convolveLength = firNPadded;
+        break;
+#endif
+    default:
+        convolve = &convolveScalar;
+        convolveLength = firN;
+        break;
+    }
 }
 
 template<typename I, typename O>
@@ -53,14 +53,36 @@ namespace reSIDfp
  */
 class SincResampler final : public Resampler
 {
+public:
+    /**
+     * The implementations of the FIR convolution. They all give the exact same results.
+     * The SIMD kernels are only available on the CPUs supporting them.
+     */
+    enum class ConvolutionKernel
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
 private:
     /// Size of the ring buffer, must be a power of 2
     static const int RINGSIZE = 2048;
 
+    /// The FIR tables are padded with zeroes to a multiple of this many coefficients, so the SIMD kernels need no loop for the remainder
+    static const int FIR_PADDING = 16;
+
+    typedef int (*convolve_t)(const short* a, const short* b, int bLength);
+
 private:
-    /// Table of the fir filter coefficients
+    /// Table of the fir filter coefficients, with a row of firNPadded coefficients for each phase
     matrix_t* firTable;
 
+    /// The convolution kernel, and the number of coefficients it convolves
+    convolve_t convolve;
+    int convolveLength;
+
     int sampleIndex;
 
     /// Filter resolution
@@ -69,13 +91,17 @@ private:
     /// Filter length
     int firN;
 
+    /// Filter length, padded to a multiple of FIR_PADDING
+    int firNPadded;
+
     const int cyclesPerSample;
 
     int sampleOffset;
 
     int outputValue;
 
-    short sample[RINGSIZE * 2];
+    /// The padding at the end is read by the SIMD kernels, but always multiplied by the zeroes padding the FIR tables
+    short sample[RINGSIZE * 2 + FIR_PADDING];
 
 private:
     int fir(int subcycle);
@@ -100,8 +126,16 @@ public:
      * @param clockFrequency System clock frequency at Hz
      * @param samplingFrequency Desired output sampling rate
      * @param highestAccurateFrequency
+     * @param kernel the convolution kernel to use, which must be supported by the CPU
      */
-    SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency);
+    SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, ConvolutionKernel kernel = getBestKernel());
+
+    /// The fastest convolution kernel supported by the CPU
+    static ConvolutionKernel getBestKernel();
+
+    static bool isKernelSupported(ConvolutionKernel kernel);
+
+    static const char* getKernelName(ConvolutionKernel kernel);
 
     bool input(int input) override;
 
@@ -44,21 +44,21 @@ private:
     std::unique_ptr<SincResampler> const s2;
 
 private:
-    TwoPassSincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, double intermediateFrequency) :
-        s1(new SincResampler(clockFrequency, intermediateFrequency, highestAccurateFrequency)),
-        s2(new SincResampler(intermediateFrequency, samplingFrequency, highestAccurateFrequency))
+    TwoPassSincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, double intermediateFrequency, SincResampler::ConvolutionKernel kernel) :
+        s1(new SincResampler(clockFrequency, intermediateFrequency, highestAccurateFrequency, kernel)),
+        s2(new SincResampler(intermediateFrequency, samplingFrequency, highestAccurateFrequency, kernel))
     {}
 
 public:
     // Named constructor
-    static TwoPassSincResampler* create(double clockFrequency, double samplingFrequency, double highestAccurateFrequency)
+    static TwoPassSincResampler* create(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, SincResampler::ConvolutionKernel kernel = SincResampler::getBestKernel())
     {
         // Calculation according to Laurent Ganier. It evaluates to about 120 kHz at typical settings.
         // Some testing around the chosen value seems to confirm that this does work.
         double const intermediateFrequency = 2. * highestAccurateFrequency
             + sqrt(2. * highestAccurateFrequency * clockFrequency
                 * (samplingFrequency - 2. * highestAccurateFrequency) / samplingFrequency);
-        return new TwoPassSincResampler(clockFrequency, samplingFrequency, highestAccurateFrequency, intermediateFrequency);
+        return new TwoPassSincResampler(clockFrequency, samplingFrequency, highestAccurateFrequency, intermediateFrequency, kernel);
     }
 
     bool input(int sample) override
@@ -0,0 +1,330 @@
+#include "runtime/editor/autosave_journal.h"
+#include "utils/utilities.h"
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+namespace Editor
+{
+	namespace
+	{
+		// Journal layout, all values little endian:
+		// Header: "SF2J", version byte, song path length word, song path
+		// Record: 'R', file image size long, range count long, ranges of (offset long, length long, data), 'E'
+		const unsigned char JournalVersion = 1;
+		const unsigned char RecordBeginMark = 'R';
+		const unsigned char RecordEndMark = 'E';
+
+		// Unchanged runs shorter than the header of a range are included in the range around them, instead of starting a new range
+		const unsigned int MinUnchangedRunBetweenRanges = 8;
+
+		// The journal is started over, when it grows larger than this many times the size of a full file image
+		const long MaxJournalSizeFactor = 4;
+		const int MaxJournalFileSize = 0x800000;
+
+		void AppendByte(std::vector<unsigned char>& outData, unsigned char inValue)
+		{
+			outData.push_back(inValue);
+		}
+
+		void AppendWord(std::vector<unsigned char>& outData, unsigned short inValue)
+		{
+			outData.push_back(static_cast<unsigned char>(inValue & 0xff));
+			outData.push_back(static_cast<unsigned char>(inValue >> 8));
+		}
+
+		void AppendLong(std::vector<unsigned char>& outData, unsigned int inValue)
+		{
+			AppendWord(outData, static_cast<unsigned short>(inValue & 0xffff));
+			AppendWord(outData, static_cast<unsigned short>(inValue >> 16));
+		}
+
+		void AppendRange(std::vector<unsigned char>& outData, const std::vector<unsigned char>& inFileImage, size_t inBegin, size_t inEnd)
+		{
+			AppendLong(outData, static_cast<unsigned int>(inBegin));
+			AppendLong(outData, static_cast<unsigned int>(inEnd - inBegin));
+			outData.insert(outData.end(), inFileImage.begin() + inBegin, inFileImage.begin() + inEnd);
+		}
+
+		// Creates a record of the ranges in which the new file image differs from the old. Returns false, if nothing changed.
+		bool CreateRecord(const std::vector<unsigned char>& inOldFileImage, const std::vector<unsigned char>& inNewFileImage, std::vector<unsigned char>& outRecord)
+		{
+			std::vector<unsigned char> ranges;
+			unsigned int range_count = 0;
+
+			const size_t compare_size = std::min(inOldFileImage.size(), inNewFileImage.size());
+
+			for (size_t i = 0; i < compare_size; ++i)
+			{
+				if (inOldFileImage[i] == inNewFileImage[i])
+					continue;
+
+				size_t last_changed = i;
+
+				for (size_t j = i + 1; j < compare_size && j - last_changed <= MinUnchangedRunBetweenRanges; ++j)
+				{
+					if (inOldFileImage[j] != inNewFileImage[j])
+						last_changed = j;
+				}
+
+				AppendRange(ranges, inNewFileImage, i, last_changed + 1);
+				++range_count;
+
+				i = last_changed;
+			}
+
+			if (inNewFileImage.size() > compare_size)
+			{
+				AppendRange(ranges, inNewFileImage, compare_size, inNewFileImage.size());
+				++range_count;
+			}
+
+			if (range_count == 0 && inNewFileImage.size() == inOldFileImage.size())
+				return false;
+
+			outRecord.clear();
+			AppendByte(outRecord, RecordBeginMark);
+			AppendLong(outRecord, static_cast<unsigned int>(inNewFileImage.size()));
+			AppendLong(outRecord, range_count);
+			outRecord.insert(outRecord.end(), ranges.begin(), ranges.end());
+			AppendByte(outRecord, RecordEndMark);
+
+			return true;
+		}
+
+
+		class JournalReader
+		{
+		public:
+			JournalReader(const unsigned char* inData, size_t inDataSize)
+				: m_Data(inData)
+				, m_DataSize(inDataSize)
+				, m_Position(0)
+			{
+			}
+
+			bool ReadByte(unsigned char& outValue)
+			{
+				if (m_Position + 1 > m_DataSize)
+					return false;
+
+				outValue = m_Data[m_Position++];
+				return true;
+			}
+
+			bool ReadWord(unsigned short& outValue)
+			{
+				unsigned char low, high;
+
+				if (!ReadByte(low) || !ReadByte(high))
+					return false;
+
+				outValue = static_cast<unsigned short>(low | (high << 8));
+				return true;
+			}
+
+			bool ReadLong(unsigned int& outValue)
+			{
+				unsigned short low, high;
+
+				if (!ReadWord(low) || !ReadWord(high))
+					return false;
+
+				outValue = static_cast<unsigned int>(low) | (static_cast<unsigned int>(high) << 16);
+				return true;
+			}
+
+			const unsigned char* ReadBytes(size_t inSize)
+			{
+				if (inSize > m_DataSize - m_Position)
+					return nullptr;
+
+				const unsigned char* bytes = m_Data + m_Position;
+				m_Position += inSize;
+
+				return bytes;
+			}
+
+		private:
+			const unsigned char* m_Data;
+			const size_t m_DataSize;
+			size_t m_Position;
+		};
+
+
+		// Applies the next record to the file image. The file image is left untouched, if the record is incomplete or invalid.
+		bool ApplyRecord(JournalReader& inReader, std::vector<unsigned char>& ioFileImage)
+		{
+			unsigned char begin_mark;
+			unsigned int file_image_size;
+			unsigned int range_count;
+
+			if (!inReader.ReadByte(begin_mark) || begin_mark != RecordBeginMark)
+				return false;
+			if (!inReader.ReadLong(file_image_size) || !inReader.ReadLong(range_count) || file_image_size > static_cast<unsigned int>(MaxJournalFileSize))
+				return false;
+
+			std::vector<unsigned char> file_image = ioFileImage;
+			file_image.resize(file_image_size);
+
+			for (unsigned int i = 0; i < range_count; ++i)
+			{
+				unsigned int offset;
+				unsigned int length;
+
+				if (!inReader.ReadLong(offset) || !inReader.ReadLong(length))
+					return false;
+				if (offset > file_image_size || length > file_image_size - offset)
+					return false;
+
+				const unsigned char* data = inReader.ReadBytes(length);
+
+				if (data == nullptr)
+					return false;
+
+				std::copy(data, data + length, file_image.begin() + offset);
+			}
+
+			unsigned char end_mark;
+
+			if (!inReader.ReadByte(end_mark) || end_mark != RecordEndMark)
+				return false;
+
+			ioFileImage.swap(file_image);
+			return true;
+		}
+	}
+
+
+	AutosaveJournal::AutosaveJournal(const std::string& inPathAndFilename)
+		: m_PathAndFilename(inPathAndFilename)
+		, m_IsStarted(false)
+		, m_JournalSize(0)
+	{
+	}
+
+	AutosaveJournal::~AutosaveJournal()
+	{
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool AutosaveJournal::Write(const std::vector<unsigned char>& inFileImage, const std::string& inSongPathAndFilename)
+	{
+		if (!m_IsStarted || inSongPathAndFilename != m_SongPathAndFilename)
+			return Restart(inFileImage, inSongPathAndFilename);
+
+		return Append(inFileImage);
+	}
+
+
+	bool AutosaveJournal::Read(std::vector<unsigned char>& outFileImage, std::string& outSongPathAndFilename) const
+	{
+		void* data = nullptr;
+		long data_size = 0;
+
+		if (!Utility::ReadFile(m_PathAndFilename, MaxJournalFileSize, &data, data_size))
+			return false;
+
+		JournalReader reader(static_cast<const unsigned char*>(data), static_cast<size_t>(data_size));
+
+		const unsigned char* identifier = reader.ReadBytes(4);
+		unsigned char version = 0;
+		unsigned short song_path_length = 0;
+
+		const bool has_header = identifier != nullptr && std::equal(identifier, identifier + 4, "SF2J")
+			&& reader.ReadByte(version) && version == JournalVersion
+			&& reader.ReadWord(song_path_length);
+
+		const char* song_path = has_header ? reinterpret_cast<const char*>(reader.ReadBytes(song_path_length)) : nullptr;
+
+		// The first record holds the full file image. Following records are applied for as long as they were written completely.
+		std::vector<unsigned char> file_image;
+		const bool is_valid = song_path != nullptr && ApplyRecord(reader, file_image);
+
+		if (is_valid)
+		{
+			while (ApplyRecord(reader, file_image))
+				;
+
+			outFileImage.swap(file_image);
+			outSongPathAndFilename = std::string(song_path, song_path_length);
+		}
+
+		delete[] static_cast<char*>(data);
+
+		return is_valid;
+	}
+
+
+	void AutosaveJournal::Remove()
+	{
+		remove(m_PathAndFilename.c_str());
+
+		m_IsStarted = false;
+		m_FileImage.clear();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool AutosaveJournal::Restart(const std::vector<unsigned char>& inFileImage, const std::string& inSongPathAndFilename)
+	{
+		std::vector<unsigned char> journal = { 'S', 'F', '2', 'J' };
+		AppendByte(journal, JournalVersion);
+		AppendWord(journal, static_cast<unsigned short>(inSongPathAndFilename.size()));
+		journal.insert(journal.end(), inSongPathAndFilename.begin(), inSongPathAndFilename.end());
+
+		std::vector<unsigned char> record;
+		CreateRecord(std::vector<unsigned char>(), inFileImage, record);
+		journal.insert(journal.end(), record.begin(), record.end());
+
+		// The previous journal stays in place, until the new one has been written completely
+		m_IsStarted = Utility::WriteFileAtomic(m_PathAndFilename, journal.data(), static_cast<long>(journal.size()));
+
+		if (m_IsStarted)
+		{
+			m_JournalSize = static_cast<long>(journal.size());
+			m_SongPathAndFilename = inSongPathAndFilename;
+			m_FileImage = inFileImage;
+		}
+
+		return m_IsStarted;
+	}
+
+
+	bool AutosaveJournal::Append(const std::vector<unsigned char>& inFileImage)
+	{
+		FOUNDATION_ASSERT(m_IsStarted);
+
+		std::vector<unsigned char> record;
+
+		if (!CreateRecord(m_FileImage, inFileImage, record))
+			return true;
+
+		const long record_size = static_cast<long>(record.size());
+
+		if (m_JournalSize + record_size > MaxJournalSizeFactor * static_cast<long>(inFileImage.size() + m_SongPathAndFilename.size()))
+			return Restart(inFileImage, m_SongPathAndFilename);
+
+		FILE* file = fopen(m_PathAndFilename.c_str(), "ab");
+
+		if (file != nullptr)
+		{
+			const bool record_written = fwrite(record.data(), 1, record.size(), file) == record.size();
+			const bool file_closed = fclose(file) == 0;
+
+			if (record_written && file_closed)
+			{
+				m_JournalSize += record_size;
+				m_FileImage = inFileImage;
+
+				return true;
+			}
+		}
+
+		// A partly written record is ignored when the journal is read, but nothing can be appended after it, so start over the next time
+		m_IsStarted = false;
+		return false;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Editor
+{
+	// Keeps a journal of the file image of the song being edited, so the song can be recovered if the editor is not shut down properly.
+	// The journal starts with the full file image, and every write after that appends only the ranges that changed since the last one,
+	// so keeping it up to date costs next to nothing. Each write is appended as one record, which is only applied on recovery if it was
+	// written completely.
+	class AutosaveJournal final
+	{
+	public:
+		AutosaveJournal(const std::string& inPathAndFilename);
+		~AutosaveJournal();
+
+		// Brings the journal up to date with the file image. The journal is started over with the full file image, if it was written for
+		// a different song file, or if the appended changes have grown larger than a full file image would be.
+		bool Write(const std::vector<unsigned char>& inFileImage, const std::string& inSongPathAndFilename);
+
+		// Replays the journal on disk. Returns false, if there is no journal, or if it is not valid.
+		bool Read(std::vector<unsigned char>& outFileImage, std::string& outSongPathAndFilename) const;
+
+		void Remove();
+
+	private:
+		bool Restart(const std::vector<unsigned char>& inFileImage, const std::string& inSongPathAndFilename);
+		bool Append(const std::vector<unsigned char>& inFileImage);
+
+		const std::string m_PathAndFilename;
+
+		bool m_IsStarted;
+		long m_JournalSize;
+
+		// The song and file image, as the journal on disk has them
+		std::string m_SongPathAndFilename;
+		std::vector<unsigned char> m_FileImage;
+	};
+}
@@ -0,0 +1,182 @@
+#include "runtime/editor/batch_renderer.h"
+#include "utils/utilities.h"
+
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/imutex.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+#include "libraries/ghc/fs_std.h"
+#include "SDL.h"
+#include <algorithm>
+
+using namespace fs;
+
+namespace Editor
+{
+	BatchRenderer::BatchRenderer(
+		Foundation::IPlatform* inPlatform,
+		const Emulation::SIDConfiguration& inSIDConfiguration,
+		const std::vector<Emulation::SIDChipSetup>& inSIDChipSetups,
+		OfflineRenderer::OutputFormat inOutputFormat,
+		Foundation::WaveFileWriter::SampleFormat inSampleFormat,
+		unsigned int inMaxFrameCount
+	)
+		: m_Platform(inPlatform)
+		, m_SIDConfiguration(inSIDConfiguration)
+		, m_SIDChipSetups(inSIDChipSetups)
+		, m_OutputFormat(inOutputFormat)
+		, m_SampleFormat(inSampleFormat)
+		, m_MaxFrameCount(inMaxFrameCount)
+		, m_Jobs(nullptr)
+		, m_RenderTimeInSeconds(0.0)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+	}
+
+	BatchRenderer::~BatchRenderer()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	std::vector<BatchRenderer::Job> BatchRenderer::CollectJobs(const std::string& inInputDirectory, const std::string& inOutputDirectory, OfflineRenderer::OutputFormat inOutputFormat)
+	{
+		std::vector<Job> jobs;
+		std::error_code error_code;
+
+		if (!is_directory(path(inInputDirectory), error_code))
+			return jobs;
+
+		create_directories(path(inOutputDirectory), error_code);
+
+		const std::string output_extension = inOutputFormat == OfflineRenderer::OutputFormat::Wave ? ".wav" : ".raw";
+
+		for (auto& entry : directory_iterator(path(inInputDirectory), error_code))
+		{
+			if (!is_regular_file(entry, error_code))
+				continue;
+
+			const std::string extension = Utility::StringToLowerCase(entry.path().extension().string());
+
+			if (extension == ".sf2" || extension == ".prg")
+			{
+				path output_path = path(inOutputDirectory) / entry.path().stem();
+				output_path += output_extension;
+
+				jobs.push_back({ entry.path().string(), output_path.string() });
+			}
+		}
+
+		std::sort(jobs.begin(), jobs.end(), [](const Job& inJob1, const Job& inJob2)
+		{
+			return inJob1.m_InputPathAndFilename < inJob2.m_InputPathAndFilename;
+		});
+
+		return jobs;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void BatchRenderer::Render(const std::vector<Job>& inJobs, unsigned int inThreadCount)
+	{
+		const unsigned int thread_count = std::max(1u, std::min(inThreadCount, static_cast<unsigned int>(inJobs.size())));
+
+		m_Jobs = &inJobs;
+		m_Results = std::vector<JobResult>(inJobs.size(), { false, "", { 0, 0, 0.0, false } });
+		m_WorkerQueues = std::vector<WorkerQueue>(thread_count);
+
+		// Deal out the jobs round robin. The workers even out any imbalance by stealing from each other.
+		for (unsigned int i = 0; i < thread_count; ++i)
+			m_WorkerQueues[i].m_Mutex = m_Platform->CreateMutex();
+
+		for (unsigned int i = 0; i < static_cast<unsigned int>(inJobs.size()); ++i)
+			m_WorkerQueues[i % thread_count].m_JobIndices.push_back(i);
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		std::vector<std::shared_ptr<Foundation::IThread>> threads;
+
+		for (unsigned int i = 0; i < thread_count; ++i)
+			threads.push_back(m_Platform->CreateThread("SF2 Batch Render", [this, i]() { WorkerThread(i); }));
+
+		for (auto& thread : threads)
+			thread->Join();
+
+		m_RenderTimeInSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+		m_WorkerQueues.clear();
+		m_Jobs = nullptr;
+	}
+
+
+	const std::vector<BatchRenderer::JobResult>& BatchRenderer::GetResults() const
+	{
+		return m_Results;
+	}
+
+
+	double BatchRenderer::GetRenderTimeInSeconds() const
+	{
+		return m_RenderTimeInSeconds;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	bool BatchRenderer::TakeJob(unsigned int inWorkerIndex, unsigned int& outJobIndex)
+	{
+		const unsigned int worker_count = static_cast<unsigned int>(m_WorkerQueues.size());
+
+		// Take from the back of the worker's own queue first, then steal from the front of the others
+		for (unsigned int i = 0; i < worker_count; ++i)
+		{
+			WorkerQueue& queue = m_WorkerQueues[(inWorkerIndex + i) % worker_count];
+
+			queue.m_Mutex->Lock();
+
+			const bool has_job = !queue.m_JobIndices.empty();
+
+			if (has_job)
+			{
+				if (i == 0)
+				{
+					outJobIndex = queue.m_JobIndices.back();
+					queue.m_JobIndices.pop_back();
+				}
+				else
+				{
+					outJobIndex = queue.m_JobIndices.front();
+					queue.m_JobIndices.pop_front();
+				}
+			}
+
+			queue.m_Mutex->Unlock();
+
+			if (has_job)
+				return true;
+		}
+
+		return false;
+	}
+
+
+	void BatchRenderer::WorkerThread(unsigned int inWorkerIndex)
+	{
+		// The renderer, and with it the emulation context, is reused for all the jobs this worker takes
+		OfflineRenderer renderer(m_Platform, m_SIDConfiguration, m_SIDChipSetups);
+
+		unsigned int job_index;
+
+		while (TakeJob(inWorkerIndex, job_index))
+		{
+			const Job& job = (*m_Jobs)[job_index];
+			JobResult& result = m_Results[job_index];
+
+			result.m_Success = renderer.Load(job.m_InputPathAndFilename)
+				&& renderer.Render(job.m_OutputPathAndFilename, m_OutputFormat, m_SampleFormat, m_MaxFrameCount, result.m_Result);
+
+			if (!result.m_Success)
+				result.m_ErrorMessage = renderer.GetErrorMessage();
+		}
+	}
+}
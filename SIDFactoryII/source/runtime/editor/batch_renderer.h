@@ -0,0 +1,80 @@
+#pragma once
+
+#include "runtime/editor/offline_renderer.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
+#include "foundation/sound/wavefilewriter.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+	class IMutex;
+}
+
+namespace Editor
+{
+	// Renders a number of songs on a pool of worker threads, each with its own offline renderer. Every worker has a queue of its own,
+	// and steals work from the other queues when it runs dry, so a few long songs do not leave the rest of the workers idle.
+	class BatchRenderer final
+	{
+	public:
+		struct Job
+		{
+			std::string m_InputPathAndFilename;
+			std::string m_OutputPathAndFilename;
+		};
+
+		struct JobResult
+		{
+			bool m_Success;
+			std::string m_ErrorMessage;
+			OfflineRenderer::Result m_Result;
+		};
+
+		BatchRenderer(
+			Foundation::IPlatform* inPlatform,
+			const Emulation::SIDConfiguration& inSIDConfiguration,
+			const std::vector<Emulation::SIDChipSetup>& inSIDChipSetups,
+			OfflineRenderer::OutputFormat inOutputFormat,
+			Foundation::WaveFileWriter::SampleFormat inSampleFormat,
+			unsigned int inMaxFrameCount
+		);
+		~BatchRenderer();
+
+		// Creates a job for each .sf2 and .prg file in the input directory, with an output file of the same name in the output directory
+		static std::vector<Job> CollectJobs(const std::string& inInputDirectory, const std::string& inOutputDirectory, OfflineRenderer::OutputFormat inOutputFormat);
+
+		void Render(const std::vector<Job>& inJobs, unsigned int inThreadCount);
+
+		const std::vector<JobResult>& GetResults() const;
+		double GetRenderTimeInSeconds() const;
+
+	private:
+		struct WorkerQueue
+		{
+			std::shared_ptr<Foundation::IMutex> m_Mutex;
+			std::deque<unsigned int> m_JobIndices;
+		};
+
+		bool TakeJob(unsigned int inWorkerIndex, unsigned int& outJobIndex);
+		void WorkerThread(unsigned int inWorkerIndex);
+
+		Foundation::IPlatform* m_Platform;
+
+		const Emulation::SIDConfiguration m_SIDConfiguration;
+		const std::vector<Emulation::SIDChipSetup> m_SIDChipSetups;
+		const OfflineRenderer::OutputFormat m_OutputFormat;
+		const Foundation::WaveFileWriter::SampleFormat m_SampleFormat;
+		const unsigned int m_MaxFrameCount;
+
+		const std::vector<Job>* m_Jobs;
+		std::vector<JobResult> m_Results;
+		std::vector<WorkerQueue> m_WorkerQueues;
+
+		double m_RenderTimeInSeconds;
+	};
+}
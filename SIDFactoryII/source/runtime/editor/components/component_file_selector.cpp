@@ -9,6 +9,7 @@
 #include "foundation/graphics/textfield.h"
 #include "foundation/platform/iplatform.h"
 
+#include <algorithm>
 #include <cctype>
 
 using namespace Foundation;
@@ -19,6 +20,7 @@ namespace Editor
 		: ComponentListSelector(inID, inGroupID, inUndo, inDataSource, inTextField, inX, inY, inWidth, inHeight, inHorizontalMargin, inVerticalMargin)
 		, m_DirectoryDataSource(inDataSource)
 		, m_Platform(inPlatform)
+		, m_IsCursorAtDefaultPosition(true)
 	{
 		ResetCursorPosition();
 	}
@@ -35,7 +37,10 @@ namespace Editor
 		if (m_HasControl)
 		{
 			if (ComponentListSelector::ConsumeInput(inKeyboard, inCursorControl, inComponentsManager))
+			{
+				m_IsCursorAtDefaultPosition = false;
 				return true;
+			}
 
 			for (auto& key_event : inKeyboard.GetKeyEventList())
 			{
@@ -71,8 +76,10 @@ namespace Editor
 								{
 									if (m_Platform->Storage_DeleteFile(directory_entry.m_Path.string()))
 									{
-										m_DirectoryDataSource->GenerateData();
-										SetCursorPosition(m_CursorPos > 0 ? (m_CursorPos - 1) : 0);
+										const int focus_pos = m_CursorPos > 0 ? (m_CursorPos - 1) : 0;
+
+										m_DirectoryDataSource->GenerateData((*m_DirectoryDataSource)[focus_pos].m_Path);
+										ResetCursorPosition();
 										m_RequireRefresh = true;
 									}
 									else
@@ -92,7 +99,10 @@ namespace Editor
 				if (character != 0)
 				{
 					if (DoMoveToLineWithCharacter(character))
+					{
+						m_IsCursorAtDefaultPosition = false;
 						m_RequireRefresh = true;
+					}
 
 					return true;
 				}
@@ -117,6 +127,7 @@ namespace Editor
 				if (cursor_pos >= 0 && cursor_pos < m_DataSource->GetSize())
 				{
 					m_CursorPos = cursor_pos;
+					m_IsCursorAtDefaultPosition = false;
 					m_RequireRefresh = true;
 
 					if (inMouse.IsButtonDoublePressed(Mouse::Left))
@@ -140,6 +151,36 @@ namespace Editor
 	}
 
 
+	//----------------------------------------------------------------------------------------------------------------------------------------
+
+	void ComponentFileSelector::UpdateDirectory()
+	{
+		if (!m_DirectoryDataSource->IsScanning())
+			return;
+
+		// Keep the cursor on the entry it is on, as the entries found are sorted into the list
+		const bool has_cursor_entry = m_CursorPos >= 0 && m_CursorPos < m_DirectoryDataSource->GetSize();
+		const fs::path cursor_path = has_cursor_entry ? (*m_DirectoryDataSource)[m_CursorPos].m_Path : fs::path();
+
+		if (!m_DirectoryDataSource->UpdateScan())
+			return;
+
+		if (m_IsCursorAtDefaultPosition)
+			ResetCursorPosition();
+		else
+		{
+			const int cursor_pos = m_DirectoryDataSource->FindEntry(cursor_path);
+
+			if (cursor_pos >= 0)
+			{
+				m_TopVisibleIndex = std::max(0, m_TopVisibleIndex + cursor_pos - m_CursorPos);
+				m_CursorPos = cursor_pos;
+			}
+		}
+
+		m_RequireRefresh = true;
+	}
+
 	//----------------------------------------------------------------------------------------------------------------------------------------
 
 	void ComponentFileSelector::RefreshLine(int inIndex, int inPosY)
@@ -147,6 +188,11 @@ namespace Editor
 		const int max_name_length = m_ContentWidth - 11;
 		const DirectoryEntry& directory_entry = (*m_DirectoryDataSource)[inIndex];
 
+		// Files with info get half of the line for the name, and the rest for the info
+		const bool has_info = directory_entry.m_Type == DirectoryEntry::File && !directory_entry.m_Info.empty();
+		const int info_x = max_name_length / 2 + 2;
+		const int max_display_name_length = has_info ? info_x - 2 : max_name_length;
+
         std::string name = [&]() -> std::string
 		{
 			if (directory_entry.m_Type != DirectoryEntry::Drive)
@@ -157,11 +203,22 @@ namespace Editor
 			return directory_entry.m_Path.string();
 		}();
 
-		if (static_cast<int>(name.length()) > max_name_length)
-			name = CondenseString(name, "...", max_name_length);
+		if (static_cast<int>(name.length()) > max_display_name_length)
+			name = CondenseString(name, "...", max_display_name_length);
 
 		m_TextField->Print(m_ContentX, inPosY, m_TextColor, name);
 
+		if (has_info)
+		{
+			const int max_info_length = m_ContentWidth - info_x;
+			std::string info = directory_entry.m_Info;
+
+			if (static_cast<int>(info.length()) > max_info_length)
+				info = CondenseString(info, "...", max_info_length);
+
+			m_TextField->Print(m_ContentX + info_x, inPosY, m_TextColor, info);
+		}
+
 		if (directory_entry.m_Type == DirectoryEntry::Drive)
 			m_TextField->Print(m_ContentX + m_ContentWidth - 10, inPosY, m_TextColor, "<DRIVE>");
 		else if (directory_entry.m_Type == DirectoryEntry::Folder || directory_entry.m_Type == DirectoryEntry::Back)
@@ -172,16 +229,12 @@ namespace Editor
 
 	void ComponentFileSelector::ResetCursorPosition()
 	{
-		int cursor_pos = 0;
-		auto& data_source = *m_DirectoryDataSource;
+		int cursor_pos = m_DirectoryDataSource->GetFocusIndex();
 
-		if (data_source.HasFileSelection())
-		{
-			cursor_pos = data_source.GetFileSelectIndex();
-			data_source.ClearFileSelection();
-		}
-		else
+		if (cursor_pos < 0)
 		{
+			cursor_pos = 0;
+
 			for (int i = 0; i < m_DataSource->GetSize(); ++i)
 			{
 				const auto type = (*m_DirectoryDataSource)[i].m_Type;
@@ -194,6 +247,7 @@ namespace Editor
 		}
 
 		SetCursorPosition(cursor_pos);
+		m_IsCursorAtDefaultPosition = true;
 	}
 
 	void ComponentFileSelector::SetCursorPosition(int inCursorPos)
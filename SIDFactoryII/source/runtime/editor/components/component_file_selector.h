@@ -27,6 +27,9 @@ namespace Editor
 		bool ConsumeInput(const Foundation::Keyboard& inKeyboard, CursorControl& inCursorControl, ComponentsManager& inComponentsManager) override;
 		bool ConsumeInput(const Foundation::Mouse& inMouse, bool inModifierKeyMask, CursorControl& inCursorControl, ComponentsManager& inComponentsManager) override;
 
+		// Adds the entries found by the directory scan since the last update
+		void UpdateDirectory();
+
 	private:
 		void RefreshLine(int inIndex, int inPosY) override;
 		void ResetCursorPosition();
@@ -36,5 +39,7 @@ namespace Editor
 
 		std::shared_ptr<DataSourceDirectory> m_DirectoryDataSource;
 		Foundation::IPlatform* m_Platform;
+
+		bool m_IsCursorAtDefaultPosition;		// Until the cursor is moved, it follows the entries found by the scan
 	};
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ namespace Editor
 		, m_DataSource(inDataSource)
 		, m_CursorPos(0)
 		, m_MaxCursorPos(static_cast<unsigned int>(m_DataSource->GetSize()) - inHeight)
+		, m_SIDIndex(0)
 	{
 		FOUNDATION_ASSERT(inTextField != nullptr);
 		m_RequireRefresh = true;
@@ -90,6 +91,12 @@ namespace Editor
 				case SDLK_END:
 					m_CursorPos = m_MaxCursorPos;
 
+					consume_input = true;
+					break;
+				case SDLK_TAB:
+					m_SIDIndex = (m_SIDIndex + 1) % Emulation::SID_MAX_CHIP_COUNT;
+					m_RequireRefresh = true;
+
 					consume_input = true;
 					break;
 				default:
@@ -152,29 +159,38 @@ namespace Editor
 
 			m_DataSource->Lock();
 
+			// Only the registers of one SID chip fit on a line. The chip shown is cycled with tab.
+			const int sid_count = m_DataSource->GetSize() > 0 ? (*m_DataSource)[m_DataSource->GetSize() - 1].m_SIDCount : 1;
+
+			if (m_SIDIndex >= static_cast<unsigned int>(sid_count))
+				m_SIDIndex = 0;
+
 			auto print_channel = [&](int x, int y, int channel, const Emulation::FlightRecorder::Frame& frame_data)
 			{
 				const int sid_index = 7 * channel;
+				const unsigned char* sid_data = frame_data.m_SIDData[m_SIDIndex < frame_data.m_SIDCount ? m_SIDIndex : 0];
 
 				m_TextField->PrintHexValue(x, y, is_uppercase, frame_data.m_DriverSync[channel]);
 				
-				unsigned short FREQ = (static_cast<unsigned short>(frame_data.m_SIDData[sid_index + 1]) << 8) | frame_data.m_SIDData[sid_index + 0];
-				unsigned short PLSW = (static_cast<unsigned short>(frame_data.m_SIDData[sid_index + 3]) << 8) | frame_data.m_SIDData[sid_index + 2];
-				unsigned short ADSR = (static_cast<unsigned short>(frame_data.m_SIDData[sid_index + 5]) << 8) | frame_data.m_SIDData[sid_index + 6];
+				unsigned short FREQ = (static_cast<unsigned short>(sid_data[sid_index + 1]) << 8) | sid_data[sid_index + 0];
+				unsigned short PLSW = (static_cast<unsigned short>(sid_data[sid_index + 3]) << 8) | sid_data[sid_index + 2];
+				unsigned short ADSR = (static_cast<unsigned short>(sid_data[sid_index + 5]) << 8) | sid_data[sid_index + 6];
 				
-				Color color = (frame_data.m_SIDData[sid_index + 4] & 1) == 0 ? color_gate_off : color_gate_on;
+				Color color = (sid_data[sid_index + 4] & 1) == 0 ? color_gate_off : color_gate_on;
 
 				m_TextField->PrintHexValue(x + 3, y, color, is_uppercase, FREQ);
 				m_TextField->PrintHexValue(x + 8, y, color, is_uppercase, PLSW);
-				m_TextField->PrintHexValue(x + 13, y, color, is_uppercase, frame_data.m_SIDData[sid_index + 4]);
+				m_TextField->PrintHexValue(x + 13, y, color, is_uppercase, sid_data[sid_index + 4]);
 				m_TextField->PrintHexValue(x + 16, y, color, is_uppercase, ADSR);
 			};
 
 			auto print_filter = [&](int x, int y, const Emulation::FlightRecorder::Frame& frame_data)
 			{
-				unsigned short CUTOFF = (static_cast<unsigned short>(frame_data.m_SIDData[0x16]) << 3) | (frame_data.m_SIDData[0x15] & 7);
-				unsigned char RES_SEL = frame_data.m_SIDData[0x17];
-				unsigned char BANDPASS_VOL = frame_data.m_SIDData[0x18];
+				const unsigned char* sid_data = frame_data.m_SIDData[m_SIDIndex < frame_data.m_SIDCount ? m_SIDIndex : 0];
+
+				unsigned short CUTOFF = (static_cast<unsigned short>(sid_data[0x16]) << 3) | (sid_data[0x15] & 7);
+				unsigned char RES_SEL = sid_data[0x17];
+				unsigned char BANDPASS_VOL = sid_data[0x18];
 
 				Color color = color_filter_and_volume;
 
@@ -185,6 +201,9 @@ namespace Editor
 
 			m_TextField->Print(2, 1, color_desc, "Frame Cycl SL  SC  Sy Freq Puls Wf ADSR  Sy Freq Puls Wf ADSR  Sy Freq Puls Wf ADSR  CutO RS BV");
 
+			if (sid_count > 1)
+				m_TextField->Print(2 + 98, 1, color_desc, "SID " + std::to_string(m_SIDIndex + 1) + "/" + std::to_string(sid_count) + " (tab)");
+
 			const int x = 2;
 
 			for (int i = 0; i < m_Dimensions.m_Height - 4; ++i)
@@ -42,5 +42,8 @@ namespace Editor
 		unsigned int m_CursorPos;
 		unsigned int m_MaxCursorPos;
 		unsigned int m_TopVisible;
+
+		// The SID chip shown, when more than one is emulated
+		unsigned int m_SIDIndex;
 	};
 }
@@ -27,6 +27,7 @@
 #include "utils/usercolors.h"
 
 #include <string>
+#include <algorithm>
 #include "foundation/base/assert.h"
 
 using namespace Foundation;
@@ -112,6 +113,7 @@ namespace Editor
 		, m_GetFirstEmptySequenceIndexFunction(inGetFirstEmptySequenceIndexFunction)
 		, m_DataSourceOrderList(inDataSourceOrderList)
 		, m_DataSourceSequenceList(inDataSourceSequenceList)
+		, m_EventPositionIndex(m_DataSourceOrderList, m_DataSourceSequenceList)
 		, m_CopyPasteData(inCopyPasteData)
 		, m_CursorPos(0)
 		, m_EventPos(0xffffffff)
@@ -247,8 +249,9 @@ namespace Editor
 
 		if (m_SequenceDataHasChanged)
 		{
-			m_SequenceChangedEvent.Execute();
+			m_SequenceChangedEvent.Execute(m_ChangedSequenceIndexList);
 			m_SequenceDataHasChanged = false;
+			m_ChangedSequenceIndexList.clear();
 		}
 
 		if (m_HasDataChangeOrderList)
@@ -467,12 +470,15 @@ namespace Editor
 	void ComponentTrack::PullDataFromSource()
 	{
 		m_DataSourceOrderList->PullDataFromSource();
+		m_EventPositionIndex.Invalidate();
 	}
 
 	void ComponentTrack::PullSequenceDataFromSource()
 	{
 		for (auto& sequence : m_DataSourceSequenceList)
 			sequence->PullDataFromSource();
+
+		m_EventPositionIndex.Invalidate();
 	}
 
 
@@ -528,7 +534,6 @@ namespace Editor
 		m_EventPos = inEventPos;
 		m_TopEventPos = inEventPos - m_FocusRow.m_RowsAbove;
 
-		bool found_event_pos = false;
 		bool found_top_event_pos = false;
 
 		if (m_TopEventPos <= 0)
@@ -546,34 +551,21 @@ namespace Editor
 		}
 		else
 		{
-			int event_pos = 0;
+			unsigned int order_list_index;
+			unsigned int sequence_position;
 
-			for (unsigned int i = 0; i < m_DataSourceOrderList->GetLength(); ++i)
+			if (!found_top_event_pos && m_EventPositionIndex.Find(static_cast<unsigned int>(m_TopEventPos), order_list_index, sequence_position))
 			{
-				unsigned char sequence_index = (*m_DataSourceOrderList)[i].m_SequenceIndex;
-				const std::shared_ptr<DataSourceSequence>& sequence = m_DataSourceSequenceList[sequence_index];
-
-				int next_event_pos = event_pos + sequence->GetLength();
-
-				if (!found_top_event_pos && m_TopEventPos >= event_pos && m_TopEventPos < next_event_pos)
-				{
-					found_top_event_pos = true;
-
-					m_FirstValidOrderListIndex = i;
-					m_FirstValidSequenceIndex = m_TopEventPos - event_pos;
-				}
-
-				if (!found_event_pos && m_EventPos >= event_pos && m_EventPos < next_event_pos)
-				{
-					found_event_pos = true;
+				found_top_event_pos = true;
 
-					m_EventPosDetails.m_OrderListIndex = i;
-					m_EventPosDetails.m_SequenceIndex = m_EventPos - event_pos;
-
-					break;
-				}
+				m_FirstValidOrderListIndex = order_list_index;
+				m_FirstValidSequenceIndex = sequence_position;
+			}
 
-				event_pos = next_event_pos;
+			if (m_EventPositionIndex.Find(static_cast<unsigned int>(m_EventPos), order_list_index, sequence_position))
+			{
+				m_EventPosDetails.m_OrderListIndex = order_list_index;
+				m_EventPosDetails.m_SequenceIndex = sequence_position;
 			}
 
 			m_HasFirstValid = true;
@@ -592,27 +584,14 @@ namespace Editor
 
 	int ComponentTrack::GetEventPositionAtTopOfCurrentSequence() const
 	{
-		int event_pos = 0;
+		unsigned int order_list_index;
+		unsigned int sequence_position;
 
-		for (unsigned int i = 0; i < m_DataSourceOrderList->GetLength(); ++i)
-		{
-			const unsigned char transposition = (*m_DataSourceOrderList)[i].m_Transposition;
-			const unsigned char sequence_index = (*m_DataSourceOrderList)[i].m_SequenceIndex;
+		// Beyond the sequences, the top is where the end marker is
+		if (m_EventPos < 0 || !m_EventPositionIndex.Find(static_cast<unsigned int>(m_EventPos), order_list_index, sequence_position) || (*m_DataSourceOrderList)[order_list_index].m_Transposition >= 0xfe)
+			return static_cast<int>(m_EventPositionIndex.GetMaxEventPosition());
 
-			if (transposition == 0xff || transposition == 0xfe)
-				break;
-
-			const std::shared_ptr<DataSourceSequence>& sequence = m_DataSourceSequenceList[sequence_index];
-
-			const int next_event_pos = event_pos + sequence->GetLength();
-
-			if (m_EventPos >= event_pos && m_EventPos < next_event_pos)
-				break;
-
-			event_pos = next_event_pos;
-		}
-
-		return event_pos;
+		return static_cast<int>(m_EventPositionIndex.GetEventPosOf(order_list_index, 0));
 	}
 
 	//--------------------------------------------------------------------------------------------------
@@ -691,16 +670,9 @@ namespace Editor
 		if (loop_index == 0)
 			return 0;
 
-		int event_position = 0;
-		for (int i = 0; i < loop_index; ++i)
-		{
-			const auto& entry = (*m_DataSourceOrderList)[i];
-			FOUNDATION_ASSERT(entry.m_Transposition < 0xfe);
-			const int sequence_length = m_DataSourceSequenceList[entry.m_SequenceIndex]->GetLength();
-			event_position += sequence_length;
-		}
+		FOUNDATION_ASSERT((*m_DataSourceOrderList)[loop_index - 1].m_Transposition < 0xfe);
 
-		return event_position;
+		return static_cast<int>(m_EventPositionIndex.GetEventPosOf(static_cast<unsigned int>(loop_index), 0));
 	}
 
 
@@ -884,6 +856,12 @@ namespace Editor
 		OnOrderListChanged();
 	}
 
+
+	void ComponentTrack::HandleSequenceChangedInOtherTrack(unsigned char inSequenceIndex)
+	{
+		m_EventPositionIndex.InvalidateSequence(inSequenceIndex);
+	}
+
 	//--------------------------------------------------------------------------------------------------
 	// Draw sequence entry
 	//--------------------------------------------------------------------------------------------------
@@ -1360,17 +1338,15 @@ namespace Editor
 				event.m_Note = 0x00;
 
 				if (inChangeSequenceSize && sequence_data_source_length > 1)
-				{
 					sequence_data_source->SetLength(sequence_data_source_length - 1);
-					UpdateMaxEventPos();
-				}
 
 				OnSequenceChanged(order_list_entry.m_SequenceIndex);
 
 				if (inChangeSequenceSize && sequence_data_source_length > 1)
 				{
 					OnOrderListChanged();
-					return ComponentTrackUtils::GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex, m_DataSourceOrderList, m_DataSourceSequenceList);
+					UpdateMaxEventPos();
+					return m_EventPositionIndex.GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex);
 				}
 			}
 		}
@@ -1411,15 +1387,13 @@ namespace Editor
 				event.m_Instrument = 0x80;
 				event.m_Note = 0x00;
 
-				if (changed_size)
-					UpdateMaxEventPos();
-
 				OnSequenceChanged(order_list_entry.m_SequenceIndex);
 
 				if (changed_size)
 				{
 					OnOrderListChanged();
-					return ComponentTrackUtils::GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex, m_DataSourceOrderList, m_DataSourceSequenceList);
+					UpdateMaxEventPos();
+					return m_EventPositionIndex.GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex);
 				}
 			}
 		}
@@ -1452,11 +1426,10 @@ namespace Editor
 				event.m_Note = 0x00;
 			}
 
-			UpdateMaxEventPos();
-
 			OnSequenceChanged(order_list_entry.m_SequenceIndex);
+			UpdateMaxEventPos();
 
-			return ComponentTrackUtils::GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex, m_DataSourceOrderList, m_DataSourceSequenceList);
+			return m_EventPositionIndex.GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex);
 		}
 
 		return m_EventPos;
@@ -1477,11 +1450,10 @@ namespace Editor
 			for (int i = 0; i < source_length; ++i)
 				(*sequence_data_source)[i] = (*inSequenceData)[i];
 
-			UpdateMaxEventPos();
-
 			OnSequenceChanged(order_list_entry.m_SequenceIndex);
+			UpdateMaxEventPos();
 
-			return ComponentTrackUtils::GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex, m_DataSourceOrderList, m_DataSourceSequenceList);
+			return m_EventPositionIndex.GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex);
 		}
 
 		return m_EventPos;
@@ -1523,11 +1495,10 @@ namespace Editor
 					event.m_Note = 0x00;
 				}
 
-				UpdateMaxEventPos();
-
 				OnSequenceChanged(order_list_entry.m_SequenceIndex);
+				UpdateMaxEventPos();
 
-				return ComponentTrackUtils::GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex, m_DataSourceOrderList, m_DataSourceSequenceList);
+				return m_EventPositionIndex.GetEventPosOf(m_EventPosDetails.m_OrderListIndex, m_EventPosDetails.m_SequenceIndex);
 			}
 		}
 
@@ -1538,7 +1509,7 @@ namespace Editor
 
 	void ComponentTrack::UpdateMaxEventPos()
 	{
-		m_MaxEventPos = ComponentTrackUtils::GetMaxEventPosition(m_DataSourceOrderList, m_DataSourceSequenceList);
+		m_MaxEventPos = static_cast<int>(m_EventPositionIndex.GetMaxEventPosition());
 	}
 
 	//--------------------------------------------------------------------------------------------------
@@ -2137,6 +2108,8 @@ namespace Editor
 
 	void ComponentTrack::OnOrderListChanged()
 	{
+		m_EventPositionIndex.Invalidate();
+
 		// Pack orderlist
 		DataSourceOrderList::PackResult packed_result = m_DataSourceOrderList->Pack();
 
@@ -2155,6 +2128,8 @@ namespace Editor
 		const std::shared_ptr<DataSourceSequence>& inSequence = m_DataSourceSequenceList[inSequenceIndex];
 		DataSourceSequence::PackResult packed_result = inSequence->Pack();
 
+		m_EventPositionIndex.InvalidateSequence(inSequenceIndex);
+
 		m_RequireRefresh = true;
 
 		if (packed_result.m_DataLength < 0x100 && packed_result.m_Data != nullptr)
@@ -2167,6 +2142,9 @@ namespace Editor
 
 		m_SequenceDataHasChanged = true;
 
+		if (std::find(m_ChangedSequenceIndexList.begin(), m_ChangedSequenceIndexList.end(), inSequenceIndex) == m_ChangedSequenceIndexList.end())
+			m_ChangedSequenceIndexList.push_back(inSequenceIndex);
+
 		UpdateSequenceStatusReport();
 	}
 
@@ -2176,8 +2154,6 @@ namespace Editor
 	{
 		EventPosDetails details;
 
-		int event_pos = 0;
-
 		if (inEventPos >= m_MaxEventPos && m_MaxEventPos > 0)
 		{
 			const int loop_event_pos = GetLoopEventPosition();
@@ -2190,22 +2166,13 @@ namespace Editor
 			}
 		}
 
-		for (unsigned int i = 0; i < m_DataSourceOrderList->GetLength(); ++i)
-		{
-			unsigned char sequence_index = (*m_DataSourceOrderList)[i].m_SequenceIndex;
-			const std::shared_ptr<DataSourceSequence>& sequence = m_DataSourceSequenceList[sequence_index];
-
-			int next_event_pos = event_pos + sequence->GetLength();
-
-			if (inEventPos >= event_pos && inEventPos < next_event_pos)
-			{
-				details.m_OrderListIndex = i;
-				details.m_SequenceIndex = static_cast<unsigned int>(inEventPos - event_pos);
+		unsigned int order_list_index;
+		unsigned int sequence_position;
 
-				break;
-			}
-
-			event_pos = next_event_pos;
+		if (inEventPos >= 0 && m_EventPositionIndex.Find(static_cast<unsigned int>(inEventPos), order_list_index, sequence_position))
+		{
+			details.m_OrderListIndex = order_list_index;
+			details.m_SequenceIndex = sequence_position;
 		}
 
 		return details;
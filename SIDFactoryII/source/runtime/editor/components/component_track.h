@@ -94,7 +94,7 @@ namespace Editor
 
 	public:
 		using SequenceSplitEvent = Utility::TEvent<void(unsigned char, unsigned char)>;
-		using SequenceChangedEvent = Utility::TEvent<void(void)>;
+		using SequenceChangedEvent = Utility::TEvent<void(const std::vector<unsigned char>&)>;
 		using OrderListChangedEvent = Utility::TEvent<void(void)>;
 
 		ComponentTrack(
@@ -162,6 +162,7 @@ namespace Editor
 
 		void CancelOrderListInputValue();
 		void HandleOrderListUpdateAfterSequenceSplit(unsigned char inSequenceIndex, unsigned char inAddSequenceIndex);
+		void HandleSequenceChangedInOtherTrack(unsigned char inSequenceIndex);
 
 		void SetUndoHandlers(std::function<void(UndoComponentDataTableTracks&)> inAddUndoStepHandler, std::function<void(const UndoComponentDataTableTracks&, CursorControl&)> inOnUndoHandler);
 
@@ -271,6 +272,7 @@ namespace Editor
 		bool m_HasDataChangeOrderList;
 		bool m_LocalDataChange;
 		std::vector<unsigned char> m_DataChangeSequenceIndexList;
+		std::vector<unsigned char> m_ChangedSequenceIndexList;
 
 		int m_TopEventPos;
 		int m_HasFirstValid;
@@ -290,6 +292,7 @@ namespace Editor
 
 		std::shared_ptr<DataSourceOrderList> m_DataSourceOrderList;
 		std::vector<std::shared_ptr<DataSourceSequence>> m_DataSourceSequenceList;
+		ComponentTrackUtils::EventPositionIndex m_EventPositionIndex;
 
 		std::function<void(bool, int, int)> m_StatusReportFunction;
 		std::function<unsigned char()> m_GetFirstFreeSequenceIndexFunction;
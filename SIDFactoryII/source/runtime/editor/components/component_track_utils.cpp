@@ -5,6 +5,8 @@
 
 #include "foundation/base/assert.h"
 
+#include <algorithm>
+
 namespace Editor
 {
 	namespace ComponentTrackUtils
@@ -64,5 +66,105 @@ namespace Editor
 
 			return max_event_position + inSequencePosition;
 		}
+
+		//------------------------------------------------------------------------------------------------------------
+
+		EventPositionIndex::EventPositionIndex(const std::shared_ptr<DataSourceOrderList>& inOrderList, const std::vector<std::shared_ptr<DataSourceSequence>>& inSequenceList)
+			: m_OrderList(inOrderList)
+			, m_SequenceList(inSequenceList)
+			, m_ValidEntryCount(0)
+		{
+			FOUNDATION_ASSERT(inOrderList != nullptr);
+		}
+
+
+		void EventPositionIndex::Invalidate()
+		{
+			m_ValidEntryCount = 0;
+		}
+
+
+		void EventPositionIndex::InvalidateSequence(unsigned char inSequenceIndex)
+		{
+			// Only the entries from the first one playing the sequence have to be updated
+			for (unsigned int i = 0; i < m_ValidEntryCount; ++i)
+			{
+				if (m_EntrySequenceIndex[i] == inSequenceIndex)
+				{
+					m_ValidEntryCount = i;
+					return;
+				}
+			}
+		}
+
+
+		unsigned int EventPositionIndex::GetMaxEventPosition() const
+		{
+			Update();
+
+			return m_PlayedEntryStart.back();
+		}
+
+
+		unsigned int EventPositionIndex::GetEventPosOf(unsigned int inOrderListIndex, unsigned int inSequencePosition) const
+		{
+			Update();
+
+			FOUNDATION_ASSERT(inOrderListIndex < m_OrderList->GetLength());
+
+			return m_PlayedEntryStart[inOrderListIndex] + inSequencePosition;
+		}
+
+
+		bool EventPositionIndex::Find(unsigned int inEventPosition, unsigned int& outOrderListIndex, unsigned int& outSequencePosition) const
+		{
+			Update();
+
+			if (inEventPosition >= m_EntryStart.back())
+				return false;
+
+			// The last entry starting at or before the event position. Entries with empty sequences start at the same position as
+			// the next one, and are skipped this way.
+			const auto it = std::upper_bound(m_EntryStart.begin(), m_EntryStart.end(), inEventPosition) - 1;
+
+			outOrderListIndex = static_cast<unsigned int>(it - m_EntryStart.begin());
+			outSequencePosition = inEventPosition - *it;
+
+			return true;
+		}
+
+
+		void EventPositionIndex::Update() const
+		{
+			const unsigned int length = m_OrderList->GetLength();
+
+			// Entries may have been added or removed without an explicit invalidation
+			if (m_EntrySequenceIndex.size() != length)
+			{
+				m_EntryStart.resize(length + 1);
+				m_PlayedEntryStart.resize(length + 1);
+				m_EntrySequenceIndex.resize(length);
+
+				m_ValidEntryCount = 0;
+			}
+
+			if (m_ValidEntryCount >= length)
+				return;
+
+			m_EntryStart[0] = 0;
+			m_PlayedEntryStart[0] = 0;
+
+			for (unsigned int i = m_ValidEntryCount; i < length; ++i)
+			{
+				const DataSourceOrderList::Entry& entry = (*m_OrderList)[i];
+				const unsigned int sequence_length = m_SequenceList[entry.m_SequenceIndex]->GetLength();
+
+				m_EntrySequenceIndex[i] = entry.m_SequenceIndex;
+				m_EntryStart[i + 1] = m_EntryStart[i] + sequence_length;
+				m_PlayedEntryStart[i + 1] = m_PlayedEntryStart[i] + (entry.m_Transposition < 0xfe ? sequence_length : 0);
+			}
+
+			m_ValidEntryCount = length;
+		}
 	}
 }
\ No newline at end of file
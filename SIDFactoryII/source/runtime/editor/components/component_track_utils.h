@@ -21,5 +21,37 @@ namespace Editor
 
 		unsigned int GetMaxEventPosition(const std::shared_ptr<DataSourceOrderList>& inOrderList, const std::vector<std::shared_ptr<DataSourceSequence>>& inSequenceList);
 		unsigned int GetEventPosOf(unsigned int inOrderListIndex, unsigned int inSequencePosition, const std::shared_ptr<DataSourceOrderList>& inOrderList, const std::vector<std::shared_ptr<DataSourceSequence>>& inSequenceList);
+
+		// Keeps the event position at the start of every entry in an order list, so that event positions can be looked up with a
+		// binary search, instead of summing up the sequence lengths through the order list every time. The positions are brought
+		// up to date on the first look up after a change, and only from the first order list entry affected by the change.
+		class EventPositionIndex final
+		{
+		public:
+			EventPositionIndex(const std::shared_ptr<DataSourceOrderList>& inOrderList, const std::vector<std::shared_ptr<DataSourceSequence>>& inSequenceList);
+
+			void Invalidate();									// Call when the order list changes
+			void InvalidateSequence(unsigned char inSequenceIndex);	// Call when the length of a sequence may have changed
+
+			unsigned int GetMaxEventPosition() const;
+			unsigned int GetEventPosOf(unsigned int inOrderListIndex, unsigned int inSequencePosition) const;
+
+			// Finds the order list entry, and the position in its sequence, that an event position falls within. Returns false, if
+			// the event position is beyond the end of the order list.
+			bool Find(unsigned int inEventPosition, unsigned int& outOrderListIndex, unsigned int& outSequencePosition) const;
+
+		private:
+			void Update() const;
+
+			std::shared_ptr<DataSourceOrderList> m_OrderList;
+			const std::vector<std::shared_ptr<DataSourceSequence>>& m_SequenceList;
+
+			// Start positions for each entry and one past the last one. The end marker entry counts in m_EntryStart, just like the
+			// editor counts the rows of the end marker when it finds its way through the order list, but not in m_PlayedEntryStart.
+			mutable std::vector<unsigned int> m_EntryStart;
+			mutable std::vector<unsigned int> m_PlayedEntryStart;
+			mutable std::vector<unsigned char> m_EntrySequenceIndex;
+			mutable unsigned int m_ValidEntryCount;
+		};
 	}
 }
\ No newline at end of file
@@ -70,7 +70,7 @@ namespace Editor
 			track_position.m_X += (*inDataSource)[i]->GetDimensions().m_Width + 1;
 
 			// And add sequence changed event delegate
-			(*inDataSource)[i]->GetSequenceChangedEvent().Add(this, Utility::TDelegate<void(void)>([&]() { AlignTracks(); }));
+			(*inDataSource)[i]->GetSequenceChangedEvent().Add(this, Utility::TDelegate<void(const std::vector<unsigned char>&)>([&](const std::vector<unsigned char>& inChangedSequenceIndexList) { AlignTracks(inChangedSequenceIndexList); }));
 
 			// And add sequence split event delegate
 			(*inDataSource)[i]->GetSequenceSplitEvent().Add(this, Utility::TDelegate<void(unsigned char, unsigned char)>([&](unsigned char inSequence, unsigned char inSequenceToAdd) { HandleSequenceSplit(inSequence, inSequenceToAdd); }));
@@ -549,14 +549,20 @@ namespace Editor
 	}
 
 
-	void ComponentTracks::AlignTracks()
+	void ComponentTracks::AlignTracks(const std::vector<unsigned char>& inChangedSequenceIndexList)
 	{
 		m_RequireRefresh = true;
 
 		for (int i = 0; i < m_DataSource->GetSize(); ++i)
 		{
 			if (i != m_FocusTrackIndex)
+			{
+				// The sequences are shared between the tracks, so the other tracks must know which ones changed
+				for (unsigned char sequence_index : inChangedSequenceIndexList)
+					(*m_DataSource)[i]->HandleSequenceChangedInOtherTrack(sequence_index);
+
 				(*m_DataSource)[i]->ForceRefresh();
+			}
 		}
 	}
 
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Foundation
 {
@@ -81,7 +82,7 @@ namespace Editor
 		bool ComputePlaybackStateFromEventPosition(int inEventPos, std::vector<IDriverArchitecture::PlayMarkerInfo>& inPlayMarkerInfoList) const;
 
 	private:
-		void AlignTracks();
+		void AlignTracks(const std::vector<unsigned char>& inChangedSequenceIndexList);
 		void HandleSequenceSplit(unsigned char inSequence, unsigned char inSequenceToAdd);
 		
 		void OnTabForward(CursorControl& inCursorControl);
@@ -51,6 +51,13 @@ namespace Editor
 		}
 	}
 
+
+	int CursorControl::GetTicksToNextBlink() const
+	{
+		// The cursor flips visibility every time the tick count passes a multiple of half the blink period
+		return (m_Tick & ((1 << (blink_speed - 1)) - 1)) + 1;
+	}
+
 	//---------------------------------------------------------------------------------------------------------------------------
 
 	void CursorControl::SetTargetTextField(Foundation::TextField* inTextField)
@@ -34,6 +34,7 @@ namespace Editor
 		bool IsEnabled() const;
 
 		void Update(int inTick);
+		int GetTicksToNextBlink() const;
 
 		void SetTargetTextField(Foundation::TextField* inTextField);
 
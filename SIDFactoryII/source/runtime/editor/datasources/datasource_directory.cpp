@@ -1,8 +1,16 @@
 #include "datasource_directory.h"
+#include "directory_metadata_cache.h"
+#include "runtime/editor/driver/driver_info.h"
 #include "foundation/platform/iplatform.h"
+#include "foundation/platform/imutex.h"
+#include "foundation/platform/ithread.h"
 #include "utils/configfile.h"
 #include "utils/config/configtypes.h"
+#include "utils/c64file.h"
+#include "utils/psidfile.h"
+#include "utils/utilities.h"
 #include <cctype>
+#include <unordered_map>
 
 using namespace fs;
 using namespace Utility;
@@ -10,13 +18,101 @@ using namespace Utility::Config;
 
 namespace Editor
 {
+	// The scan hands the entries it has found over in batches of this size
+	static const size_t ScanBatchSize = 64;
+
+	static bool HasFileInfo(const path& inPath)
+	{
+		const std::string extension = Utility::StringToLowerCase(inPath.extension().string());
+		return extension == ".sid" || extension == ".sf2" || extension == ".prg";
+	}
+
+
+	static std::string ReadFileInfo(const path& inPath)
+	{
+		std::string info;
+
+		if (Utility::StringToLowerCase(inPath.extension().string()) == ".sid")
+		{
+			// Only the header is read, as that is where the title and author are, and the files may be on a slow network share
+			unsigned char header[0x7c];
+			const unsigned int header_size = Utility::ReadFileStart(inPath.string(), header, sizeof(header));
+
+			std::string title;
+			std::string author;
+
+			if (PSIDFile::ReadHeaderInfo(header, header_size, title, author))
+				info = author.empty() ? title : title + " / " + author;
+
+			return info;
+		}
+
+		void* data = nullptr;
+		long data_size = 0;
+
+		if (!Utility::ReadFile(inPath.string(), 0x10000 + 2, &data, data_size))
+			return "";
+
+		std::shared_ptr<C64File> c64_file = C64File::CreateFromPRGData(data, static_cast<unsigned int>(data_size));
+
+		if (c64_file != nullptr)
+		{
+			DriverInfo driver_info;
+			driver_info.Parse(*c64_file);
+
+			if (driver_info.IsValid())
+				info = driver_info.GetDescriptor().m_DriverName;
+		}
+
+		delete[] static_cast<char*>(data);
+
+		return info;
+	}
+
+
+	static bool IsEntryBefore(const DirectoryEntry& inEntry1, const DirectoryEntry& inEntry2)
+	{
+		// If the types are the same, lets check the filenames against eachother (and ignore case .. which means a transformation per comparasin, not fast.. but who cares! This is disk operation stuff)
+		if (inEntry1.m_Type == inEntry2.m_Type)
+		{
+			if (!(inEntry1.m_DisplayName.empty() ^ inEntry2.m_DisplayName.empty()))
+			{
+				std::string name1 = inEntry1.m_DisplayName.empty() ? inEntry1.m_Path.string() : inEntry1.m_DisplayName;
+				std::string name2 = inEntry2.m_DisplayName.empty() ? inEntry2.m_Path.string() : inEntry2.m_DisplayName;
+
+				std::transform(name1.begin(), name1.end(), name1.begin(),
+					[](char c) { return std::tolower(c); });
+				std::transform(name2.begin(), name2.end(), name2.begin(),
+					[](char c) { return std::tolower(c); });
+
+				return name1 < name2;
+			}
+			else
+			{
+				// If inEntry2 is not using the display name, entry 1 is and vice versa!
+				return inEntry2.m_DisplayName.empty();
+			}
+		}
+
+		// Otherwise just prefer one type over the other
+		return inEntry1.m_Type < inEntry2.m_Type;
+	}
+
+
 	DataSourceDirectory::DataSourceDirectory(Foundation::IPlatform* inPlatform, const ConfigFile& inConfigFile)
 		: DataSourceTList<DirectoryEntry>()
 		, m_Platform(inPlatform)
 		, m_ConfigFile(inConfigFile)
 		, m_HasFileSelection(false)
-		, m_SelectedFileIndex(0)
+		, m_CancelScan(false)
+		, m_IsScanning(false)
+		, m_IsScanDone(false)
 	{
+		m_ScanMutex = inPlatform->CreateMutex();
+
+		if (GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Disk.MetadataCache", 1) != 0)
+			m_MetadataCache = std::make_unique<DirectoryMetadataCache>(inPlatform->Storage_GetConfigHomePath() + "directory_cache.txt");
+
 		const unsigned int drives_count = inPlatform->Storage_GetLogicalDrivesCount();
 		for (unsigned int i = 0; i < drives_count; ++i)
 			m_Drives.push_back({ inPlatform->Storage_GetLogicalDriveName(i), "" });
@@ -39,6 +135,12 @@ namespace Editor
 		GenerateData();
 	}
 
+
+	DataSourceDirectory::~DataSourceDirectory()
+	{
+		CancelScan();
+	}
+
 	//----------------------------------------------------------------------------------------------------------------
 
 	DataSourceDirectory::SelectResult DataSourceDirectory::Select(int inIndex)
@@ -65,7 +167,7 @@ namespace Editor
 
 			return SelectResult::SelectFolderFailed;
 		case DirectoryEntry::File:
-			m_SelectedFileIndex = inIndex;
+			m_FileSelection = entry;
 			m_HasFileSelection = true;
 
 			return SelectResult::SelectFileSucceeded;
@@ -79,24 +181,12 @@ namespace Editor
 
 	bool DataSourceDirectory::Back()
 	{
-        std::error_code error_code;
-        
-		std::string current_path_string = current_path().string();
-		if (m_Platform->Storage_SetCurrentPath(current_path().parent_path().string()))
- 		{
-			GenerateData();
+		// Put the cursor on the folder that was left, once the scan has found it
+		const path previous_path = current_path();
 
-			for (size_t i = 0; i < m_List.size(); ++i)
-			{
-				if (m_List[i].m_Type == DirectoryEntry::Folder && m_List[i].m_Path == current_path_string)
-				{
-					m_HasFileSelection = true;
-					m_SelectedFileIndex = static_cast<int>(i);
-					return true;
-				}
-			}
-
-			m_SelectedFileIndex = -1;
+		if (m_Platform->Storage_SetCurrentPath(previous_path.parent_path().string()))
+ 		{
+			GenerateData(previous_path);
 			return true;
 		}
 
@@ -113,20 +203,13 @@ namespace Editor
 	void DataSourceDirectory::ClearFileSelection()
 	{
 		m_HasFileSelection = false;
-		m_SelectedFileIndex = -1;
 	}
 
 	const DirectoryEntry& DataSourceDirectory::GetFileSelection() const
 	{
 		FOUNDATION_ASSERT(m_HasFileSelection);
-		FOUNDATION_ASSERT(m_SelectedFileIndex >= 0 && m_SelectedFileIndex < static_cast<int>(m_List.size()));
-
-		return m_List[m_SelectedFileIndex];
-	}
 
-	const int DataSourceDirectory::GetFileSelectIndex() const
-	{
-		return m_SelectedFileIndex;
+		return m_FileSelection;
 	}
 
 
@@ -134,65 +217,223 @@ namespace Editor
 
 	void DataSourceDirectory::GenerateData()
 	{
+		GenerateData(path());
+	}
+
+
+	void DataSourceDirectory::GenerateData(const path& inFocusPath)
+	{
+		CancelScan();
+
+		m_FocusPath = inFocusPath;
+
 		// Clear the list (data)
 		m_List.clear();
 
 		// Add drives to the list
 		for (const Drive& drive_name : m_Drives)
-			m_List.push_back({ DirectoryEntry::Drive, path(drive_name.m_Path), drive_name.m_Alias });
+			m_List.push_back({ DirectoryEntry::Drive, path(drive_name.m_Path), drive_name.m_Alias, "" });
 
 		// Add back
 		fs::path current_path = fs::current_path();
 
 		const bool is_root = current_path.parent_path() == current_path;
 		if(!is_root)
-			m_List.push_back({ DirectoryEntry::Back, ".." });
+			m_List.push_back({ DirectoryEntry::Back, "..", "", "" });
+
+		std::sort(m_List.begin(), m_List.end(), IsEntryBefore);
 
-		// Iterate entries in current directory and add folder to the list and cache files for adding afterward
-		directory_iterator directory_iterator(current_path);
-		std::vector<path> files;
-		for (auto& path : directory_iterator)
+		// Find the entries of the directory in the background
+		m_ScannedEntries.clear();
+		m_ScannedInfos.clear();
+		m_IsScanDone = false;
+
+		m_CancelScan = false;
+		m_IsScanning = true;
+		m_ScanThread = m_Platform->CreateThread("SF2 Directory Scan", [this, current_path]() { ScanThread(current_path); });
+	}
+
+
+	bool DataSourceDirectory::UpdateScan()
+	{
+		if (!m_IsScanning)
+			return false;
+
+		std::vector<DirectoryEntry> entries;
+		std::vector<DirectoryEntry> infos;
+
+		m_ScanMutex->Lock();
+		entries.swap(m_ScannedEntries);
+		infos.swap(m_ScannedInfos);
+		const bool is_scan_done = m_IsScanDone;
+		m_ScanMutex->Unlock();
+
+		if (is_scan_done)
 		{
-            if(!m_Platform->Storage_IsSystemFile(path.path().string()))
-            {
-                std::error_code error_code;
-                if (is_directory(path, error_code))
-                    m_List.push_back({ DirectoryEntry::Folder, path });
-				else if (is_regular_file(path, error_code))
-					files.push_back(path);
+			m_ScanThread->Join();
+			m_ScanThread = nullptr;
+			m_IsScanning = false;
+		}
+
+		if (entries.empty() && infos.empty())
+			return false;
+
+		if (!entries.empty())
+		{
+			// Sort the new entries, and merge them into the list, which is already sorted
+			std::sort(entries.begin(), entries.end(), IsEntryBefore);
+
+			const size_t list_size = m_List.size();
+			m_List.insert(m_List.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+			std::inplace_merge(m_List.begin(), m_List.begin() + list_size, m_List.end(), IsEntryBefore);
+		}
+
+		if (!infos.empty())
+		{
+			std::unordered_map<std::string, size_t> file_indices;
+
+			for (size_t i = 0; i < m_List.size(); ++i)
+			{
+				if (m_List[i].m_Type == DirectoryEntry::File)
+					file_indices[m_List[i].m_Path.string()] = i;
 			}
+
+			for (const DirectoryEntry& info : infos)
+			{
+				auto it = file_indices.find(info.m_Path.string());
+
+				if (it != file_indices.end())
+					m_List[it->second].m_Info = info.m_Info;
+			}
+		}
+
+		return true;
+	}
+
+
+	bool DataSourceDirectory::IsScanning() const
+	{
+		return m_IsScanning;
+	}
+
+
+	int DataSourceDirectory::GetFocusIndex() const
+	{
+		return m_FocusPath.empty() ? -1 : FindEntry(m_FocusPath);
+	}
+
+
+	int DataSourceDirectory::FindEntry(const path& inPath) const
+	{
+		for (size_t i = 0; i < m_List.size(); ++i)
+		{
+			if (m_List[i].m_Path == inPath)
+				return static_cast<int>(i);
 		}
 
-		for (auto& file : files)
-			m_List.push_back({ DirectoryEntry::File, file });
+		return -1;
+	}
 
-		// Sort the list
-		std::sort(m_List.begin(), m_List.end(), [](const DirectoryEntry& inEntry1, const DirectoryEntry& inEntry2)
+	//----------------------------------------------------------------------------------------------------------------
+
+	void DataSourceDirectory::CancelScan()
+	{
+		if (m_ScanThread != nullptr)
+		{
+			m_CancelScan = true;
+			m_ScanThread->Join();
+			m_ScanThread = nullptr;
+		}
+
+		m_IsScanning = false;
+	}
+
+
+	void DataSourceDirectory::ScanThread(const path& inPath)
+	{
+		std::vector<DirectoryEntry> entries;
+		std::vector<path> info_files;
+
+		auto hand_over = [&](std::vector<DirectoryEntry>& inEntries, std::vector<DirectoryEntry>& outScannedEntries)
+		{
+			m_ScanMutex->Lock();
+			outScannedEntries.insert(outScannedEntries.end(), std::make_move_iterator(inEntries.begin()), std::make_move_iterator(inEntries.end()));
+			m_ScanMutex->Unlock();
+
+			inEntries.clear();
+		};
+
+		// Iterate entries in the directory and hand them over in batches, so that the list fills while the scan goes on
+		std::error_code error_code;
+
+		for (directory_iterator it(inPath, error_code); !error_code && it != directory_iterator() && !m_CancelScan; it.increment(error_code))
+		{
+			const path& entry_path = it->path();
+
+			if (m_Platform->Storage_IsSystemFile(entry_path.string()))
+				continue;
+
+			std::error_code type_error_code;
+
+			if (is_directory(entry_path, type_error_code))
+				entries.push_back({ DirectoryEntry::Folder, entry_path, "", "" });
+			else if (is_regular_file(entry_path, type_error_code))
 			{
-				// If the types are the same, lets check the filenames against eachother (and ignore case .. which means a transformation per comparasin, not fast.. but who cares! This is disk operation stuff)
-				if (inEntry1.m_Type == inEntry2.m_Type)
+				entries.push_back({ DirectoryEntry::File, entry_path, "", "" });
+
+				if (HasFileInfo(entry_path))
+					info_files.push_back(entry_path);
+			}
+
+			if (entries.size() >= ScanBatchSize)
+				hand_over(entries, m_ScannedEntries);
+		}
+
+		hand_over(entries, m_ScannedEntries);
+
+		// Read the info of the files afterwards, as it takes much longer than listing them. Files seen before are looked up in the cache.
+		if (m_MetadataCache != nullptr)
+			m_MetadataCache->Load();
+
+		for (const path& file : info_files)
+		{
+			if (m_CancelScan)
+				break;
+
+			std::string info;
+
+			if (m_MetadataCache != nullptr)
+			{
+				std::error_code stat_error_code;
+
+				const unsigned long long size = static_cast<unsigned long long>(file_size(file, stat_error_code));
+				const long long modified_time = static_cast<long long>(last_write_time(file, stat_error_code).time_since_epoch().count());
+
+				if (!m_MetadataCache->Find(file.string(), size, modified_time, info))
 				{
-					if (!(inEntry1.m_DisplayName.empty() ^ inEntry2.m_DisplayName.empty()))
-					{
-						std::string name1 = inEntry1.m_DisplayName.empty() ? inEntry1.m_Path.string() : inEntry1.m_DisplayName;
-						std::string name2 = inEntry2.m_DisplayName.empty() ? inEntry2.m_Path.string() : inEntry2.m_DisplayName;
-
-						std::transform(name1.begin(), name1.end(), name1.begin(),
-							[](char c) { return std::tolower(c); });
-						std::transform(name2.begin(), name2.end(), name2.begin(),
-							[](char c) { return std::tolower(c); });
-
-						return name1 < name2;
-					}
-					else
-					{
-						// If inEntry2 is not using the display name, entry 1 is and vice versa!
-						return inEntry2.m_DisplayName.empty();
-					}
+					info = ReadFileInfo(file);
+					m_MetadataCache->Add(file.string(), size, modified_time, info);
 				}
+			}
+			else
+				info = ReadFileInfo(file);
+
+			if (!info.empty())
+			{
+				entries.push_back({ DirectoryEntry::File, file, "", info });
+
+				if (entries.size() >= ScanBatchSize)
+					hand_over(entries, m_ScannedInfos);
+			}
+		}
+
+		hand_over(entries, m_ScannedInfos);
+
+		if (m_MetadataCache != nullptr)
+			m_MetadataCache->Save();
 
-				// Otherwise just prefer one type over the other
-				return inEntry1.m_Type < inEntry2.m_Type;
-			});
+		m_ScanMutex->Lock();
+		m_IsScanDone = true;
+		m_ScanMutex->Unlock();
 	}
 }
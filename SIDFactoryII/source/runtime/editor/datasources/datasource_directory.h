@@ -2,6 +2,8 @@
 
 #include "datasource_tlist.h"
 #include "libraries/ghc/fs_std.h"
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -13,6 +15,8 @@ namespace Utility
 namespace Foundation
 {
     class IPlatform;
+	class IMutex;
+	class IThread;
 }
 
 namespace Editor
@@ -30,8 +34,11 @@ namespace Editor
 		Type m_Type;
         fs::path m_Path;
 		std::string m_DisplayName;
+		std::string m_Info;				// Song title and author, or driver name, of the files that have it
 	};
 
+	class DirectoryMetadataCache;
+
 	class DataSourceDirectory : public DataSourceTList<DirectoryEntry>
 	{
 	public:
@@ -46,6 +53,7 @@ namespace Editor
 		};
 
 		DataSourceDirectory(Foundation::IPlatform* inPlatform, const Utility::ConfigFile& inConfigFile);
+		~DataSourceDirectory();
 
 		SelectResult Select(int inIndex);
 		bool Back();
@@ -53,9 +61,19 @@ namespace Editor
 		bool HasFileSelection() const;
 		void ClearFileSelection();
 		const DirectoryEntry& GetFileSelection() const;
-		const int GetFileSelectIndex() const;
 
+		// Starts scanning the current directory on a background thread. The list holds the drives right away, and the entries of the
+		// directory are added by UpdateScan, as they are found. The focus path is the entry the cursor should go to, once it has been found.
 		void GenerateData();
+		void GenerateData(const fs::path& inFocusPath);
+
+		// Adds the entries found by the scan since the last call to the list. Returns true, if the list has changed.
+		bool UpdateScan();
+		bool IsScanning() const;
+
+		int GetFocusIndex() const;
+		int FindEntry(const fs::path& inPath) const;
+
 	private:
 
 		struct Drive
@@ -67,9 +85,25 @@ namespace Editor
         Foundation::IPlatform* m_Platform;
 		const Utility::ConfigFile& m_ConfigFile;
 
+		void CancelScan();
+		void ScanThread(const fs::path& inPath);
+
 		std::vector<Drive> m_Drives;
 
 		bool m_HasFileSelection;
-		int m_SelectedFileIndex;
+		DirectoryEntry m_FileSelection;
+		fs::path m_FocusPath;
+
+		// Scan thread, and the results it has not handed over yet
+		std::shared_ptr<Foundation::IThread> m_ScanThread;
+		std::atomic<bool> m_CancelScan;
+		bool m_IsScanning;
+
+		std::shared_ptr<Foundation::IMutex> m_ScanMutex;
+		std::vector<DirectoryEntry> m_ScannedEntries;
+		std::vector<DirectoryEntry> m_ScannedInfos;
+		bool m_IsScanDone;
+
+		std::unique_ptr<DirectoryMetadataCache> m_MetadataCache;		// Only used by the scan thread
 	};
 }
@@ -1,4 +1,5 @@
 #include "datasource_orderlist.h"
+#include "runtime/editor/driver/song_usage_index.h"
 #include "runtime/emulation/cpumemory.h"
 #include <cstring>
 #include "foundation/base/assert.h"
@@ -9,6 +10,7 @@ namespace Editor
 		: DataSourceEmulationMemory(inCPUMemory, inSourceAddress, inBlockSize)
 		, m_Length(0)
 		, m_PackedSize(0)
+		, m_Track(0)
 	{
 		m_Events = new Entry[MaxEntryCount];
 		m_InternalBuffer = new unsigned char[MaxEntryCount * 2 + 1];
@@ -42,10 +44,20 @@ namespace Editor
 
 		m_CPUMemory->SetData(m_SourceAddress, m_Data, m_DataSize);
 
+		if (m_SongUsageIndex != nullptr)
+			m_SongUsageIndex->UpdateOrderList(m_Track, m_Data, m_DataSize);
+
 		return true;
 	}
 
 
+	void DataSourceOrderList::SetSongUsageIndex(std::shared_ptr<SongUsageIndex> inSongUsageIndex, unsigned int inTrack)
+	{
+		m_SongUsageIndex = inSongUsageIndex;
+		m_Track = inTrack;
+	}
+
+
 	unsigned int DataSourceOrderList::GetPackedSize() const
 	{
 		return m_PackedSize;
@@ -241,6 +253,9 @@ namespace Editor
 		m_CPUMemory->GetData(m_SourceAddress, m_Data, m_DataSize);
 		m_CPUMemory->Unlock();
 
+		if (m_SongUsageIndex != nullptr)
+			m_SongUsageIndex->UpdateOrderList(m_Track, m_Data, m_DataSize);
+
 		ClearEntries();
 		Unpack();
 	}
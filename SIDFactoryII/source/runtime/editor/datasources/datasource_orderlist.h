@@ -12,6 +12,8 @@ namespace Emulation
 
 namespace Editor
 {
+	class SongUsageIndex;
+
 	class DataSourceOrderList : public DataSourceEmulationMemory
 	{
 	public:
@@ -56,6 +58,9 @@ namespace Editor
 		bool PushDataToSource() override;
 		void PullDataFromSource() override;
 
+		// Keeps the usage of sequences by the order list up to date in the index, whenever the order list is pushed to or pulled from the memory
+		void SetSongUsageIndex(std::shared_ptr<SongUsageIndex> inSongUsageIndex, unsigned int inTrack);
+
 		unsigned int GetPackedSize() const;
 		unsigned int GetLength() const;
 
@@ -82,5 +87,8 @@ namespace Editor
 		Entry* m_Events;
 		unsigned char* m_InternalBuffer;
 		unsigned int m_PackedSize;
+
+		std::shared_ptr<SongUsageIndex> m_SongUsageIndex;
+		unsigned int m_Track;
 	};
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "runtime/emulation/cpumemory.h"
 #include "runtime/editor/driver/driver_info.h"
 #include "runtime/editor/driver/driver_state.h"
+#include "runtime/editor/driver/song_usage_index.h"
+#include <algorithm>
 #include <cstring>
 #include "foundation/base/assert.h"
 
@@ -9,6 +11,9 @@ namespace Editor
 {
     const unsigned int DataSourceSequence::MaxEventCount = 1024;
 
+	// A note packs to at most four bytes (command, instrument, duration and note), with the end mark after the last one
+	static const unsigned int PackBufferSize = DataSourceSequence::MaxEventCount * 4 + 1;
+
 	DataSourceSequence::DataSourceSequence(
 		Emulation::CPUMemory* inCPUMemory,
 		const Editor::DriverInfo& inDriverInfo,
@@ -23,10 +28,18 @@ namespace Editor
 		, m_SequenceIndex(inSequenceIndex)
 		, m_Length(0)
 		, m_PackedSize(0)
+		, m_PackedEventCount(0)
+		, m_EditedBegin(0)
+		, m_EditedEnd(MaxEventCount)
 		, m_PackingErrorState(false)
 	{
 		m_Events = new Event[MaxEventCount];
-		m_InternalBuffer = new unsigned char[MaxEventCount * 3];
+		m_InternalBuffer = new unsigned char[PackBufferSize];
+		m_PackedEvents = new Event[MaxEventCount];
+		m_RepackBuffer = new unsigned char[PackBufferSize];
+
+		// Nothing has been packed yet, so there is only the end mark
+		m_PackedRuns.push_back({ 0, 0, 0, 0 });
 
 		ClearEvents();
 
@@ -40,10 +53,19 @@ namespace Editor
 		, m_SequenceIndex(inOther.m_SequenceIndex)
 		, m_Length(inOther.m_Length)
 		, m_PackedSize(inOther.m_PackedSize)
+		, m_PackedEventCount(0)
+		, m_EditedBegin(0)
+		, m_EditedEnd(MaxEventCount)
+		, m_DataRuns(inOther.m_DataRuns)
 		, m_PackingErrorState(inOther.m_PackingErrorState)
+		, m_SongUsageIndex(inOther.m_SongUsageIndex)
 	{
 		m_Events = new Event[MaxEventCount];
-		m_InternalBuffer = new unsigned char[MaxEventCount * 3];
+		m_InternalBuffer = new unsigned char[PackBufferSize];
+		m_PackedEvents = new Event[MaxEventCount];
+		m_RepackBuffer = new unsigned char[PackBufferSize];
+
+		m_PackedRuns.push_back({ 0, 0, 0, 0 });
 
 		for (int i = 0; i < MaxEventCount; ++i)
 			m_Events[i] = inOther.m_Events[i];
@@ -53,6 +75,8 @@ namespace Editor
 	{
 		delete[] m_Events;
 		delete[] m_InternalBuffer;
+		delete[] m_PackedEvents;
+		delete[] m_RepackBuffer;
 	}
 
 	//------------------------------------------------------------------------------------------------------------------
@@ -63,6 +87,8 @@ namespace Editor
 			m_Events[i] = inRhs.m_Events[i];
 
 		m_Length = inRhs.m_Length;
+
+		MarkEdited(0, MaxEventCount);
 	}
 
 	DataSourceSequence::Event& DataSourceSequence::operator[](int inIndex)
@@ -70,6 +96,8 @@ namespace Editor
 		FOUNDATION_ASSERT(inIndex >= 0);
 		FOUNDATION_ASSERT(inIndex < MaxEventCount);
 
+		MarkEdited(inIndex, inIndex + 1);
+
 		return m_Events[inIndex];
 	}
 
@@ -131,6 +159,10 @@ namespace Editor
 		if(may_push_sequence_data)
 		{
 			m_CPUMemory->SetData(m_SourceAddress, m_Data, m_DataSize);
+
+			if (m_SongUsageIndex != nullptr)
+				m_SongUsageIndex->UpdateSequence(m_SequenceIndex, m_Data, m_DataSize);
+
 			return true;
 		}
 
@@ -138,6 +170,12 @@ namespace Editor
 	}
 
 
+	void DataSourceSequence::SetSongUsageIndex(std::shared_ptr<SongUsageIndex> inSongUsageIndex)
+	{
+		m_SongUsageIndex = inSongUsageIndex;
+	}
+
+
 	unsigned int DataSourceSequence::GetPackedSize() const
 	{
 		return m_PackedSize;
@@ -166,6 +204,9 @@ namespace Editor
 		m_CPUMemory->GetData(m_SourceAddress, m_Data, m_DataSize);
 		m_CPUMemory->Unlock();
 
+		if (m_SongUsageIndex != nullptr)
+			m_SongUsageIndex->UpdateSequence(m_SequenceIndex, m_Data, m_DataSize);
+
 		ClearEvents();
 		Unpack();
 	}
@@ -178,6 +219,15 @@ namespace Editor
 
 		for (int i = 0; i < MaxEventCount; ++i)
 			m_Events[i].Clear();
+
+		MarkEdited(0, MaxEventCount);
+	}
+
+
+	void DataSourceSequence::MarkEdited(unsigned int inBegin, unsigned int inEnd)
+	{
+		m_EditedBegin = std::min(m_EditedBegin, inBegin);
+		m_EditedEnd = std::max(m_EditedEnd, inEnd);
 	}
 
 	//------------------------------------------------------------------------------------------------------------------
@@ -201,13 +251,18 @@ namespace Editor
 		int event_index = 0;
 		int duration = 0;
 		bool tie_note = false;
+		unsigned char last_instrument = 0;
+
+		m_DataRuns.clear();
 
 		for (int i = 0; i < 0x100;)
 		{
+			const PackedRun data_run = { static_cast<unsigned int>(event_index), static_cast<unsigned int>(i), 0, last_instrument };
 			unsigned char value = m_Data[i++];
 
 			if (value == 0x7f)
 			{
+				m_DataRuns.push_back(data_run);
 				m_PackedSize = i;
 				break;
 			}
@@ -227,6 +282,7 @@ namespace Editor
 			{
 				m_Events[event_index].m_Instrument = value;
 				m_LastInstrumentSet = value & 0x1f;
+				last_instrument = value;
 				value = m_Data[i++];
 
 				FOUNDATION_ASSERT(i < 0x100);
@@ -252,6 +308,9 @@ namespace Editor
 
 			m_Events[event_index++].m_Note = value;
 
+			m_DataRuns.push_back(data_run);
+			m_DataRuns.back().m_Duration = static_cast<unsigned char>(duration);
+
 			for (int j = 0; j < duration; ++j)
 			{
 				m_Events[event_index].m_Command = 0x80;
@@ -281,96 +340,211 @@ namespace Editor
 
 	DataSourceSequence::PackResult DataSourceSequence::Pack()
 	{
+		// Find the range of events that differ from the events that were packed the last time. Only the events that may have been edited
+		// are compared, along with the ones added or removed by a change of length.
+		const unsigned int common_length = std::min(m_Length, m_PackedEventCount);
+
+		unsigned int change_begin = std::min(m_EditedBegin, common_length);
+		unsigned int change_end = m_Length != m_PackedEventCount ? std::max(m_Length, m_PackedEventCount) : std::min(m_EditedEnd, common_length);
+
+		while (change_begin < change_end && change_begin < common_length && !(m_Events[change_begin] != m_PackedEvents[change_begin]))
+			++change_begin;
+
+		if (m_Length == m_PackedEventCount)
+		{
+			while (change_end > change_begin && !(m_Events[change_end - 1] != m_PackedEvents[change_end - 1]))
+				--change_end;
+		}
+
+		m_EditedBegin = MaxEventCount;
+		m_EditedEnd = 0;
+
+		if (change_begin < change_end)
+			RepackEvents(change_begin, change_end);
+
+		// Commands and instruments are only set on the first event of a note
 		m_LastCommandSet = 0xff;
 		m_LastInstrumentSet = 0xff;
 
-		int packIndex = 0;
-		int lastDuration = -1;
+		for (size_t i = m_PackedRuns.size() - 1; i > 0 && (m_LastCommandSet == 0xff || m_LastInstrumentSet == 0xff); --i)
+		{
+			const Event& event = m_Events[m_PackedRuns[i - 1].m_EventIndex];
+
+			if (m_LastCommandSet == 0xff && event.m_Command != 0x80)
+				m_LastCommandSet = event.m_Command & 0x3f;
+			if (m_LastInstrumentSet == 0xff && event.m_Instrument >= 0xa0)
+				m_LastInstrumentSet = event.m_Instrument & 0x1f;
+		}
+
+		const unsigned int packed_size = m_PackedRuns.back().m_Offset;
+		m_PackingErrorState = !(packed_size > 0 && packed_size < 0xff);
+
+		if(!m_PackingErrorState)
+		{
+			// Insert end mark
+			m_InternalBuffer[packed_size] = 0x7f;
+
+			return PackResult(m_InternalBuffer, packed_size + 1);
+		}
+
+		return PackResult();
+	}
+
 
-		for (unsigned int i = 0; i < m_Length; ++i)
+	void DataSourceSequence::RepackEvents(unsigned int inChangeBegin, unsigned int inChangeEnd)
+	{
+		// Packing starts again at the note holding the first changed event. If the event is the first of its note, the note before it
+		// may now last over it, so packing starts at that note instead.
+		const auto last_run = m_PackedRuns.end() - 1;
+		auto restart_run = std::upper_bound(m_PackedRuns.begin(), last_run, inChangeBegin, [](unsigned int inEventIndex, const PackedRun& inRun)
 		{
-			unsigned char instrument = m_Events[i].m_Instrument;
-			unsigned char command = m_Events[i].m_Command;
-			unsigned char note = m_Events[i].m_Note;
+			return inEventIndex < inRun.m_EventIndex;
+		});
+
+		if (restart_run != m_PackedRuns.begin())
+			--restart_run;
+		if (restart_run != m_PackedRuns.begin() && restart_run->m_EventIndex == inChangeBegin)
+			--restart_run;
 
-			// Look for next event
-			int duration = 0;
+		const size_t restart_index = restart_run - m_PackedRuns.begin();
+		const unsigned int restart_offset = restart_run->m_Offset;
 
-			for (unsigned int j = i + 1; j < m_Length; ++j)
+		unsigned int event_index = restart_run->m_EventIndex;
+		unsigned int offset = 0;
+		int last_duration = restart_index > 0 ? m_PackedRuns[restart_index - 1].m_Duration : -1;
+		unsigned char instrument = restart_run->m_InstrumentBefore;
+
+		// Pack notes until one starts after the changed events at the same event as a note packed before, with the same duration before
+		// it. From there on, the notes pack to the exact same data as before.
+		size_t resume_index = restart_index + 1;
+		bool is_resumed = false;
+
+		m_RepackRuns.clear();
+
+		while (event_index < m_Length)
+		{
+			if (event_index >= inChangeEnd)
 			{
-				if (m_Events[j].m_Instrument != 0x80 || m_Events[j].m_Command != 0x80)
-					break;
+				while (resume_index < m_PackedRuns.size() - 1 && m_PackedRuns[resume_index].m_EventIndex < event_index)
+					++resume_index;
 
-				if (note == 0)
+				if (resume_index < m_PackedRuns.size() - 1 && m_PackedRuns[resume_index].m_EventIndex == event_index && m_PackedRuns[resume_index - 1].m_Duration == last_duration)
 				{
-					if (m_Events[j].m_Note != 0)
-						break;
-				}
-				else
-				{
-					if (m_Events[j].m_Note != 0x7e)
-						break;
+					is_resumed = true;
+					break;
 				}
+			}
 
-				duration++;
+			PackedRun run = { event_index, restart_offset + offset, 0, instrument };
+			run.m_Duration = static_cast<unsigned char>(PackRun(event_index, m_RepackBuffer, offset, last_duration));
+			m_RepackRuns.push_back(run);
 
-				if (duration >= 0x0f)
-					break;
-			}
+			if (m_Events[event_index].m_Instrument >= 0xa0)
+				instrument = m_Events[event_index].m_Instrument;
+
+			event_index += run.m_Duration + 1;
+		}
 
-			bool bTieNote = (instrument == 0x90);
+		// Move the notes after the packed ones into place, and put the packed ones in front of them
+		const unsigned int end_offset = m_PackedRuns.back().m_Offset;
+		const unsigned int resume_offset = is_resumed ? m_PackedRuns[resume_index].m_Offset : end_offset;
+		const int shift = static_cast<int>(restart_offset + offset) - static_cast<int>(resume_offset);
 
-			if (command != 0x80)
-			{
-				m_InternalBuffer[packIndex++] = command;
-				m_LastCommandSet = command & 0x3f;
-			}
-			if (instrument >= 0xa0)
-			{
-				m_InternalBuffer[packIndex++] = instrument;
-				m_LastInstrumentSet = instrument & 0x1f;
-			}
+		FOUNDATION_ASSERT(static_cast<int>(end_offset) + shift < static_cast<int>(PackBufferSize));
+
+		memmove(&m_InternalBuffer[restart_offset + offset], &m_InternalBuffer[resume_offset], end_offset - resume_offset);
+		memcpy(&m_InternalBuffer[restart_offset], m_RepackBuffer, offset);
 
-			if (lastDuration != duration || bTieNote)
+		if (is_resumed)
+		{
+			for (size_t i = resume_index; i < m_PackedRuns.size(); ++i)
 			{
-				m_InternalBuffer[packIndex++] = static_cast<unsigned char>((duration | 0x80) | (bTieNote ? 0x10 : 0x00));
-				lastDuration = duration;
-			}
+				PackedRun& run = m_PackedRuns[i];
+
+				run.m_Offset = static_cast<unsigned int>(static_cast<int>(run.m_Offset) + shift);
+				run.m_InstrumentBefore = instrument;
 
-			m_InternalBuffer[packIndex++] = note;
+				if (i < m_PackedRuns.size() - 1 && m_Events[run.m_EventIndex].m_Instrument >= 0xa0)
+					instrument = m_Events[run.m_EventIndex].m_Instrument;
+			}
 
-			i += duration;
+			m_PackedRuns.erase(m_PackedRuns.begin() + restart_index, m_PackedRuns.begin() + resume_index);
+		}
+		else
+		{
+			m_PackedRuns.resize(restart_index);
+			m_PackedRuns.push_back({ m_Length, restart_offset + offset, 0, instrument });
 		}
 
-		// Create a buffer of the exact size of the packed data and copy the data into it
-		m_PackingErrorState = !(packIndex > 0 && packIndex < 0xff);
+		m_PackedRuns.insert(m_PackedRuns.begin() + restart_index, m_RepackRuns.begin(), m_RepackRuns.end());
 
-		if(!m_PackingErrorState)
+		// Remember the events as they are packed now
+		for (unsigned int i = inChangeBegin; i < std::min(inChangeEnd, m_Length); ++i)
+			m_PackedEvents[i] = m_Events[i];
+
+		m_PackedEventCount = m_Length;
+	}
+
+
+	int DataSourceSequence::PackRun(unsigned int inEventIndex, unsigned char* outBuffer, unsigned int& ioOffset, int& ioLastDuration) const
+	{
+		unsigned char instrument = m_Events[inEventIndex].m_Instrument;
+		unsigned char command = m_Events[inEventIndex].m_Command;
+		unsigned char note = m_Events[inEventIndex].m_Note;
+
+		// Look for next event
+		int duration = 0;
+
+		for (unsigned int j = inEventIndex + 1; j < m_Length; ++j)
 		{
-			// Insert end mark
-			m_InternalBuffer[packIndex++] = 0x7f;
+			if (m_Events[j].m_Instrument != 0x80 || m_Events[j].m_Command != 0x80)
+				break;
+
+			if (note == 0)
+			{
+				if (m_Events[j].m_Note != 0)
+					break;
+			}
+			else
+			{
+				if (m_Events[j].m_Note != 0x7e)
+					break;
+			}
+
+			duration++;
 
-			unsigned char* packed_data = new unsigned char[packIndex];
+			if (duration >= 0x0f)
+				break;
+		}
 
-			for (int i = 0; i < packIndex; i++)
-				packed_data[i] = m_InternalBuffer[i];
+		bool bTieNote = (instrument == 0x90);
 
-			m_PackingErrorState = false;
+		if (command != 0x80)
+			outBuffer[ioOffset++] = command;
+		if (instrument >= 0xa0)
+			outBuffer[ioOffset++] = instrument;
 
-			return PackResult(packed_data, packIndex);
+		if (ioLastDuration != duration || bTieNote)
+		{
+			outBuffer[ioOffset++] = static_cast<unsigned char>((duration | 0x80) | (bTieNote ? 0x10 : 0x00));
+			ioLastDuration = duration;
 		}
 
-		return PackResult();
+		outBuffer[ioOffset++] = note;
+
+		return duration;
 	}
 
 	void DataSourceSequence::SendPackedDataToBuffer(const PackResult& inPackResult)
 	{
 		FOUNDATION_ASSERT(inPackResult.m_DataLength <= m_DataSize);
+		FOUNDATION_ASSERT(inPackResult.m_Data == m_InternalBuffer);
 
 		memset(m_Data, 0, m_DataSize);
-		memcpy(m_Data, &*inPackResult.m_Data, inPackResult.m_DataLength);
+		memcpy(m_Data, inPackResult.m_Data, inPackResult.m_DataLength);
 
 		m_PackedSize = inPackResult.m_DataLength;
+		m_DataRuns = m_PackedRuns;
 	}
 
 
@@ -383,30 +557,18 @@ namespace Editor
 
 	DataSourceSequence::PackedDataEventPosition DataSourceSequence::GetEventPositionInPackedData(int inEventPosition) const
 	{
-		int event_position = 0;
-		int index = 0;
-		unsigned char current_delta_tick = 0;
-		unsigned char next_instrument = 0;
-
-		while (index < static_cast<int>(m_PackedSize))
+		// The first note starting at or after the event, or the end mark if none does
+		const auto data_run = std::lower_bound(m_DataRuns.begin(), m_DataRuns.end(), inEventPosition, [](const PackedRun& inRun, int inEventPosition)
 		{
-			if (event_position >= inEventPosition)
-				return { true, static_cast<unsigned char>(index), static_cast<unsigned char>(event_position - inEventPosition), current_delta_tick, next_instrument, m_Data[index] == 0x7f };
-
-			while (m_Data[index] >= 0x80)
-			{
-				if (m_Data[index] < 0xa0)
-					current_delta_tick = m_Data[index] & 0x0f;
-				else if (m_Data[index] < 0xc0)
-					next_instrument = m_Data[index];
+			return static_cast<int>(inRun.m_EventIndex) < inEventPosition;
+		});
 
-				++index;
-			}
+		if (data_run == m_DataRuns.end())
+			return { false, 0, 0, 0, 0, false };
 
-			event_position += (current_delta_tick + 1);
-			++index;
-		}
+		const unsigned char current_delta_tick = data_run != m_DataRuns.begin() ? (data_run - 1)->m_Duration : 0;
+		const bool is_end_of_sequence = data_run + 1 == m_DataRuns.end();
 
-		return { false, 0, 0, 0, 0, false };
+		return { true, static_cast<unsigned char>(data_run->m_Offset), static_cast<unsigned char>(data_run->m_EventIndex - inEventPosition), current_delta_tick, data_run->m_InstrumentBefore, is_end_of_sequence };
 	}
 }
@@ -4,6 +4,7 @@
 #include "datasource_emulation_memory.h"
 
 #include <memory>
+#include <vector>
 
 namespace Emulation
 {
@@ -14,6 +15,7 @@ namespace Editor
 {
 	class DriverInfo;
 	class DriverState;
+	class SongUsageIndex;
 
 	class DataSourceSequence : public DataSourceEmulationMemory
 	{
@@ -33,6 +35,11 @@ namespace Editor
 				m_Note = inRhs.m_Note;
 			}
 
+			bool operator!=(const Event& inRhs) const
+			{
+				return m_Instrument != inRhs.m_Instrument || m_Command != inRhs.m_Command || m_Note != inRhs.m_Note;
+			}
+
 			void Clear()
 			{
 				m_Instrument = 0x80;
@@ -59,13 +66,14 @@ namespace Editor
 			{
 			}
 
-			PackResult(unsigned char* inData, int inDataLength)
+			PackResult(const unsigned char* inData, int inDataLength)
 				: m_Data(inData)
 				, m_DataLength(inDataLength)
 			{
 			}
 
-			std::shared_ptr<unsigned char> m_Data;
+			// Points into the packing buffer of the sequence, and is only valid until the sequence is packed again
+			const unsigned char* m_Data;
 			int m_DataLength;
 		};
 
@@ -87,6 +95,9 @@ namespace Editor
 		bool PushDataToSource() override;
 		void PullDataFromSource() override;
 
+		// Keeps the usage of instruments and commands by the sequence up to date in the index, whenever the sequence is pushed to or pulled from the memory
+		void SetSongUsageIndex(std::shared_ptr<SongUsageIndex> inSongUsageIndex);
+
 		unsigned int GetPackedSize() const;
 		unsigned int GetLength() const;
 		void SetLength(unsigned int inLength);
@@ -94,6 +105,9 @@ namespace Editor
 		unsigned char GetLastInstrumentSet() const;
 		unsigned char GetLastCommandSet() const;
 
+		// Packs the events into the format of the driver. Only the notes around the events that have changed since the last time the
+		// sequence was packed are packed again; the rest of the packed data is moved into place as it is. Events are taken to be edited
+		// when they are accessed through the non-const index operator, or when the length changes.
 		PackResult Pack();
 		void SendPackedDataToBuffer(const PackResult& inPackResult);
 		bool IsInErrorState() const;
@@ -102,9 +116,21 @@ namespace Editor
 
 		void ClearEvents();
 	private:
+		// A note in the packed data, which lasts for the duration of events following the first one
+		struct PackedRun
+		{
+			unsigned int m_EventIndex;
+			unsigned int m_Offset;
+			unsigned char m_Duration;
+			unsigned char m_InstrumentBefore;		// The last instrument set in the packed data before the note, or 0 if none is
+		};
 
 		void Unpack();
 
+		void MarkEdited(unsigned int inBegin, unsigned int inEnd);
+		void RepackEvents(unsigned int inChangeBegin, unsigned int inChangeEnd);
+		int PackRun(unsigned int inEventIndex, unsigned char* outBuffer, unsigned int& ioOffset, int& ioLastDuration) const;
+
 		const Editor::DriverInfo& m_DriverInfo;
 		const Editor::DriverState& m_DriverState;
 		const unsigned char m_SequenceIndex;
@@ -118,6 +144,25 @@ namespace Editor
 		unsigned char* m_InternalBuffer;
 		unsigned int m_PackedSize;
 
+		// The events as they were the last time the sequence was packed, and the notes they were packed to in the internal buffer. The
+		// last entry in the notes marks the end of the packed data.
+		Event* m_PackedEvents;
+		unsigned int m_PackedEventCount;
+		std::vector<PackedRun> m_PackedRuns;
+
+		// The range of events that may have been edited since the sequence was last packed
+		unsigned int m_EditedBegin;
+		unsigned int m_EditedEnd;
+
+		// The notes that are packed again, before they are moved into the internal buffer
+		unsigned char* m_RepackBuffer;
+		std::vector<PackedRun> m_RepackRuns;
+
+		// The notes in the packed data of the data buffer, for finding the packed data of an event
+		std::vector<PackedRun> m_DataRuns;
+
 		bool m_PackingErrorState;
+
+		std::shared_ptr<SongUsageIndex> m_SongUsageIndex;
 	};
 }
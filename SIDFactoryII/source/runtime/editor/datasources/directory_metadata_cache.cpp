@@ -0,0 +1,125 @@
+#include "directory_metadata_cache.h"
+#include "utils/utilities.h"
+
+#include <sstream>
+#include <stdlib.h>
+
+namespace Editor
+{
+	// When the cache grows past this, only the entries used since it was loaded are saved
+	static const size_t MaxSavedEntryCount = 16384;
+
+	DirectoryMetadataCache::DirectoryMetadataCache(const std::string& inCachePathAndFilename)
+		: m_CachePathAndFilename(inCachePathAndFilename)
+		, m_IsLoaded(false)
+		, m_HasChanges(false)
+	{
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool DirectoryMetadataCache::Load()
+	{
+		if (m_IsLoaded)
+			return true;
+
+		m_IsLoaded = true;
+
+		void* data = nullptr;
+		long data_size = 0;
+
+		if (!Utility::ReadFile(m_CachePathAndFilename, 0, &data, data_size))
+			return false;
+
+		// Each line holds the file size, the modification time, the info and the path of a file, separated by tabs. The info cannot
+		// contain tabs, so the path is the rest of the line.
+		const char* text = static_cast<const char*>(data);
+		const char* text_end = text + data_size;
+
+		while (text < text_end)
+		{
+			const char* line_end = text;
+
+			while (line_end < text_end && *line_end != '\n')
+				++line_end;
+
+			const std::string line(text, line_end);
+			text = line_end + 1;
+
+			const size_t info_begin = line.find('\t', line.find('\t') + 1) + 1;
+			const size_t path_begin = info_begin > 0 ? line.find('\t', info_begin) + 1 : 0;
+
+			if (path_begin == 0 || path_begin >= line.size())
+				continue;
+
+			Entry entry;
+
+			entry.m_FileSize = strtoull(line.c_str(), nullptr, 10);
+			entry.m_ModifiedTime = strtoll(line.c_str() + line.find('\t') + 1, nullptr, 10);
+			entry.m_Info = line.substr(info_begin, path_begin - 1 - info_begin);
+			entry.m_IsUsed = false;
+
+			m_Entries[line.substr(path_begin)] = entry;
+		}
+
+		delete[] static_cast<char*>(data);
+
+		return true;
+	}
+
+
+	bool DirectoryMetadataCache::Save()
+	{
+		if (!m_HasChanges)
+			return true;
+
+		const bool save_all = m_Entries.size() <= MaxSavedEntryCount;
+
+		std::stringstream stream;
+
+		for (const auto& entry : m_Entries)
+		{
+			if (save_all || entry.second.m_IsUsed)
+				stream << entry.second.m_FileSize << '\t' << entry.second.m_ModifiedTime << '\t' << entry.second.m_Info << '\t' << entry.first << '\n';
+		}
+
+		const std::string text = stream.str();
+
+		if (!Utility::WriteFile(m_CachePathAndFilename, text.c_str(), static_cast<long>(text.size())))
+			return false;
+
+		m_HasChanges = false;
+		return true;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool DirectoryMetadataCache::Find(const std::string& inPathAndFilename, unsigned long long inFileSize, long long inModifiedTime, std::string& outInfo)
+	{
+		auto it = m_Entries.find(inPathAndFilename);
+
+		if (it == m_Entries.end() || it->second.m_FileSize != inFileSize || it->second.m_ModifiedTime != inModifiedTime)
+			return false;
+
+		it->second.m_IsUsed = true;
+		outInfo = it->second.m_Info;
+
+		return true;
+	}
+
+
+	void DirectoryMetadataCache::Add(const std::string& inPathAndFilename, unsigned long long inFileSize, long long inModifiedTime, const std::string& inInfo)
+	{
+		// Tabs and line breaks would break the format of the cache file
+		std::string info = inInfo;
+
+		for (char& character : info)
+		{
+			if (character == '\t' || character == '\n' || character == '\r')
+				character = ' ';
+		}
+
+		m_Entries[inPathAndFilename] = { inFileSize, inModifiedTime, info, true };
+		m_HasChanges = true;
+	}
+}
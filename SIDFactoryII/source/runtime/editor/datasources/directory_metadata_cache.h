@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+namespace Editor
+{
+	// Keeps the information read from the files in the directories visited on the disk screen, so that it does not have to be
+	// read again on the next visit. An entry is only used, if the size and the modification time of the file are still the same.
+	class DirectoryMetadataCache final
+	{
+	public:
+		DirectoryMetadataCache(const std::string& inCachePathAndFilename);
+
+		bool Load();
+		bool Save();
+
+		bool Find(const std::string& inPathAndFilename, unsigned long long inFileSize, long long inModifiedTime, std::string& outInfo);
+		void Add(const std::string& inPathAndFilename, unsigned long long inFileSize, long long inModifiedTime, const std::string& inInfo);
+
+	private:
+		struct Entry
+		{
+			unsigned long long m_FileSize;
+			long long m_ModifiedTime;
+			std::string m_Info;
+			bool m_IsUsed;						// Found or added since the cache was loaded
+		};
+
+		const std::string m_CachePathAndFilename;
+
+		bool m_IsLoaded;
+		bool m_HasChanges;
+		std::unordered_map<std::string, Entry> m_Entries;
+	};
+}
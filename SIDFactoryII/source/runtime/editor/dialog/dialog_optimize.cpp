@@ -22,6 +22,8 @@ using namespace Utility;
 namespace Editor
 {
 	DialogOptimize::DialogOptimize(
+		Foundation::IPlatform* inPlatform,
+		const Emulation::SIDConfiguration& inSIDConfiguration,
 		std::vector<std::shared_ptr<DataSourceOrderList>> inOrderListDataSources,
 		std::vector<std::shared_ptr<DataSourceSequence>> inSequenceDataSources,
 		std::shared_ptr<DataSourceTable> inInstrumentTableDataSource,
@@ -31,14 +33,14 @@ namespace Editor
 		const ComponentsManager& inComponentsManager,
 		DriverInfo& inDriverInfo,
 		Emulation::CPUMemory* inCPUMemory,
-		std::function<void()> inOnDoneCallback
+		std::function<void(bool, const std::string&)> inOnDoneCallback
 	)
 		: DialogBase()
 		, m_Width(51)
-		, m_Height(24)
+		, m_Height(26)
 		, m_OnDoneCallback(inOnDoneCallback)
 	{
-		m_Optimizer = std::make_unique<Optimizer>(inCPUMemory, inDriverInfo, inOrderListDataSources, inSequenceDataSources, inInstrumentTableDataSource, inCommandTableDataSource, inInstrumentsTableID, inCommandsTableID);
+		m_Optimizer = std::make_unique<Optimizer>(inPlatform, inSIDConfiguration, inCPUMemory, inDriverInfo, inOrderListDataSources, inSequenceDataSources, inInstrumentTableDataSource, inCommandTableDataSource, inInstrumentsTableID, inCommandsTableID);
 		m_InstrumentData = InstrumentData::Create(0, inDriverInfo, inComponentsManager);
 	}
 
@@ -48,7 +50,7 @@ namespace Editor
 
 	void DialogOptimize::Cancel()
 	{
-		m_OnDoneCallback();
+		m_OnDoneCallback(false, "");
 	}
 
 
@@ -92,7 +94,11 @@ namespace Editor
 		y = PrintUsedNumbers(x, y + 1, is_uppercase, 0x40, 0x10, m_Optimizer->GetUsedCommandIndices());
 
 		m_TextField->Print({ x, y }, ToColor(UserColor::DialogText), "Sequences:");
-		PrintUsedNumbers(x, y + 1, is_uppercase, 0x80, 0x10, m_Optimizer->GetUsedSequenceIndices());
+		y = PrintUsedNumbers(x, y + 1, is_uppercase, 0x80, 0x10, m_Optimizer->GetUsedSequenceIndices());
+
+		const std::string duplicates = "Duplicates: " + std::to_string(m_Optimizer->GetMergedSequenceCount()) + " seq, " + std::to_string(m_Optimizer->GetMergedInstrumentCount()) + " instr, "
+			+ std::to_string(m_Optimizer->GetMergedCommandCount()) + " cmd, " + std::to_string(m_Optimizer->GetJoinedSequenceCount()) + " joins";
+		m_TextField->Print({ x, y }, ToColor(UserColor::DialogText), duplicates);
 	}
 
 
@@ -162,10 +168,10 @@ namespace Editor
 
 	void DialogOptimize::OnDone()
 	{
-		m_Optimizer->Execute();
+		const bool is_optimized = m_Optimizer->Execute();
 
 		m_Done = true;
-		m_OnDoneCallback();
+		m_OnDoneCallback(is_optimized, m_Optimizer->GetReport());
 	}
 
 }
@@ -2,11 +2,18 @@
 
 #include "dialog_base.h"
 #include "runtime/editor/components/component_button.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
 
 #include <memory>
 #include <functional>
+#include <string>
 #include <vector>
 
+namespace Foundation
+{
+	class IPlatform;
+}
+
 namespace Emulation
 {
 	class CPUMemory;
@@ -32,6 +39,8 @@ namespace Editor
 		};
 
 		DialogOptimize(
+			Foundation::IPlatform* inPlatform,
+			const Emulation::SIDConfiguration& inSIDConfiguration,
 			std::vector<std::shared_ptr<DataSourceOrderList>> inOrderListDataSources,
 			std::vector<std::shared_ptr<DataSourceSequence>> inSequenceDataSources,
 			std::shared_ptr<DataSourceTable> inInstrumentTableDataSource,
@@ -41,7 +50,7 @@ namespace Editor
 			const ComponentsManager& inComponentsManager,
 			DriverInfo& inDriverInfo,
 			Emulation::CPUMemory* inCPUMemory,
-			std::function<void()> inOnDoneCallback
+			std::function<void(bool, const std::string&)> inOnDoneCallback
 		);
 
 		~DialogOptimize();
@@ -65,7 +74,7 @@ namespace Editor
 
 		Foundation::TextField* m_TextField;
 
-		std::function<void()> m_OnDoneCallback;
+		std::function<void(bool, const std::string&)> m_OnDoneCallback;
 
 		std::unique_ptr<Optimizer> m_Optimizer;
 		std::shared_ptr<InstrumentData> m_InstrumentData;
@@ -14,6 +14,7 @@ namespace Editor
 			Statistics,
 			Optimize,
 			Pack,
+			RastertimeProfile,
 			ClearSequences,
 			ExpandSequences
 		};
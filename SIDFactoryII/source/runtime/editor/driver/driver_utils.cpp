@@ -325,6 +325,12 @@ namespace Editor
 
 
 		void InsertIRQ(const Editor::DriverInfo& inDriverInfo, Utility::C64FileWriter& inFileWriter)
+		{
+			InsertIRQ(inDriverInfo.GetDriverCommon(), inFileWriter);
+		}
+
+
+		void InsertIRQ(const Editor::DriverInfo::DriverCommon& inDriverCommon, Utility::C64FileWriter& inFileWriter)
 		{
 			unsigned char irq_assembly[] = {
 				0xa9, 0x00, 0x20, 0x00, 0x10, 0x78, 0xa2, 0x00,
@@ -341,8 +347,8 @@ namespace Editor
 			const unsigned short irq_vector = inFileWriter.GetWriteAddress();
 
 			// Adjust driver vectors
-			const unsigned short driver_init_vector = inDriverInfo.GetDriverCommon().m_InitAddress;
-			const unsigned short driver_update_vector = inDriverInfo.GetDriverCommon().m_UpdateAddress;
+			const unsigned short driver_init_vector = inDriverCommon.m_InitAddress;
+			const unsigned short driver_update_vector = inDriverCommon.m_UpdateAddress;
 
 			irq_assembly[0x03] = static_cast<unsigned char>(driver_init_vector & 0xff);
 			irq_assembly[0x04] = static_cast<unsigned char>(driver_init_vector >> 8);
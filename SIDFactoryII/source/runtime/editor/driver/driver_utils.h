@@ -34,5 +34,6 @@ namespace Editor
 		unsigned short GetEndOfFileAddress(const Editor::DriverInfo& inDriverInfo, const Emulation::IMemoryRandomReadAccess& inMemoryReader);
 
 		void InsertIRQ(const Editor::DriverInfo& inDriverInfo, Utility::C64FileWriter& inFileWriter);
+		void InsertIRQ(const Editor::DriverInfo::DriverCommon& inDriverCommon, Utility::C64FileWriter& inFileWriter);
 	}
 }
@@ -0,0 +1,245 @@
+#include "runtime/editor/driver/song_usage_index.h"
+#include "runtime/editor/driver/driver_info.h"
+#include "runtime/emulation/imemoryrandomreadaccess.h"
+#include "foundation/base/assert.h"
+
+namespace Editor
+{
+	SongUsageIndex::SongUsageIndex(const DriverInfo& inDriverInfo)
+		: m_DriverInfo(inDriverInfo)
+		, m_InstrumentUsageCount(InstrumentCount, 0)
+		, m_CommandUsageCount(CommandCount, 0)
+		, m_HighestSequenceIndex(0)
+		, m_HighestInstrumentIndex(0)
+		, m_HighestCommandIndex(0)
+		, m_FreeSequenceCount(0)
+	{
+		FOUNDATION_ASSERT(inDriverInfo.HasParsedHeaderBlock(DriverInfo::HeaderBlockID::ID_MusicData));
+
+		const DriverInfo::MusicData& music_data = inDriverInfo.GetMusicData();
+
+		m_Tracks.resize(music_data.m_TrackCount, { {}, 0 });
+		m_Sequences.resize(music_data.m_SequenceCount, { false, {}, {} });
+		m_SequenceUsageCount.resize(music_data.m_SequenceCount, 0);
+	}
+
+
+	SongUsageIndex::~SongUsageIndex()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+
+	void SongUsageIndex::Rebuild(const Emulation::IMemoryRandomReadAccess& inMemoryReader)
+	{
+		const DriverInfo::MusicData& music_data = m_DriverInfo.GetMusicData();
+
+		std::vector<unsigned char> data(music_data.m_OrderListSize > music_data.m_SequenceSize ? music_data.m_OrderListSize : music_data.m_SequenceSize);
+
+		for (unsigned int i = 0; i < m_Tracks.size(); ++i)
+		{
+			inMemoryReader.GetData(music_data.m_OrderListTrack1Address + i * music_data.m_OrderListSize, data.data(), music_data.m_OrderListSize);
+			UpdateOrderList(i, data.data(), music_data.m_OrderListSize);
+		}
+
+		for (unsigned int i = 0; i < m_Sequences.size(); ++i)
+		{
+			inMemoryReader.GetData(music_data.m_Sequence00Address + i * music_data.m_SequenceSize, data.data(), music_data.m_SequenceSize);
+			UpdateSequence(static_cast<unsigned char>(i), data.data(), music_data.m_SequenceSize);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+
+	void SongUsageIndex::UpdateOrderList(unsigned int inTrack, const unsigned char* inData, unsigned int inDataSize)
+	{
+		FOUNDATION_ASSERT(inTrack < m_Tracks.size());
+		FOUNDATION_ASSERT(inData != nullptr);
+
+		Track& track = m_Tracks[inTrack];
+
+		for (unsigned char sequence_index : track.m_SequenceReferences)
+			AddSequenceUsage(sequence_index, -1);
+
+		track.m_SequenceReferences.clear();
+		track.m_HighestSequenceIndex = 0;
+
+		// The highest index is looked for up to the end of the order list, while references are counted up to a $7f, as in DriverUtils
+		bool is_past_end = false;
+		bool is_past_references = false;
+
+		for (unsigned int i = 0; i < inDataSize && !(is_past_end && is_past_references); ++i)
+		{
+			const unsigned char value = inData[i];
+
+			if (value < 0x80)
+			{
+				if (!is_past_end && value > track.m_HighestSequenceIndex)
+					track.m_HighestSequenceIndex = value;
+
+				if (value == 0x7f)
+					is_past_references = true;
+				else if (!is_past_references && value < m_Sequences.size())
+					track.m_SequenceReferences.push_back(value);
+			}
+			else if (value == 0xff)
+				is_past_end = true;
+		}
+
+		for (unsigned char sequence_index : track.m_SequenceReferences)
+			AddSequenceUsage(sequence_index, 1);
+
+		m_HighestSequenceIndex = 0;
+
+		for (const Track& other_track : m_Tracks)
+		{
+			if (other_track.m_HighestSequenceIndex > m_HighestSequenceIndex)
+				m_HighestSequenceIndex = other_track.m_HighestSequenceIndex;
+		}
+	}
+
+
+	void SongUsageIndex::UpdateSequence(unsigned char inSequenceIndex, const unsigned char* inData, unsigned int inDataSize)
+	{
+		FOUNDATION_ASSERT(inSequenceIndex < m_Sequences.size());
+		FOUNDATION_ASSERT(inData != nullptr);
+
+		Sequence& sequence = m_Sequences[inSequenceIndex];
+
+		const bool was_free = IsSequenceFree(inSequenceIndex);
+
+		AddUsage(m_InstrumentUsageCount, m_HighestInstrumentIndex, sequence.m_Instruments, -1);
+		AddUsage(m_CommandUsageCount, m_HighestCommandIndex, sequence.m_Commands, -1);
+
+		sequence.m_Instruments.clear();
+		sequence.m_Commands.clear();
+		sequence.m_IsEmpty = inDataSize >= 3 && inData[0] == 0x80 && inData[1] == 0x00 && inData[2] == 0x7f;
+
+		for (unsigned int i = 0; i < inDataSize; ++i)
+		{
+			const unsigned char value = inData[i];
+
+			if (value >= 0xc0)
+				sequence.m_Commands.push_back(value & 0x3f);
+			else if (value >= 0xa0)
+				sequence.m_Instruments.push_back(value & 0x1f);
+			else if (value == 0x7f)
+				break;
+		}
+
+		AddUsage(m_InstrumentUsageCount, m_HighestInstrumentIndex, sequence.m_Instruments, 1);
+		AddUsage(m_CommandUsageCount, m_HighestCommandIndex, sequence.m_Commands, 1);
+
+		m_FreeSequenceCount += static_cast<int>(IsSequenceFree(inSequenceIndex)) - static_cast<int>(was_free);
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+
+	unsigned char SongUsageIndex::GetHighestSequenceIndexUsed() const
+	{
+		return m_HighestSequenceIndex;
+	}
+
+
+	int SongUsageIndex::GetSequenceUsageCount(unsigned char inSequenceIndex) const
+	{
+		FOUNDATION_ASSERT(inSequenceIndex < m_SequenceUsageCount.size());
+
+		return m_SequenceUsageCount[inSequenceIndex];
+	}
+
+
+	unsigned char SongUsageIndex::GetFirstUnusedSequenceIndex() const
+	{
+		for (unsigned int i = 0; i < m_SequenceUsageCount.size(); ++i)
+		{
+			if (m_SequenceUsageCount[i] == 0)
+				return static_cast<unsigned char>(i);
+		}
+
+		return 0xff;
+	}
+
+
+	unsigned char SongUsageIndex::GetFirstEmptySequenceIndex() const
+	{
+		if (m_FreeSequenceCount > 0)
+		{
+			for (unsigned int i = 0; i < m_Sequences.size(); ++i)
+			{
+				if (IsSequenceFree(static_cast<unsigned char>(i)))
+					return static_cast<unsigned char>(i);
+			}
+		}
+
+		return 0xff;
+	}
+
+
+	int SongUsageIndex::GetFreeSequenceCount() const
+	{
+		return m_FreeSequenceCount;
+	}
+
+
+	unsigned char SongUsageIndex::GetHighestInstrumentIndexUsed() const
+	{
+		return m_HighestInstrumentIndex;
+	}
+
+
+	unsigned char SongUsageIndex::GetHighestCommandIndexUsed() const
+	{
+		return m_HighestCommandIndex;
+	}
+
+
+	int SongUsageIndex::GetInstrumentUsageCount(unsigned char inInstrumentIndex) const
+	{
+		FOUNDATION_ASSERT(inInstrumentIndex < InstrumentCount);
+
+		return m_InstrumentUsageCount[inInstrumentIndex];
+	}
+
+
+	int SongUsageIndex::GetCommandUsageCount(unsigned char inCommandIndex) const
+	{
+		FOUNDATION_ASSERT(inCommandIndex < CommandCount);
+
+		return m_CommandUsageCount[inCommandIndex];
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+
+	bool SongUsageIndex::IsSequenceFree(unsigned char inSequenceIndex) const
+	{
+		return m_Sequences[inSequenceIndex].m_IsEmpty && m_SequenceUsageCount[inSequenceIndex] == 0;
+	}
+
+
+	void SongUsageIndex::AddSequenceUsage(unsigned char inSequenceIndex, int inDelta)
+	{
+		const bool was_free = IsSequenceFree(inSequenceIndex);
+
+		m_SequenceUsageCount[inSequenceIndex] += inDelta;
+		FOUNDATION_ASSERT(m_SequenceUsageCount[inSequenceIndex] >= 0);
+
+		m_FreeSequenceCount += static_cast<int>(IsSequenceFree(inSequenceIndex)) - static_cast<int>(was_free);
+	}
+
+
+	void SongUsageIndex::AddUsage(std::vector<int>& ioUsageCount, unsigned char& ioHighestIndex, const std::vector<unsigned char>& inIndices, int inDelta)
+	{
+		for (unsigned char index : inIndices)
+		{
+			ioUsageCount[index] += inDelta;
+
+			if (inDelta > 0 && index > ioHighestIndex)
+				ioHighestIndex = index;
+		}
+
+		// When the highest index is no longer used, look for the one below it. As with the scans in DriverUtils, the highest index is 0 if none are used.
+		while (ioHighestIndex > 0 && ioUsageCount[ioHighestIndex] == 0)
+			--ioHighestIndex;
+	}
+}
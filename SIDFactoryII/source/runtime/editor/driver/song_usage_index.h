@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+namespace Emulation
+{
+	class IMemoryRandomReadAccess;
+}
+
+namespace Editor
+{
+	class DriverInfo;
+
+	// Keeps count of which sequences the order lists refer to, and which instruments and commands the sequences use. It is built from the
+	// music data in memory once, and from then on the order lists and sequences update it as they are pushed to, or pulled from, the memory.
+	// Only the order list or sequence that changed is scanned, so the queries can be made as often as needed.
+	//
+	// The counts follow the rules of the scans in DriverUtils, so that the results are the same as those of the functions of the same names.
+	class SongUsageIndex final
+	{
+	public:
+		static const int InstrumentCount = 0x20;
+		static const int CommandCount = 0x40;
+
+		SongUsageIndex(const DriverInfo& inDriverInfo);
+		~SongUsageIndex();
+
+		void Rebuild(const Emulation::IMemoryRandomReadAccess& inMemoryReader);
+
+		void UpdateOrderList(unsigned int inTrack, const unsigned char* inData, unsigned int inDataSize);
+		void UpdateSequence(unsigned char inSequenceIndex, const unsigned char* inData, unsigned int inDataSize);
+
+		// Sequences
+		unsigned char GetHighestSequenceIndexUsed() const;
+		int GetSequenceUsageCount(unsigned char inSequenceIndex) const;
+		unsigned char GetFirstUnusedSequenceIndex() const;
+		unsigned char GetFirstEmptySequenceIndex() const;
+		int GetFreeSequenceCount() const;					// Sequences that are both unused and empty
+
+		// Instruments and commands
+		unsigned char GetHighestInstrumentIndexUsed() const;
+		unsigned char GetHighestCommandIndexUsed() const;
+		int GetInstrumentUsageCount(unsigned char inInstrumentIndex) const;
+		int GetCommandUsageCount(unsigned char inCommandIndex) const;
+
+	private:
+		struct Track
+		{
+			std::vector<unsigned char> m_SequenceReferences;
+			unsigned char m_HighestSequenceIndex;
+		};
+
+		struct Sequence
+		{
+			bool m_IsEmpty;
+			std::vector<unsigned char> m_Instruments;
+			std::vector<unsigned char> m_Commands;
+		};
+
+		bool IsSequenceFree(unsigned char inSequenceIndex) const;
+		void AddSequenceUsage(unsigned char inSequenceIndex, int inDelta);
+
+		static void AddUsage(std::vector<int>& ioUsageCount, unsigned char& ioHighestIndex, const std::vector<unsigned char>& inIndices, int inDelta);
+
+		const DriverInfo& m_DriverInfo;
+
+		std::vector<Track> m_Tracks;
+		std::vector<Sequence> m_Sequences;
+
+		std::vector<int> m_SequenceUsageCount;
+		std::vector<int> m_InstrumentUsageCount;
+		std::vector<int> m_CommandUsageCount;
+
+		unsigned char m_HighestSequenceIndex;
+		unsigned char m_HighestInstrumentIndex;
+		unsigned char m_HighestCommandIndex;
+		int m_FreeSequenceCount;
+	};
+}
@@ -4,8 +4,10 @@
 #include "runtime/emulation/cpumos6510.h"
 #include "runtime/emulation/cpumemory.h"
 #include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/emulation/sid/multisidrenderer.h"
 #include "runtime/execution/executionhandler.h"
 #include "runtime/execution/flightrecorder.h"
+#include "runtime/execution/emulationcontext.h"
 #include "runtime/editor/converters/converterbase.h"
 #include "runtime/editor/screens/screen_base.h"
 #include "runtime/editor/screens/screen_intro.h"
@@ -22,8 +24,12 @@
 #include "runtime/editor/dialog/dialog_sid_file_info.h"
 #include "runtime/editor/driver/driver_utils.h"
 #include "runtime/editor/driver/driver_info.h"
-#include "runtime/editor/packer/packer.h"
+#include "runtime/editor/packer/packer_batch.h"
 #include "runtime/editor/overlay_control.h"
+#include "runtime/editor/playback_keyframes.h"
+#include "runtime/editor/save_worker.h"
+#include "runtime/editor/autosave_journal.h"
+#include "runtime/editor/rastertime_profiler.h"
 #include "runtime/editor/keys/keyhook_setup.h"
 #include "foundation/graphics/viewport.h"
 #include "foundation/graphics/textfield.h"
@@ -47,6 +53,7 @@
 
 // System
 #include "foundation/base/assert.h"
+#include <algorithm>
 
 using namespace Foundation;
 using namespace Emulation;
@@ -58,6 +65,66 @@ namespace Editor
 {
     const unsigned int EditorFacility::DefaultDialogWidth = 100;
 
+	namespace
+	{
+		// A copy of the song data a file is built from, so the file can be built on the save worker thread, while editing goes on
+		struct SongSnapshot
+		{
+			unsigned short m_TopAddress;
+			unsigned short m_EndAddress;
+			std::vector<unsigned char> m_Data;
+
+			DriverInfo::DriverCommon m_DriverCommon;
+			AuxilaryDataCollection m_AuxilaryDataCollection;
+		};
+
+		std::shared_ptr<const SongSnapshot> CreateSongSnapshot(const DriverInfo& inDriverInfo, CPUMemory& inCPUMemory)
+		{
+			std::shared_ptr<SongSnapshot> snapshot = std::make_shared<SongSnapshot>();
+
+			inCPUMemory.Lock();
+
+			snapshot->m_TopAddress = inDriverInfo.GetTopAddress();
+			snapshot->m_EndAddress = DriverUtils::GetEndOfMusicDataAddress(inDriverInfo, reinterpret_cast<const Emulation::IMemoryRandomReadAccess&>(inCPUMemory));
+			snapshot->m_Data.resize(snapshot->m_EndAddress - snapshot->m_TopAddress);
+			inCPUMemory.GetData(snapshot->m_TopAddress, snapshot->m_Data.data(), static_cast<unsigned int>(snapshot->m_Data.size()));
+
+			inCPUMemory.Unlock();
+
+			snapshot->m_DriverCommon = inDriverInfo.GetDriverCommon();
+			snapshot->m_AuxilaryDataCollection = inDriverInfo.GetAuxilaryDataCollection();
+
+			return snapshot;
+		}
+
+		// Builds the file image of the song, as it is saved to an .sf2 file
+		std::vector<unsigned char> CreateSongFileImage(const SongSnapshot& inSnapshot)
+		{
+			std::shared_ptr<Utility::C64File> file = Utility::C64File::CreateFromData(inSnapshot.m_TopAddress, inSnapshot.m_Data.data(), static_cast<unsigned short>(inSnapshot.m_Data.size()));
+
+			Utility::C64FileWriter file_writer(*file, inSnapshot.m_EndAddress, true);
+
+			const unsigned short irq_vector = file_writer.GetWriteAddress();
+			DriverUtils::InsertIRQ(inSnapshot.m_DriverCommon, file_writer);
+
+			const unsigned short auxilary_data_vector = file_writer.GetWriteAddress();
+			inSnapshot.m_AuxilaryDataCollection.Save(file_writer);
+
+			// Adjust IRQ and auxilary data vectors in file
+			const unsigned short driver_init_vector = inSnapshot.m_DriverCommon.m_InitAddress;
+			(*file)[driver_init_vector - 2] = static_cast<unsigned char>(irq_vector & 0xff);
+			(*file)[driver_init_vector - 1] = static_cast<unsigned char>(irq_vector >> 8);
+			(*file)[driver_init_vector - 5] = static_cast<unsigned char>(auxilary_data_vector & 0xff);
+			(*file)[driver_init_vector - 4] = static_cast<unsigned char>(auxilary_data_vector >> 8);
+
+			unsigned char* data = file->GetDataCopyAsPRG();
+			std::vector<unsigned char> file_image(data, data + file->GetPRGDataSize());
+			delete[] data;
+
+			return file_image;
+		}
+	}
+
 	EditorFacility::EditorFacility(IPlatform* inPlatform, Viewport* inViewport, Utility::ConfigFile& inConfigFile)
 		: m_Viewport(inViewport)
 		, m_Platform(inPlatform)
@@ -84,21 +151,35 @@ namespace Editor
 		}
 
 		// Create emulation environment
+		const bool sid_use_table_cache = GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Sound.Emulation.TableCache", 1) != 0;
+		SIDProxy::SetTableCacheFolder(sid_use_table_cache ? m_Platform->Storage_GetConfigHomePath() : std::string());
+
 		SIDConfiguration sid_configuration;										// Default settings are applicable
 
 		const bool sid_use_resample = GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Sound.Emulation.Resample", 1) != 0;
 		sid_configuration.m_eSampleMethod = sid_use_resample ? SID_SAMPLE_METHOD_RESAMPLE_INTERPOLATE : SID_SAMPLE_METHOD_INTERPOLATE;
 		sid_configuration.m_eModel = SID_MODEL_8580;
 
-		m_SIDProxy = new SIDProxy(sid_configuration);
-		m_CPUMemory = new CPUMemory(0x10000, m_Platform);
-		m_CPU = new CPUmos6510();
-		m_FlightRecorder = new FlightRecorder(m_Platform, 0x800);
-		m_ExecutionHandler = new ExecutionHandler(m_Platform, m_CPU, m_CPUMemory, m_SIDProxy, m_FlightRecorder);
+		const int emulation_lookahead = GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Sound.Emulation.Lookahead", 2);
+		m_EmulationContext = std::make_unique<EmulationContext>(m_Platform, sid_configuration, 0x800, static_cast<unsigned int>(std::max<const int>(emulation_lookahead, 1)));
+
+		m_SIDProxy = m_EmulationContext->GetSIDProxy();
+		m_CPUMemory = m_EmulationContext->GetCPUMemory();
+		m_CPU = m_EmulationContext->GetCPU();
+		m_FlightRecorder = m_EmulationContext->GetFlightRecorder();
+		m_ExecutionHandler = m_EmulationContext->GetExecutionHandler();
+
+		const bool cpu_use_fast_core = GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Sound.Emulation.FastCPU", 1) != 0;
+		m_CPU->SetExecutionCore(cpu_use_fast_core ? CPUmos6510::ExecutionCore::Fast : CPUmos6510::ExecutionCore::Reference);
+
+		const std::vector<int> sid_addresses = GetConfigurationValues<ConfigValueInt>(inConfigFile, "Sound.Emulation.SIDAddresses", { 0xd400 });
+		const std::vector<int> sid_pannings = GetConfigurationValues<ConfigValueInt>(inConfigFile, "Sound.Emulation.SIDPanning", { 50 });
+		const std::vector<SIDChipSetup> sid_chip_setups = MultiSIDRenderer::CreateChipSetups(sid_addresses, sid_pannings);
+		m_ExecutionHandler->SetSIDChips(sid_chip_setups);
 
 		// Create audio stream
 		const int audio_buffer_size = GetSingleConfigurationValue<ConfigValueInt>(inConfigFile, "Sound.Buffer.Size", 256);
-		m_AudioStream = new AudioStream(44100, 16, std::max<const int>(audio_buffer_size, 0x80), m_ExecutionHandler);
+		m_AudioStream = new AudioStream(44100, 16, m_ExecutionHandler->GetChannelCount(), std::max<const int>(audio_buffer_size, 0x80), m_ExecutionHandler);
 
 		// Create the main text field
 		m_TextField = m_Viewport->CreateTextField(m_Viewport->GetClientWidth() / TextField::font_width, m_Viewport->GetClientHeight() / TextField::font_height, 0, 0);
@@ -147,7 +228,24 @@ namespace Editor
 		// 	bool EditorFacility::OnConversionSuccess(ScreenBase* inCallerScreen, const std::string& inPathAndFilename, std::shared_ptr<Utility::C64File> inConversionResult)
 
 
+		// Build and write files on a background thread, and journal the changes to the song for recovering it, if the editor is not shut down properly
+		m_SaveWorker = std::make_unique<SaveWorker>(m_Platform);
+
+		const int autosave_interval = GetSingleConfigurationValue<ConfigValueInt>(m_ConfigFile, "Editor.Autosave.Interval", 30);
+
+		m_AutosaveInterval = std::max(autosave_interval, 1) * 1000;
+		m_TicksToAutosave = m_AutosaveInterval;
+		m_IsAutosaveRecoveryPending = false;
+
+		if (autosave_interval > 0)
+			m_AutosaveJournal = std::make_unique<AutosaveJournal>(m_Platform->Storage_GetConfigHomePath() + "autosave_journal.bin");
+
+		// Follow the song in the background, for starting playback from any event position as if the song had been played from the beginning
+		if (GetSingleConfigurationValue<ConfigValueInt>(m_ConfigFile, "Editor.Play.Keyframes", 1) != 0)
+			m_PlaybackKeyframes = std::make_unique<PlaybackKeyframes>(m_Platform, m_SIDProxy->GetConfiguration(), sid_chip_setups, PlaybackKeyframes::DefaultKeyframeInterval);
+
 		m_EditScreen = std::make_unique<ScreenEdit>(
+			m_Platform,
 			m_Viewport,
 			m_TextField,
 			&m_CursorControl,
@@ -157,6 +255,7 @@ namespace Editor
 			m_CPUMemory,
 			m_ExecutionHandler,
 			m_SIDProxy,
+			m_PlaybackKeyframes.get(),
 			m_DriverInfo,
 			[&]() {	m_DiskScreen->SetMode(ScreenDisk::Load); RequestScreen(m_DiskScreen.get()); },
 			[&]() {	m_DiskScreen->SetMode(ScreenDisk::Save); m_DiskScreen->SetSuggestedFileName(m_LastSF2PathAndFilename);  RequestScreen(m_DiskScreen.get()); },
@@ -165,6 +264,7 @@ namespace Editor
 			[&]() {	m_DiskScreen->SetMode(ScreenDisk::SaveInstrument); m_DiskScreen->SetSuggestedFileName(m_LastSF2PathAndFilename);  RequestScreen(m_DiskScreen.get()); },
 			[&]() { OnQuickSave(m_EditScreen.get()); },
 			[&](unsigned short inDestinationAddress) { OnPack(m_EditScreen.get(), inDestinationAddress); },
+			[&]() { OnRastertimeProfile(m_EditScreen.get()); },
 			[&]() { m_FlipOverlayState = true; },
 			[&](unsigned int inReconfigureOption) { Reconfigure(inReconfigureOption); }
 		);
@@ -172,22 +272,25 @@ namespace Editor
 		// Apply additional configuration to the edit screen
 		m_EditScreen->SetAdditionalConfiguration
 		(
-			GetSingleConfigurationValue<ConfigValueInt>(m_ConfigFile, "Editor.Driver.ConvertLegacyColors", 0) != 0
+			GetSingleConfigurationValue<ConfigValueInt>(m_ConfigFile, "Editor.Driver.ConvertLegacyColors", 0) != 0,
+			static_cast<unsigned int>(std::max(256, GetSingleConfigurationValue<ConfigValueInt>(m_ConfigFile, "Editor.Undo.MemoryBudget", 4096))) * 1024
 		);
 	}
 
 	EditorFacility::~EditorFacility()
 	{
+		// Finish writing the files being saved. After a normal shut down, there is nothing to recover from the journal.
+		m_SaveWorker = nullptr;
+
+		if (m_AutosaveJournal != nullptr && !m_IsAutosaveRecoveryPending)
+			m_AutosaveJournal->Remove();
+
 		m_AudioStream->Stop();
 
 		m_Viewport->Destroy(m_TextField);
 
 		delete m_AudioStream;
-		delete m_ExecutionHandler;
-		delete m_FlightRecorder;
-		delete m_SIDProxy;
-		delete m_CPU;
-		delete m_CPUMemory;
+		m_EmulationContext = nullptr;
 	}
 
 	//--------------------------------------------------------------------------------
@@ -234,6 +337,10 @@ namespace Editor
 			}
 		}
 
+		// Offer to recover the song from the journal left behind, if the editor was not shut down properly the last time
+		if (m_AutosaveJournal != nullptr)
+			OfferAutosaveRecovery();
+
 		m_AudioStream->Start();
 		m_ExecutionHandler->Start();
 	}
@@ -243,18 +350,34 @@ namespace Editor
 		FOUNDATION_ASSERT(m_AudioStream != nullptr);
 
 		m_AudioStream->Stop();
+		m_ExecutionHandler->Stop();
 	}
 
 	//--------------------------------------------------------------------------------
 
-	void EditorFacility::Update(const Keyboard& inKeyboard, const Mouse& inMouse, int inDeltaTicks)
+	bool EditorFacility::Update(const Keyboard& inKeyboard, const Mouse& inMouse, int inDeltaTicks)
 	{
 		if (m_IsDone)
-			return;
+			return false;
 
 		// Check screen status
 		HandleScreenState();
 
+		// Complete saves done by the save worker
+		m_SaveWorker->Update();
+
+		// Journal the changes to the song
+		if (m_AutosaveJournal != nullptr)
+		{
+			m_TicksToAutosave -= inDeltaTicks;
+
+			if (m_TicksToAutosave <= 0)
+			{
+				m_TicksToAutosave = m_AutosaveInterval;
+				DoAutosave();
+			}
+		}
+
 		// Handle component updates
 		if (m_CurrentScreen != nullptr)
 		{
@@ -277,7 +400,7 @@ namespace Editor
 		if (m_CurrentScreen != nullptr)
 			m_CurrentScreen->Refresh();
 
-		m_Viewport->End();
+		return m_Viewport->End();
 	}
 
 	//------------------------------------------------------------------------------------------------------------
@@ -287,6 +410,34 @@ namespace Editor
 		return m_IsDone;
 	}
 
+
+	bool EditorFacility::IsPlaybackActive() const
+	{
+		return m_CurrentScreen != nullptr && m_CurrentScreen->IsPlaybackActive();
+	}
+
+
+	int EditorFacility::GetTicksToNextUpdate() const
+	{
+		// Status bar messages time out by themselves as well, but they do not need to be removed on the exact tick
+		const int max_ticks_to_next_update = 250;
+
+		if (m_OverlayControl->IsFading() || m_RequestedScreen != nullptr)
+			return 0;
+
+		// Poll the save worker for completed saves, while it is busy
+		const int save_poll_ticks = 20;
+
+		const int screen_ticks_to_next_update = m_CurrentScreen != nullptr ? m_CurrentScreen->GetTicksToNextUpdate() : max_ticks_to_next_update;
+		const int worker_ticks_to_next_update = m_SaveWorker->IsBusy() ? save_poll_ticks : max_ticks_to_next_update;
+		const int ticks_to_next_update = std::min(std::min(screen_ticks_to_next_update, worker_ticks_to_next_update), max_ticks_to_next_update);
+
+		if (m_CursorControl.IsEnabled())
+			return std::min(m_CursorControl.GetTicksToNextBlink(), ticks_to_next_update);
+
+		return ticks_to_next_update;
+	}
+
 	void EditorFacility::TryQuit()
 	{
 		if (m_CurrentScreen != nullptr)
@@ -439,6 +590,9 @@ namespace Editor
 	{
 		const int max_file_size = 0x10000;
 
+		// Complete the saves of the current song first, so they don't set the path of the song being loaded
+		m_SaveWorker->Flush();
+
 		// Read test music data to cpu memory
 		void* data = nullptr;
 		long data_size = 0;
@@ -489,6 +643,8 @@ namespace Editor
 
 	bool EditorFacility::LoadFileForImport(const std::string& inPathAndFilename, std::shared_ptr<DriverInfo>& outDriverInfo, std::shared_ptr<Utility::C64File>& outC64File)
 	{
+		m_SaveWorker->Flush();
+
 		// Read test music data to cpu memory
 		void* data = nullptr;
 		long data_size = 0;
@@ -533,6 +689,8 @@ namespace Editor
 		{
 			std::shared_ptr<DriverInfo> driver_info = std::make_shared<DriverInfo>();
 
+			m_SaveWorker->Flush();
+
 			if (inC64File != nullptr)
 			{
 				driver_info->Parse(*inC64File);
@@ -597,42 +755,28 @@ namespace Editor
 	}
 
 
-	bool EditorFacility::SaveFile(const std::string& inPathAndFilename)
+	bool EditorFacility::SaveFile(const std::string& inPathAndFilename, const std::function<void(bool)>& inCompletion)
 	{
 		if (m_DriverInfo->IsValid())
 		{
-			m_CPUMemory->Lock();
-
-			const unsigned short top_of_file_address = m_DriverInfo->GetTopAddress();
-			const unsigned short end_of_file_address = DriverUtils::GetEndOfMusicDataAddress(*m_DriverInfo, reinterpret_cast<const Emulation::IMemoryRandomReadAccess&>(*m_CPUMemory));
-			const unsigned short data_size = end_of_file_address - top_of_file_address;
-
-			unsigned char* data = new unsigned char[data_size];
-			m_CPUMemory->GetData(top_of_file_address, data, data_size);
-			m_CPUMemory->Unlock();
-			std::shared_ptr<Utility::C64File> file = Utility::C64File::CreateFromData(top_of_file_address, data, data_size);
-			delete[] data;
-
-			Utility::C64FileWriter file_writer(*file, end_of_file_address, true);
-
-			const unsigned short irq_vector = file_writer.GetWriteAddress();
-			DriverUtils::InsertIRQ(*m_DriverInfo, file_writer);
+			// Only copying the song data waits for the memory lock. The file is built and written on the save worker thread.
+			std::shared_ptr<const SongSnapshot> snapshot = CreateSongSnapshot(*m_DriverInfo, *m_CPUMemory);
 
-			const unsigned short auxilary_data_vector = file_writer.GetWriteAddress();
-			m_DriverInfo->GetAuxilaryDataCollection().Save(file_writer);
+			auto save = [snapshot, inPathAndFilename]()
+			{
+				const std::vector<unsigned char> file_image = CreateSongFileImage(*snapshot);
+				return Utility::WriteFileAtomic(inPathAndFilename, file_image.data(), static_cast<long>(file_image.size()));
+			};
 
-			// Adjust IRQ and auxilary data vectors in file
-			const unsigned short driver_init_vector = m_DriverInfo->GetDriverCommon().m_InitAddress;
-			(*file)[driver_init_vector - 2] = static_cast<unsigned char>(irq_vector & 0xff);
-			(*file)[driver_init_vector - 1] = static_cast<unsigned char>(irq_vector >> 8);
-			(*file)[driver_init_vector - 5] = static_cast<unsigned char>(auxilary_data_vector & 0xff);
-			(*file)[driver_init_vector - 4] = static_cast<unsigned char>(auxilary_data_vector >> 8);
+			auto on_saved = [this, inPathAndFilename, inCompletion](bool inSucceeded)
+			{
+				if (inSucceeded)
+					SetLastSavedPathAndFilename(inPathAndFilename);
 
-			// Save to disk
-			if (!Utility::WriteFile(inPathAndFilename, file))
-				return false;
+				inCompletion(inSucceeded);
+			};
 
-			SetLastSavedPathAndFilename(inPathAndFilename);
+			m_SaveWorker->Queue(save, on_saved);
 
 			return true;
 		}
@@ -803,6 +947,8 @@ namespace Editor
 	{
 		std::shared_ptr<DriverInfo> driver_info = std::make_shared<DriverInfo>();
 
+		m_SaveWorker->Flush();
+
 		if (inConversionResult != nullptr)
 		{
 			driver_info->Parse(*inConversionResult);
@@ -846,15 +992,42 @@ namespace Editor
 	{
 		const bool is_uppercase = m_DisplayState.IsHexUppercase();
 
-		Packer packer(*m_CPUMemory, *m_DriverInfo, inDestinationAddress);
-		m_PackedData = packer.GetResult();
+		// Pack the song, and play the packed song through to verify that it sounds the same as the song
+		PackerBatch packer_batch(m_Platform, m_SIDProxy->GetConfiguration());
+
+		m_CPUMemory->Lock();
+		const bool is_song_played = packer_batch.SetSong(*m_CPUMemory, *m_DriverInfo, 0);
+		m_CPUMemory->Unlock();
+
+		if (!is_song_played)
+		{
+			inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Packing failed", packer_batch.GetErrorMessage(), DefaultDialogWidth, true, []() {}));
+			return;
+		}
+
+		packer_batch.Build({ inDestinationAddress }, 1);
+
+		const PackerBatch::Result& pack_result = packer_batch.GetResults()[0];
+
+		if (pack_result.m_PackedData == nullptr)
+		{
+			inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Packing failed", PackerBatch::GetReport(pack_result, is_uppercase), DefaultDialogWidth, true, []() {}));
+			return;
+		}
+
+		m_PackedData = pack_result.m_PackedData;
 
 		std::string packing_info;
 		packing_info += "Range: 0x" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(m_PackedData->GetTopAddress()), is_uppercase) + " - 0x" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(m_PackedData->GetBottomAddress()), is_uppercase) + "\n";
-		packing_info += "Size : 0x" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(m_PackedData->GetDataSize()), is_uppercase);
+		packing_info += "Size : 0x" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(m_PackedData->GetDataSize()), is_uppercase) + "\n";
+
+		if (pack_result.m_IsVerified)
+			packing_info += "Verified over " + std::to_string(pack_result.m_FrameCount) + " frames";
+		else
+			packing_info += "NOT VERIFIED!\n" + pack_result.m_Message;
 
 		inCallerScreen->GetComponentsManager().StartDialog(
-			std::make_shared<DialogMessage>("Packing results", packing_info, 30, false, [&]() 
+			std::make_shared<DialogMessage>("Packing results", packing_info, pack_result.m_IsVerified ? 30 : DefaultDialogWidth, false, [&]() 
 			{
 				m_DiskScreen->SetMode(ScreenDisk::Mode::SavePacked);
 				SetCurrentScreen(m_DiskScreen.get());
@@ -863,6 +1036,48 @@ namespace Editor
 	}
 
 
+	void EditorFacility::OnRastertimeProfile(ScreenBase* inCallerScreen)
+	{
+		RastertimeProfiler profiler(m_Platform, m_SIDProxy->GetConfiguration());
+		std::shared_ptr<RastertimeProfiler::Profile> profile = std::make_shared<RastertimeProfiler::Profile>();
+
+		m_CPUMemory->Lock();
+		profiler.SetSong(*m_CPUMemory, *m_DriverInfo);
+		m_CPUMemory->Unlock();
+
+		if (!profiler.Run(0, *profile))
+		{
+			inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Rastertime profile", profiler.GetErrorMessage(), DefaultDialogWidth, true, []() {}));
+			return;
+		}
+
+		// The frames of the profile are exported next to the song, if it has been saved
+		path csv_path_and_filename = m_LastSF2PathAndFilename;
+
+		if (csv_path_and_filename.extension().string() == ".sf2")
+			csv_path_and_filename.replace_extension(".csv");
+		else
+			csv_path_and_filename = current_path() / "rastertime.csv";
+
+		auto do_export = [csv_path_and_filename, profile, this]()
+		{
+			if (RastertimeProfiler::WriteCSV(csv_path_and_filename.string(), *profile))
+				this->m_EditScreen->SetStatusBarMessage(" Rastertime profile exported to: " + csv_path_and_filename.filename().string(), 5000);
+			else
+				this->m_CurrentScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Error", "The rastertime profile could not be exported!", DefaultDialogWidth, true, []() {}));
+		};
+
+		// The report is left aligned to keep its columns, so the export is offered in a dialog of its own once it has been read
+		auto on_continue = [csv_path_and_filename, do_export, inCallerScreen]()
+		{
+			inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessageYesNo>("Rastertime profile", "Export the rastertime of every frame to:\n" + csv_path_and_filename.string() + "?", DefaultDialogWidth, do_export, []() {}));
+		};
+
+		const std::string report = RastertimeProfiler::GetReport(*profile, m_DisplayState.IsHexUppercase());
+		inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Rastertime profile", report, 60, false, on_continue));
+	}
+
+
 	void EditorFacility::OnQuickSave(ScreenBase* inCallerScreen)
 	{
 		DoQuickSave(inCallerScreen);
@@ -908,20 +1123,25 @@ namespace Editor
 	{
 		path save_path_and_filename = inSelectedFilename;
 
+		// Leave the disk screen once the file has been written, unless it was left already while saving
+		auto on_saved = [inCallerScreen, this](bool inSucceeded)
+		{
+			if (!inSucceeded)
+				this->OnSaveError(this->m_CurrentScreen);
+			else if (this->m_CurrentScreen == inCallerScreen)
+				this->RequestScreen(this->m_EditScreen.get());
+		};
+
 		if (!exists(save_path_and_filename))
 		{
-			if(SaveFile(save_path_and_filename.string()))
-                RequestScreen(m_EditScreen.get());
-            else
+			if (!SaveFile(save_path_and_filename.string(), on_saved))
                 OnSaveError(inCallerScreen);
 		}
 		else if (IsFileSF2(save_path_and_filename.string()))
 		{
-			auto do_save = [save_path_and_filename, inCallerScreen, this]()
+			auto do_save = [save_path_and_filename, inCallerScreen, on_saved, this]()
 			{
-				if(SaveFile(save_path_and_filename.string()))
-                    this->RequestScreen(this->m_EditScreen.get());
-                else
+				if (!SaveFile(save_path_and_filename.string(), on_saved))
                     OnSaveError(inCallerScreen);
 			};
 
@@ -960,11 +1180,17 @@ namespace Editor
 			inCallerScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Illegal save destination", "You are trying to quick save to a file, with an extension other than .sf2.\nPlease save through the save disk menu!", DefaultDialogWidth, true, []() {}));
 		else
 		{	
-			auto do_save = [save_path_and_filename, inCallerScreen, this]()
+			auto on_saved = [save_path_and_filename, this](bool inSucceeded)
 			{
-				if(SaveFile(save_path_and_filename.string()))
+				if (inSucceeded)
                     this->m_EditScreen->SetStatusBarMessage(" Quick saved to: " + save_path_and_filename.filename().string(), 5000);
                 else
+                    this->OnSaveError(this->m_CurrentScreen);
+			};
+
+			auto do_save = [save_path_and_filename, inCallerScreen, on_saved, this]()
+			{
+				if (!SaveFile(save_path_and_filename.string(), on_saved))
                     this->OnSaveError(inCallerScreen);
 			};
 
@@ -1046,6 +1272,80 @@ namespace Editor
 	}
 
 
+	void EditorFacility::DoAutosave()
+	{
+		// Skipped while saving, so the journal jobs never pile up behind a slow disk
+		if (!m_DriverInfo->IsValid() || m_IsAutosaveRecoveryPending || m_SaveWorker->IsBusy())
+			return;
+
+		std::shared_ptr<const SongSnapshot> snapshot = CreateSongSnapshot(*m_DriverInfo, *m_CPUMemory);
+		AutosaveJournal* autosave_journal = m_AutosaveJournal.get();
+		const std::string song_path_and_filename = m_LastSF2PathAndFilename;
+
+		m_SaveWorker->Queue([snapshot, autosave_journal, song_path_and_filename]()
+		{
+			return autosave_journal->Write(CreateSongFileImage(*snapshot), song_path_and_filename);
+		}, nullptr);
+	}
+
+
+	void EditorFacility::OfferAutosaveRecovery()
+	{
+		std::vector<unsigned char> file_image;
+		std::string song_path_and_filename;
+
+		if (!m_AutosaveJournal->Read(file_image, song_path_and_filename))
+			return;
+
+		// There is nothing to recover, if the song was not changed after it was last loaded or saved
+		void* data = nullptr;
+		long data_size = 0;
+		bool is_song_file_unchanged = false;
+
+		if (Utility::ReadFile(song_path_and_filename, 0x10002, &data, data_size))
+		{
+			is_song_file_unchanged = static_cast<size_t>(data_size) == file_image.size() && std::equal(file_image.begin(), file_image.end(), static_cast<const unsigned char*>(data));
+			delete[] static_cast<char*>(data);
+		}
+
+		if (is_song_file_unchanged)
+		{
+			m_AutosaveJournal->Remove();
+			return;
+		}
+
+		// The journal is left alone, until the user has decided
+		m_IsAutosaveRecoveryPending = true;
+
+		auto do_recover = [this, file_image, song_path_and_filename]()
+		{
+			const std::string recovered_path_and_filename = m_Platform->Storage_GetConfigHomePath() + "autosave_recovered.sf2";
+
+			m_IsAutosaveRecoveryPending = false;
+
+			if (Utility::WriteFileAtomic(recovered_path_and_filename, file_image.data(), static_cast<long>(file_image.size())) && LoadFile(recovered_path_and_filename))
+			{
+				// Quick save goes to the file the song was being edited in
+				if (!song_path_and_filename.empty())
+					SetLastSavedPathAndFilename(song_path_and_filename);
+
+				ForceRequestScreen(m_EditScreen.get());
+			}
+			else
+				m_CurrentScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessage>("Error", "The song could not be recovered!", DefaultDialogWidth, true, []() {}));
+		};
+
+		auto do_discard = [this]()
+		{
+			m_IsAutosaveRecoveryPending = false;
+			m_AutosaveJournal->Remove();
+		};
+
+		const std::string song_filename = path(song_path_and_filename).filename().string();
+		m_CurrentScreen->GetComponentsManager().StartDialog(std::make_shared<DialogMessageYesNo>("Recover song", "SID Factory II was not shut down properly the last time.\nDo you want to recover the changes to " + song_filename + "?", DefaultDialogWidth, do_recover, do_discard));
+	}
+
+
 	void EditorFacility::SetLastSavedPathAndFilename(const std::string& inLastSavedPathAndFilename)
 	{
 		m_LastSF2PathAndFilename = inLastSavedPathAndFilename;
@@ -28,6 +28,7 @@ namespace Emulation
 	class SIDProxy;
 	class ExecutionHandler;
 	class FlightRecorder;
+	class EmulationContext;
 }
 
 namespace Utility
@@ -43,6 +44,9 @@ namespace Editor
 	class ScreenDisk;
 	class ScreenConvert;
 	class ConverterBase;
+	class PlaybackKeyframes;
+	class SaveWorker;
+	class AutosaveJournal;
 
 	enum FileType : int;
 
@@ -57,9 +61,12 @@ namespace Editor
 		void Start(const char* inFileToLoad);
 		void Stop();
 
-		void Update(const Foundation::Keyboard& inKeyboard, const Foundation::Mouse& inMouse, int inDeltaTicks);
+		bool Update(const Foundation::Keyboard& inKeyboard, const Foundation::Mouse& inMouse, int inDeltaTicks);		// Returns true, if the viewport was redrawn
 		bool IsDone() const;
 
+		bool IsPlaybackActive() const;
+		int GetTicksToNextUpdate() const;		// The time until the editor changes by itself (a blinking cursor, a fade), if there is no input
+
 		void TryQuit();
 		void TryLoad(const std::string inPathAndFilename);
 
@@ -78,7 +85,7 @@ namespace Editor
 		bool LoadFile(const std::string& inPathAndFilename);
 		bool LoadFileForImport(const std::string& inPathAndFilename, std::shared_ptr<DriverInfo>& outDriverInfo, std::shared_ptr<Utility::C64File>& outC64File);
 		bool LoadAndConvertFile(const std::string& inPathAndFilename, ScreenBase* inCallerScreen, std::function<void()> inSuccesfullConversionAction);
-		bool SaveFile(const std::string& inSavename);
+		bool SaveFile(const std::string& inSavename, const std::function<void(bool)>& inCompletion);		// Returns false, if there is no song to save. The completion is called, when the file has been written.
 		bool SavePackedFile(const std::string& inSavename);
 		bool SavePackedFileToSID(ScreenBase* inCallerScreen, const std::string& inSavename);
 
@@ -89,6 +96,7 @@ namespace Editor
 		bool OnConversionSuccess(ScreenBase* inCallerScreen, const std::string& inPathAndFilename, std::shared_ptr<Utility::C64File> inConversionResult);
 
 		void OnPack(ScreenBase* inCallerScreen, unsigned short inDestinationAddress);
+		void OnRastertimeProfile(ScreenBase* inCallerScreen);
 		void OnQuickSave(ScreenBase* inCallerScreen);
         void OnSaveError(ScreenBase* inCallerScreen);
 
@@ -101,6 +109,9 @@ namespace Editor
 		void DoSavePacked(ScreenBase* inCallerScreen, const std::string& inSelectedFilename);
 		void DoSavePackedToSID(ScreenBase* inCallerScreen, const std::string& inSelectedFilename);
 
+		void DoAutosave();
+		void OfferAutosaveRecovery();
+
 		void SetLastSavedPathAndFilename(const std::string& inLastSavedPathAndFilename);
 		std::string ConfigureColorsFromScheme(int inSchemeIndex, const Utility::ConfigFile& inMainConfigFile, Foundation::Viewport& inViewport);
 
@@ -119,6 +130,7 @@ namespace Editor
 		Foundation::TextField* m_TextField;
 		Foundation::AudioStream* m_AudioStream;
 
+		std::unique_ptr<Emulation::EmulationContext> m_EmulationContext;
 		Emulation::CPUmos6510* m_CPU;
 		Emulation::CPUMemory* m_CPUMemory;
 		Emulation::SIDProxy* m_SIDProxy;
@@ -140,6 +152,14 @@ namespace Editor
 
 		std::string m_LastSF2PathAndFilename;
 
+		std::unique_ptr<PlaybackKeyframes> m_PlaybackKeyframes;
+
+		std::unique_ptr<AutosaveJournal> m_AutosaveJournal;
+		std::unique_ptr<SaveWorker> m_SaveWorker;			// Declared after the journal, as its jobs write to the journal
+		int m_AutosaveInterval;
+		int m_TicksToAutosave;
+		bool m_IsAutosaveRecoveryPending;
+
 		std::unique_ptr<ScreenIntro> m_IntroScreen;
 		std::unique_ptr<ScreenEdit> m_EditScreen;
 		std::unique_ptr<ScreenDisk> m_DiskScreen;
@@ -0,0 +1,336 @@
+#include "runtime/editor/offline_renderer.h"
+#include "runtime/editor/driver/driver_info.h"
+#include "runtime/editor/driver/driver_state.h"
+#include "runtime/editor/datasources/datasource_orderlist.h"
+#include "runtime/editor/datasources/datasource_sequence.h"
+#include "runtime/editor/components/component_track_utils.h"
+#include "runtime/editor/screens/screen_edit_utils.h"
+#include "runtime/editor/packer/packer_batch.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpumos6510_verifier.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpuframecapture.h"
+#include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/emulation/sid/multisidrenderer.h"
+#include "runtime/execution/emulationcontext.h"
+#include "runtime/environmentdefines.h"
+#include "utils/c64file.h"
+#include "utils/utilities.h"
+
+#include "foundation/base/assert.h"
+
+#include "SDL.h"
+
+using namespace Emulation;
+
+namespace Editor
+{
+	OfflineRenderer::OfflineRenderer(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration, const std::vector<SIDChipSetup>& inSIDChipSetups)
+		: m_Platform(inPlatform)
+		, m_MaxEventPosition(0)
+		, m_EventPosition(-1)
+		, m_ErrorState(false)
+	{
+		m_EmulationContext = std::make_unique<EmulationContext>(inPlatform, inSIDConfiguration);
+
+		m_CPUMemory = m_EmulationContext->GetCPUMemory();
+		m_CPU = m_EmulationContext->GetCPU();
+		m_SIDProxy = m_EmulationContext->GetSIDProxy();
+		m_SIDRenderer = std::make_unique<MultiSIDRenderer>(inPlatform, m_SIDProxy, inSIDChipSetups);
+
+		m_CyclesPerFrame = inSIDConfiguration.m_eEnvironment == SID_ENVIRONMENT_PAL ? EMULATION_CYCLES_PER_FRAME_PAL : EMULATION_CYCLES_PER_FRAME_NTSC;
+		m_FrameCapture = std::make_unique<CPUFrameCapture>(m_CPU, m_SIDRenderer->GetCaptureRangeBegin(), m_SIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+	}
+
+	OfflineRenderer::~OfflineRenderer()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	bool OfflineRenderer::Load(const std::string& inPathAndFilename)
+	{
+		const int max_file_size = 0x10000;
+
+		void* data = nullptr;
+		long data_size = 0;
+
+		m_DriverInfo = nullptr;
+		m_ErrorState = false;
+
+		if (!Utility::ReadFile(inPathAndFilename, max_file_size, &data, data_size))
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "Could not read file: " + inPathAndFilename;
+
+			return false;
+		}
+
+		std::shared_ptr<DriverInfo> driver_info = std::make_shared<DriverInfo>();
+		std::shared_ptr<Utility::C64File> c64_file = Utility::C64File::CreateFromPRGData(data, static_cast<unsigned int>(data_size));
+
+		if (c64_file != nullptr)
+			driver_info->Parse(*c64_file);
+
+		if (driver_info->IsValid())
+		{
+			m_DriverInfo = driver_info;
+
+			// Copy the data to the emulated memory, and make sure it is in the same state as when played back in the editor
+			m_CPUMemory->Lock();
+			m_CPUMemory->Clear();
+			m_CPUMemory->SetData(c64_file->GetTopAddress(), c64_file->GetData(), c64_file->GetDataSize());
+
+			ScreenEditUtils::PrepareSequenceData(*m_DriverInfo, *m_CPUMemory);
+			ScreenEditUtils::PrepareSequencePointers(*m_DriverInfo, *m_CPUMemory);
+			m_CPUMemory->Unlock();
+
+			PrepareSongEndDetection();
+		}
+		else
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "Not a valid SID Factory II file: " + inPathAndFilename;
+		}
+
+		delete[] static_cast<char*>(data);
+
+		return m_DriverInfo != nullptr;
+	}
+
+
+	bool OfflineRenderer::Render(const std::string& inOutputPathAndFilename, OutputFormat inOutputFormat, Foundation::WaveFileWriter::SampleFormat inSampleFormat, unsigned int inMaxFrameCount, Result& outResult)
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		outResult = { 0, 0, 0.0, false };
+		m_ErrorState = false;
+
+		if (inMaxFrameCount == 0 && m_MaxEventPosition == 0)
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "The end of the song cannot be detected, a frame count must be specified!";
+
+			return false;
+		}
+
+		const int sample_frequency = m_SIDProxy->GetSampleFrequency();
+		const unsigned int channel_count = m_SIDRenderer->GetChannelCount();
+
+		// The file writer converts to the output sample format, and writes to disk on its own thread
+		Foundation::WaveFileWriter file_writer(m_Platform, static_cast<unsigned int>(sample_frequency), static_cast<unsigned short>(channel_count), inSampleFormat, inOutputFormat == OutputFormat::Wave);
+
+		if (!file_writer.Open(inOutputPathAndFilename))
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "Could not open file for writing: " + inOutputPathAndFilename;
+
+			return false;
+		}
+
+		// The resampler does not deliver the exact same number of samples every frame, so leave plenty of room
+		const unsigned int max_samples_per_frame = 2 * channel_count * (static_cast<unsigned int>((static_cast<unsigned long long>(m_CyclesPerFrame) * sample_frequency) / EMULATION_CYCLES_PER_SECOND_PAL) + 1);
+		std::vector<short> frame_samples(max_samples_per_frame);
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		m_SIDRenderer->Reset();
+		m_EventPosition = -1;
+
+		unsigned int frame = 0;
+
+		while (!m_ErrorState && !file_writer.IsInErrorState() && (inMaxFrameCount == 0 || frame < inMaxFrameCount))
+		{
+			const unsigned int sample_count = RenderFrame(frame == 0, &frame_samples[0], max_samples_per_frame);
+
+			file_writer.Write(&frame_samples[0], sample_count);
+			outResult.m_SampleCount += sample_count / channel_count;
+
+			++frame;
+
+			if (m_MaxEventPosition > 0 && m_EventPosition >= static_cast<int>(m_MaxEventPosition))
+			{
+				outResult.m_ReachedSongEnd = true;
+				break;
+			}
+		}
+
+		// Closing the file waits for the last of the data to be written
+		const bool write_error = !file_writer.Close();
+
+		outResult.m_FrameCount = frame;
+		outResult.m_RenderTimeInSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+		if (write_error)
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "Could not write to file: " + inOutputPathAndFilename;
+		}
+
+		return !m_ErrorState;
+	}
+
+
+	bool OfflineRenderer::BenchmarkDriverUpdate(unsigned int inFrameCount, CPUmos6510::ExecutionCore inExecutionCore, BenchmarkResult& outResult)
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		outResult = { 0, 0, 0.0 };
+		m_ErrorState = false;
+		m_EventPosition = -1;
+
+		const CPUmos6510::ExecutionCore previous_execution_core = m_CPU->GetExecutionCore();
+		m_CPU->SetExecutionCore(inExecutionCore);
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		for (unsigned int frame = 0; frame < inFrameCount && !m_ErrorState; ++frame)
+		{
+			CaptureFrame(frame == 0);
+
+			outResult.m_CycleCount += m_FrameCapture->GetCyclesSpend();
+			outResult.m_FrameCount = frame + 1;
+		}
+
+		outResult.m_TimeInSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+		m_CPU->SetExecutionCore(previous_execution_core);
+
+		return !m_ErrorState;
+	}
+
+
+	bool OfflineRenderer::VerifyExecutionCores(unsigned int inFrameCount)
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		const DriverInfo::DriverCommon& driver_common = m_DriverInfo->GetDriverCommon();
+		CPUmos6510Verifier verifier(m_Platform);
+
+		m_CPUMemory->Lock();
+		const bool success = verifier.VerifyDriver(*m_CPUMemory, driver_common.m_InitAddress, driver_common.m_UpdateAddress, inFrameCount, m_CyclesPerFrame);
+		m_CPUMemory->Unlock();
+
+		m_ErrorState = !success;
+
+		if (!success)
+			m_ErrorMessage = verifier.GetErrorMessage();
+
+		return success;
+	}
+
+
+	bool OfflineRenderer::ProfileRastertime(unsigned int inMaxFrameCount, RastertimeProfiler::Profile& outProfile)
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		RastertimeProfiler profiler(m_Platform, m_SIDProxy->GetConfiguration());
+
+		m_CPUMemory->Lock();
+		profiler.SetSong(*m_CPUMemory, *m_DriverInfo);
+		m_CPUMemory->Unlock();
+
+		m_ErrorState = !profiler.Run(inMaxFrameCount, outProfile);
+
+		if (m_ErrorState)
+			m_ErrorMessage = profiler.GetErrorMessage();
+
+		return !m_ErrorState;
+	}
+
+
+	bool OfflineRenderer::Pack(const std::vector<unsigned short>& inDestinationAddresses, unsigned int inThreadCount, unsigned int inMaxFrameCount, PackerBatch& ioPackerBatch)
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		m_CPUMemory->Lock();
+		m_ErrorState = !ioPackerBatch.SetSong(*m_CPUMemory, *m_DriverInfo, inMaxFrameCount);
+		m_CPUMemory->Unlock();
+
+		if (m_ErrorState)
+		{
+			m_ErrorMessage = ioPackerBatch.GetErrorMessage();
+			return false;
+		}
+
+		ioPackerBatch.Build(inDestinationAddresses, inThreadCount);
+
+		return true;
+	}
+
+
+	const std::string& OfflineRenderer::GetErrorMessage() const
+	{
+		return m_ErrorMessage;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void OfflineRenderer::PrepareSongEndDetection()
+	{
+		FOUNDATION_ASSERT(m_DriverInfo != nullptr);
+
+		m_MaxEventPosition = 0;
+
+		// The song end can only be tracked if the driver exposes its tempo counter
+		if (m_DriverInfo->GetDriverCommon().m_TempoCounterAddress == 0)
+			return;
+
+		DriverState driver_state;
+		std::vector<std::shared_ptr<DataSourceOrderList>> order_lists;
+		std::vector<std::shared_ptr<DataSourceSequence>> sequences;
+
+		ScreenEditUtils::PrepareOrderListsDataSources(*m_DriverInfo, *m_CPUMemory, order_lists);
+		ScreenEditUtils::PrepareSequenceDataSources(*m_DriverInfo, driver_state, *m_CPUMemory, sequences);
+
+		// The song has played through, when the longest track reaches its end
+		for (const auto& order_list : order_lists)
+		{
+			const unsigned int max_event_position = ComponentTrackUtils::GetMaxEventPosition(order_list, sequences);
+
+			if (max_event_position > m_MaxEventPosition)
+				m_MaxEventPosition = max_event_position;
+		}
+	}
+
+
+	void OfflineRenderer::CaptureFrame(bool inInit)
+	{
+		const DriverInfo::DriverCommon& driver_common = m_DriverInfo->GetDriverCommon();
+
+		m_CPUMemory->Lock();
+		m_CPU->SetMemory(m_CPUMemory);
+
+		CPUFrameCapture& frame_capture = *m_FrameCapture;
+		frame_capture.Begin();
+
+		if (inInit)
+			frame_capture.Capture(driver_common.m_InitAddress, 0);
+
+		if (!frame_capture.IsMaxCycleCountReached())
+			frame_capture.Capture(driver_common.m_UpdateAddress, 0);
+
+		if (frame_capture.IsMaxCycleCountReached())
+		{
+			m_ErrorState = true;
+			m_ErrorMessage = "Emulation of 6510 code exceeded cycle window!";
+		}
+
+		// Follow the event position the same way as the editor does during playback
+		if (driver_common.m_TempoCounterAddress != 0 && (*m_CPUMemory)[driver_common.m_TempoCounterAddress] == 0)
+			++m_EventPosition;
+
+		frame_capture.End();
+
+		m_CPUMemory->Unlock();
+	}
+
+
+	unsigned int OfflineRenderer::RenderFrame(bool inInit, short* outSampleBuffer, unsigned int inSampleBufferSize)
+	{
+		CaptureFrame(inInit);
+
+		// Do all writes to the SID chips and emulate the cycles in between
+		return m_SIDRenderer->RenderFrame(*m_FrameCapture, static_cast<int>(m_CyclesPerFrame), outSampleBuffer, inSampleBufferSize);
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "runtime/editor/rastertime_profiler.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
+#include "foundation/sound/wavefilewriter.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+	class CPUFrameCapture;
+	class SIDProxy;
+	class MultiSIDRenderer;
+	class EmulationContext;
+}
+
+namespace Editor
+{
+	class DriverInfo;
+	class PackerBatch;
+
+	// Renders a song to a PCM file as fast as the host allows, without any video or audio device. The emulation
+	// is driven exactly as the execution handler does it, one captured driver update per frame. Each renderer has
+	// its own emulation context, so several renderers can run on separate threads.
+	class OfflineRenderer final
+	{
+	public:
+		enum class OutputFormat : int
+		{
+			Wave,
+			Raw
+		};
+
+		struct Result
+		{
+			unsigned int m_FrameCount;
+			unsigned int m_SampleCount;					// Samples of each channel
+			double m_RenderTimeInSeconds;
+			bool m_ReachedSongEnd;
+		};
+
+		struct BenchmarkResult
+		{
+			unsigned int m_FrameCount;
+			unsigned long long m_CycleCount;			// Cycles spent on driver updates, summed up over all frames
+			double m_TimeInSeconds;
+		};
+
+		// With more than one SID chip set up, the output is stereo
+		OfflineRenderer(Foundation::IPlatform* inPlatform, const Emulation::SIDConfiguration& inSIDConfiguration, const std::vector<Emulation::SIDChipSetup>& inSIDChipSetups);
+		~OfflineRenderer();
+
+		bool Load(const std::string& inPathAndFilename);
+
+		// Renders until the song reaches its loop point, or until inMaxFrameCount frames have been rendered. A max frame count of 0 means no limit,
+		// which is only usable with songs where the end of the song can be detected.
+		bool Render(const std::string& inOutputPathAndFilename, OutputFormat inOutputFormat, Foundation::WaveFileWriter::SampleFormat inSampleFormat, unsigned int inMaxFrameCount, Result& outResult);
+
+		// Runs the driver update for a number of frames, without emulating the SID, and measures the time it takes. This is a
+		// benchmark of the 6510 emulation and the frame capture alone.
+		bool BenchmarkDriverUpdate(unsigned int inFrameCount, Emulation::CPUmos6510::ExecutionCore inExecutionCore, BenchmarkResult& outResult);
+
+		// Runs the driver update for a number of frames on both execution cores of the CPU, and checks that they give the exact same results
+		bool VerifyExecutionCores(unsigned int inFrameCount);
+
+		// Finds the rastertime of the driver update in every frame of the song. See RastertimeProfiler.
+		bool ProfileRastertime(unsigned int inMaxFrameCount, RastertimeProfiler::Profile& outProfile);
+
+		// Packs the song at each of the destination addresses, and verifies the packed files against the song. See PackerBatch. Returns
+		// false if the song itself can't be played, not if any of the packed files fail to verify.
+		bool Pack(const std::vector<unsigned short>& inDestinationAddresses, unsigned int inThreadCount, unsigned int inMaxFrameCount, PackerBatch& ioPackerBatch);
+
+		const std::string& GetErrorMessage() const;
+
+	private:
+		void PrepareSongEndDetection();
+		void CaptureFrame(bool inInit);
+		unsigned int RenderFrame(bool inInit, short* outSampleBuffer, unsigned int inSampleBufferSize);
+
+		Foundation::IPlatform* m_Platform;
+
+		std::unique_ptr<Emulation::EmulationContext> m_EmulationContext;
+		Emulation::CPUMemory* m_CPUMemory;
+		Emulation::CPUmos6510* m_CPU;
+		Emulation::SIDProxy* m_SIDProxy;
+		std::unique_ptr<Emulation::MultiSIDRenderer> m_SIDRenderer;
+		std::unique_ptr<Emulation::CPUFrameCapture> m_FrameCapture;
+
+		std::shared_ptr<DriverInfo> m_DriverInfo;
+
+		unsigned int m_CyclesPerFrame;
+		unsigned int m_MaxEventPosition;
+		int m_EventPosition;
+		bool m_ErrorState;
+		std::string m_ErrorMessage;
+	};
+}
@@ -1,20 +1,65 @@
 #include "runtime/editor/optimize/optimizer.h"
+#include "runtime/editor/optimize/register_trace.h"
 #include "runtime/editor/datasources/datasource_orderlist.h"
 #include "runtime/editor/datasources/datasource_sequence.h"
 #include "runtime/editor/datasources/datasource_table.h"
 #include "runtime/editor/driver/driver_info.h"
+#include "runtime/editor/driver/driver_utils.h"
+#include "runtime/editor/driver/song_usage_index.h"
+#include "runtime/editor/components/component_track_utils.h"
+#include "runtime/editor/screens/screen_edit_utils.h"
 #include "runtime/editor/auxilarydata/auxilary_data_collection.h"
 #include "runtime/editor/auxilarydata/auxilary_data_table_text.h"
 
 #include "runtime/emulation/cpumemory.h"
 
 #include <algorithm>
+#include <unordered_map>
 #include "foundation/base/assert.h"
 
 namespace Editor
 {
+	namespace
+	{
+		// Songs that don't reach their end, or take longer to play through twice, are traced for ten minutes
+		const unsigned int MaxTraceFrameCount = 50 * 60 * 10;
+
+		// FNV-1a of the contents of a sequence or a table row
+		struct ContentHash
+		{
+			size_t operator()(const std::vector<unsigned char>& inContent) const
+			{
+				unsigned long long hash = 0xcbf29ce484222325ULL;
+
+				for (unsigned char value : inContent)
+					hash = (hash ^ value) * 0x100000001b3ULL;
+
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		// The first index found with the contents
+		typedef std::unordered_map<std::vector<unsigned char>, unsigned char, ContentHash> ContentMap;
+
+		bool IsPlayableNote(unsigned char inNote)
+		{
+			return inNote > 0 && inNote < 0x60;
+		}
+
+		unsigned char GetTarget(const std::vector<unsigned char>& inTarget, unsigned char inIndex)
+		{
+			return inIndex < inTarget.size() && inTarget[inIndex] != 0xff ? inTarget[inIndex] : inIndex;
+		}
+	}
+
+
+	const unsigned char Optimizer::Unused = 0xff;
+
+
 	Optimizer::Optimizer
 	(
+		Foundation::IPlatform* inPlatform,
+		const Emulation::SIDConfiguration& inSIDConfiguration,
 		Emulation::CPUMemory* inCPUMemory,
 		DriverInfo& inDriverInfo,
 		std::vector<std::shared_ptr<DataSourceOrderList>> inOrderListDataSources,
@@ -24,17 +69,21 @@ namespace Editor
 		int inInstrumentsTableID,
 		int inCommandsTableID
 	)
-		: m_CPUMemory(inCPUMemory)
+		: m_Platform(inPlatform)
+		, m_SIDConfiguration(inSIDConfiguration)
+		, m_CPUMemory(inCPUMemory)
 		, m_DriverInfo(inDriverInfo)
-		, m_OrderListDataSources(inOrderListDataSources)
-		, m_SequenceDataSources(inSequenceDataSources)
-		, m_InstrumentTableDataSource(inInstrumentTableDataSource)
-		, m_CommandTableDataSource(inCommandTableDataSource)
 		, m_InstrumentsTableID(inInstrumentsTableID)
 		, m_CommandsTableID(inCommandsTableID)
 	{
+		m_DataSources.m_OrderLists = inOrderListDataSources;
+		m_DataSources.m_Sequences = inSequenceDataSources;
+		m_DataSources.m_InstrumentTable = inInstrumentTableDataSource;
+		m_DataSources.m_CommandTable = inCommandTableDataSource;
+
 		GatherOptimizationData();
-		BuildRelocationData();
+
+		m_DeepPlan = BuildPlan(Level::Deep);
 	}
 
 
@@ -57,20 +106,129 @@ namespace Editor
 	{
 		return m_UsedCommandIndices;
 	}
-	
 
-	void Optimizer::Execute()
+
+	unsigned int Optimizer::GetMergedSequenceCount() const
+	{
+		return m_DeepPlan.m_MergedSequenceCount;
+	}
+
+
+	unsigned int Optimizer::GetMergedInstrumentCount() const
 	{
+		return m_DeepPlan.m_MergedInstrumentCount;
+	}
+
+
+	unsigned int Optimizer::GetMergedCommandCount() const
+	{
+		return m_DeepPlan.m_MergedCommandCount;
+	}
+
+
+	unsigned int Optimizer::GetJoinedSequenceCount() const
+	{
+		return m_DeepPlan.m_JoinedSequenceCount;
+	}
+
+
+	bool Optimizer::Execute()
+	{
+		const unsigned int memory_size = m_CPUMemory->GetSize();
+		std::vector<unsigned char> song_memory(memory_size);
+
 		m_CPUMemory->Lock();
-		RelocateData();
+		m_CPUMemory->GetData(0, &song_memory[0], memory_size);
 		m_CPUMemory->Unlock();
+
+		// The song is traced until it has played through twice, if the end of it can be found
+		unsigned int max_event_position = 0;
+
+		for (const auto& order_list : m_DataSources.m_OrderLists)
+			max_event_position = std::max(max_event_position, ComponentTrackUtils::GetMaxEventPosition(order_list, m_DataSources.m_Sequences));
+
+		Emulation::CPUMemory copy_memory(memory_size, m_Platform);
+		copy_memory.Lock();
+		copy_memory.SetData(0, &song_memory[0], memory_size);
+
+		RegisterTrace song_trace(m_Platform, m_SIDConfiguration);
+
+		if (!song_trace.Record(copy_memory, m_DriverInfo, MaxTraceFrameCount, 2 * max_event_position))
+		{
+			copy_memory.Unlock();
+
+			m_Report = "The song could not be traced. " + song_trace.GetErrorMessage();
+			return false;
+		}
+
+		RegisterTrace copy_trace(m_Platform, m_SIDConfiguration);
+		unsigned int packed_size = 0;
+		unsigned int difference_frame = 0;
+		std::string difference;
+
+		// Try the levels of optimization on a copy of the song, from the deepest one, until one is found that plays the same as the song
+		for (int level = 0; level < static_cast<int>(Level::Count); ++level)
+		{
+			const Plan plan = level == static_cast<int>(Level::Deep) ? m_DeepPlan : BuildPlan(static_cast<Level>(level));
+
+			copy_memory.SetData(0, &song_memory[0], memory_size);
+			DataSources copy_data_sources = CreateDataSources(copy_memory);
+
+			if (level == 0)
+				packed_size = GetPackedSize(copy_memory, copy_data_sources);
+
+			Apply(plan, copy_data_sources, false);
+
+			if (!copy_trace.Record(copy_memory, m_DriverInfo, song_trace.GetFrameCount(), 0))
+			{
+				difference = copy_trace.GetErrorMessage();
+				continue;
+			}
+
+			if (!song_trace.IsIdentical(copy_trace, difference_frame, difference))
+				continue;
+
+			const int saved_size = static_cast<int>(packed_size) - static_cast<int>(GetPackedSize(copy_memory, copy_data_sources));
+
+			copy_memory.Unlock();
+
+			m_CPUMemory->Lock();
+			Apply(plan, m_DataSources, true);
+			m_CPUMemory->Unlock();
+
+			m_Report = " Optimized: " + std::to_string(plan.m_MergedSequenceCount) + " sequences, " + std::to_string(plan.m_MergedInstrumentCount) + " instruments and "
+				+ std::to_string(plan.m_MergedCommandCount) + " commands merged, " + std::to_string(plan.m_JoinedSequenceCount) + " sequences joined, "
+				+ std::to_string(saved_size) + " bytes saved";
+
+			if (level != static_cast<int>(Level::Deep))
+				m_Report += " (deeper optimization did not verify)";
+
+			return true;
+		}
+
+		copy_memory.Unlock();
+
+		m_Report = "The optimized song did not play the same as the song, which has been left as it is.\n\n" + difference;
+		return false;
+	}
+
+
+	const std::string& Optimizer::GetReport() const
+	{
+		return m_Report;
 	}
 
 
 	void Optimizer::GatherOptimizationData()
 	{
+		const unsigned int sequence_count = static_cast<unsigned int>(m_DataSources.m_Sequences.size());
+
+		m_SequenceReferenceCount.assign(sequence_count, 0);
+		m_SequenceLowestTransposition.assign(sequence_count, 0xff);
+		m_SequenceHighestTransposition.assign(sequence_count, 0x00);
+
 		// Sequences referenced from orderlist
-		for (const auto& orderlist : m_OrderListDataSources)
+		for (const auto& orderlist : m_DataSources.m_OrderLists)
 		{
 			const unsigned int length = orderlist->GetLength();
 
@@ -82,233 +240,474 @@ namespace Editor
 				{
 					const unsigned char sequence_index = (*orderlist)[i].m_SequenceIndex;
 
-					if (std::find(m_UsedSequenceIndices.begin(), m_UsedSequenceIndices.end(), sequence_index) == m_UsedSequenceIndices.end())
-						m_UsedSequenceIndices.push_back(sequence_index);
+					if (sequence_index < sequence_count)
+					{
+						++m_SequenceReferenceCount[sequence_index];
+
+						m_SequenceLowestTransposition[sequence_index] = std::min(m_SequenceLowestTransposition[sequence_index], transpose);
+						m_SequenceHighestTransposition[sequence_index] = std::max(m_SequenceHighestTransposition[sequence_index], transpose);
+					}
 				}
 			}
 		}
 
-		std::sort(m_UsedSequenceIndices.begin(), m_UsedSequenceIndices.end(), [](const auto& inA, const auto& inB) { return inA < inB; });
+		std::vector<bool> is_instrument_used(0x20, false);
+		std::vector<bool> is_command_used(0x40, false);
 
-		for (const unsigned char& sequence_index : m_UsedSequenceIndices)
+		for (unsigned int sequence_index = 0; sequence_index < sequence_count; ++sequence_index)
 		{
-			const auto& sequence = m_SequenceDataSources[sequence_index];
-			const unsigned int length = sequence->GetLength();
+			if (m_SequenceReferenceCount[sequence_index] == 0)
+				continue;
+
+			m_UsedSequenceIndices.push_back(static_cast<unsigned char>(sequence_index));
+
+			const DataSourceSequence& sequence = *m_DataSources.m_Sequences[sequence_index];
+			const unsigned int length = sequence.GetLength();
 
 			for (unsigned int i = 0; i < length; ++i)
 			{
-				const auto& event = (*sequence)[i];
-				if (event.m_Instrument >= 0xa0)
-				{
-					const char instrument = event.m_Instrument & 0x1f;
+				const auto& event = sequence[i];
 
-					if (std::find(m_UsedInstrumentIndices.begin(), m_UsedInstrumentIndices.end(), instrument) == m_UsedInstrumentIndices.end())
-						m_UsedInstrumentIndices.push_back(instrument);
-				}
+				if (event.m_Instrument >= 0xa0)
+					is_instrument_used[event.m_Instrument & 0x1f] = true;
 				if (event.m_Command >= 0xc0)
-				{
-					const char command = event.m_Command & 0x3f;
-
-					if (std::find(m_UsedCommandIndices.begin(), m_UsedCommandIndices.end(), command) == m_UsedCommandIndices.end())
-						m_UsedCommandIndices.push_back(command);
-				}
+					is_command_used[event.m_Command & 0x3f] = true;
 			}
 		}
 
-		std::sort(m_UsedInstrumentIndices.begin(), m_UsedInstrumentIndices.end(), [](const auto& inA, const auto& inB) { return inA < inB; });
-		std::sort(m_UsedCommandIndices.begin(), m_UsedCommandIndices.end(), [](const auto& inA, const auto& inB) { return inA < inB; });
+		for (unsigned int i = 0; i < is_instrument_used.size(); ++i)
+		{
+			if (is_instrument_used[i])
+				m_UsedInstrumentIndices.push_back(static_cast<unsigned char>(i));
+		}
+
+		for (unsigned int i = 0; i < is_command_used.size(); ++i)
+		{
+			if (is_command_used[i])
+				m_UsedCommandIndices.push_back(static_cast<unsigned char>(i));
+		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------------------
 
-	void Optimizer::BuildRelocationData()
+	Optimizer::Plan Optimizer::BuildPlan(Level inLevel) const
 	{
-		BuildRelocationData(m_UsedInstrumentIndices, m_InstrumentRelocationData);
-		BuildRelocationData(m_UsedCommandIndices, m_CommandRelocatonInfo);
-		BuildRelocationData(m_UsedSequenceIndices, m_SequenceRelocationData);
-	}
+		const unsigned int sequence_count = static_cast<unsigned int>(m_DataSources.m_Sequences.size());
+		const bool merge_duplicates = inLevel != Level::Compact;
+		const bool merge_transposed = inLevel == Level::Deep;
 
+		Plan plan;
 
-	void Optimizer::RelocateData()
-	{
-		RelocateTableRows(m_InstrumentsTableID, m_InstrumentTableDataSource, m_InstrumentRelocationData, m_UsedInstrumentIndices);
-		RelocateTableRows(m_CommandsTableID, m_CommandTableDataSource, m_CommandRelocatonInfo, m_UsedCommandIndices);
-		RelocateSequences();
-		AdjustOrderlists();
-		AdjustSequences();
-	}
+		plan.m_Level = inLevel;
+		plan.m_SequenceTarget.assign(sequence_count, Unused);
+		plan.m_SequenceTransposition.assign(sequence_count, 0);
+		plan.m_IsSequenceJoined.assign(sequence_count, false);
+		plan.m_MergedSequenceCount = 0;
+		plan.m_JoinedSequenceCount = 0;
 
+		BuildTableRowPlan(*m_DataSources.m_InstrumentTable, m_UsedInstrumentIndices, merge_duplicates, plan.m_InstrumentTarget, plan.m_InstrumentSources, plan.m_MergedInstrumentCount);
+		BuildTableRowPlan(*m_DataSources.m_CommandTable, m_UsedCommandIndices, merge_duplicates, plan.m_CommandTarget, plan.m_CommandSources, plan.m_MergedCommandCount);
 
-	void Optimizer::RelocateTableRows(int inTableID, std::shared_ptr<DataSourceTable>& inTableData, const std::vector<RelocationInfo>& inRelocationInfo, const std::vector<unsigned char>& inUsedIndicesSorted)
-	{
-		const int stride = inTableData->GetColumnCount();
+		// Find the sequences that are the same, once the instruments and commands that are the same have been merged. For transposed
+		// sequences, the notes are taken relative to the first note. A sequence is merged into the first one like it.
+		std::vector<unsigned char> merged_into(sequence_count, Unused);
+		std::vector<bool> has_merged(sequence_count, false);
+		std::vector<int> first_notes(sequence_count, 0);
 
-		if (inRelocationInfo.size() > 0)
+		ContentMap sequence_contents;
+
+		for (unsigned char sequence_index : m_UsedSequenceIndices)
 		{
-			int highest_to = 0;
+			if (!merge_duplicates)
+				continue;
+
+			const DataSourceSequence& sequence = *m_DataSources.m_Sequences[sequence_index];
+			const unsigned int length = sequence.GetLength();
+
+			std::vector<unsigned char> content;
+			content.reserve(length * 4);
+
+			int first_note = 0;
 
-			// Relocate table entries
-			for (const RelocationInfo& relocation_info : inRelocationInfo)
+			for (unsigned int i = 0; i < length; ++i)
 			{
-				const int index_from = stride * relocation_info.m_From;
-				const int index_to = stride * relocation_info.m_To;
+				const auto& event = sequence[i];
 
-				if (relocation_info.m_To > highest_to)
-					highest_to = relocation_info.m_To;
+				content.push_back(event.m_Instrument >= 0xa0 ? (0xa0 | GetTarget(plan.m_InstrumentTarget, event.m_Instrument & 0x1f)) : event.m_Instrument);
+				content.push_back(event.m_Command >= 0xc0 ? (0xc0 | GetTarget(plan.m_CommandTarget, event.m_Command & 0x3f)) : event.m_Command);
 
-				for (int i = 0; i < stride; ++i)
-					(*inTableData)[index_to + i] = (*inTableData)[index_from + i];
-			}
+				if (merge_transposed && IsPlayableNote(event.m_Note))
+				{
+					if (first_note == 0)
+						first_note = event.m_Note;
 
-			// Clear the rest of the table
-			for (int i = (highest_to + 1) * stride; i < inTableData->GetSize(); ++i)
-				(*inTableData)[i] = 0;
+					content.push_back(1);
+					content.push_back(static_cast<unsigned char>(event.m_Note - first_note + 0x60));
+				}
+				else
+				{
+					content.push_back(0);
+					content.push_back(event.m_Note);
+				}
+			}
 
-			inTableData->PushDataToSource();
+			first_notes[sequence_index] = first_note;
 
-			// Move description text, if table has any
-			auto& text_data = m_DriverInfo.GetAuxilaryDataCollection().GetTableText();
+			const auto result = sequence_contents.insert({ content, sequence_index });
 
-			if (text_data.HasText(inTableID))
+			if (!result.second)
 			{
-				for (const RelocationInfo& relocation_info : inRelocationInfo)
+				// The transposition of the order list entries playing the sequence must stay in range, once the difference is added to it
+				const unsigned char first_sequence_index = result.first->second;
+				const int transposition = first_note - first_notes[first_sequence_index];
+
+				const bool is_in_range = transposition == 0 || (m_SequenceLowestTransposition[sequence_index] + transposition >= 0x80 && m_SequenceHighestTransposition[sequence_index] + transposition <= 0xbf);
+
+				if (is_in_range)
 				{
-					std::string desc = text_data.GetText(inTableID, relocation_info.m_From);
-					text_data.SetText(inTableID, relocation_info.m_To, desc);
-				}
+					merged_into[sequence_index] = first_sequence_index;
+					has_merged[first_sequence_index] = true;
+					plan.m_SequenceTransposition[sequence_index] = transposition;
 
-				for (int i = highest_to + 1; i < inTableData->GetSize() / stride; ++i)
-					text_data.SetText(inTableID, i, "");
+					++plan.m_MergedSequenceCount;
+				}
 			}
 		}
-		else
+
+		// Find pairs of sequences, that are each played once, one after the other with the same transposition
+		std::vector<unsigned char> joined_with(sequence_count, Unused);
+
+		if (merge_transposed)
 		{
-			int first_clear_index = !inUsedIndicesSorted.empty() ? static_cast<int>(inUsedIndicesSorted.back() + 1) : 0;
+			std::vector<bool> is_in_join(sequence_count, false);
+
+			for (const auto& order_list : m_DataSources.m_OrderLists)
+			{
+				const unsigned int length = order_list->GetLength();
+				const unsigned int loop_index = order_list->GetLoopIndex();
+
+				for (unsigned int i = 0; i + 2 < length; ++i)
+				{
+					const DataSourceOrderList::Entry first = (*order_list)[i];
+					const DataSourceOrderList::Entry second = (*order_list)[i + 1];
+
+					if (first.m_Transposition >= 0xfe || second.m_Transposition != first.m_Transposition || i + 1 == loop_index)
+						continue;
+
+					const unsigned char first_index = first.m_SequenceIndex;
+					const unsigned char second_index = second.m_SequenceIndex;
+
+					if (first_index == second_index || first_index >= sequence_count || second_index >= sequence_count)
+						continue;
+					if (m_SequenceReferenceCount[first_index] != 1 || m_SequenceReferenceCount[second_index] != 1)
+						continue;
+					if (is_in_join[first_index] || is_in_join[second_index])
+						continue;
+					if (merged_into[first_index] != Unused || merged_into[second_index] != Unused || has_merged[first_index] || has_merged[second_index])
+						continue;
+					if (!CanJoinSequences(first_index, second_index))
+						continue;
 
-			// Clear the rest of the table
-			for (int i = first_clear_index * stride; i < inTableData->GetSize(); ++i)
-				(*inTableData)[i] = 0;
+					joined_with[first_index] = second_index;
+					plan.m_IsSequenceJoined[second_index] = true;
 
-			inTableData->PushDataToSource();
+					is_in_join[first_index] = true;
+					is_in_join[second_index] = true;
 
-			// Move description text, if table has any
-			auto& text_data = m_DriverInfo.GetAuxilaryDataCollection().GetTableText();
+					++plan.m_JoinedSequenceCount;
+				}
+			}
+		}
 
-			if (text_data.HasText(inTableID))
+		// Give the sequences that are kept new indices, in the order they are in now
+		for (unsigned char sequence_index : m_UsedSequenceIndices)
+		{
+			if (plan.m_IsSequenceJoined[sequence_index])
+				continue;
+
+			if (merged_into[sequence_index] != Unused)
 			{
-				for (int i = first_clear_index; i < inTableData->GetSize() / stride; ++i)
-					text_data.SetText(inTableID, i, "");
+				plan.m_SequenceTarget[sequence_index] = plan.m_SequenceTarget[merged_into[sequence_index]];
+				continue;
 			}
+
+			plan.m_SequenceTarget[sequence_index] = static_cast<unsigned char>(plan.m_SequenceSources.size());
+			plan.m_SequenceSources.push_back({ sequence_index });
+
+			if (joined_with[sequence_index] != Unused)
+				plan.m_SequenceSources.back().push_back(joined_with[sequence_index]);
 		}
+
+		return plan;
 	}
 
 
-	void Optimizer::RelocateSequences()
+	void Optimizer::BuildTableRowPlan(const DataSourceTable& inTableData, const std::vector<unsigned char>& inUsedIndicesSorted, bool inMergeDuplicates, std::vector<unsigned char>& outTarget, std::vector<unsigned char>& outSources, unsigned int& outMergedCount) const
 	{
-		if (m_SequenceRelocationData.size() > 0)
+		const unsigned int row_count = inTableData.GetRowCount();
+		const unsigned int column_count = inTableData.GetColumnCount();
+
+		outTarget.assign(row_count, Unused);
+		outSources.clear();
+		outMergedCount = 0;
+
+		ContentMap row_contents;
+
+		for (unsigned char row_index : inUsedIndicesSorted)
 		{
-			int highest_to = 0;
+			if (row_index >= row_count)
+				continue;
 
-			for (const RelocationInfo& relocation_info : m_SequenceRelocationData)
+			if (inMergeDuplicates)
 			{
-				const int index_from = relocation_info.m_From;
-				const int index_to = relocation_info.m_To;
+				std::vector<unsigned char> content(column_count);
+
+				for (unsigned int i = 0; i < column_count; ++i)
+					content[i] = inTableData[row_index * column_count + i];
+
+				const auto result = row_contents.insert({ content, row_index });
 
-				if (relocation_info.m_To > highest_to)
-					highest_to = relocation_info.m_To;
+				if (!result.second)
+				{
+					outTarget[row_index] = outTarget[result.first->second];
+					++outMergedCount;
 
-				(*m_SequenceDataSources[index_to]) = (*m_SequenceDataSources[index_from]);
+					continue;
+				}
 			}
 
-			for (int i = highest_to + 1; i < static_cast<int>(m_SequenceDataSources.size()); ++i)
+			outTarget[row_index] = static_cast<unsigned char>(outSources.size());
+			outSources.push_back(row_index);
+		}
+	}
+
+
+	bool Optimizer::CanJoinSequences(unsigned char inFirstSequenceIndex, unsigned char inSecondSequenceIndex) const
+	{
+		const DataSourceSequence& first = *m_DataSources.m_Sequences[inFirstSequenceIndex];
+		const DataSourceSequence& second = *m_DataSources.m_Sequences[inSecondSequenceIndex];
+
+		const unsigned int length = first.GetLength() + second.GetLength();
+
+		if (length > DataSourceSequence::MaxEventCount)
+			return false;
+
+		// The joined sequence must fit in the memory of a sequence, once it is packed
+		DataSourceSequence joined(first);
+
+		for (unsigned int i = 0; i < second.GetLength(); ++i)
+			joined[first.GetLength() + i] = second[i];
+
+		joined.SetLength(length);
+
+		const DataSourceSequence::PackResult packed_result = joined.Pack();
+
+		return packed_result.m_Data != nullptr && packed_result.m_DataLength < 0x100 && packed_result.m_DataLength <= m_DriverInfo.GetMusicData().m_SequenceSize;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+
+	void Optimizer::Apply(const Plan& inPlan, DataSources& ioDataSources, bool inMoveTableText)
+	{
+		RelocateTableRows(m_InstrumentsTableID, *ioDataSources.m_InstrumentTable, inPlan.m_InstrumentSources, inMoveTableText);
+		RelocateTableRows(m_CommandsTableID, *ioDataSources.m_CommandTable, inPlan.m_CommandSources, inMoveTableText);
+		RelocateSequences(inPlan, ioDataSources);
+		AdjustOrderlists(inPlan, ioDataSources);
+	}
+
+
+	void Optimizer::RelocateTableRows(int inTableID, DataSourceTable& inTableData, const std::vector<unsigned char>& inSources, bool inMoveTableText)
+	{
+		const int stride = inTableData.GetColumnCount();
+		const int kept_row_count = static_cast<int>(inSources.size());
+
+		// The rows are only ever moved down, so moving them in order doesn't overwrite any row before it has been moved
+		for (int i = 0; i < kept_row_count; ++i)
+		{
+			const int index_from = stride * inSources[i];
+			const int index_to = stride * i;
+
+			if (index_from != index_to)
 			{
-				m_SequenceDataSources[i]->ClearEvents();
-				m_SequenceDataSources[i]->SetLength(1);
+				for (int j = 0; j < stride; ++j)
+					inTableData[index_to + j] = inTableData[index_from + j];
 			}
 		}
+
+		// Clear the rest of the table
+		for (int i = kept_row_count * stride; i < inTableData.GetSize(); ++i)
+			inTableData[i] = 0;
+
+		inTableData.PushDataToSource();
+
+		// Move description text, if table has any
+		auto& text_data = m_DriverInfo.GetAuxilaryDataCollection().GetTableText();
+
+		if (inMoveTableText && text_data.HasText(inTableID))
+		{
+			for (int i = 0; i < kept_row_count; ++i)
+			{
+				if (inSources[i] != i)
+				{
+					std::string desc = text_data.GetText(inTableID, inSources[i]);
+					text_data.SetText(inTableID, i, desc);
+				}
+			}
+
+			for (int i = kept_row_count; i < inTableData.GetSize() / stride; ++i)
+				text_data.SetText(inTableID, i, "");
+		}
 	}
 
 
-	void Optimizer::AdjustOrderlists()
+	void Optimizer::RelocateSequences(const Plan& inPlan, DataSources& ioDataSources)
 	{
-		if (m_SequenceRelocationData.size() > 0)
+		// Copy the events first, as a sequence may be joined with a sequence that is moved before it
+		std::vector<std::vector<DataSourceSequence::Event>> sequence_events;
+
+		for (const auto& sources : inPlan.m_SequenceSources)
+		{
+			sequence_events.push_back({});
+
+			for (unsigned char source_index : sources)
+			{
+				const DataSourceSequence& source = *ioDataSources.m_Sequences[source_index];
+
+				for (unsigned int i = 0; i < source.GetLength(); ++i)
+					sequence_events.back().push_back(source[i]);
+			}
+		}
+
+		for (unsigned int i = 0; i < ioDataSources.m_Sequences.size(); ++i)
 		{
-			// Sequences referenced from orderlist
-			for (const auto& orderlist : m_OrderListDataSources)
+			DataSourceSequence& sequence = *ioDataSources.m_Sequences[i];
+
+			if (i < sequence_events.size())
 			{
-				const unsigned int length = orderlist->GetLength();
+				const std::vector<DataSourceSequence::Event>& events = sequence_events[i];
+				const unsigned int length = static_cast<unsigned int>(events.size());
 
-				for (unsigned int i = 0; i < length; ++i)
+				for (unsigned int j = 0; j < length; ++j)
 				{
-					const unsigned char transpose = (*orderlist)[i].m_Transposition;
+					DataSourceSequence::Event& event = sequence[j];
+					event = events[j];
 
-					if (transpose < 0xfe)
-					{
-						unsigned char sequence_index = (*orderlist)[i].m_SequenceIndex;
-						const auto it = std::find_if(m_SequenceRelocationData.begin(), m_SequenceRelocationData.end(), [&](const auto& data) { return data.m_From == sequence_index; });
-						if (it != m_SequenceRelocationData.end())
-							(*orderlist)[i].m_SequenceIndex = (*it).m_To;
-					}
+					if (event.m_Instrument >= 0xa0)
+						event.m_Instrument = 0xa0 | GetTarget(inPlan.m_InstrumentTarget, event.m_Instrument & 0x1f);
+					if (event.m_Command >= 0xc0)
+						event.m_Command = 0xc0 | GetTarget(inPlan.m_CommandTarget, event.m_Command & 0x3f);
 				}
 
-				DataSourceOrderList::PackResult packed_result = orderlist->Pack();
-
-				if (packed_result.m_DataLength < 0x100)
-					orderlist->SendPackedDataToBuffer(packed_result);
+				for (unsigned int j = length; j < sequence.GetLength(); ++j)
+					sequence[j].Clear();
 
-				orderlist->PushDataToSource();
+				sequence.SetLength(length);
 			}
+			else
+			{
+				sequence.ClearEvents();
+				sequence.SetLength(1);
+			}
+
+			DataSourceSequence::PackResult packed_result = sequence.Pack();
+
+			if (packed_result.m_DataLength < 0x100 && packed_result.m_Data != nullptr)
+				sequence.SendPackedDataToBuffer(packed_result);
+
+			sequence.PushDataToSource();
 		}
 	}
 
 
-	void Optimizer::AdjustSequences()
+	void Optimizer::AdjustOrderlists(const Plan& inPlan, DataSources& ioDataSources)
 	{
-		for (const auto& sequence : m_SequenceDataSources)
+		for (const auto& orderlist : ioDataSources.m_OrderLists)
 		{
-			const unsigned int length = sequence->GetLength();
+			const unsigned int length = orderlist->GetLength();
 
-			for (unsigned int i = 0; i < length; ++i)
+			if (length == 0)
+				continue;
+
+			const DataSourceOrderList::Entry end_entry = (*orderlist)[length - 1];
+
+			unsigned int kept_length = 0;
+			unsigned int removed_before_loop_count = 0;
+
+			for (unsigned int i = 0; i + 1 < length; ++i)
 			{
-				auto& event = (*sequence)[i];
-				if (event.m_Instrument >= 0xa0 && m_InstrumentRelocationData.size() > 0)
-				{
-					const char instrument = event.m_Instrument & 0x1f;
+				DataSourceOrderList::Entry entry = (*orderlist)[i];
 
-					const auto it = std::find_if(m_InstrumentRelocationData.begin(), m_InstrumentRelocationData.end(), [&](const auto& data) { return data.m_From == instrument; });
-					if(it != m_InstrumentRelocationData.end())
-						event.m_Instrument = ((*it).m_To | 0xa0);
-				}
-				if (event.m_Command >= 0xc0 && m_CommandRelocatonInfo.size() > 0)
+				if (entry.m_Transposition < 0xfe && entry.m_SequenceIndex < inPlan.m_SequenceTarget.size())
 				{
-					const char command = event.m_Command & 0x3f;
+					const unsigned char sequence_index = entry.m_SequenceIndex;
 
-					const auto it = std::find_if(m_CommandRelocatonInfo.begin(), m_CommandRelocatonInfo.end(), [&](const auto& data) { return data.m_From == command; });
-					if(it != m_CommandRelocatonInfo.end())
-						event.m_Command = ((*it).m_To | 0xc0);
+					// The entries of a sequence that has been joined with the one before it are removed
+					if (inPlan.m_IsSequenceJoined[sequence_index])
+					{
+						if (i < end_entry.m_SequenceIndex)
+							++removed_before_loop_count;
+
+						continue;
+					}
+
+					entry.m_Transposition = static_cast<unsigned char>(entry.m_Transposition + inPlan.m_SequenceTransposition[sequence_index]);
+					entry.m_SequenceIndex = inPlan.m_SequenceTarget[sequence_index];
 				}
+
+				(*orderlist)[kept_length++] = entry;
 			}
 
-			DataSourceSequence::PackResult packed_result = sequence->Pack();
+			(*orderlist)[kept_length] = { end_entry.m_Transposition, static_cast<unsigned char>(end_entry.m_SequenceIndex - removed_before_loop_count) };
+			orderlist->ComputeLength();
+
+			DataSourceOrderList::PackResult packed_result = orderlist->Pack();
 
 			if (packed_result.m_DataLength < 0x100 && packed_result.m_Data != nullptr)
-				sequence->SendPackedDataToBuffer(packed_result);
-				
-			sequence->PushDataToSource();
+				orderlist->SendPackedDataToBuffer(packed_result);
+
+			orderlist->PushDataToSource();
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------------------
 
-	void Optimizer::BuildRelocationData(const std::vector<unsigned char>& inUsedIndicesSorted, std::vector<Optimizer::RelocationInfo>& outRelocationData)
+	Optimizer::DataSources Optimizer::CreateDataSources(Emulation::CPUMemory& inCPUMemory) const
 	{
-		unsigned char target_index = 0;
+		DataSources data_sources;
 
-		for (unsigned char source_index : inUsedIndicesSorted)
-		{
-			if (target_index != source_index)
-				outRelocationData.push_back({ source_index, target_index });
+		ScreenEditUtils::PrepareOrderListsDataSources(m_DriverInfo, inCPUMemory, data_sources.m_OrderLists);
+		ScreenEditUtils::PrepareSequenceDataSources(m_DriverInfo, m_CopyDriverState, inCPUMemory, data_sources.m_Sequences);
 
-			++target_index;
+		for (const auto& table_definition : m_DriverInfo.GetTableDefinitions())
+		{
+			if (table_definition.m_Type == DriverInfo::TableType::Instruments)
+				data_sources.m_InstrumentTable = DriverUtils::CreateTableDataSource(table_definition, &inCPUMemory);
+			else if (table_definition.m_Type == DriverInfo::TableType::Commands)
+				data_sources.m_CommandTable = DriverUtils::CreateTableDataSource(table_definition, &inCPUMemory);
 		}
+
+		return data_sources;
 	}
-}
 
+
+	unsigned int Optimizer::GetPackedSize(Emulation::CPUMemory& inCPUMemory, const DataSources& inDataSources) const
+	{
+		// The music data the packer takes along: the order lists, the sequences up to the highest one used with their pointers, and the
+		// instrument and command rows up to the highest ones used
+		SongUsageIndex song_usage_index(m_DriverInfo);
+		song_usage_index.Rebuild(inCPUMemory);
+
+		unsigned int packed_size = 0;
+
+		for (const auto& orderlist : inDataSources.m_OrderLists)
+			packed_size += orderlist->GetPackedSize();
+
+		for (unsigned int i = 0; i <= song_usage_index.GetHighestSequenceIndexUsed() && i < inDataSources.m_Sequences.size(); ++i)
+			packed_size += inDataSources.m_Sequences[i]->GetPackedSize() + 2;
+
+		packed_size += (song_usage_index.GetHighestInstrumentIndexUsed() + 1) * inDataSources.m_InstrumentTable->GetColumnCount();
+		packed_size += (song_usage_index.GetHighestCommandIndexUsed() + 1) * inDataSources.m_CommandTable->GetColumnCount();
+
+		return packed_size;
+	}
+}
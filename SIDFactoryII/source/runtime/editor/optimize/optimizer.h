@@ -1,8 +1,17 @@
 #pragma once
 
+#include "runtime/editor/driver/driver_state.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
+
 #include <memory>
+#include <string>
 #include <vector>
 
+namespace Foundation
+{
+	class IPlatform;
+}
+
 namespace Emulation
 {
 	class CPUMemory;
@@ -15,18 +24,65 @@ namespace Editor
 	class DataSourceSequence;
 	class DataSourceTable;
 
+	// Removes the sequences, instruments and commands that the song doesn't use, and moves the ones it does use to the lowest indices.
+	// Duplicates are merged on the way: sequences that are the same, or the same but transposed, and instrument and command rows that are
+	// the same. Pairs of sequences that are only ever played one after the other are joined.
+	//
+	// The optimization is done on a copy of the song first, and is only applied to the song if the register trace of the copy is identical
+	// to that of the song. If it isn't, the next level of optimization is tried, down to only removing what isn't used.
 	class Optimizer
 	{
+	public:
+		enum class Level : int
+		{
+			Deep,				// Merge transposed sequences, and join sequences that follow each other
+			Duplicates,			// Merge sequences, instruments and commands that are the same
+			Compact,			// Remove what isn't used
+
+			Count
+		};
+
 	private:
-		struct RelocationInfo
+		static const unsigned char Unused;
+
+		struct Plan
 		{
-			unsigned char m_From;
-			unsigned char m_To;
+			Level m_Level;
+
+			// By the current index: the new index, or Unused if the sequence or row is removed
+			std::vector<unsigned char> m_SequenceTarget;
+			std::vector<unsigned char> m_InstrumentTarget;
+			std::vector<unsigned char> m_CommandTarget;
+
+			// By the current index of a sequence: the change to the transposition of the order list entries playing it, and if the order
+			// list entries are removed, because the sequence has been joined onto the sequence played before it
+			std::vector<int> m_SequenceTransposition;
+			std::vector<bool> m_IsSequenceJoined;
+
+			// By the new index: the current indices of the sequences, in the order they are joined, and of the rows it is made of
+			std::vector<std::vector<unsigned char>> m_SequenceSources;
+			std::vector<unsigned char> m_InstrumentSources;
+			std::vector<unsigned char> m_CommandSources;
+
+			unsigned int m_MergedSequenceCount;
+			unsigned int m_MergedInstrumentCount;
+			unsigned int m_MergedCommandCount;
+			unsigned int m_JoinedSequenceCount;
+		};
+
+		struct DataSources
+		{
+			std::vector<std::shared_ptr<DataSourceOrderList>> m_OrderLists;
+			std::vector<std::shared_ptr<DataSourceSequence>> m_Sequences;
+			std::shared_ptr<DataSourceTable> m_InstrumentTable;
+			std::shared_ptr<DataSourceTable> m_CommandTable;
 		};
 
 	public:
 		Optimizer
 		(
+			Foundation::IPlatform* inPlatform,
+			const Emulation::SIDConfiguration& inSIDConfiguration,
 			Emulation::CPUMemory* inCPUMemory,
 			DriverInfo& inDriverInfo,
 			std::vector<std::shared_ptr<DataSourceOrderList>> inOrderListDataSources,
@@ -43,18 +99,33 @@ namespace Editor
 		const std::vector<unsigned char>& GetUsedInstrumentIndices() const;
 		const std::vector<unsigned char>& GetUsedCommandIndices() const;
 
-		void Execute();
+		// What the deepest level of optimization would merge and join, if it is verified
+		unsigned int GetMergedSequenceCount() const;
+		unsigned int GetMergedInstrumentCount() const;
+		unsigned int GetMergedCommandCount() const;
+		unsigned int GetJoinedSequenceCount() const;
+
+		// Returns false if the song was left as it is, because no level of optimization could be verified
+		bool Execute();
+		const std::string& GetReport() const;
 
 	private:
 		void GatherOptimizationData();
-		void BuildRelocationData();
-		void RelocateData();
 
-		void BuildRelocationData(const std::vector<unsigned char>& inUsedIndicesSorted, std::vector<RelocationInfo>& outRelocationData);
-		void RelocateTableRows(int inTableID, std::shared_ptr<DataSourceTable>& inTableData, const std::vector<RelocationInfo>& inRelocationInfo, const std::vector<unsigned char>& inUsedIndicesSorted);
-		void RelocateSequences();
-		void AdjustOrderlists();
-		void AdjustSequences();
+		Plan BuildPlan(Level inLevel) const;
+		void BuildTableRowPlan(const DataSourceTable& inTableData, const std::vector<unsigned char>& inUsedIndicesSorted, bool inMergeDuplicates, std::vector<unsigned char>& outTarget, std::vector<unsigned char>& outSources, unsigned int& outMergedCount) const;
+		bool CanJoinSequences(unsigned char inFirstSequenceIndex, unsigned char inSecondSequenceIndex) const;
+
+		void Apply(const Plan& inPlan, DataSources& ioDataSources, bool inMoveTableText);
+		void RelocateTableRows(int inTableID, DataSourceTable& inTableData, const std::vector<unsigned char>& inSources, bool inMoveTableText);
+		void RelocateSequences(const Plan& inPlan, DataSources& ioDataSources);
+		void AdjustOrderlists(const Plan& inPlan, DataSources& ioDataSources);
+
+		DataSources CreateDataSources(Emulation::CPUMemory& inCPUMemory) const;
+		unsigned int GetPackedSize(Emulation::CPUMemory& inCPUMemory, const DataSources& inDataSources) const;
+
+		Foundation::IPlatform* m_Platform;
+		const Emulation::SIDConfiguration m_SIDConfiguration;
 
 		Emulation::CPUMemory* m_CPUMemory;
 
@@ -66,19 +137,24 @@ namespace Editor
 		int m_CommandsTableID;
 
 		// Data sources
-		std::vector<std::shared_ptr<DataSourceOrderList>> m_OrderListDataSources;
-		std::vector<std::shared_ptr<DataSourceSequence>> m_SequenceDataSources;
-		std::shared_ptr<DataSourceTable> m_InstrumentTableDataSource;
-		std::shared_ptr<DataSourceTable> m_CommandTableDataSource;
+		DataSources m_DataSources;
 
 		// Optimization data
 		std::vector<unsigned char> m_UsedSequenceIndices;
 		std::vector<unsigned char> m_UsedInstrumentIndices;
 		std::vector<unsigned char> m_UsedCommandIndices;
 
-		// Relocation data
-		std::vector<RelocationInfo> m_SequenceRelocationData;
-		std::vector<RelocationInfo> m_InstrumentRelocationData;
-		std::vector<RelocationInfo> m_CommandRelocatonInfo;
+		// The number of times each sequence is played from the order lists
+		std::vector<int> m_SequenceReferenceCount;
+
+		// The range of the transpositions each sequence is played with
+		std::vector<unsigned char> m_SequenceLowestTransposition;
+		std::vector<unsigned char> m_SequenceHighestTransposition;
+
+		// The state the sequence data sources of the copies of the song are made with
+		DriverState m_CopyDriverState;
+
+		Plan m_DeepPlan;
+		std::string m_Report;
 	};
-}
\ No newline at end of file
+}
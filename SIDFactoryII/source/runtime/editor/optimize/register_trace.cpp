@@ -0,0 +1,186 @@
+#include "runtime/editor/optimize/register_trace.h"
+#include "runtime/editor/driver/driver_info.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpuframecapture.h"
+#include "runtime/environmentdefines.h"
+#include "utils/c64file.h"
+
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace Emulation;
+
+namespace Editor
+{
+	// The area of the I/O space any of the SID chips can be placed in
+	static const unsigned short CaptureRangeBegin = 0xd400;
+	static const unsigned short CaptureRangeEnd = 0xd7ff;
+
+
+	RegisterTrace::RegisterTrace(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration)
+		: m_CyclesPerFrame(inSIDConfiguration.m_eEnvironment == SID_ENVIRONMENT_PAL ? EMULATION_CYCLES_PER_FRAME_PAL : EMULATION_CYCLES_PER_FRAME_NTSC)
+	{
+		m_CPUMemory = std::make_unique<CPUMemory>(0x10000, inPlatform);
+		m_CPU = std::make_unique<CPUmos6510>();
+		m_CPU->SetExecutionCore(CPUmos6510::ExecutionCore::Fast);
+		m_FrameCapture = std::make_unique<CPUFrameCapture>(m_CPU.get(), CaptureRangeBegin, CaptureRangeEnd, m_CyclesPerFrame);
+	}
+
+	RegisterTrace::~RegisterTrace()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	bool RegisterTrace::Record(const CPUMemory& inMemory, const DriverInfo& inDriverInfo, unsigned int inFrameCount, unsigned int inEndEventPosition)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inMemory.GetSize() == m_CPUMemory->GetSize());
+
+		const DriverInfo::DriverCommon& driver_common = inDriverInfo.GetDriverCommon();
+
+		m_CPUMemory->Lock();
+		inMemory.GetData(0, &(*m_CPUMemory)[0], m_CPUMemory->GetSize());
+
+		const bool result = Run(driver_common.m_InitAddress, driver_common.m_UpdateAddress, driver_common.m_TempoCounterAddress, inFrameCount, inEndEventPosition);
+
+		m_CPUMemory->Unlock();
+
+		return result;
+	}
+
+
+	bool RegisterTrace::Record(const Utility::C64File& inFile, unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned int inFrameCount)
+	{
+		m_CPUMemory->Lock();
+		m_CPUMemory->Clear();
+		m_CPUMemory->SetData(inFile.GetTopAddress(), inFile.GetData(), inFile.GetDataSize());
+
+		const bool result = Run(inInitAddress, inUpdateAddress, 0, inFrameCount, 0);
+
+		m_CPUMemory->Unlock();
+
+		return result;
+	}
+
+
+	unsigned int RegisterTrace::GetFrameCount() const
+	{
+		return m_FrameWriteOffsets.empty() ? 0 : static_cast<unsigned int>(m_FrameWriteOffsets.size() - 1);
+	}
+
+
+	bool RegisterTrace::IsIdentical(const RegisterTrace& inOther, unsigned int& outFrame, std::string& outDifference) const
+	{
+		auto to_hex = [](unsigned int inValue, int inDigits)
+		{
+			std::stringstream stream;
+			stream << "$" << std::hex << std::setw(inDigits) << std::setfill('0') << inValue;
+
+			return stream.str();
+		};
+
+		const unsigned int frame_count = std::min(GetFrameCount(), inOther.GetFrameCount());
+
+		for (unsigned int frame = 0; frame < frame_count; ++frame)
+		{
+			const unsigned int begin = m_FrameWriteOffsets[frame];
+			const unsigned int count = m_FrameWriteOffsets[frame + 1] - begin;
+			const unsigned int other_begin = inOther.m_FrameWriteOffsets[frame];
+			const unsigned int other_count = inOther.m_FrameWriteOffsets[frame + 1] - other_begin;
+
+			for (unsigned int i = 0; i < std::min(count, other_count); ++i)
+			{
+				const Write& write = m_Writes[begin + i];
+				const Write& other_write = inOther.m_Writes[other_begin + i];
+
+				if (write.m_Address != other_write.m_Address || write.m_Value != other_write.m_Value)
+				{
+					outFrame = frame;
+					outDifference = "Frame " + std::to_string(frame) + ": write of " + to_hex(write.m_Value, 2) + " to " + to_hex(write.m_Address, 4)
+						+ " differs from write of " + to_hex(other_write.m_Value, 2) + " to " + to_hex(other_write.m_Address, 4);
+					return false;
+				}
+			}
+
+			if (count != other_count)
+			{
+				outFrame = frame;
+				outDifference = "Frame " + std::to_string(frame) + ": the number of writes differs";
+				return false;
+			}
+		}
+
+		if (GetFrameCount() != inOther.GetFrameCount())
+		{
+			outFrame = frame_count;
+			outDifference = "The traces are of " + std::to_string(GetFrameCount()) + " and " + std::to_string(inOther.GetFrameCount()) + " frames";
+			return false;
+		}
+
+		return true;
+	}
+
+
+	const std::string& RegisterTrace::GetErrorMessage() const
+	{
+		return m_ErrorMessage;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	bool RegisterTrace::Run(unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned short inTempoCounterAddress, unsigned int inFrameCount, unsigned int inEndEventPosition)
+	{
+		FOUNDATION_ASSERT(m_CPUMemory->IsLocked());
+
+		m_Writes.clear();
+		m_FrameWriteOffsets.clear();
+		m_ErrorMessage.clear();
+
+		CPUMemory& memory = *m_CPUMemory;
+		CPUFrameCapture& frame_capture = *m_FrameCapture;
+
+		m_CPU->SetMemory(&memory);
+
+		const bool is_following_event_position = inEndEventPosition > 0 && inTempoCounterAddress != 0;
+		unsigned int event_position = 0;
+
+		for (unsigned int frame = 0; frame < inFrameCount; ++frame)
+		{
+			frame_capture.Begin();
+
+			if (frame == 0)
+				frame_capture.Capture(inInitAddress, 0);
+			if (!frame_capture.IsMaxCycleCountReached())
+				frame_capture.Capture(inUpdateAddress, 0);
+
+			frame_capture.End();
+
+			if (frame_capture.IsMaxCycleCountReached() || frame_capture.IsWriteLogOverflowed())
+			{
+				m_ErrorMessage = "Emulation of 6510 code exceeded cycle window in frame " + std::to_string(frame) + "!";
+				break;
+			}
+
+			m_FrameWriteOffsets.push_back(static_cast<unsigned int>(m_Writes.size()));
+
+			while (frame_capture.HasNext())
+			{
+				const CPUFrameCapture::WriteCapture& write = frame_capture.GetNext();
+				m_Writes.push_back({ write.m_usReg, write.m_ucVal });
+			}
+
+			// Follow the event position the same way as the editor does during playback
+			if (is_following_event_position && memory[inTempoCounterAddress] == 0 && ++event_position >= inEndEventPosition)
+				break;
+		}
+
+		m_FrameWriteOffsets.push_back(static_cast<unsigned int>(m_Writes.size()));
+
+		return m_ErrorMessage.empty();
+	}
+}
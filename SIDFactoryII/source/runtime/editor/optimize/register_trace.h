@@ -0,0 +1,73 @@
+#pragma once
+
+#include "runtime/emulation/sid/sidproxydefines.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+	class CPUmos6510;
+	class CPUFrameCapture;
+}
+
+namespace Utility
+{
+	class C64File;
+}
+
+namespace Editor
+{
+	class DriverInfo;
+
+	// Records the writes the driver does to the SID registers, frame by frame, from the driver being initialized. The driver is run
+	// headless on a copy of the song, the same way the editor plays it. Two songs that give the same trace sound the same, which is
+	// how changes to the music data that are meant to leave the sound as it is, are verified.
+	class RegisterTrace final
+	{
+	public:
+		RegisterTrace(Foundation::IPlatform* inPlatform, const Emulation::SIDConfiguration& inSIDConfiguration);
+		~RegisterTrace();
+
+		// Runs the driver for a number of frames, or until the event position reaches the end event position, if that isn't 0. The memory must be locked.
+		bool Record(const Emulation::CPUMemory& inMemory, const DriverInfo& inDriverInfo, unsigned int inFrameCount, unsigned int inEndEventPosition);
+
+		// Runs a file that is loaded on its own into memory that is otherwise cleared, such as a packed song, for a number of frames
+		bool Record(const Utility::C64File& inFile, unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned int inFrameCount);
+
+		unsigned int GetFrameCount() const;
+
+		// Compares the writes of every frame, in the order they were done. The cycles they were done on are not compared, as these
+		// move with the layout of the music data. If the traces differ, the first frame they differ in is given.
+		bool IsIdentical(const RegisterTrace& inOther, unsigned int& outFrame, std::string& outDifference) const;
+
+		const std::string& GetErrorMessage() const;
+
+	private:
+		bool Run(unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned short inTempoCounterAddress, unsigned int inFrameCount, unsigned int inEndEventPosition);
+
+		struct Write
+		{
+			unsigned short m_Address;
+			unsigned char m_Value;
+		};
+
+		const unsigned int m_CyclesPerFrame;
+
+		std::unique_ptr<Emulation::CPUMemory> m_CPUMemory;
+		std::unique_ptr<Emulation::CPUmos6510> m_CPU;
+		std::unique_ptr<Emulation::CPUFrameCapture> m_FrameCapture;
+
+		std::vector<Write> m_Writes;
+		std::vector<unsigned int> m_FrameWriteOffsets;		// The first write of each frame, with the end of the writes last
+
+		std::string m_ErrorMessage;
+	};
+}
@@ -72,6 +72,12 @@ namespace Editor
 	}
 
 
+	bool OverlayControl::IsFading() const
+	{
+		return m_IsFading;
+	}
+
+
 	void OverlayControl::SetOverlayEnabled(bool inEnabled)
 	{
 		if (m_Enabled != inEnabled && !m_IsFading)
@@ -27,6 +27,7 @@ namespace Editor
 		bool GetOverlayEnabled() const;
 
 		void Update(int inDeltaTicks);
+		bool IsFading() const;
 
 		void OnChange(const DriverInfo& inDriverInfo);
 		void OnWindowResized();
@@ -0,0 +1,323 @@
+#include "overlay_cpu_profile.h"
+
+#include "foundation/graphics/viewport.h"
+#include "foundation/graphics/textfield.h"
+#include "runtime/editor/display_state.h"
+#include "runtime/editor/utilities/editor_utils.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpuprofile.h"
+#include "runtime/execution/executionhandler.h"
+#include "utils/usercolors.h"
+
+#include <stdio.h>
+
+using namespace Foundation;
+using namespace Emulation;
+using namespace Utility;
+
+namespace Editor
+{
+	namespace
+	{
+		const int RefreshInterval = 500;
+
+		// The disassembly only shows the executed instructions this far from the hottest address
+		const int DisassemblyRange = 0x100;
+
+		const char* const RoutineNames[CPUProfile::RoutineCount] = { "Init", "Stop", "Update", "Fast forward" };
+
+		std::string PadLeft(const std::string& inString, size_t inWidth)
+		{
+			return inString.size() < inWidth ? std::string(inWidth - inString.size(), ' ') + inString : inString;
+		}
+
+		std::string PadRight(const std::string& inString, size_t inWidth)
+		{
+			return inString.size() < inWidth ? inString + std::string(inWidth - inString.size(), ' ') : inString;
+		}
+	}
+
+
+	OverlayCPUProfile::OverlayCPUProfile(Foundation::Viewport* inViewport, Emulation::CPUMemory* inCPUMemory, Emulation::ExecutionHandler* inExecutionHandler, const Foundation::Extent& inMainTextFieldDimensions)
+		: m_Enabled(false)
+		, m_TicksToRefresh(0)
+		, m_ExecutionHandler(inExecutionHandler)
+		, m_CPUMemory(inCPUMemory)
+		, m_Viewport(inViewport)
+		, m_TotalCycles(0)
+	{
+		const unsigned int margin_h = 4;
+		const unsigned int margin_v = 2;
+		const unsigned int width = inMainTextFieldDimensions.m_Width - 2 * margin_h;
+		const unsigned int height = inMainTextFieldDimensions.m_Height - 2 * margin_v;
+		const unsigned int x = margin_h * Foundation::TextField::font_width;
+		const unsigned int y = margin_v * Foundation::TextField::font_height;
+
+		m_TextField = m_Viewport->CreateTextField(width, height, x, y);
+		m_TextField->SetEnable(false);
+
+		m_TextField->ColorAreaBackground(ToColor(UserColor::FlightRecorderBackground));
+	}
+
+
+	OverlayCPUProfile::~OverlayCPUProfile()
+	{
+		// Stop profiling, so the CPU runs on the fast core again
+		if (m_Enabled)
+			m_ExecutionHandler->SetCPUProfileEnabled(false);
+
+		m_Viewport->Destroy(m_TextField);
+	}
+
+
+	void OverlayCPUProfile::SetEnabled(bool inEnabled)
+	{
+		if (inEnabled != m_Enabled)
+		{
+			m_Enabled = inEnabled;
+
+			m_TextField->SetEnable(inEnabled);
+			m_ExecutionHandler->SetCPUProfileEnabled(inEnabled);
+
+			if (m_Profile == nullptr)
+				m_Profile = std::make_unique<CPUProfile>();
+
+			m_TicksToRefresh = 0;
+		}
+	}
+
+
+	bool OverlayCPUProfile::IsEnabled() const
+	{
+		return m_Enabled;
+	}
+
+
+	void OverlayCPUProfile::Update(int inDeltaTick, const DisplayState& inDisplayState)
+	{
+		if (!m_Enabled)
+			return;
+
+		m_TicksToRefresh -= inDeltaTick;
+
+		if (m_TicksToRefresh <= 0)
+		{
+			m_TicksToRefresh = RefreshInterval;
+
+			if (m_ExecutionHandler->GetCPUProfile(*m_Profile))
+				Refresh(inDisplayState);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void OverlayCPUProfile::Refresh(const DisplayState& inDisplayState)
+	{
+		const bool is_uppercase = inDisplayState.IsHexUppercase();
+		const Extent dimensions = m_TextField->GetDimensions();
+
+		m_TotalCycles = m_Profile->GetTotalCycles();
+
+		m_TextField->Clear();
+		m_TextField->Print(2, 1, ToColor(UserColor::FlightRecorderDesc), "6510 profile, " + std::to_string(m_TotalCycles) + " cycles since shown");
+
+		const std::vector<CPUProfile::AddressEntry> hot_addresses = m_Profile->GetHotAddresses(static_cast<unsigned int>(dimensions.m_Height - 14));
+
+		PrintRoutines(2, 3);
+
+		// The instructions are read from memory
+		m_CPUMemory->Lock();
+
+		PrintHotAddresses(2, 11, hot_addresses, is_uppercase);
+
+		if (!hot_addresses.empty())
+			PrintDisassembly(78, 3, dimensions.m_Height - 6, hot_addresses[0].m_Address, is_uppercase);
+
+		m_CPUMemory->Unlock();
+	}
+
+
+	void OverlayCPUProfile::PrintRoutines(int inX, int inY)
+	{
+		const Color color_desc = ToColor(UserColor::FlightRecorderDesc);
+		const Color color_text = ToColor(UserColor::FlightRecorderCPUUsageLow);
+
+		m_TextField->Print(inX, inY, color_desc, "Routine            Calls         Cycles  Cycles/call   Share");
+
+		for (unsigned int i = 0; i < CPUProfile::RoutineCount; ++i)
+		{
+			const CPUProfile::Routine routine = static_cast<CPUProfile::Routine>(i);
+			const unsigned long long call_count = m_Profile->GetRoutineCallCount(routine);
+			const unsigned long long cycles = m_Profile->GetRoutineCycles(routine);
+			const unsigned long long cycles_per_call = call_count > 0 ? cycles / call_count : 0;
+
+			const std::string line = PadRight(RoutineNames[i], 13)
+				+ PadLeft(std::to_string(call_count), 11)
+				+ PadLeft(std::to_string(cycles), 15)
+				+ PadLeft(std::to_string(cycles_per_call), 13)
+				+ PadLeft(GetShareString(cycles), 8);
+
+			m_TextField->Print(inX, inY + 2 + static_cast<int>(i), color_text, line);
+		}
+	}
+
+
+	void OverlayCPUProfile::PrintHotAddresses(int inX, int inY, const std::vector<CPUProfile::AddressEntry>& inHotAddresses, bool inIsUppercase)
+	{
+		const Color color_desc = ToColor(UserColor::FlightRecorderDesc);
+
+		m_TextField->Print(inX, inY, color_desc, "Address  Instruction         Executed         Cycles  Cycles/exec   Share");
+
+		for (size_t i = 0; i < inHotAddresses.size(); ++i)
+		{
+			const CPUProfile::AddressEntry& entry = inHotAddresses[i];
+			const unsigned long long cycles_per_execution = entry.m_ExecutionCount > 0 ? entry.m_Cycles / entry.m_ExecutionCount : 0;
+
+			const std::string line = EditorUtils::ConvertToHexValue(entry.m_Address, inIsUppercase) + "     "
+				+ PadRight(DisassembleInstruction(entry.m_Address, inIsUppercase), 14)
+				+ PadLeft(std::to_string(entry.m_ExecutionCount), 14)
+				+ PadLeft(std::to_string(entry.m_Cycles), 15)
+				+ PadLeft(std::to_string(cycles_per_execution), 13)
+				+ PadLeft(GetShareString(entry.m_Cycles), 8);
+
+			const double share = m_TotalCycles > 0 ? static_cast<double>(entry.m_Cycles) / static_cast<double>(m_TotalCycles) : 0.0;
+			const UserColor color = share >= 0.1 ? UserColor::FlightRecorderCPUUsageHigh : (share >= 0.02 ? UserColor::FlightRecorderCPUUsageMedium : UserColor::FlightRecorderCPUUsageLow);
+
+			m_TextField->Print(inX, inY + 2 + static_cast<int>(i), ToColor(color), line);
+		}
+	}
+
+
+	void OverlayCPUProfile::PrintDisassembly(int inX, int inY, int inMaxCount, unsigned short inAddress, bool inIsUppercase)
+	{
+		const Color color_desc = ToColor(UserColor::FlightRecorderDesc);
+
+		m_TextField->Print(inX, inY, color_desc, "Hottest code");
+		m_TextField->Print(inX, inY + 1, color_desc, "Address Bytes     Instruction           Executed   Share");
+
+		// Every address an instruction was executed from is the start of an instruction, so the executed code can be listed from
+		// the profile alone. Half of the lines are spent on the code leading up to the hottest address.
+		const int lines_before = (inMaxCount - 2) / 2;
+
+		int first_address = inAddress;
+		int found_before = 0;
+
+		for (int address = inAddress - 1; address >= 0 && address >= inAddress - DisassemblyRange && found_before < lines_before; --address)
+		{
+			if (m_Profile->GetExecutionCount(static_cast<unsigned short>(address)) > 0)
+			{
+				first_address = address;
+				++found_before;
+			}
+		}
+
+		int y = inY + 2;
+		int next_address = -1;
+
+		for (int address = first_address; address < static_cast<int>(CPUProfile::AddressCount) && address <= inAddress + DisassemblyRange && y < inY + inMaxCount; ++address)
+		{
+			const unsigned short address_word = static_cast<unsigned short>(address);
+			const unsigned long long execution_count = m_Profile->GetExecutionCount(address_word);
+
+			if (execution_count == 0)
+				continue;
+
+			// Mark where code, which was not executed, has been left out
+			if (next_address >= 0 && next_address != address)
+				m_TextField->Print(inX, y++, color_desc, "...");
+
+			if (y >= inY + inMaxCount)
+				break;
+
+			const unsigned char opcode = (*m_CPUMemory)[address];
+			const int byte_size = CPUmos6510::GetOpcodeByteSize(opcode);
+
+			std::string bytes;
+
+			for (int i = 0; i < byte_size; ++i)
+				bytes += EditorUtils::ConvertToHexValue((*m_CPUMemory)[(address + i) & 0xffff], inIsUppercase) + " ";
+
+			const unsigned long long cycles = m_Profile->GetCycles(address_word);
+			const std::string line = EditorUtils::ConvertToHexValue(address_word, inIsUppercase) + "    "
+				+ PadRight(bytes, 10)
+				+ PadRight(DisassembleInstruction(address_word, inIsUppercase), 14)
+				+ PadLeft(std::to_string(execution_count), 16)
+				+ PadLeft(GetShareString(cycles), 8);
+
+			const UserColor color = address == inAddress ? UserColor::FlightRecorderCPUUsageHigh : UserColor::FlightRecorderCPUUsageLow;
+			m_TextField->Print(inX, y++, ToColor(color), line);
+
+			next_address = address + byte_size;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	std::string OverlayCPUProfile::GetShareString(unsigned long long inCycles) const
+	{
+		char buffer[16];
+		snprintf(buffer, sizeof(buffer), "%.1f%%", m_TotalCycles > 0 ? 100.0 * static_cast<double>(inCycles) / static_cast<double>(m_TotalCycles) : 0.0);
+
+		return std::string(buffer);
+	}
+
+
+	std::string OverlayCPUProfile::DisassembleInstruction(unsigned short inAddress, bool inIsUppercase) const
+	{
+		const CPUMemory& memory = *m_CPUMemory;
+
+		const unsigned char opcode = memory[inAddress];
+		const unsigned char operand_low = memory[(inAddress + 1) & 0xffff];
+		const unsigned char operand_high = memory[(inAddress + 2) & 0xffff];
+		const unsigned short operand_word = static_cast<unsigned short>(operand_low | (operand_high << 8));
+
+		auto hex_byte = [&]() { return "$" + EditorUtils::ConvertToHexValue(operand_low, inIsUppercase); };
+		auto hex_word = [&]() { return "$" + EditorUtils::ConvertToHexValue(operand_word, inIsUppercase); };
+
+		std::string operand;
+
+		switch (CPUmos6510::GetOpcodeAddressingMode(opcode))
+		{
+		case CPUmos6510::am_IMP:
+			break;
+		case CPUmos6510::am_IMM:
+			operand = "#" + hex_byte();
+			break;
+		case CPUmos6510::am_ZP:
+			operand = hex_byte();
+			break;
+		case CPUmos6510::am_ZPX:
+			operand = hex_byte() + ",X";
+			break;
+		case CPUmos6510::am_ZPY:
+			operand = hex_byte() + ",Y";
+			break;
+		case CPUmos6510::am_IZX:
+			operand = "(" + hex_byte() + ",X)";
+			break;
+		case CPUmos6510::am_IZY:
+			operand = "(" + hex_byte() + "),Y";
+			break;
+		case CPUmos6510::am_ABS:
+			operand = hex_word();
+			break;
+		case CPUmos6510::am_ABX:
+			operand = hex_word() + ",X";
+			break;
+		case CPUmos6510::am_ABY:
+			operand = hex_word() + ",Y";
+			break;
+		case CPUmos6510::am_IND:
+			operand = "(" + hex_word() + ")";
+			break;
+		case CPUmos6510::am_REL:
+			operand = "$" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(inAddress + 2 + static_cast<signed char>(operand_low)), inIsUppercase);
+			break;
+		}
+
+		const std::string mnemonic = CPUmos6510::GetOpcodeMnemonic(opcode);
+
+		return operand.empty() ? mnemonic : mnemonic + " " + operand;
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "foundation/base/types.h"
+#include "runtime/emulation/cpuprofile.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class Viewport;
+	class TextField;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+	class ExecutionHandler;
+}
+
+namespace Editor
+{
+	class DisplayState;
+
+	// Shows where the driver spends its cycles: the cycles of each routine, the addresses taking the most cycles, and a disassembly of
+	// the code around the hottest address, with the share of the cycles of each instruction. The CPU is only profiled while the overlay
+	// is shown, and the profile starts over every time it is shown.
+	class OverlayCPUProfile
+	{
+	public:
+		OverlayCPUProfile(Foundation::Viewport* inViewport, Emulation::CPUMemory* inCPUMemory, Emulation::ExecutionHandler* inExecutionHandler, const Foundation::Extent& inMainTextFieldDimensions);
+		~OverlayCPUProfile();
+
+		void SetEnabled(bool inEnabled);
+		bool IsEnabled() const;
+
+		void Update(int inDeltaTick, const DisplayState& inDisplayState);
+
+	private:
+		void Refresh(const DisplayState& inDisplayState);
+		void PrintRoutines(int inX, int inY);
+		void PrintHotAddresses(int inX, int inY, const std::vector<Emulation::CPUProfile::AddressEntry>& inHotAddresses, bool inIsUppercase);
+		void PrintDisassembly(int inX, int inY, int inMaxCount, unsigned short inAddress, bool inIsUppercase);
+
+		std::string GetShareString(unsigned long long inCycles) const;
+
+		// The memory must be locked
+		std::string DisassembleInstruction(unsigned short inAddress, bool inIsUppercase) const;
+
+		bool m_Enabled;
+		int m_TicksToRefresh;
+
+		Emulation::ExecutionHandler* m_ExecutionHandler;
+		Emulation::CPUMemory* m_CPUMemory;
+		Foundation::Viewport* m_Viewport;
+		Foundation::TextField* m_TextField;
+
+		// A copy of the profile of the execution handler, taken at every refresh
+		std::unique_ptr<Emulation::CPUProfile> m_Profile;
+		unsigned long long m_TotalCycles;
+	};
+}
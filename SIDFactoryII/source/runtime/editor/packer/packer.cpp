@@ -30,6 +30,7 @@ namespace Editor
 		, m_OrderListPointersDataSectionHighID(0)
 		, m_SequencePointersDataSectionLowID(0)
 		, m_SequencePointersDataSectionHighID(0)
+		, m_SongUsageIndex(inDriverInfo)
 	{
 		FOUNDATION_ASSERT(inDriverInfo.IsValid());
 
@@ -40,6 +41,9 @@ namespace Editor
 
 		m_CPUMemory.Lock();
 
+		// Scan the music data once, for the highest sequence, instrument and command used
+		m_SongUsageIndex.Rebuild(m_CPUMemory);
+
 		FetchTables();
 		FetchOrderListPointers();
 		FetchSequencePointers();
@@ -112,9 +116,9 @@ namespace Editor
 				const unsigned short data_size = [&]()
 				{
 					if (table.m_Type == DriverInfo::TableType::Instruments)
-						return static_cast<unsigned short>(DriverUtils::GetHighestInstrumentIndexUsed(m_DriverInfo, m_CPUMemory)) + 1;
+						return static_cast<unsigned short>(m_SongUsageIndex.GetHighestInstrumentIndexUsed()) + 1;
 					if (table.m_Type == DriverInfo::TableType::Commands)
-						return static_cast<unsigned short>(DriverUtils::GetHighestCommandIndexUsed(m_DriverInfo, m_CPUMemory)) + 1;
+						return static_cast<unsigned short>(m_SongUsageIndex.GetHighestCommandIndexUsed()) + 1;
 
 					return static_cast<unsigned short>(DriverUtils::GetHighestTableRowUsedIndex(table, m_CPUMemory)) + 1;
 				}();
@@ -130,9 +134,9 @@ namespace Editor
 				const unsigned short data_size = [&]()
 				{
 					if (table.m_Type == DriverInfo::TableType::Instruments)
-						return static_cast<unsigned short>(table.m_ColumnCount * (DriverUtils::GetHighestInstrumentIndexUsed(m_DriverInfo, m_CPUMemory) + 1));
+						return static_cast<unsigned short>(table.m_ColumnCount * (m_SongUsageIndex.GetHighestInstrumentIndexUsed() + 1));
 					if (table.m_Type == DriverInfo::TableType::Commands)
-						return static_cast<unsigned short>(table.m_ColumnCount * (DriverUtils::GetHighestCommandIndexUsed(m_DriverInfo, m_CPUMemory) + 1));
+						return static_cast<unsigned short>(table.m_ColumnCount * (m_SongUsageIndex.GetHighestCommandIndexUsed() + 1));
 
 					return static_cast<unsigned short>(table.m_ColumnCount * (DriverUtils::GetHighestTableRowUsedIndex(table, m_CPUMemory) + 1));
 				}();
@@ -157,7 +161,7 @@ namespace Editor
 
 	void Packer::FetchSequencePointers()
 	{
-		unsigned char higest_sequence_used = DriverUtils::GetHighestSequenceIndexUsed(m_DriverInfo, m_CPUMemory);
+		unsigned char higest_sequence_used = m_SongUsageIndex.GetHighestSequenceIndexUsed();
 		unsigned short data_size = static_cast<unsigned short>(higest_sequence_used) + 1;
 
 		const unsigned short sequence_pointers_low_address = m_DriverInfo.GetMusicData().m_SequencePointersLowAddress;
@@ -182,7 +186,7 @@ namespace Editor
 
 	void Packer::FetchSequences()
 	{
-		m_HighestUsedSequenceIndex = DriverUtils::GetHighestSequenceIndexUsed(m_DriverInfo, m_CPUMemory);
+		m_HighestUsedSequenceIndex = m_SongUsageIndex.GetHighestSequenceIndexUsed();
 		const auto& music_data = m_DriverInfo.GetMusicData();
 
 		for (int i = 0; i <= m_HighestUsedSequenceIndex; ++i)
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "runtime/editor/driver/driver_info.h"
+#include "runtime/editor/driver/song_usage_index.h"
 #include "runtime/emulation/cpumemory.h"
 
 namespace Emulation
@@ -80,6 +81,8 @@ namespace Editor
 		const DriverInfo& m_DriverInfo;
 		Emulation::CPUMemory& m_CPUMemory;
 
+		SongUsageIndex m_SongUsageIndex;
+
 		std::shared_ptr<Utility::C64File> m_OutputData;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "runtime/editor/packer/packer_batch.h"
+#include "runtime/editor/packer/packer.h"
+#include "runtime/editor/optimize/register_trace.h"
+#include "runtime/editor/driver/driver_info.h"
+#include "runtime/editor/driver/driver_state.h"
+#include "runtime/editor/datasources/datasource_orderlist.h"
+#include "runtime/editor/datasources/datasource_sequence.h"
+#include "runtime/editor/components/component_track_utils.h"
+#include "runtime/editor/screens/screen_edit_utils.h"
+#include "runtime/editor/utilities/editor_utils.h"
+#include "runtime/emulation/cpumemory.h"
+#include "utils/c64file.h"
+
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+#include "SDL.h"
+#include <algorithm>
+
+using namespace Emulation;
+
+namespace Editor
+{
+	// Songs that don't reach their end are played for ten minutes
+	static const unsigned int DefaultMaxFrameCount = 50 * 60 * 10;
+
+	// The packed song can't be played from where the I/O is, when the driver writes to the SID
+	static const unsigned int IOAreaBegin = 0xd000;
+	static const unsigned int IOAreaEnd = 0xe000;
+
+
+	PackerBatch::PackerBatch(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration)
+		: m_Platform(inPlatform)
+		, m_SIDConfiguration(inSIDConfiguration)
+		, m_DriverInfo(nullptr)
+		, m_PackedSize(0)
+		, m_NextResultIndex(0)
+		, m_BuildTimeInSeconds(0.0)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+	}
+
+	PackerBatch::~PackerBatch()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	bool PackerBatch::SetSong(const CPUMemory& inMemory, const DriverInfo& inDriverInfo, unsigned int inMaxFrameCount)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inDriverInfo.IsValid());
+
+		m_SongMemory.resize(inMemory.GetSize());
+		inMemory.GetData(0, &m_SongMemory[0], inMemory.GetSize());
+
+		m_DriverInfo = &inDriverInfo;
+		m_ErrorMessage.clear();
+
+		CPUMemory song_memory(inMemory.GetSize(), m_Platform);
+		song_memory.Lock();
+		song_memory.SetData(0, &m_SongMemory[0], static_cast<unsigned int>(m_SongMemory.size()));
+
+		// The song has played through, when the longest track reaches its end
+		DriverState driver_state;
+		std::vector<std::shared_ptr<DataSourceOrderList>> order_lists;
+		std::vector<std::shared_ptr<DataSourceSequence>> sequences;
+
+		ScreenEditUtils::PrepareOrderListsDataSources(inDriverInfo, song_memory, order_lists);
+		ScreenEditUtils::PrepareSequenceDataSources(inDriverInfo, driver_state, song_memory, sequences);
+
+		unsigned int max_event_position = 0;
+
+		for (const auto& order_list : order_lists)
+			max_event_position = std::max(max_event_position, ComponentTrackUtils::GetMaxEventPosition(order_list, sequences));
+
+		m_SongTrace = std::make_unique<RegisterTrace>(m_Platform, m_SIDConfiguration);
+
+		const bool is_recorded = m_SongTrace->Record(song_memory, inDriverInfo, inMaxFrameCount > 0 ? inMaxFrameCount : DefaultMaxFrameCount, inMaxFrameCount > 0 ? 0 : 2 * max_event_position);
+
+		song_memory.Unlock();
+
+		if (!is_recorded)
+		{
+			m_ErrorMessage = "The song could not be played. " + m_SongTrace->GetErrorMessage();
+			m_SongTrace = nullptr;
+
+			return false;
+		}
+
+		// The size of the packed song is the same at any destination address, so it is found by packing it where the driver is
+		Packer packer(song_memory, inDriverInfo, inDriverInfo.GetDescriptor().m_DriverCodeTop);
+		m_PackedSize = packer.GetResult()->GetDataSize();
+
+		return true;
+	}
+
+
+	void PackerBatch::Build(const std::vector<unsigned short>& inDestinationAddresses, unsigned int inThreadCount)
+	{
+		FOUNDATION_ASSERT(m_SongTrace != nullptr);
+
+		const unsigned int thread_count = std::max(1u, std::min(inThreadCount, static_cast<unsigned int>(inDestinationAddresses.size())));
+
+		m_Results.clear();
+
+		for (unsigned short destination_address : inDestinationAddresses)
+			m_Results.push_back({ destination_address, nullptr, false, 0, 0, "" });
+
+		m_NextResultIndex = 0;
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		// The destination addresses all take about as long, so the workers just take the next one in line
+		std::vector<std::shared_ptr<Foundation::IThread>> threads;
+
+		for (unsigned int i = 0; i < thread_count; ++i)
+			threads.push_back(m_Platform->CreateThread("SF2 Pack", [this]() { WorkerThread(); }));
+
+		for (auto& thread : threads)
+			thread->Join();
+
+		m_BuildTimeInSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency());
+	}
+
+
+	const std::vector<PackerBatch::Result>& PackerBatch::GetResults() const
+	{
+		return m_Results;
+	}
+
+
+	bool PackerBatch::IsAllVerified() const
+	{
+		return std::all_of(m_Results.begin(), m_Results.end(), [](const Result& inResult) { return inResult.m_IsVerified; });
+	}
+
+
+	double PackerBatch::GetBuildTimeInSeconds() const
+	{
+		return m_BuildTimeInSeconds;
+	}
+
+
+	const std::string& PackerBatch::GetErrorMessage() const
+	{
+		return m_ErrorMessage;
+	}
+
+
+	std::string PackerBatch::GetReport(const Result& inResult, bool inHexUppercase)
+	{
+		std::string report = "0x" + EditorUtils::ConvertToHexValue(inResult.m_DestinationAddress, inHexUppercase);
+
+		if (inResult.m_PackedData != nullptr)
+			report += " - 0x" + EditorUtils::ConvertToHexValue(static_cast<unsigned short>(inResult.m_PackedData->GetBottomAddress()), inHexUppercase);
+
+		if (inResult.m_IsVerified)
+			return report + ": OK, " + std::to_string(inResult.m_FrameCount) + " frames verified";
+
+		return report + ": FAILED, " + inResult.m_Message;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void PackerBatch::WorkerThread()
+	{
+		// Each worker packs from a copy of the song of its own, and plays the packed files on an emulated machine of its own
+		CPUMemory song_memory(static_cast<unsigned int>(m_SongMemory.size()), m_Platform);
+
+		song_memory.Lock();
+		song_memory.SetData(0, &m_SongMemory[0], static_cast<unsigned int>(m_SongMemory.size()));
+		song_memory.Unlock();
+
+		RegisterTrace trace(m_Platform, m_SIDConfiguration);
+
+		for (unsigned int i = m_NextResultIndex++; i < m_Results.size(); i = m_NextResultIndex++)
+			BuildResult(song_memory, trace, m_Results[i]);
+	}
+
+
+	void PackerBatch::BuildResult(CPUMemory& inSongMemory, RegisterTrace& inTrace, Result& ioResult) const
+	{
+		const unsigned int top_address = ioResult.m_DestinationAddress;
+		const unsigned int bottom_address = top_address + m_PackedSize;
+
+		// The file can't end at the very end of memory, as its bottom address would be out of range
+		if (bottom_address >= 0x10000)
+		{
+			ioResult.m_Message = "the packed song does not fit in memory";
+			return;
+		}
+
+		if (top_address < IOAreaEnd && bottom_address > IOAreaBegin)
+		{
+			ioResult.m_Message = "the packed song overlaps the I/O area";
+			return;
+		}
+
+		Packer packer(inSongMemory, *m_DriverInfo, ioResult.m_DestinationAddress);
+		ioResult.m_PackedData = packer.GetResult();
+
+		// The driver is at the top of the packed song, with its entry points where they are in the driver
+		const DriverInfo::DriverCommon& driver_common = m_DriverInfo->GetDriverCommon();
+		const unsigned short driver_code_top = m_DriverInfo->GetDescriptor().m_DriverCodeTop;
+
+		const unsigned short init_address = ioResult.m_DestinationAddress + (driver_common.m_InitAddress - driver_code_top);
+		const unsigned short update_address = ioResult.m_DestinationAddress + (driver_common.m_UpdateAddress - driver_code_top);
+
+		const bool is_played = inTrace.Record(*ioResult.m_PackedData, init_address, update_address, m_SongTrace->GetFrameCount());
+
+		ioResult.m_FrameCount = inTrace.GetFrameCount();
+
+		if (!is_played)
+		{
+			ioResult.m_FirstDivergentFrame = ioResult.m_FrameCount;
+			ioResult.m_Message = inTrace.GetErrorMessage();
+
+			return;
+		}
+
+		std::string difference;
+
+		if (m_SongTrace->IsIdentical(inTrace, ioResult.m_FirstDivergentFrame, difference))
+			ioResult.m_IsVerified = true;
+		else
+			ioResult.m_Message = difference;
+	}
+}
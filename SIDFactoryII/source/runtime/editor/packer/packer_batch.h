@@ -0,0 +1,84 @@
+#pragma once
+
+#include "runtime/emulation/sid/sidproxydefines.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+}
+
+namespace Utility
+{
+	class C64File;
+}
+
+namespace Editor
+{
+	class DriverInfo;
+	class RegisterTrace;
+
+	// Packs a song at a number of destination addresses on a pool of worker threads, and proves each packed file correct. The packed file
+	// is loaded on its own into the memory of an emulated machine, and played for as long as the song takes to play through twice. The
+	// writes it does to the SID registers must be the same, frame by frame, as those of the song as it is in the editor.
+	class PackerBatch final
+	{
+	public:
+		struct Result
+		{
+			unsigned short m_DestinationAddress;
+			std::shared_ptr<Utility::C64File> m_PackedData;		// nullptr if the song can't be packed at the destination address
+
+			bool m_IsVerified;
+			unsigned int m_FrameCount;							// The number of frames compared
+			unsigned int m_FirstDivergentFrame;					// If the packed file has been played, but not verified
+			std::string m_Message;
+		};
+
+		PackerBatch(Foundation::IPlatform* inPlatform, const Emulation::SIDConfiguration& inSIDConfiguration);
+		~PackerBatch();
+
+		// Copies the song from memory, and records the trace the packed files are compared with. A max frame count of 0 means until the
+		// song has played through twice, or ten minutes if the end of the song can't be detected. The memory must be locked. The driver
+		// info is used until the packed files are built.
+		bool SetSong(const Emulation::CPUMemory& inMemory, const DriverInfo& inDriverInfo, unsigned int inMaxFrameCount);
+
+		void Build(const std::vector<unsigned short>& inDestinationAddresses, unsigned int inThreadCount);
+
+		const std::vector<Result>& GetResults() const;
+		bool IsAllVerified() const;
+		double GetBuildTimeInSeconds() const;
+
+		const std::string& GetErrorMessage() const;
+
+		static std::string GetReport(const Result& inResult, bool inHexUppercase);
+
+	private:
+		void WorkerThread();
+		void BuildResult(Emulation::CPUMemory& inSongMemory, RegisterTrace& inTrace, Result& ioResult) const;
+
+		Foundation::IPlatform* m_Platform;
+
+		const Emulation::SIDConfiguration m_SIDConfiguration;
+
+		std::vector<unsigned char> m_SongMemory;
+		const DriverInfo* m_DriverInfo;
+		std::unique_ptr<RegisterTrace> m_SongTrace;
+		unsigned int m_PackedSize;
+
+		std::vector<Result> m_Results;
+		std::atomic<unsigned int> m_NextResultIndex;
+
+		double m_BuildTimeInSeconds;
+		std::string m_ErrorMessage;
+	};
+}
@@ -0,0 +1,301 @@
+#include "runtime/editor/playback_keyframes.h"
+#include "runtime/execution/emulationcontext.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpuframecapture.h"
+#include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/emulation/sid/multisidrenderer.h"
+#include "runtime/environmentdefines.h"
+#include "utils/delta_encoding.h"
+
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/imutex.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace Emulation;
+
+namespace Editor
+{
+	const unsigned int PlaybackKeyframes::DefaultKeyframeInterval = 10;
+
+	// Songs that never reach their end are only followed for half an hour
+	static const unsigned int MaxBuildFrameCount = 50 * 60 * 30;
+
+	static unsigned int GetCyclesPerFrame(const SIDConfiguration& inSIDConfiguration)
+	{
+		return inSIDConfiguration.m_eEnvironment == SID_ENVIRONMENT_PAL ? EMULATION_CYCLES_PER_FRAME_PAL : EMULATION_CYCLES_PER_FRAME_NTSC;
+	}
+
+
+	PlaybackKeyframes::PlaybackKeyframes(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration, const std::vector<SIDChipSetup>& inChipSetups, unsigned int inKeyframeInterval)
+		: m_Platform(inPlatform)
+		, m_KeyframeInterval(inKeyframeInterval)
+		, m_HasBuild(false)
+		, m_DriverSetup({ 0, 0, 0, 0, 0 })
+		, m_SIDConfiguration(inSIDConfiguration)
+		, m_CyclesPerFrame(GetCyclesPerFrame(inSIDConfiguration))
+		, m_CancelBuild(false)
+		, m_BuildDone(false)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+		FOUNDATION_ASSERT(inKeyframeInterval > 0);
+
+		m_BuildContext = std::make_unique<EmulationContext>(inPlatform, inSIDConfiguration);
+		m_SeekContext = std::make_unique<EmulationContext>(inPlatform, inSIDConfiguration);
+
+		m_BuildSIDRenderer = std::make_unique<MultiSIDRenderer>(inPlatform, m_BuildContext->GetSIDProxy(), inChipSetups);
+		m_SeekSIDRenderer = std::make_unique<MultiSIDRenderer>(inPlatform, m_SeekContext->GetSIDProxy(), inChipSetups);
+
+		m_BuildFrameCapture = std::make_unique<CPUFrameCapture>(m_BuildContext->GetCPU(), m_BuildSIDRenderer->GetCaptureRangeBegin(), m_BuildSIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+		m_SeekFrameCapture = std::make_unique<CPUFrameCapture>(m_SeekContext->GetCPU(), m_SeekSIDRenderer->GetCaptureRangeBegin(), m_SeekSIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+
+		m_Mutex = inPlatform->CreateMutex();
+	}
+
+
+	PlaybackKeyframes::~PlaybackKeyframes()
+	{
+		Cancel();
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void PlaybackKeyframes::Build(const CPUMemory& inMemory, const DriverSetup& inDriverSetup, const SIDConfiguration& inSIDConfiguration)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+
+		Cancel();
+
+		m_Keyframes.clear();
+		m_EventStartFrames.clear();
+
+		m_DriverSetup = inDriverSetup;
+		m_HasBuild = true;
+
+		// Follow changes to the SID setup
+		if (inSIDConfiguration.m_eModel != m_SIDConfiguration.m_eModel || inSIDConfiguration.m_eEnvironment != m_SIDConfiguration.m_eEnvironment)
+		{
+			m_SIDConfiguration = inSIDConfiguration;
+			m_CyclesPerFrame = GetCyclesPerFrame(inSIDConfiguration);
+
+			m_BuildContext->GetSIDProxy()->SetConfiguration(inSIDConfiguration);
+			m_SeekContext->GetSIDProxy()->SetConfiguration(inSIDConfiguration);
+
+			m_BuildFrameCapture = std::make_unique<CPUFrameCapture>(m_BuildContext->GetCPU(), m_BuildSIDRenderer->GetCaptureRangeBegin(), m_BuildSIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+			m_SeekFrameCapture = std::make_unique<CPUFrameCapture>(m_SeekContext->GetCPU(), m_SeekSIDRenderer->GetCaptureRangeBegin(), m_SeekSIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+		}
+
+		m_BaseMemory.resize(inMemory.GetSize());
+		inMemory.GetData(0, &m_BaseMemory[0], inMemory.GetSize());
+
+		// Without the tempo counter, the event positions cannot be followed
+		if (inDriverSetup.m_TempoCounterAddress == 0)
+			return;
+
+		m_CancelBuild = false;
+		m_BuildDone = false;
+		m_BuildThread = m_Platform->CreateThread("SF2 Playback Keyframes", [this]() { BuildThread(); });
+	}
+
+
+	void PlaybackKeyframes::Cancel()
+	{
+		if (m_BuildThread != nullptr)
+		{
+			m_CancelBuild = true;
+			m_BuildThread->Join();
+			m_BuildThread = nullptr;
+
+			// An interrupted build would never be completed, so it must be built anew
+			if (!m_BuildDone)
+				m_HasBuild = false;
+		}
+	}
+
+
+	bool PlaybackKeyframes::IsValid(const CPUMemory& inMemory, const DriverSetup& inDriverSetup, const SIDConfiguration& inSIDConfiguration) const
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+
+		if (!m_HasBuild || m_BaseMemory.size() != inMemory.GetSize())
+			return false;
+
+		if (inSIDConfiguration.m_eModel != m_SIDConfiguration.m_eModel || inSIDConfiguration.m_eEnvironment != m_SIDConfiguration.m_eEnvironment)
+			return false;
+
+		if (memcmp(&inDriverSetup, &m_DriverSetup, sizeof(DriverSetup)) != 0)
+			return false;
+
+		// The SID registers are written by playback, and are not part of the song
+		const unsigned int end_address = static_cast<unsigned int>(m_BaseMemory.size());
+		const unsigned int music_data_address = inDriverSetup.m_MusicDataAddress;
+		const unsigned int sid_registers_begin = m_BuildSIDRenderer->GetCaptureRangeBegin();
+		const unsigned int sid_registers_end = m_BuildSIDRenderer->GetCaptureRangeEnd() + 1;
+
+		auto is_range_unchanged = [&](unsigned int inBegin, unsigned int inEnd)
+		{
+			return inBegin >= inEnd || memcmp(inMemory.GetLocation(inBegin), &m_BaseMemory[inBegin], inEnd - inBegin) == 0;
+		};
+
+		return is_range_unchanged(music_data_address, std::min(end_address, sid_registers_begin))
+			&& is_range_unchanged(std::max(music_data_address, sid_registers_end), end_address);
+	}
+
+
+	std::shared_ptr<const PlaybackKeyframes::State> PlaybackKeyframes::GetStateAtEventPosition(unsigned int inEventPosition)
+	{
+		if (!m_HasBuild)
+			return nullptr;
+
+		// Find the frame, in which the event position is reached, and the keyframe before it
+		unsigned int frame = 0;
+		Keyframe keyframe;
+
+		m_Mutex->Lock();
+
+		const bool has_frame = inEventPosition < m_EventStartFrames.size();
+
+		if (has_frame)
+		{
+			frame = m_EventStartFrames[inEventPosition];
+
+			FOUNDATION_ASSERT(frame / m_KeyframeInterval < m_Keyframes.size());
+			keyframe = m_Keyframes[frame / m_KeyframeInterval];
+		}
+
+		m_Mutex->Unlock();
+
+		// The driver is initialized in the first frame, which a state cannot start before
+		if (!has_frame || frame == 0)
+			return nullptr;
+
+		// Restore the keyframe, and emulate the frames up to the requested one
+		std::shared_ptr<State> state = std::make_shared<State>();
+		state->m_Memory = m_BaseMemory;
+
+		Utility::ApplyXORDelta(keyframe.m_MemoryDelta, &state->m_Memory[0], static_cast<unsigned int>(state->m_Memory.size()));
+
+		CPUMemory& memory = *m_SeekContext->GetCPUMemory();
+
+		memory.Lock();
+		memory.SetData(0, &state->m_Memory[0], static_cast<unsigned int>(state->m_Memory.size()));
+		memory.Unlock();
+
+		m_SeekSIDRenderer->SetState(keyframe.m_SIDStates);
+
+		bool event_started;
+
+		for (unsigned int i = frame - frame % m_KeyframeInterval; i < frame; ++i)
+			EmulateFrame(*m_SeekContext, *m_SeekSIDRenderer, *m_SeekFrameCapture, i == 0, event_started);
+
+		memory.Lock();
+		memory.GetData(0, &state->m_Memory[0], static_cast<unsigned int>(state->m_Memory.size()));
+		memory.Unlock();
+
+		m_SeekSIDRenderer->GetState(state->m_SIDStates);
+
+		return state;
+	}
+
+
+	void PlaybackKeyframes::RestoreState(const State& inState, CPUMemory& inMemory, MultiSIDRenderer& inSIDRenderer)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inState.m_Memory.size() == inMemory.GetSize());
+
+		inMemory.SetData(0, &inState.m_Memory[0], inMemory.GetSize());
+		inSIDRenderer.SetState(inState.m_SIDStates);
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void PlaybackKeyframes::BuildThread()
+	{
+		CPUMemory& memory = *m_BuildContext->GetCPUMemory();
+
+		const unsigned int memory_size = static_cast<unsigned int>(m_BaseMemory.size());
+		std::vector<unsigned char> frame_memory(memory_size);
+		std::vector<unsigned char> delta;
+
+		memory.Lock();
+		memory.SetData(0, &m_BaseMemory[0], memory_size);
+		memory.Unlock();
+
+		m_BuildSIDRenderer->Reset();
+
+		int event_position = -1;
+
+		for (unsigned int frame = 0; frame < MaxBuildFrameCount && !m_CancelBuild; ++frame)
+		{
+			// Record the state before every n'th frame
+			if (frame % m_KeyframeInterval == 0)
+			{
+				Keyframe keyframe;
+
+				memory.Lock();
+				memory.GetData(0, &frame_memory[0], memory_size);
+				memory.Unlock();
+
+				Utility::EncodeXORDelta(&m_BaseMemory[0], &frame_memory[0], memory_size, delta);
+				keyframe.m_MemoryDelta = delta;
+				m_BuildSIDRenderer->GetState(keyframe.m_SIDStates);
+
+				m_Mutex->Lock();
+				m_Keyframes.push_back(std::move(keyframe));
+				m_Mutex->Unlock();
+			}
+
+			bool event_started;
+
+			if (!EmulateFrame(*m_BuildContext, *m_BuildSIDRenderer, *m_BuildFrameCapture, frame == 0, event_started))
+				break;
+
+			if (event_started)
+			{
+				++event_position;
+
+				m_Mutex->Lock();
+				m_EventStartFrames.push_back(frame);
+				m_Mutex->Unlock();
+
+				if (event_position + 1 >= static_cast<int>(m_DriverSetup.m_MaxEventPosition))
+					break;
+			}
+		}
+
+		m_BuildDone = !m_CancelBuild;
+	}
+
+
+	bool PlaybackKeyframes::EmulateFrame(EmulationContext& inContext, MultiSIDRenderer& inSIDRenderer, CPUFrameCapture& inFrameCapture, bool inInit, bool& outEventStarted) const
+	{
+		CPUMemory& memory = *inContext.GetCPUMemory();
+
+		// Run the driver the same way the execution handler does during playback
+		memory.Lock();
+		inContext.GetCPU()->SetMemory(&memory);
+
+		inFrameCapture.Begin();
+
+		if (inInit)
+			inFrameCapture.Capture(m_DriverSetup.m_InitAddress, 0);
+
+		if (!inFrameCapture.IsMaxCycleCountReached())
+			inFrameCapture.Capture(m_DriverSetup.m_UpdateAddress, 0);
+
+		const bool success = !inFrameCapture.IsMaxCycleCountReached();
+		outEventStarted = memory[m_DriverSetup.m_TempoCounterAddress] == 0;
+
+		inFrameCapture.End();
+		memory.Unlock();
+
+		// Do all writes to the SID chips, and clock them in between without producing any output
+		inSIDRenderer.ClockFrameNoOutput(inFrameCapture, static_cast<int>(m_CyclesPerFrame));
+
+		return success;
+	}
+}
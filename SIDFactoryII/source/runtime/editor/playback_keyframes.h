@@ -0,0 +1,107 @@
+#pragma once
+
+#include "runtime/emulation/sid/sidproxydefines.h"
+#include "libraries/residfp/SIDState.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+	class IMutex;
+	class IThread;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+	class CPUFrameCapture;
+	class MultiSIDRenderer;
+	class EmulationContext;
+}
+
+namespace Editor
+{
+	// Finds the state the emulation would be in at any event position of a song, so that playback can start from there as if the song
+	// had been played from the beginning, with the instruments, the filter and the pulse programs where they would be. The song is emulated
+	// silently on a background thread, recording a keyframe of the memory and the SID chips every few frames. To start from an event position,
+	// the keyframe before it is restored in a separate emulation context, and the few frames up to the event position are emulated on top.
+	class PlaybackKeyframes final
+	{
+	public:
+		struct DriverSetup
+		{
+			unsigned short m_InitAddress;
+			unsigned short m_UpdateAddress;
+			unsigned short m_TempoCounterAddress;
+			unsigned short m_MusicDataAddress;			// The music data runs from here to the end of the memory
+			unsigned int m_MaxEventPosition;			// The build stops, when playback reaches this event position
+		};
+
+		struct State
+		{
+			std::vector<unsigned char> m_Memory;
+			std::vector<reSIDfp::SIDState> m_SIDStates;		// One for each chip
+		};
+
+		static const unsigned int DefaultKeyframeInterval;
+
+		PlaybackKeyframes(Foundation::IPlatform* inPlatform, const Emulation::SIDConfiguration& inSIDConfiguration, const std::vector<Emulation::SIDChipSetup>& inChipSetups, unsigned int inKeyframeInterval);
+		~PlaybackKeyframes();
+
+		// Starts building the keyframes of the song in memory on a background thread. A build in progress is cancelled first. The memory must be locked.
+		void Build(const Emulation::CPUMemory& inMemory, const DriverSetup& inDriverSetup, const Emulation::SIDConfiguration& inSIDConfiguration);
+		void Cancel();
+
+		// Returns true, if the keyframes were built from the music data in memory and the same driver and SID setup. The memory must be locked.
+		bool IsValid(const Emulation::CPUMemory& inMemory, const DriverSetup& inDriverSetup, const Emulation::SIDConfiguration& inSIDConfiguration) const;
+
+		// Returns the state right before the frame, in which playback from the start of the song reaches the event position. Returns
+		// nullptr, if the build has not got that far, if it stopped before, or if the event position is reached in the first frame.
+		std::shared_ptr<const State> GetStateAtEventPosition(unsigned int inEventPosition);
+
+		// Copies a state to the memory and the SID chips, which must be set up the same way as those given to the keyframes. The memory
+		// must be locked, and the chips must not be clocked at the same time.
+		static void RestoreState(const State& inState, Emulation::CPUMemory& inMemory, Emulation::MultiSIDRenderer& inSIDRenderer);
+
+	private:
+		struct Keyframe
+		{
+			std::vector<unsigned char> m_MemoryDelta;	// The difference to the memory the build started from
+			std::vector<reSIDfp::SIDState> m_SIDStates;
+		};
+
+		void BuildThread();
+		bool EmulateFrame(Emulation::EmulationContext& inContext, Emulation::MultiSIDRenderer& inSIDRenderer, Emulation::CPUFrameCapture& inFrameCapture, bool inInit, bool& outEventStarted) const;
+
+		Foundation::IPlatform* m_Platform;
+		const unsigned int m_KeyframeInterval;
+
+		// Setup of the current build. Only changed, while no build is running.
+		bool m_HasBuild;
+		DriverSetup m_DriverSetup;
+		Emulation::SIDConfiguration m_SIDConfiguration;
+		unsigned int m_CyclesPerFrame;
+		std::vector<unsigned char> m_BaseMemory;
+
+		// Build thread, and the emulation context it uses
+		std::unique_ptr<Emulation::EmulationContext> m_BuildContext;
+		std::unique_ptr<Emulation::MultiSIDRenderer> m_BuildSIDRenderer;
+		std::unique_ptr<Emulation::CPUFrameCapture> m_BuildFrameCapture;
+		std::shared_ptr<Foundation::IThread> m_BuildThread;
+		std::atomic<bool> m_CancelBuild;
+		std::atomic<bool> m_BuildDone;
+
+		// Emulation context for emulating from a keyframe to the requested frame, used on the calling thread
+		std::unique_ptr<Emulation::EmulationContext> m_SeekContext;
+		std::unique_ptr<Emulation::MultiSIDRenderer> m_SeekSIDRenderer;
+		std::unique_ptr<Emulation::CPUFrameCapture> m_SeekFrameCapture;
+
+		// Results of the build, guarded by the mutex while the build is running
+		std::shared_ptr<Foundation::IMutex> m_Mutex;
+		std::vector<Keyframe> m_Keyframes;
+		std::vector<unsigned int> m_EventStartFrames;	// The frame, in which playback reaches each event position
+	};
+}
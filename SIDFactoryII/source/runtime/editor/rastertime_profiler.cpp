@@ -0,0 +1,345 @@
+#include "runtime/editor/rastertime_profiler.h"
+#include "runtime/editor/driver/driver_state.h"
+#include "runtime/editor/datasources/datasource_orderlist.h"
+#include "runtime/editor/datasources/datasource_sequence.h"
+#include "runtime/editor/components/component_track_utils.h"
+#include "runtime/editor/screens/screen_edit_utils.h"
+#include "runtime/editor/utilities/editor_utils.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpuframecapture.h"
+#include "runtime/environmentdefines.h"
+
+#include "foundation/base/assert.h"
+
+#include "SDL.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+using namespace Emulation;
+
+namespace Editor
+{
+	const unsigned int RastertimeProfiler::WorstFrameCount = 10;
+
+	// Songs that never reach their end are only followed for an hour
+	static const unsigned int MaxProfileFrameCount = 50 * 60 * 60;
+
+	// The histogram in the report groups the raster lines in this many rows
+	static const unsigned int ReportHistogramRowCount = 8;
+
+
+	RastertimeProfiler::RastertimeProfiler(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration)
+		: m_CyclesPerFrame(inSIDConfiguration.m_eEnvironment == SID_ENVIRONMENT_PAL ? EMULATION_CYCLES_PER_FRAME_PAL : EMULATION_CYCLES_PER_FRAME_NTSC)
+		, m_CyclesPerRasterLine(inSIDConfiguration.m_eEnvironment == SID_ENVIRONMENT_PAL ? EMULATION_CYCLES_PER_SCANLINE_PAL : EMULATION_CYCLES_PER_SCANLINE_NTSC)
+		, m_TrackCount(0)
+		, m_MaxEventPosition(0)
+	{
+		m_CPUMemory = std::make_unique<CPUMemory>(0x10000, inPlatform);
+		m_CPU = std::make_unique<CPUmos6510>();
+		m_CPU->SetExecutionCore(CPUmos6510::ExecutionCore::Fast);
+		m_FrameCapture = std::make_unique<CPUFrameCapture>(m_CPU.get(), 0xd400, 0xd418, m_CyclesPerFrame);
+	}
+
+	RastertimeProfiler::~RastertimeProfiler()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void RastertimeProfiler::SetSong(const CPUMemory& inMemory, const DriverInfo& inDriverInfo)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inMemory.GetSize() == m_CPUMemory->GetSize());
+
+		m_SongMemory.resize(inMemory.GetSize());
+		inMemory.GetData(0, &m_SongMemory[0], inMemory.GetSize());
+
+		m_DriverCommon = inDriverInfo.GetDriverCommon();
+		m_TrackCount = inDriverInfo.GetMusicData().m_TrackCount;
+		m_MaxEventPosition = 0;
+
+		// The song end can only be tracked if the driver exposes its tempo counter
+		if (m_DriverCommon.m_TempoCounterAddress == 0)
+			return;
+
+		m_CPUMemory->Lock();
+		m_CPUMemory->SetData(0, &m_SongMemory[0], static_cast<unsigned int>(m_SongMemory.size()));
+		m_CPUMemory->Unlock();
+
+		DriverState driver_state;
+		std::vector<std::shared_ptr<DataSourceOrderList>> order_lists;
+		std::vector<std::shared_ptr<DataSourceSequence>> sequences;
+
+		ScreenEditUtils::PrepareOrderListsDataSources(inDriverInfo, *m_CPUMemory, order_lists);
+		ScreenEditUtils::PrepareSequenceDataSources(inDriverInfo, driver_state, *m_CPUMemory, sequences);
+
+		// The song has played through, when the longest track reaches its end
+		for (const auto& order_list : order_lists)
+			m_MaxEventPosition = std::max(m_MaxEventPosition, ComponentTrackUtils::GetMaxEventPosition(order_list, sequences));
+	}
+
+
+	bool RastertimeProfiler::Run(unsigned int inMaxFrameCount, Profile& outProfile)
+	{
+		FOUNDATION_ASSERT(!m_SongMemory.empty());
+
+		if (inMaxFrameCount == 0 && m_MaxEventPosition == 0)
+		{
+			m_ErrorMessage = "The end of the song cannot be detected, a frame count must be specified!";
+			return false;
+		}
+
+		const unsigned int end_event_position = 2 * m_MaxEventPosition;
+		const unsigned int max_frame_count = inMaxFrameCount > 0 ? inMaxFrameCount : MaxProfileFrameCount;
+
+		outProfile = Profile();
+		outProfile.m_TrackCount = m_TrackCount;
+		outProfile.m_CyclesPerFrame = m_CyclesPerFrame;
+		outProfile.m_CyclesPerRasterLine = m_CyclesPerRasterLine;
+		outProfile.m_ReachedSongEnd = false;
+
+		const Uint64 start_time = SDL_GetPerformanceCounter();
+
+		CPUMemory& memory = *m_CPUMemory;
+		CPUFrameCapture& frame_capture = *m_FrameCapture;
+
+		memory.Lock();
+		memory.SetData(0, &m_SongMemory[0], static_cast<unsigned int>(m_SongMemory.size()));
+		m_CPU->SetMemory(&memory);
+
+		bool cycle_window_exceeded = false;
+
+		// The driver is initialized in a frame of its own, which is not part of the profile
+		frame_capture.Begin();
+		frame_capture.Capture(m_DriverCommon.m_InitAddress, 0);
+		cycle_window_exceeded = frame_capture.IsMaxCycleCountReached();
+		frame_capture.End();
+
+		int event_position = -1;
+
+		for (unsigned int frame = 0; frame < max_frame_count && !cycle_window_exceeded; ++frame)
+		{
+			frame_capture.Begin();
+			frame_capture.Capture(m_DriverCommon.m_UpdateAddress, 0);
+			frame_capture.End();
+
+			if (frame_capture.IsMaxCycleCountReached())
+			{
+				cycle_window_exceeded = true;
+				break;
+			}
+
+			// Follow the event position the same way as the editor does during playback
+			if (m_DriverCommon.m_TempoCounterAddress != 0 && memory[m_DriverCommon.m_TempoCounterAddress] == 0)
+				++event_position;
+
+			outProfile.m_FrameCycles.push_back(static_cast<unsigned short>(frame_capture.GetCyclesSpend()));
+			outProfile.m_FrameEventPositions.push_back(event_position);
+
+			for (unsigned int i = 0; i < m_TrackCount; ++i)
+			{
+				outProfile.m_FrameOrderListIndices.push_back(memory[m_DriverCommon.m_OrderListIndexAddress + i]);
+				outProfile.m_FrameSequenceIndices.push_back(memory[m_DriverCommon.m_CurrentSequenceAddress + i]);
+			}
+
+			if (m_MaxEventPosition > 0 && event_position >= static_cast<int>(end_event_position))
+			{
+				outProfile.m_ReachedSongEnd = true;
+				break;
+			}
+		}
+
+		memory.Unlock();
+
+		outProfile.m_FrameCount = static_cast<unsigned int>(outProfile.m_FrameCycles.size());
+		CollectStatistics(outProfile);
+
+		outProfile.m_TimeInSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start_time) / static_cast<double>(SDL_GetPerformanceFrequency());
+
+		if (cycle_window_exceeded)
+		{
+			m_ErrorMessage = "Emulation of 6510 code exceeded cycle window in frame " + std::to_string(outProfile.m_FrameCount) + "!";
+			return false;
+		}
+
+		return true;
+	}
+
+
+	const std::string& RastertimeProfiler::GetErrorMessage() const
+	{
+		return m_ErrorMessage;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	std::string RastertimeProfiler::GetReport(const Profile& inProfile, bool inHexUppercase)
+	{
+		if (inProfile.m_FrameCount == 0)
+			return "No frames were profiled.";
+
+		const unsigned int cycles_per_line = inProfile.m_CyclesPerRasterLine;
+
+		auto to_fixed = [](double inValue)
+		{
+			char buffer[32];
+			snprintf(buffer, sizeof(buffer), "%.1f", inValue);
+
+			return std::string(buffer);
+		};
+
+		auto to_lines = [&](unsigned int inCycles)
+		{
+			return to_fixed(static_cast<double>(inCycles) / static_cast<double>(cycles_per_line));
+		};
+
+		auto pad_left = [](const std::string& inString, size_t inWidth)
+		{
+			return inString.size() < inWidth ? std::string(inWidth - inString.size(), ' ') + inString : inString;
+		};
+
+		std::string text = "Frames: " + std::to_string(inProfile.m_FrameCount) + (inProfile.m_ReachedSongEnd ? ", the full song and loop" : ", stopped before the end of the song") + "\n\n";
+
+		text += "        Cycles  Raster lines\n";
+		text += "Min    " + pad_left(std::to_string(inProfile.m_MinCycles), 7) + pad_left(to_lines(inProfile.m_MinCycles), 14) + "\n";
+		text += "Avg    " + pad_left(to_fixed(inProfile.m_AverageCycles), 7) + pad_left(to_fixed(inProfile.m_AverageCycles / static_cast<double>(cycles_per_line)), 14) + "\n";
+		text += "99%    " + pad_left(std::to_string(inProfile.m_Percentile99Cycles), 7) + pad_left(to_lines(inProfile.m_Percentile99Cycles), 14) + "\n";
+		text += "Max    " + pad_left(std::to_string(inProfile.m_MaxCycles), 7) + pad_left(to_lines(inProfile.m_MaxCycles), 14) + "\n\n";
+
+		// Group the raster lines, so the histogram fits in the report
+		const unsigned int line_count = static_cast<unsigned int>(inProfile.m_RasterLineHistogram.size());
+		const unsigned int min_line = inProfile.m_MinCycles / cycles_per_line;
+		const unsigned int lines_per_row = std::max(1u, (line_count - min_line + ReportHistogramRowCount - 1) / ReportHistogramRowCount);
+		const unsigned int max_bar_length = 24;
+
+		text += "Raster lines  Frames\n";
+
+		for (unsigned int row_line = min_line; row_line < line_count; row_line += lines_per_row)
+		{
+			unsigned int frame_count = 0;
+
+			for (unsigned int line = row_line; line < std::min(row_line + lines_per_row, line_count); ++line)
+				frame_count += inProfile.m_RasterLineHistogram[line];
+
+			const unsigned int bar_length = frame_count == 0 ? 0 : std::max(1u, static_cast<unsigned int>((static_cast<unsigned long long>(frame_count) * max_bar_length) / inProfile.m_FrameCount));
+			const std::string lines = lines_per_row == 1 ? std::to_string(row_line) : std::to_string(row_line) + "-" + std::to_string(row_line + lines_per_row - 1);
+
+			text += pad_left(lines, 7) + pad_left(std::to_string(frame_count), 13) + " " + std::string(bar_length, '*') + "\n";
+		}
+
+		text += "\nWorst frames  Cycles  Row   Order lists  Sequences\n";
+
+		for (unsigned int frame : inProfile.m_WorstFrames)
+		{
+			const int event_position = inProfile.m_FrameEventPositions[frame];
+
+			std::string order_list_indices;
+			std::string sequence_indices;
+
+			for (unsigned int i = 0; i < inProfile.m_TrackCount; ++i)
+			{
+				order_list_indices += EditorUtils::ConvertToHexValue(inProfile.m_FrameOrderListIndices[frame * inProfile.m_TrackCount + i], inHexUppercase) + " ";
+				sequence_indices += EditorUtils::ConvertToHexValue(inProfile.m_FrameSequenceIndices[frame * inProfile.m_TrackCount + i], inHexUppercase) + " ";
+			}
+
+			text += pad_left(std::to_string(frame + 1), 12) + pad_left(std::to_string(inProfile.m_FrameCycles[frame]), 8) + "  "
+				+ (event_position < 0 ? std::string("----") : EditorUtils::ConvertToHexValue(static_cast<unsigned short>(event_position), inHexUppercase)) + "  "
+				+ order_list_indices + " " + sequence_indices + "\n";
+		}
+
+		return text;
+	}
+
+
+	bool RastertimeProfiler::WriteCSV(const std::string& inPathAndFilename, const Profile& inProfile)
+	{
+		FILE* file = fopen(inPathAndFilename.c_str(), "w");
+
+		if (file == nullptr)
+			return false;
+
+		fprintf(file, "frame,cycles,raster_lines,row");
+
+		for (unsigned int i = 0; i < inProfile.m_TrackCount; ++i)
+			fprintf(file, ",order_list_%u", i + 1);
+		for (unsigned int i = 0; i < inProfile.m_TrackCount; ++i)
+			fprintf(file, ",sequence_%u", i + 1);
+
+		fprintf(file, "\n");
+
+		for (unsigned int frame = 0; frame < inProfile.m_FrameCount; ++frame)
+		{
+			const unsigned int cycles = inProfile.m_FrameCycles[frame];
+
+			fprintf(file, "%u,%u,%.2f,%d", frame + 1, cycles, static_cast<double>(cycles) / static_cast<double>(inProfile.m_CyclesPerRasterLine), inProfile.m_FrameEventPositions[frame]);
+
+			for (unsigned int i = 0; i < inProfile.m_TrackCount; ++i)
+				fprintf(file, ",%u", inProfile.m_FrameOrderListIndices[frame * inProfile.m_TrackCount + i]);
+			for (unsigned int i = 0; i < inProfile.m_TrackCount; ++i)
+				fprintf(file, ",%u", inProfile.m_FrameSequenceIndices[frame * inProfile.m_TrackCount + i]);
+
+			fprintf(file, "\n");
+		}
+
+		const bool write_error = ferror(file) != 0;
+		return fclose(file) == 0 && !write_error;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void RastertimeProfiler::CollectStatistics(Profile& ioProfile)
+	{
+		ioProfile.m_MinCycles = 0;
+		ioProfile.m_MaxCycles = 0;
+		ioProfile.m_Percentile99Cycles = 0;
+		ioProfile.m_AverageCycles = 0.0;
+
+		if (ioProfile.m_FrameCount == 0)
+			return;
+
+		unsigned long long total_cycles = 0;
+
+		ioProfile.m_MinCycles = ioProfile.m_FrameCycles[0];
+
+		for (unsigned int cycles : ioProfile.m_FrameCycles)
+		{
+			ioProfile.m_MinCycles = std::min(ioProfile.m_MinCycles, cycles);
+			ioProfile.m_MaxCycles = std::max(ioProfile.m_MaxCycles, cycles);
+			total_cycles += cycles;
+		}
+
+		ioProfile.m_AverageCycles = static_cast<double>(total_cycles) / static_cast<double>(ioProfile.m_FrameCount);
+
+		// The rastertime 99% of the frames stay within
+		std::vector<unsigned short> sorted_cycles = ioProfile.m_FrameCycles;
+		const size_t percentile_index = std::min(sorted_cycles.size() - 1, (sorted_cycles.size() * 99) / 100);
+
+		std::nth_element(sorted_cycles.begin(), sorted_cycles.begin() + percentile_index, sorted_cycles.end());
+		ioProfile.m_Percentile99Cycles = sorted_cycles[percentile_index];
+
+		ioProfile.m_RasterLineHistogram.assign(ioProfile.m_MaxCycles / ioProfile.m_CyclesPerRasterLine + 1, 0);
+
+		for (unsigned int cycles : ioProfile.m_FrameCycles)
+			++ioProfile.m_RasterLineHistogram[cycles / ioProfile.m_CyclesPerRasterLine];
+
+		// Worst first, and the earliest of equally bad frames first
+		std::vector<unsigned int> frames(ioProfile.m_FrameCount);
+
+		for (unsigned int i = 0; i < ioProfile.m_FrameCount; ++i)
+			frames[i] = i;
+
+		const size_t worst_frame_count = std::min<size_t>(WorstFrameCount, frames.size());
+
+		std::partial_sort(frames.begin(), frames.begin() + worst_frame_count, frames.end(), [&](unsigned int inFrameA, unsigned int inFrameB)
+		{
+			const unsigned short cycles_a = ioProfile.m_FrameCycles[inFrameA];
+			const unsigned short cycles_b = ioProfile.m_FrameCycles[inFrameB];
+
+			return cycles_a > cycles_b || (cycles_a == cycles_b && inFrameA < inFrameB);
+		});
+
+		ioProfile.m_WorstFrames.assign(frames.begin(), frames.begin() + worst_frame_count);
+	}
+}
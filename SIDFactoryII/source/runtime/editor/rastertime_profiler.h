@@ -0,0 +1,88 @@
+#pragma once
+
+#include "runtime/editor/driver/driver_info.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+	class CPUmos6510;
+	class CPUFrameCapture;
+}
+
+namespace Editor
+{
+	// Finds the rastertime the driver update takes in every frame of a song. The song is played through its full length, and then on for
+	// as long again, so the frames in which the tracks loop are included. Only the 6510 is emulated, so even long songs take a fraction of a
+	// second. The profiler works on its own copy of the song, so the song can be edited and played while it runs.
+	class RastertimeProfiler final
+	{
+	public:
+		struct Profile
+		{
+			unsigned int m_FrameCount;						// Not counting the frame in which the driver is initialized
+			unsigned int m_TrackCount;
+			unsigned int m_CyclesPerFrame;
+			unsigned int m_CyclesPerRasterLine;
+			bool m_ReachedSongEnd;
+
+			// Per frame. The positions are the ones the driver update has played in the frame.
+			std::vector<unsigned short> m_FrameCycles;
+			std::vector<int> m_FrameEventPositions;
+			std::vector<unsigned char> m_FrameOrderListIndices;		// Track count entries per frame
+			std::vector<unsigned char> m_FrameSequenceIndices;		// Track count entries per frame
+
+			unsigned int m_MinCycles;
+			unsigned int m_MaxCycles;
+			unsigned int m_Percentile99Cycles;
+			double m_AverageCycles;
+
+			std::vector<unsigned int> m_RasterLineHistogram;		// The number of frames by the number of raster lines they take
+			std::vector<unsigned int> m_WorstFrames;				// The indices of the frames taking the most cycles, worst first
+
+			double m_TimeInSeconds;
+		};
+
+		static const unsigned int WorstFrameCount;
+
+		RastertimeProfiler(Foundation::IPlatform* inPlatform, const Emulation::SIDConfiguration& inSIDConfiguration);
+		~RastertimeProfiler();
+
+		// Copies the song from memory. The memory must be locked.
+		void SetSong(const Emulation::CPUMemory& inMemory, const DriverInfo& inDriverInfo);
+
+		// A max frame count of 0 means no limit, which is only usable with songs where the end of the song can be detected
+		bool Run(unsigned int inMaxFrameCount, Profile& outProfile);
+
+		const std::string& GetErrorMessage() const;
+
+		static std::string GetReport(const Profile& inProfile, bool inHexUppercase);
+		static bool WriteCSV(const std::string& inPathAndFilename, const Profile& inProfile);
+
+	private:
+		static void CollectStatistics(Profile& ioProfile);
+
+		std::unique_ptr<Emulation::CPUMemory> m_CPUMemory;
+		std::unique_ptr<Emulation::CPUmos6510> m_CPU;
+		std::unique_ptr<Emulation::CPUFrameCapture> m_FrameCapture;
+
+		const unsigned int m_CyclesPerFrame;
+		const unsigned int m_CyclesPerRasterLine;
+
+		std::vector<unsigned char> m_SongMemory;
+		DriverInfo::DriverCommon m_DriverCommon;
+		unsigned int m_TrackCount;
+		unsigned int m_MaxEventPosition;
+
+		std::string m_ErrorMessage;
+	};
+}
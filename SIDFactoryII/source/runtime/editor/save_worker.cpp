@@ -0,0 +1,121 @@
+#include "runtime/editor/save_worker.h"
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/imutex.h"
+#include "foundation/platform/isemaphore.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+namespace Editor
+{
+	SaveWorker::SaveWorker(Foundation::IPlatform* inPlatform)
+		: m_Platform(inPlatform)
+		, m_PendingJobCount(0)
+		, m_Stop(false)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+
+		m_Mutex = m_Platform->CreateMutex();
+		m_JobQueued = m_Platform->CreateSemaphore(0);
+		m_JobDone = m_Platform->CreateSemaphore(0);
+		m_WorkerThread = m_Platform->CreateThread("SF2 Save Worker", [this]() { WorkerThread(); });
+	}
+
+	SaveWorker::~SaveWorker()
+	{
+		m_Mutex->Lock();
+		m_Stop = true;
+		m_Mutex->Unlock();
+
+		m_JobQueued->Post();
+		m_WorkerThread->Join();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void SaveWorker::Queue(const std::function<bool()>& inJob, const std::function<void(bool)>& inCompletion)
+	{
+		m_Mutex->Lock();
+		m_QueuedJobs.push_back({ inJob, inCompletion, false });
+		m_Mutex->Unlock();
+
+		++m_PendingJobCount;
+		m_JobQueued->Post();
+	}
+
+
+	void SaveWorker::Update()
+	{
+		if (m_PendingJobCount == 0)
+			return;
+
+		std::vector<Job> done_jobs;
+
+		m_Mutex->Lock();
+		done_jobs.swap(m_DoneJobs);
+		m_Mutex->Unlock();
+
+		// A completion callback may queue a new job, so the done jobs are taken out of the list before calling them
+		for (const Job& job : done_jobs)
+		{
+			FOUNDATION_ASSERT(m_PendingJobCount > 0);
+			--m_PendingJobCount;
+
+			if (job.m_Completion)
+				job.m_Completion(job.m_Result);
+		}
+	}
+
+
+	void SaveWorker::Flush()
+	{
+		// The done semaphore is posted once for every job, but it is only waited on here, so it can be posted more times than there are
+		// jobs left. This only makes the loop check the pending count again.
+		while (m_PendingJobCount > 0)
+		{
+			m_JobDone->Wait();
+			Update();
+		}
+	}
+
+
+	bool SaveWorker::IsBusy() const
+	{
+		return m_PendingJobCount > 0;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void SaveWorker::WorkerThread()
+	{
+		while (true)
+		{
+			m_JobQueued->Wait();
+
+			m_Mutex->Lock();
+
+			// Jobs queued before stopping are still done, so nothing queued for saving is lost
+			if (m_QueuedJobs.empty())
+			{
+				const bool stop = m_Stop;
+				m_Mutex->Unlock();
+
+				if (stop)
+					return;
+
+				continue;
+			}
+
+			Job job = std::move(m_QueuedJobs.front());
+			m_QueuedJobs.pop_front();
+			m_Mutex->Unlock();
+
+			job.m_Result = job.m_Job();
+
+			m_Mutex->Lock();
+			m_DoneJobs.push_back(std::move(job));
+			m_Mutex->Unlock();
+
+			m_JobDone->Post();
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+	class IMutex;
+	class ISemaphore;
+	class IThread;
+}
+
+namespace Editor
+{
+	// Runs the jobs of building files and writing them to disk on a background thread, one at a time in the order they were queued, so
+	// the editor does not wait for the disk. The jobs must only work on copies of the editor state. When a job is done, its completion
+	// callback is called from Update() on the thread that queued it, with the result of the job.
+	class SaveWorker final
+	{
+	public:
+		SaveWorker(Foundation::IPlatform* inPlatform);
+		~SaveWorker();		// Finishes the queued jobs, without calling their completion callbacks
+
+		SaveWorker(const SaveWorker& inOther) = delete;
+
+		void Queue(const std::function<bool()>& inJob, const std::function<void(bool)>& inCompletion);
+
+		// Calls the completion callbacks of the jobs done since the last update
+		void Update();
+
+		// Waits for all queued jobs to be done, and calls their completion callbacks
+		void Flush();
+
+		bool IsBusy() const;
+
+	private:
+		struct Job
+		{
+			std::function<bool()> m_Job;
+			std::function<void(bool)> m_Completion;
+			bool m_Result;
+		};
+
+		void WorkerThread();
+
+		Foundation::IPlatform* m_Platform;
+
+		// Only touched by the thread that queues the jobs
+		unsigned int m_PendingJobCount;
+
+		// Guarded by the mutex
+		std::deque<Job> m_QueuedJobs;
+		std::vector<Job> m_DoneJobs;
+		bool m_Stop;
+
+		std::shared_ptr<Foundation::IMutex> m_Mutex;
+		std::shared_ptr<Foundation::ISemaphore> m_JobQueued;
+		std::shared_ptr<Foundation::ISemaphore> m_JobDone;
+		std::shared_ptr<Foundation::IThread> m_WorkerThread;
+	};
+}
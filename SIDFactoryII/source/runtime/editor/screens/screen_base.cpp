@@ -8,6 +8,7 @@
 #include "utils/keyhook.h"
 
 #include "foundation/base/assert.h"
+#include <limits>
 #include <memory>
 
 using namespace Foundation;
@@ -89,6 +90,18 @@ namespace Editor
 	}
 
 
+	bool ScreenBase::IsPlaybackActive() const
+	{
+		return false;
+	}
+
+
+	int ScreenBase::GetTicksToNextUpdate() const
+	{
+		return std::numeric_limits<int>::max();
+	}
+
+
 	//------------------------------------------------------------------------------------------------------------
 
 	ComponentsManager& ScreenBase::GetComponentsManager()
@@ -50,6 +50,9 @@ namespace Editor
 		virtual void Update(int inDeltaTick);
 		virtual void Refresh();
 
+		virtual bool IsPlaybackActive() const;
+		virtual int GetTicksToNextUpdate() const;		// The time until the screen changes by itself, if there is no input
+
 		ComponentsManager& GetComponentsManager();
 
 	protected:
@@ -67,6 +67,7 @@ namespace Editor
 	void ScreenDisk::Deactivate()
 	{
 		m_ComponentsManager->Clear();
+		m_ComponentFileSelector = nullptr;
 		m_DataSourceDirectory = nullptr;
 	}
 
@@ -167,6 +168,10 @@ namespace Editor
 				m_ComponentsManager->SetComponentInFocus(m_ComponentFileNameInput);
 			}
 		}
+
+		// Show the entries the directory scan has found since the last update
+		if (m_ComponentFileSelector != nullptr)
+			m_ComponentFileSelector->UpdateDirectory();
 	}
 
 	void ScreenDisk::Refresh()
@@ -174,6 +179,18 @@ namespace Editor
 		ScreenBase::Refresh();
 	}
 
+
+	int ScreenDisk::GetTicksToNextUpdate() const
+	{
+		// Poll the directory scan, while it is running
+		const int scan_poll_ticks = 20;
+
+		if (m_DataSourceDirectory != nullptr && m_DataSourceDirectory->IsScanning())
+			return scan_poll_ticks;
+
+		return ScreenBase::GetTicksToNextUpdate();
+	}
+
 	//------------------------------------------------------------------------------------------------------------
 
 	void ScreenDisk::SetMode(Mode inMode)
@@ -204,7 +221,7 @@ namespace Editor
 
 		m_DataSourceDirectory = std::make_shared<DataSourceDirectory>(m_Platform, m_ConfigFile);
 
-		auto file_selector = std::make_shared<ComponentFileSelector>(
+		m_ComponentFileSelector = std::make_shared<ComponentFileSelector>(
 			0, 0,
 			nullptr,
 			m_DataSourceDirectory,
@@ -233,10 +250,10 @@ namespace Editor
 			return Color::Black;
 		}();
 
-		file_selector->SetColors(ToColor(UserColor::FileSelectorBackground), selection_color, ToColor(UserColor::FileSelectorCursorNoFocus));
-		file_selector->SetColors(ToColor(UserColor::FileSelectorListText));
+		m_ComponentFileSelector->SetColors(ToColor(UserColor::FileSelectorBackground), selection_color, ToColor(UserColor::FileSelectorCursorNoFocus));
+		m_ComponentFileSelector->SetColors(ToColor(UserColor::FileSelectorListText));
 
-		m_ComponentsManager->AddComponent(file_selector);
+		m_ComponentsManager->AddComponent(m_ComponentFileSelector);
 
 		const int filename_position_y = dimensions.m_Height - bottom_margin + 1;
 		const int filename_position_x = horizontal_margin;
@@ -22,6 +22,7 @@ namespace Editor
 {
 	class ComponentsManager;
 	class DataSourceDirectory;
+	class ComponentFileSelector;
 	enum FileType : int;
 
 	class ScreenDisk final : public ScreenBase
@@ -59,6 +60,8 @@ namespace Editor
 		void Update(int inDeltaTick) override;
 		void Refresh() override;
 
+		int GetTicksToNextUpdate() const override;
+
 		void SetMode(Mode inMode);
 		const Mode GetMode() const;
 
@@ -71,6 +74,7 @@ namespace Editor
 		std::string m_SuggestedFileName;
 
 		std::shared_ptr<DataSourceDirectory> m_DataSourceDirectory;
+		std::shared_ptr<ComponentFileSelector> m_ComponentFileSelector;
 		std::shared_ptr<DataSourceMemoryBufferString> m_DataSourceFileNameBuffer;
 		std::shared_ptr<ComponentTextInput> m_ComponentFileNameInput;
 
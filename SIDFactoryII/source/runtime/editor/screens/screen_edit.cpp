@@ -15,6 +15,7 @@
 #include "runtime/editor/driver/driver_info.h"
 #include "runtime/editor/driver/driver_utils.h"
 #include "runtime/editor/driver/idriver_architecture.h"
+#include "runtime/editor/driver/song_usage_index.h"
 #include "runtime/editor/components/component_track.h"
 #include "runtime/editor/components/component_tracks.h"
 #include "runtime/editor/components/component_table_row_elements.h"
@@ -24,6 +25,7 @@
 #include "runtime/editor/datasources/datasource_track_components.h"
 #include "runtime/editor/datasources/datasource_table_column_major.h"
 #include "runtime/editor/datasources/datasource_table_row_major.h"
+#include "runtime/editor/datasources/datasource_orderlist.h"
 #include "runtime/editor/datasources/datasource_play_markers.h"
 #include "runtime/editor/datasources/datasource_flightrecorder.h"
 #include "runtime/editor/datasources/datasource_sequence.h"
@@ -37,6 +39,8 @@
 #include "runtime/editor/dialog/dialog_optimize.h"
 #include "runtime/editor/screens/statusbar/status_bar_edit.h"
 #include "runtime/editor/overlays/overlay_flightrecorder.h"
+#include "runtime/editor/overlays/overlay_cpu_profile.h"
+#include "runtime/editor/playback_keyframes.h"
 #include "runtime/emulation/cpumemory.h"
 #include "runtime/emulation/sid/sidproxy.h"
 #include "runtime/emulation/sid/sidproxydefines.h"
@@ -64,6 +68,7 @@ namespace Editor
 	const unsigned char ScreenEdit::TracksTableID = 0x42;
 
 	ScreenEdit::ScreenEdit(
+		Foundation::IPlatform* inPlatform,
 		Foundation::Viewport* inViewport,
 		Foundation::TextField* inMainTextField,
 		CursorControl* inCursorControl,
@@ -73,6 +78,7 @@ namespace Editor
 		Emulation::CPUMemory* inCPUMemory,
 		Emulation::ExecutionHandler* inExecutionHandler,
 		Emulation::SIDProxy* inSIDProxy,
+		PlaybackKeyframes* inPlaybackKeyframes,
 		std::shared_ptr<DriverInfo>& inDriverInfo,
 		std::function<void(void)> inRequestLoadCallback,
 		std::function<void(void)> inRequestSaveCallback,
@@ -81,18 +87,10 @@ namespace Editor
 		std::function<void(void)> inRequestSaveInstrumentCallback,
 		std::function<void(void)> inQuickSaveCallback,
 		std::function<void(unsigned short)> inPackCallback,
+		std::function<void(void)> inRastertimeProfileCallback,
 		std::function<void(void)> inToggleShowOverlay,
 		std::function<void(unsigned int)> inReconfigure)
 		: ScreenBase(inViewport, inMainTextField, inCursorControl, inDisplayState, inKeyHookStore)
-		, m_EditState(inEditState)
-		, m_CPUMemory(inCPUMemory)
-		, m_ExecutionHandler(inExecutionHandler)
-		, m_SIDProxy(inSIDProxy)
-		, m_DriverInfo(inDriverInfo)
-		, m_IsTrackDataReportSequence(false)
-		, m_CurrentTrackDataIndex(0)
-		, m_CurrentTrackDataPackedSize(0)
-		, m_PlaybackCurrentEventPos(-1)
 		, m_LoadRequestCallback(inRequestLoadCallback)
 		, m_SaveRequestCallback(inRequestSaveCallback)
 		, m_ImportRequestCallback(inRequestImportCallback)
@@ -100,13 +98,31 @@ namespace Editor
 		, m_SaveInstrumentRequestCallback(inRequestSaveInstrumentCallback)
 		, m_QuickSaveCallback(inQuickSaveCallback)
 		, m_PackCallback(inPackCallback)
+		, m_RastertimeProfileCallback(inRastertimeProfileCallback)
 		, m_ToggleShowOverlay(inToggleShowOverlay)
 		, m_ConfigReconfigure(inReconfigure)
+		, m_ActivationMessage("")
+		, m_EditState(inEditState)
 		, m_PlayTimerTicks(0)
 		, m_PlayTimerSeconds(0)
 		, m_LastPlayNote(0x30)
-		, m_ActivationMessage("")
+		, m_Platform(inPlatform)
+		, m_DriverInfo(inDriverInfo)
+		, m_SIDProxy(inSIDProxy)
+		, m_CPUMemory(inCPUMemory)
+		, m_ExecutionHandler(inExecutionHandler)
+		, m_PlaybackKeyframes(inPlaybackKeyframes)
+		, m_IsTrackDataReportSequence(false)
+		, m_CurrentTrackDataIndex(0)
+		, m_CurrentTrackDataPackedSize(0)
+		, m_PlaybackCurrentEventPos(-1)
+		, m_PlaybackEmulationEventPos(-1)
+		, m_PlaybackFirstSampleOffset(0)
+		, m_PlaybackMaxEventPos(0)
+		, m_PlaybackLoopEventPos(0)
+		, m_PlaybackInputTrack(0)
 		, m_ConvertLegacyDriverTableDefaultColors(false)
+		, m_UndoMemoryBudget(Undo::DefaultMemoryBudget)
 	{
 	}
 
@@ -119,9 +135,10 @@ namespace Editor
 	//------------------------------------------------------------------------------------------------------------
 
 
-	void ScreenEdit::SetAdditionalConfiguration(bool inConvertLegacyDriverTableDefaultColors)
+	void ScreenEdit::SetAdditionalConfiguration(bool inConvertLegacyDriverTableDefaultColors, unsigned int inUndoMemoryBudget)
 	{
 		m_ConvertLegacyDriverTableDefaultColors = inConvertLegacyDriverTableDefaultColors;
+		m_UndoMemoryBudget = inUndoMemoryBudget;
 	}
 
 
@@ -194,15 +211,20 @@ namespace Editor
 		m_DriverState = DriverState();
 
 		// Create the status bar
-		m_StatusBar = std::make_unique<StatusBarEdit>(m_MainTextField, m_EditState, m_DriverState, m_DriverInfo->GetAuxilaryDataCollection(), mouse_button_octave, mouse_button_flat_sharp, mouse_button_sid_model, mouse_button_context_highlight, mouse_button_follow_play);
+		m_StatusBar = std::make_unique<StatusBarEdit>(m_MainTextField, m_EditState, m_DriverState, m_DriverInfo->GetAuxilaryDataCollection(), m_SongUsageIndex, mouse_button_octave, mouse_button_flat_sharp, mouse_button_sid_model, mouse_button_context_highlight, mouse_button_follow_play);
 		m_StatusBar->SetText(m_ActivationMessage.length() > 0 ? m_ActivationMessage : " SID Factory II", 2500);
 		m_ActivationMessage = "";
 
 		// Create flight recorder overlay
 		m_OverlayFlightRecorder = std::make_shared<OverlayFlightRecorder>(m_Viewport, &*m_ComponentsManager, m_CPUMemory, m_ExecutionHandler, m_MainTextField->GetDimensions());
 
+		// Create CPU profile overlay
+		m_OverlayCPUProfile = std::make_shared<OverlayCPUProfile>(m_Viewport, m_CPUMemory, m_ExecutionHandler, m_MainTextField->GetDimensions());
+
 		// Set post update callback from emulation context
+		PublishTracksStateToEmulation();
 		m_ExecutionHandler->SetPostUpdateCallback([&](CPUMemory* inCPUMemory) { OnDriverPostUpdate(inCPUMemory); });
+		m_ExecutionHandler->SetPlaybackFrameCallback([&](CPUMemory* inCPUMemory, Emulation::PlaybackFrame& ioFrame) { OnDriverPlaybackFrame(inCPUMemory, ioFrame); });
 
 		// Set driver data for flight recorder
 		auto& driver_common = m_DriverInfo->GetDriverCommon();
@@ -213,7 +235,12 @@ namespace Editor
 		m_ExecutionHandler->QueueStop();
 		SetStatusPlaying(false);
 
-		m_PlaybackCurrentEventPos = -1;
+		ResetPlaybackEventPosition(-1);
+
+		// Start following the song for playback from any event position
+		m_CPUMemory->Lock();
+		ValidatePlaybackKeyframes();
+		m_CPUMemory->Unlock();
 
 		// Reset edit state
 		m_EditState.SetSelectedInstrument(static_cast<char>(m_InstrumentTableComponent->GetSelectedRow()));
@@ -222,14 +249,22 @@ namespace Editor
 
 	void ScreenEdit::Deactivate()
 	{
+		// Stop following the song, the data is going to change
+		if (m_PlaybackKeyframes != nullptr)
+			m_PlaybackKeyframes->Cancel();
+
 		// Dereference flight recorder overlay
 		m_OverlayFlightRecorder = nullptr;
 
+		// Dereference CPU profile overlay, which stops profiling
+		m_OverlayCPUProfile = nullptr;
+
 		// Disable flight recorder
 		m_ExecutionHandler->GetFlightRecorder()->SetRecording(false);
 
 		// Remove post update callback (dependencies are going to be removed after, so this will avoid tearing down the application)
 		m_ExecutionHandler->SetPostUpdateCallback(nullptr);
+		m_ExecutionHandler->SetPlaybackFrameCallback(nullptr);
 
 		// Restore muted tracks
 		RestoreSIDOffsetData();
@@ -240,6 +275,7 @@ namespace Editor
 		// Clear / dereference data sources
 		m_OrderListDataSources.clear();
 		m_SequenceDataSources.clear();
+		m_SongUsageIndex = nullptr;
 		m_InstrumentTableDataSource = nullptr;
 		m_CommandTableDataSource = nullptr;
 		m_TracksDataSource = nullptr;
@@ -254,7 +290,7 @@ namespace Editor
 		m_ComponentsManager->Clear();
 
 		// Reset play event position
-		m_PlaybackCurrentEventPos = -1;
+		ResetPlaybackEventPosition(-1);
 	}
 
 
@@ -327,6 +363,14 @@ namespace Editor
 		if (m_StatusBar != nullptr)
 			m_StatusBar->Update(inDeltaTick);
 
+		// Follow the playback frame being heard
+		Emulation::PlaybackFrame playback_frame;
+
+		if (m_ExecutionHandler->GetAudiblePlaybackFrame(playback_frame) && playback_frame.m_SampleOffset >= m_PlaybackFirstSampleOffset)
+			m_PlaybackCurrentEventPos = playback_frame.m_EventPosition;
+
+		PublishTracksStateToEmulation();
+
 		m_TracksComponent->TellPlaybackEventPosition(m_PlaybackCurrentEventPos);
 		m_OrderListOverviewComponent->TellPlaybackEventPosition(m_PlaybackCurrentEventPos);
 
@@ -343,6 +387,9 @@ namespace Editor
 
 		m_ComponentsManager->Update(inDeltaTick, m_CPUMemory);
 
+		if (m_OverlayCPUProfile != nullptr)
+			m_OverlayCPUProfile->Update(inDeltaTick, m_DisplayState);
+
 		// Update play timer
 		const bool is_playing = m_DriverState.GetPlayState() == Editor::DriverState::PlayState::Playing;
 		if (is_playing)
@@ -397,7 +444,7 @@ namespace Editor
 
 	void ScreenEdit::FlushUndo()
 	{
-		m_Undo = std::make_shared<Undo>(*m_CPUMemory, *m_DriverInfo);
+		m_Undo = std::make_shared<Undo>(*m_CPUMemory, *m_DriverInfo, m_UndoMemoryBudget);
 		m_Undo->SetOnRestoredStepComponentHandler([this](int inComponentID, int inComponentGroupID)
 		{
 			m_ComponentsManager->SetComponentInFocus(inComponentID);
@@ -475,28 +522,48 @@ namespace Editor
 		m_InstrumentTableDataSource->PushDataToSource();
 		m_CPUMemory->Unlock();
 
+		// Keep the emulation from running a frame, until the event position is counted from the start of playback
+		m_ExecutionHandler->Lock();
 		m_ExecutionHandler->QueueInit(0);
 		SetStatusPlaying(true);
+		ResetPlaybackEventPosition(-1);
+		m_ExecutionHandler->Unlock();
 
 		m_LastPlaybackStartEventPos = 0;
-		m_PlaybackCurrentEventPos = -1;
 	}
 
 
 	void ScreenEdit::DoPlay(unsigned int inEventPos)
 	{
-		DoRestoreMuteState();
-
 		// Push instruments data to emulation memory
 		m_CPUMemory->Lock();
 		m_InstrumentTableDataSource->PushDataToSource();
+		const bool has_valid_keyframes = ValidatePlaybackKeyframes();
 		m_CPUMemory->Unlock();
 
-		m_ExecutionHandler->QueueInit(0, [&, inEventPos](Emulation::CPUMemory* inCPUMemory) { OnDriverPostInitPlayFromEventPos(inCPUMemory, inEventPos); });
+		// Start from the state, which playback from the beginning of the song would have at the event position, if it is known
+		std::shared_ptr<const PlaybackKeyframes::State> playback_state = has_valid_keyframes ? m_PlaybackKeyframes->GetStateAtEventPosition(inEventPos) : nullptr;
+
+		// Keep the emulation from running a frame, until the event position is counted from the start of playback
+		m_ExecutionHandler->Lock();
+
+		if (playback_state != nullptr)
+		{
+			m_ExecutionHandler->QueueRestoreState([&, playback_state](Emulation::CPUMemory* inCPUMemory) { PlaybackKeyframes::RestoreState(*playback_state, *inCPUMemory, *m_ExecutionHandler->GetSIDRenderer()); });
+			DoRestoreMuteState();
+		}
+		else
+		{
+			DoRestoreMuteState();
+			m_ExecutionHandler->QueueInit(0, [&, inEventPos](Emulation::CPUMemory* inCPUMemory) { OnDriverPostInitPlayFromEventPos(inCPUMemory, inEventPos); });
+		}
+
 		SetStatusPlaying(true);
+		ResetPlaybackEventPosition(static_cast<int>(inEventPos) - 1);
+
+		m_ExecutionHandler->Unlock();
 
 		m_LastPlaybackStartEventPos = inEventPos;
-		m_PlaybackCurrentEventPos = inEventPos - 1;
 	}
 
 
@@ -517,16 +584,17 @@ namespace Editor
 
 	void ScreenEdit::DoStop()
 	{
-		// Push instruments data to emulation memory
+		// Push instruments data to emulation memory, and follow the song anew if it has been edited
 		m_CPUMemory->Lock();
 		m_InstrumentTableDataSource->PushDataToSource();
+		ValidatePlaybackKeyframes();
 		m_CPUMemory->Unlock();
 
 		m_ExecutionHandler->QueueStop();
 		SetStatusPlaying(false);
 		DoClearAllMuteState();
 
-		m_PlaybackCurrentEventPos = -1;
+		ResetPlaybackEventPosition(-1);
 	}
 
 
@@ -567,12 +635,48 @@ namespace Editor
 	}
 
 
+	bool ScreenEdit::ValidatePlaybackKeyframes()
+	{
+		FOUNDATION_ASSERT(m_CPUMemory->IsLocked());
+
+		if (m_PlaybackKeyframes == nullptr)
+			return false;
+
+		const DriverInfo::DriverCommon& driver_common = m_DriverInfo->GetDriverCommon();
+		const DriverInfo::Descriptor& descriptor = m_DriverInfo->GetDescriptor();
+
+		PlaybackKeyframes::DriverSetup driver_setup;
+
+		driver_setup.m_InitAddress = driver_common.m_InitAddress;
+		driver_setup.m_UpdateAddress = driver_common.m_UpdateAddress;
+		driver_setup.m_TempoCounterAddress = driver_common.m_TempoCounterAddress;
+		driver_setup.m_MusicDataAddress = descriptor.m_DriverCodeTop + descriptor.m_DriverSize;
+		driver_setup.m_MaxEventPosition = static_cast<unsigned int>(m_TracksComponent->GetMaxEventPosition());
+
+		const Emulation::SIDConfiguration& sid_configuration = m_SIDProxy->GetConfiguration();
+
+		if (m_PlaybackKeyframes->IsValid(*m_CPUMemory, driver_setup, sid_configuration))
+			return true;
+
+		// The song has changed, so follow it from the beginning again
+		m_PlaybackKeyframes->Build(*m_CPUMemory, driver_setup, sid_configuration);
+		return false;
+	}
+
+
 	bool ScreenEdit::IsPlaying() const
 	{
 		return m_DriverState.GetPlayState() == Editor::DriverState::PlayState::Playing;
 	}
 
 
+	bool ScreenEdit::IsPlaybackActive() const
+	{
+		// Notes played from the keyboard count as well, as they drive the visualizers too
+		return m_DriverState.GetPlayState() != Editor::DriverState::PlayState::Stopped;
+	}
+
+
 	void ScreenEdit::DoSpaceBarFromTable(bool inPressed, bool inForceApplyCommand)
 	{
 		if (inPressed)
@@ -781,9 +885,10 @@ namespace Editor
 						const bool is_uppercase = m_DisplayState.IsHexUppercase();
 
 						std::string text = "Driver: " + m_DriverInfo->GetDescriptor().m_DriverName + "\n";
-						text += "Highest sequence  : 0x" + EditorUtils::ConvertToHexValue(DriverUtils::GetHighestSequenceIndexUsed(*m_DriverInfo, *m_CPUMemory), is_uppercase) + "\n";
-						text += "Highest instrument: 0x" + EditorUtils::ConvertToHexValue(DriverUtils::GetHighestInstrumentIndexUsed(*m_DriverInfo, *m_CPUMemory), is_uppercase) + "\n";
-						text += "Highest command   : 0x" + EditorUtils::ConvertToHexValue(DriverUtils::GetHighestCommandIndexUsed(*m_DriverInfo, *m_CPUMemory), is_uppercase) + "\n";
+						text += "Highest sequence  : 0x" + EditorUtils::ConvertToHexValue(m_SongUsageIndex->GetHighestSequenceIndexUsed(), is_uppercase) + "\n";
+						text += "Free sequences    : " + std::to_string(m_SongUsageIndex->GetFreeSequenceCount()) + "\n";
+						text += "Highest instrument: 0x" + EditorUtils::ConvertToHexValue(m_SongUsageIndex->GetHighestInstrumentIndexUsed(), is_uppercase) + "\n";
+						text += "Highest command   : 0x" + EditorUtils::ConvertToHexValue(m_SongUsageIndex->GetHighestCommandIndexUsed(), is_uppercase) + "\n";
 
 						for (const auto& table_definition : m_DriverInfo->GetTableDefinitions())
 						{
@@ -798,6 +903,8 @@ namespace Editor
 					break;
 				case DialogUtilities::Selection::Optimize:
 					m_ComponentsManager->StartDialog(std::make_shared<DialogOptimize>(
+						m_Platform,
+						m_SIDProxy->GetConfiguration(),
 						m_OrderListDataSources,
 						m_SequenceDataSources,
 						m_InstrumentTableDataSource,
@@ -807,12 +914,20 @@ namespace Editor
 						*m_ComponentsManager,
 						*m_DriverInfo,
 						m_CPUMemory,
-						[&]() 
+						[&](bool inIsOptimized, const std::string& inReport)
 						{
+							RebuildSongUsageIndex();
+
 							m_InstrumentTableComponent->PullDataFromSource();
 							m_CommandTableComponent->PullDataFromSource();
+							m_TracksComponent->PullDataFromSource();
 
 							m_ComponentsManager->ForceRefresh(); 
+
+							if (inIsOptimized)
+								SetStatusBarMessage(inReport, 5000);
+							else if (!inReport.empty())
+								m_ComponentsManager->StartDialog(std::make_shared<DialogMessage>("Optimize", inReport, 60, true, []() {}));
 						}
 					));
 					break;
@@ -831,6 +946,9 @@ namespace Editor
 						m_ComponentsManager->StartDialog(std::make_shared<DialogHexValueInput>("Packer", "Packed song destination address:", 32, 4, default_destination_address, 0xffff, dialog_ok, dialog_cancel));
 					}
 
+					break;
+				case DialogUtilities::Selection::RastertimeProfile:
+					m_RastertimeProfileCallback();
 					break;
 				case DialogUtilities::Selection::ClearSequences:
 					{
@@ -843,6 +961,7 @@ namespace Editor
 
 							m_CPUMemory->Unlock();
 
+							m_TracksComponent->PullDataFromSource();
 							m_ComponentsManager->ForceRefresh();
 							m_Undo->Clear();
 						};
@@ -860,6 +979,7 @@ namespace Editor
 		
 							m_CPUMemory->Unlock();
 
+							m_TracksComponent->PullDataFromSource();
 							m_ComponentsManager->ForceRefresh();
 							m_Undo->Clear();
 						};
@@ -870,7 +990,7 @@ namespace Editor
 				}
 			};
 
-			m_ComponentsManager->StartDialog(std::make_shared<DialogUtilities>(60, 8, on_select, [&]() { DoRestoreMuteState(); }));
+			m_ComponentsManager->StartDialog(std::make_shared<DialogUtilities>(60, 9, on_select, [&]() { DoRestoreMuteState(); }));
 		}
 	}
 
@@ -931,6 +1051,15 @@ namespace Editor
 		// Create data containers for each sequence
 		ScreenEditUtils::PrepareSequenceDataSources(*m_DriverInfo, m_DriverState, *m_CPUMemory, m_SequenceDataSources);
 
+		// Create the index of what the song uses, which the data sources keep up to date from here on
+		m_SongUsageIndex = std::make_shared<SongUsageIndex>(*m_DriverInfo);
+		RebuildSongUsageIndex();
+
+		for (unsigned int i = 0; i < m_OrderListDataSources.size(); ++i)
+			m_OrderListDataSources[i]->SetSongUsageIndex(m_SongUsageIndex, i);
+		for (auto& sequence_data_source : m_SequenceDataSources)
+			sequence_data_source->SetSongUsageIndex(m_SongUsageIndex);
+
 		// Status report lamda for sequence editing
 		auto sequence_editing_status_report = [&](bool inIsSequenceReport, int inDataIndex, int inPackedSize)
 		{
@@ -941,20 +1070,12 @@ namespace Editor
 
 		auto get_first_free_sequence_index = [&]() -> unsigned char
 		{
-			m_CPUMemory->Lock();
-			unsigned char first_free_sequence_index = DriverUtils::GetFirstUnusedSequenceIndex(*m_DriverInfo, *m_CPUMemory);
-			m_CPUMemory->Unlock();
-
-			return first_free_sequence_index;
+			return m_SongUsageIndex->GetFirstUnusedSequenceIndex();
 		};
         
         auto get_first_empty_sequence_index = [&]() -> unsigned char
         {
-            m_CPUMemory->Lock();
-            unsigned char first_free_sequence_index = DriverUtils::GetFirstEmptySequenceIndex(*m_DriverInfo, *m_CPUMemory);
-            m_CPUMemory->Unlock();
-
-            return first_free_sequence_index;
+            return m_SongUsageIndex->GetFirstEmptySequenceIndex();
         };
 
 		// Create copy/paste data container
@@ -986,6 +1107,15 @@ namespace Editor
 		m_TracksDataSource = std::make_shared<DataSourceTrackComponents>(tracks);
 	}
 
+
+	void ScreenEdit::RebuildSongUsageIndex()
+	{
+		// For changes made to the music data in memory without going through the data sources, such as undo and redo
+		m_CPUMemory->Lock();
+		m_SongUsageIndex->Rebuild(*m_CPUMemory);
+		m_CPUMemory->Unlock();
+	}
+
 	void ScreenEdit::PrepareLayout()
 	{
 		Undo* undo = &(*m_Undo);
@@ -1370,10 +1500,10 @@ namespace Editor
 					const unsigned char tempo_counter_value = (*inCPUMemory)[tempo_counter_address];
 
 					if (tempo_counter_value == 0)
-						++m_PlaybackCurrentEventPos;
+						++m_PlaybackEmulationEventPos;
 
-					if (m_PlaybackCurrentEventPos >= m_TracksComponent->GetMaxEventPosition())
-						m_PlaybackCurrentEventPos = m_TracksComponent->GetLoopEventPosition();
+					if (m_PlaybackEmulationEventPos >= m_PlaybackMaxEventPos)
+						m_PlaybackEmulationEventPos = m_PlaybackLoopEventPos;
 				}
 			}
 			break;
@@ -1382,7 +1512,7 @@ namespace Editor
 				const DriverInfo::DriverCommon& driver_common = m_DriverInfo->GetDriverCommon();
 				unsigned short input_play_track = [&]()
 				{
-					int track = m_TracksComponent->GetFocusTrackIndex();
+					int track = m_PlaybackInputTrack;
 
 					if (track < 0)
 						track = 0;
@@ -1434,6 +1564,36 @@ namespace Editor
 		}
 	}
 
+	void ScreenEdit::OnDriverPlaybackFrame(Emulation::CPUMemory* inCPUMemory, Emulation::PlaybackFrame& ioFrame)
+	{
+		const unsigned short tempo_counter_address = m_DriverInfo->GetDriverCommon().m_TempoCounterAddress;
+
+		ioFrame.m_TempoCounter = tempo_counter_address != 0 ? (*inCPUMemory)[tempo_counter_address] : 0;
+		ioFrame.m_EventPosition = m_PlaybackEmulationEventPos;
+	}
+
+
+	void ScreenEdit::ResetPlaybackEventPosition(int inEventPos)
+	{
+		// Restart the count on the emulation thread, and leave out the frames it has emulated until now, which are yet to be heard
+		m_ExecutionHandler->Lock();
+		m_PlaybackEmulationEventPos = inEventPos;
+		m_PlaybackFirstSampleOffset = m_ExecutionHandler->GetNextPlaybackFrameSampleOffset();
+		m_ExecutionHandler->Unlock();
+
+		m_PlaybackCurrentEventPos = inEventPos;
+	}
+
+
+	void ScreenEdit::PublishTracksStateToEmulation()
+	{
+		// The emulation thread doesn't access the tracks component, so what it needs from it is handed over here
+		m_PlaybackMaxEventPos = m_TracksComponent->GetMaxEventPosition();
+		m_PlaybackLoopEventPos = m_TracksComponent->GetLoopEventPosition();
+		m_PlaybackInputTrack = m_TracksComponent->GetFocusTrackIndex();
+	}
+
+
 	void ScreenEdit::SetStatusPlaying(bool inIsPlaying)
 	{
 		const bool is_playing = m_DriverState.GetPlayState() == Editor::DriverState::PlayState::Playing;
@@ -1659,6 +1819,13 @@ namespace Editor
 			return true;
 		} });
 
+		m_KeyHooks.push_back({ "Key.ScreenEdit.ToggleCPUProfileOverlay", m_KeyHookStore, [&]()
+		{
+			m_OverlayCPUProfile->SetEnabled(!m_OverlayCPUProfile->IsEnabled());
+
+			return true;
+		} });
+
 		m_KeyHooks.push_back({ "Key.ScreenEdit.ToggleDebugView", m_KeyHookStore, [&]()
 		{
 			m_DebugViews->SetEnabled(!m_DebugViews->IsEnabled());
@@ -1710,7 +1877,7 @@ namespace Editor
 			m_ExecutionHandler->QueueStop();
 			SetStatusPlaying(false);
 
-			m_PlaybackCurrentEventPos = -1;
+			ResetPlaybackEventPosition(-1);
 			m_CPUMemory->Lock();
 			m_InstrumentTableDataSource->PushDataToSource();
 			m_CPUMemory->Unlock();
@@ -1725,6 +1892,7 @@ namespace Editor
 			if (m_Undo->HasUndoStep())
 			{
 				m_Undo->DoUndo(*m_CursorControl);
+				RebuildSongUsageIndex();
 				m_ComponentsManager->OnUndoOrRedo();
 			}
 
@@ -1736,6 +1904,7 @@ namespace Editor
 			if (m_Undo->HasRedoStep())
 			{
 				m_Undo->DoRedo(*m_CursorControl);
+				RebuildSongUsageIndex();
 				m_ComponentsManager->OnUndoOrRedo();
 			}
 
@@ -1836,7 +2005,7 @@ namespace Editor
 			if (m_ExecutionHandler->IsWritingOutputToFile())
 				m_ExecutionHandler->StopWriteOutputToFile();
 			else
-				m_ExecutionHandler->StartWriteOutputToFile("C:\\Temp\\sf2output.wav");
+				m_ExecutionHandler->StartWriteOutputToFile("C:\\Temp\\sf2output.wav", Foundation::WaveFileWriter::SampleFormat::PCM16);
 			return true;
 		} }); */
 
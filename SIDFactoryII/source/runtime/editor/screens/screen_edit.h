@@ -7,15 +7,22 @@
 #include "runtime/editor/driver/driver_state.h"
 #include "runtime/editor/undo/undo.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <functional>
 
+namespace Foundation
+{
+	class IPlatform;
+}
+
 namespace Emulation
 {
 	class CPUMemory;
 	class ExecutionHandler;
 	class SIDProxy;
+	struct PlaybackFrame;
 }
 
 namespace Utility
@@ -33,6 +40,8 @@ namespace Editor
 	class DataSourceSequence;
 	class DataSourceTable;
 
+	class SongUsageIndex;
+
 	class ComponentTrack;
 	class ComponentTracks;
 	class ComponentOrderListOverview;
@@ -40,8 +49,10 @@ namespace Editor
 	class ComponentStringListSelector;
 
 	class OverlayFlightRecorder;
+	class OverlayCPUProfile;
 
 	class DebugViews;
+	class PlaybackKeyframes;
 	struct TrackCopyPasteData;
 
 	class ScreenEdit final : public ScreenBase
@@ -65,6 +76,7 @@ namespace Editor
         static const unsigned char TracksTableID;
 
 		ScreenEdit(
+			Foundation::IPlatform* inPlatform,
 			Foundation::Viewport* inViewport, 
 			Foundation::TextField* inMainTextField,
 			CursorControl* inCursorControl, 
@@ -74,6 +86,7 @@ namespace Editor
 			Emulation::CPUMemory* inCPUMemory, 
 			Emulation::ExecutionHandler* inExecutionHandler, 
 			Emulation::SIDProxy* inSIDProxy,
+			PlaybackKeyframes* inPlaybackKeyframes,
 			std::shared_ptr<DriverInfo>& inDriverInfo,
 			std::function<void(void)> inRequestLoadCallback,
 			std::function<void(void)> inRequestSaveCallback,
@@ -82,11 +95,12 @@ namespace Editor
 			std::function<void(void)> inRequestSaveInstrumentCallback,
 			std::function<void(void)> inQuickSaveCallback,
 			std::function<void(unsigned short)> inPackCallback,
+			std::function<void(void)> inRastertimeProfileCallback,
 			std::function<void(void)> inToggleShowOverlay,
 			std::function<void(unsigned int)> inConfigReload);
 		virtual ~ScreenEdit();
 
-		void SetAdditionalConfiguration(bool inConvertLegacyDriverTableDefaultColors);
+		void SetAdditionalConfiguration(bool inConvertLegacyDriverTableDefaultColors, unsigned int inUndoMemoryBudget);
 
 		void Activate() override;
 		void Deactivate() override;
@@ -99,6 +113,8 @@ namespace Editor
 		void Update(int inDeltaTick) override;
 		void Refresh() override;
 
+		bool IsPlaybackActive() const override;
+
 		void SetActivationMessage(const std::string& inMessage);
 		void SetStatusBarMessage(const std::string& inMessage, int inDisplayDuration);
 		void FlushUndo();
@@ -114,6 +130,7 @@ namespace Editor
 		void DoClearAllMuteState();
 		void DoRestoreMuteState();
 		void DoMoveToEventPositionOfSelectedMarker();
+		bool ValidatePlaybackKeyframes();
 
 		bool IsPlaying() const;
 
@@ -144,6 +161,7 @@ namespace Editor
 
 		void PrepareMusicData();
 		void PrepareLayout();
+		void RebuildSongUsageIndex();
 
 		void ExecuteTableInsertDeleteRule(int inTableID, int inIndexPre, int inIndexPost);
 		void ExecuteTableInsertDeleteRules(const DriverInfo::TableInsertDeleteRules& inTableRules, int inSourceTableID, int inIndexPre, int inIndexPost);
@@ -154,6 +172,10 @@ namespace Editor
 		void OnDriverPostApplyAllChannelsMuteState(Emulation::CPUMemory* inCPUMemory);
 		void OnDriverPostClearMuteState(Emulation::CPUMemory* inCPUMemory);
 		void OnDriverPostUpdate(Emulation::CPUMemory* inCPUMemory);
+		void OnDriverPlaybackFrame(Emulation::CPUMemory* inCPUMemory, Emulation::PlaybackFrame& ioFrame);
+
+		void ResetPlaybackEventPosition(int inEventPos);
+		void PublishTracksStateToEmulation();
 
 		void SetStatusPlaying(bool inIsPlaying);
 		void SetStatusPlayingInput();
@@ -171,6 +193,7 @@ namespace Editor
 		std::function<void(void)> m_SaveInstrumentRequestCallback;
 		std::function<void(void)> m_QuickSaveCallback;
 		std::function<void(unsigned short)> m_PackCallback;
+		std::function<void(void)> m_RastertimeProfileCallback;
 		std::function<void(void)> m_ToggleShowOverlay;
 		std::function<void(unsigned int)> m_ConfigReconfigure;
 
@@ -201,11 +224,13 @@ namespace Editor
 		int m_LastPlayNoteKeyInput;
 
 		// Emulation domain
+		Foundation::IPlatform* m_Platform;
 		std::shared_ptr<DriverInfo>& m_DriverInfo;
 
 		Emulation::SIDProxy* m_SIDProxy;
 		Emulation::CPUMemory* m_CPUMemory;
 		Emulation::ExecutionHandler* m_ExecutionHandler;
+		PlaybackKeyframes* m_PlaybackKeyframes;
 
 		// Data sources
 		std::vector<std::shared_ptr<DataSourceOrderList>> m_OrderListDataSources;
@@ -214,6 +239,9 @@ namespace Editor
 		std::shared_ptr<DataSourceTable> m_CommandTableDataSource;
 		std::shared_ptr<DataSourceTrackComponents> m_TracksDataSource;
 
+		// What the song uses, kept up to date by the order list and sequence data sources
+		std::shared_ptr<SongUsageIndex> m_SongUsageIndex;
+
 		// Components
 		std::shared_ptr<ComponentTracks> m_TracksComponent;
 		std::shared_ptr<ComponentOrderListOverview> m_OrderListOverviewComponent;
@@ -223,6 +251,7 @@ namespace Editor
 
 		// Overlay
 		std::shared_ptr<OverlayFlightRecorder> m_OverlayFlightRecorder;
+		std::shared_ptr<OverlayCPUProfile> m_OverlayCPUProfile;
 
 		// Undo
 		std::shared_ptr<Undo> m_Undo;
@@ -237,10 +266,21 @@ namespace Editor
 
 		// Playback 
 		int m_LastPlaybackStartEventPos;
-		int m_PlaybackCurrentEventPos;
+		int m_PlaybackCurrentEventPos;			// The event position being heard
+
+		// Playback, as counted on the emulation thread, which runs ahead of what is heard. The first sample offset leaves out the playback
+		// frames emulated before playback was last started or stopped.
+		int m_PlaybackEmulationEventPos;
+		unsigned long long m_PlaybackFirstSampleOffset;
+
+		// State of the tracks component, for the emulation thread to use
+		std::atomic<int> m_PlaybackMaxEventPos;
+		std::atomic<int> m_PlaybackLoopEventPos;
+		std::atomic<int> m_PlaybackInputTrack;
 
 		// Added configuration
 		bool m_ConvertLegacyDriverTableDefaultColors;
+		unsigned int m_UndoMemoryBudget;
 
 		// Debug
 		std::unique_ptr<DebugViews> m_DebugViews;
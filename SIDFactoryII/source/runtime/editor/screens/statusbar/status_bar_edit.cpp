@@ -1,4 +1,5 @@
 #include "status_bar_edit.h"
+#include "runtime/editor/driver/song_usage_index.h"
 #include "foundation/graphics/textfield.h"
 #include "foundation/graphics/color.h"
 #include "utils/usercolors.h"
@@ -14,6 +15,7 @@ namespace Editor
 			const EditState& inEditState,
 			const DriverState& inDriverState,
 			const AuxilaryDataCollection& inAuxilaryDataCollection,
+			std::shared_ptr<const SongUsageIndex> inSongUsageIndex,
 			std::function<void(Mouse::Button, int)> inOctaveMousePressCallback,
 			std::function<void(Mouse::Button, int)> inSharpFlatMousePressCallback,
 			std::function<void(Mouse::Button, int)> inSIDMousePressCallback,
@@ -24,13 +26,17 @@ namespace Editor
 		, m_EditState(inEditState)
 		, m_DriverState(inDriverState)
 		, m_AuxilaryDataPlayMarkers(inAuxilaryDataCollection)
+		, m_SongUsageIndex(inSongUsageIndex)
+		, m_CachedFreeSequenceCount(-1)
 	{
+		m_TextSectionFreeSequences = std::make_shared<TextSection>(16);
 		m_TextSectionOctave = std::make_shared<TextSection>(12, inOctaveMousePressCallback);
 		m_TextSectionSharpFlat = std::make_shared<TextSection>(15, inSharpFlatMousePressCallback);
 		m_TextSectionSID = std::make_shared<TextSection>(19, inSIDMousePressCallback);
 		m_TextSectionContextHighlight = std::make_shared<TextSection>(18, inContextHighlightMousePressCallback);
 		m_TextSectionFollowPlay = std::make_shared<TextSection>(15, inFollowPlayerMousePressCallback);
 
+		m_TextSectionList.push_back(m_TextSectionFreeSequences);
 		m_TextSectionList.push_back(m_TextSectionOctave);
 		m_TextSectionList.push_back(m_TextSectionSharpFlat);
 		m_TextSectionList.push_back(m_TextSectionSID);
@@ -88,6 +94,15 @@ namespace Editor
 			m_NeedRefresh = true;
 		}
 
+		const int free_sequence_count = m_SongUsageIndex != nullptr ? m_SongUsageIndex->GetFreeSequenceCount() : 0;
+		if (free_sequence_count != m_CachedFreeSequenceCount || inNeedUpdate)
+		{
+			m_TextSectionFreeSequences->SetText(" Free seqs: " + std::to_string(free_sequence_count));
+			m_CachedFreeSequenceCount = free_sequence_count;
+
+			m_NeedRefresh = true;
+		}
+
 		if (m_CachedDriverState != m_DriverState || inNeedUpdate)
 		{
 			// Just doing this to have it set for sure.. Bit of a hack!
@@ -10,6 +10,7 @@
 #include "runtime/editor/driver/driver_state.h"
 #include <string>
 #include <functional>
+#include <memory>
 
 namespace Foundation
 {
@@ -18,6 +19,8 @@ namespace Foundation
 
 namespace Editor
 {
+	class SongUsageIndex;
+
 	class StatusBarEdit : public StatusBar
 	{
 	public:
@@ -27,6 +30,7 @@ namespace Editor
 			const EditState& inEditState,
 			const DriverState& inDriverState,
 			const AuxilaryDataCollection& inAuxilaryDataCollection,
+			std::shared_ptr<const SongUsageIndex> inSongUsageIndex,
 			std::function<void(Foundation::Mouse::Button, int)> inOctaveMousePressCallback,
 			std::function<void(Foundation::Mouse::Button, int)> inSharpFlatMousePressCallback,
 			std::function<void(Foundation::Mouse::Button, int)> inSIDMousePressCallback,
@@ -43,6 +47,7 @@ namespace Editor
 		void ClearContents() override;
 		void DrawText() override;
 
+		std::shared_ptr<TextSection> m_TextSectionFreeSequences;
 		std::shared_ptr<TextSection> m_TextSectionOctave;
 		std::shared_ptr<TextSection> m_TextSectionSharpFlat;
 		std::shared_ptr<TextSection> m_TextSectionSID;
@@ -52,9 +57,11 @@ namespace Editor
 		const EditState& m_EditState;
 		const AuxilaryDataCollection& m_AuxilaryDataPlayMarkers;
 		const DriverState& m_DriverState;
+		std::shared_ptr<const SongUsageIndex> m_SongUsageIndex;
 
 		EditState m_CachedEditState;
 		DriverState m_CachedDriverState;
+		int m_CachedFreeSequenceCount;
 
 		AuxilaryDataEditingPreferences::NotationMode m_CachedNotationMode;
 		AuxilaryDataHardwarePreferences::SIDModel m_CachedSIDModel;
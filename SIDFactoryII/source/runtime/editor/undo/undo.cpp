@@ -3,25 +3,39 @@
 #include "runtime/editor/undo/undo_componentdata.h"
 #include "runtime/editor/driver/driver_info.h"
 #include "runtime/emulation/cpumemory.h"
+#include "utils/delta_encoding.h"
 #include <memory>
 #include "foundation/base/assert.h"
 
 namespace Editor
 {
-	Undo::Undo(Emulation::CPUMemory& inCPUMemory, const DriverInfo& inDriverInfo)
-		: m_CPUMemory(inCPUMemory)
+	Undo::Undo(Emulation::CPUMemory& inCPUMemory, const DriverInfo& inDriverInfo, unsigned int inMemoryBudget)
+		: m_Position(0)
 		, m_DataSnapshotAddressBegin(inDriverInfo.GetDescriptor().m_DriverCodeTop + inDriverInfo.GetDescriptor().m_DriverSize)
 		, m_DataSnapshotSize(0x10000 - m_DataSnapshotAddressBegin)
-		, m_Begin(0)
-		, m_End(0)
+		, m_MemoryBudget(inMemoryBudget)
+		, m_DeltaMemoryUsage(0)
+		, m_CPUMemory(inCPUMemory)
+		, m_SnapshotIndex(0)
+		, m_Snapshot(m_DataSnapshotSize)
+		, m_CaptureBuffer(m_DataSnapshotSize)
+	{
+		m_EncodeBuffer.reserve(m_DataSnapshotSize);
+	}
+
+
+	Undo::~Undo()
 	{
 	}
 
 
 	void Undo::Clear()
 	{
-		for (auto& step : m_UndoSteps)
-			step = nullptr;
+		m_UndoSteps.clear();
+
+		m_Position = 0;
+		m_SnapshotIndex = 0;
+		m_DeltaMemoryUsage = 0;
 	}
 
 
@@ -33,142 +47,182 @@ namespace Editor
 
 	bool Undo::HasUndoStep() const
 	{
-		return m_Begin != m_End;
+		return m_Position > 0;
 	}
 
 
 	bool Undo::HasRedoStep() const
 	{
-		unsigned int next_end = m_End + 1;
-		
-		if (next_end >= m_UndoSteps.size())
-			next_end = 0;
-
-		if (m_Begin == next_end)
-			return false;
-
-		return m_UndoSteps[next_end] != nullptr;
+		return m_Position + 1 < static_cast<unsigned int>(m_UndoSteps.size());
 	}
 
 
 	void Undo::AddMostRecentEdit(bool inLockCPU, const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
 	{
-		FOUNDATION_ASSERT(m_End < m_UndoSteps.size());
+		CaptureData(inLockCPU);
 
-		unsigned char* data = new unsigned char[m_DataSnapshotSize];
+		// Replace the step at the current position, and flush forward
+		RemoveStepsFrom(m_Position);
+		AddStep(inComponentUndoData, inRestorePostFunction);
+		RemoveOldestSteps();
+	}
 
-		if(inLockCPU)
-			m_CPUMemory.Lock();
-		
-		m_CPUMemory.GetData(m_DataSnapshotAddressBegin, static_cast<void*>(data), m_DataSnapshotSize);
-	
-		if(inLockCPU)
-			m_CPUMemory.Unlock();
 
-		m_UndoSteps[m_End] = std::make_shared<UndoStep>(data, inComponentUndoData, inRestorePostFunction);
+	void Undo::AddUndo(const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
+	{
+		CaptureData(true);
 
-		// Flush forward
-		unsigned int i = m_End + 1;
+		RemoveStepsFrom(m_Position);
+		AddStep(inComponentUndoData, inRestorePostFunction);
 
-		while (true)
-		{
-			if (i == m_UndoSteps.size())
-				i = 0;
-			if (i == m_Begin)
-				break;
+		++m_Position;
 
-			m_UndoSteps[i] = nullptr;
+		RemoveOldestSteps();
+	}
 
-			++i;
-		}
+
+	void Undo::DoUndo(CursorControl& inCursorControl)
+	{
+		FOUNDATION_ASSERT(HasUndoStep());
+
+		--m_Position;
+		RestoreStep(m_Position, inCursorControl);
 	}
 
 
-	void Undo::AddUndo(const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
+	void Undo::DoRedo(CursorControl& inCursorControl)
 	{
-		FOUNDATION_ASSERT(m_End < m_UndoSteps.size());
+		FOUNDATION_ASSERT(HasRedoStep());
 
-		unsigned char* data = new unsigned char[m_DataSnapshotSize];
+		++m_Position;
+		RestoreStep(m_Position, inCursorControl);
+	}
 
-		m_CPUMemory.Lock();
-		m_CPUMemory.GetData(m_DataSnapshotAddressBegin, static_cast<void*>(data), m_DataSnapshotSize);
-		m_CPUMemory.Unlock();
 
-		m_UndoSteps[m_End] = std::make_shared<UndoStep>(data, inComponentUndoData, inRestorePostFunction);
+	unsigned int Undo::GetStepCount() const
+	{
+		return static_cast<unsigned int>(m_UndoSteps.size());
+	}
 
-		++m_End;
-		if (m_End == m_UndoSteps.size())
-			m_End = 0;
 
-		if (m_End == m_Begin)
-		{
-			++m_Begin;
-			if (m_Begin == m_UndoSteps.size())
-				m_Begin = 0;
-		}
+	unsigned int Undo::GetMemoryUsage() const
+	{
+		return m_DeltaMemoryUsage + static_cast<unsigned int>(m_Snapshot.size());
 	}
 
+	//------------------------------------------------------------------------------------------------------------
 
-	void Undo::DoUndo(CursorControl& inCursorControl)
+	void Undo::CaptureData(bool inLockCPU)
 	{
-		FOUNDATION_ASSERT(HasUndoStep());
+		// Only copy the data while the memory is locked. The delta is encoded afterwards.
+		if (inLockCPU)
+			m_CPUMemory.Lock();
 
-		int new_end = static_cast<int>(m_End) - 1;
+		m_CPUMemory.GetData(m_DataSnapshotAddressBegin, static_cast<void*>(m_CaptureBuffer.data()), m_DataSnapshotSize);
 
-		if (new_end < 0)
-			new_end = static_cast<int>(m_UndoSteps.size() - 1);
+		if (inLockCPU)
+			m_CPUMemory.Unlock();
+	}
 
-		FOUNDATION_ASSERT(m_UndoSteps[new_end] != nullptr);
 
-		const unsigned char* restore_data = m_UndoSteps[new_end]->GetData();
+	void Undo::AddStep(const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
+	{
+		FOUNDATION_ASSERT(m_Position == m_UndoSteps.size());
+
+		std::vector<unsigned char> delta;
 
-		if(restore_data != nullptr)
+		if (!m_UndoSteps.empty())
 		{
-			m_CPUMemory.Lock();
-			m_CPUMemory.SetData(m_DataSnapshotAddressBegin, static_cast<const void*>(restore_data), m_DataSnapshotSize);
-			m_CPUMemory.Unlock();
+			MoveSnapshotTo(static_cast<unsigned int>(m_UndoSteps.size()) - 1);
+			Utility::EncodeXORDelta(m_Snapshot.data(), m_CaptureBuffer.data(), m_DataSnapshotSize, m_EncodeBuffer);
+
+			delta = std::vector<unsigned char>(m_EncodeBuffer.begin(), m_EncodeBuffer.end());
+			m_DeltaMemoryUsage += static_cast<unsigned int>(delta.capacity());
 		}
 
-		const int component_id = m_UndoSteps[new_end]->GetComponentData().m_ComponentID;
-		const int component_group_id = m_UndoSteps[new_end]->GetComponentData().m_ComponentGroupID;
+		// The captured data becomes the snapshot of the new step
+		m_Snapshot.swap(m_CaptureBuffer);
+		m_SnapshotIndex = static_cast<unsigned int>(m_UndoSteps.size());
+
+		m_UndoSteps.push_back(std::make_unique<UndoStep>(std::move(delta), inComponentUndoData, inRestorePostFunction));
+	}
 
-		if (m_RestoredStepComponentHandler != nullptr)
-			m_RestoredStepComponentHandler(component_id, component_group_id);
 
-		m_UndoSteps[new_end]->OnRestored(inCursorControl);
+	void Undo::RemoveStepsFrom(unsigned int inIndex)
+	{
+		if (inIndex >= m_UndoSteps.size())
+			return;
+
+		if (inIndex > 0 && m_SnapshotIndex >= inIndex)
+			MoveSnapshotTo(inIndex - 1);
+
+		while (m_UndoSteps.size() > inIndex)
+		{
+			m_DeltaMemoryUsage -= m_UndoSteps.back()->GetDeltaSize();
+			m_UndoSteps.pop_back();
+		}
 
-		m_End = static_cast<unsigned int>(new_end);
+		if (m_UndoSteps.empty())
+			m_SnapshotIndex = 0;
 	}
 
 
-	void Undo::DoRedo(CursorControl& inCursorControl)
+	void Undo::RemoveOldestSteps()
 	{
-		FOUNDATION_ASSERT(HasRedoStep());
+		// Always leave at least one step to undo to
+		while (GetMemoryUsage() > m_MemoryBudget && m_Position > 1)
+		{
+			if (m_SnapshotIndex == 0)
+				MoveSnapshotTo(1);
 
-		unsigned int new_end = m_End + 1;
+			// The second oldest step becomes the oldest, which has no delta
+			m_DeltaMemoryUsage -= m_UndoSteps[1]->GetDeltaSize();
+			m_UndoSteps[1]->SetDelta(std::vector<unsigned char>());
 
-		if (new_end >= m_UndoSteps.size())
-			new_end = 0;
+			m_DeltaMemoryUsage -= m_UndoSteps.front()->GetDeltaSize();
+			m_UndoSteps.pop_front();
+
+			--m_Position;
+			--m_SnapshotIndex;
+		}
+	}
 
-		FOUNDATION_ASSERT(m_UndoSteps[new_end] != nullptr);
 
-		const unsigned char* restore_data = m_UndoSteps[new_end]->GetData();
+	void Undo::MoveSnapshotTo(unsigned int inIndex)
+	{
+		FOUNDATION_ASSERT(inIndex < m_UndoSteps.size());
 
-		if (restore_data != nullptr)
+		// The XOR deltas work both ways, applying the delta of a step to its own data gives the data of the step before it
+		while (m_SnapshotIndex > inIndex)
 		{
-			m_CPUMemory.Lock();
-			m_CPUMemory.SetData(m_DataSnapshotAddressBegin, static_cast<const void*>(restore_data), m_DataSnapshotSize);
-			m_CPUMemory.Unlock();
+			Utility::ApplyXORDelta(m_UndoSteps[m_SnapshotIndex]->GetDelta(), m_Snapshot.data(), m_DataSnapshotSize);
+			--m_SnapshotIndex;
 		}
 
-		const int component_id = m_UndoSteps[new_end]->GetComponentData().m_ComponentID;
-		const int component_group_id = m_UndoSteps[new_end]->GetComponentData().m_ComponentGroupID;
+		while (m_SnapshotIndex < inIndex)
+		{
+			++m_SnapshotIndex;
+			Utility::ApplyXORDelta(m_UndoSteps[m_SnapshotIndex]->GetDelta(), m_Snapshot.data(), m_DataSnapshotSize);
+		}
+	}
+
+
+	void Undo::RestoreStep(unsigned int inIndex, CursorControl& inCursorControl)
+	{
+		MoveSnapshotTo(inIndex);
+
+		m_CPUMemory.Lock();
+		m_CPUMemory.SetData(m_DataSnapshotAddressBegin, static_cast<const void*>(m_Snapshot.data()), m_DataSnapshotSize);
+		m_CPUMemory.Unlock();
+
+		UndoStep& step = *m_UndoSteps[inIndex];
+
+		const int component_id = step.GetComponentData().m_ComponentID;
+		const int component_group_id = step.GetComponentData().m_ComponentGroupID;
 
 		if (m_RestoredStepComponentHandler != nullptr)
 			m_RestoredStepComponentHandler(component_id, component_group_id);
 
-		m_UndoSteps[new_end]->OnRestored(inCursorControl);
-
-		m_End = new_end;
+		step.OnRestored(inCursorControl);
 	}
 }
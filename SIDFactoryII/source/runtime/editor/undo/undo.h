@@ -1,8 +1,9 @@
 #pragma once
 
-#include <array>
+#include <deque>
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace Emulation
 {
@@ -16,10 +17,16 @@ namespace Editor
 	class CursorControl;
 	struct UndoComponentData;
 
+	// The undo history keeps a single full copy of the music data, and stores each step as the XOR difference to the step before it,
+	// run length encoded, so that a step is only as large as the edit it records. Moving between steps applies the differences one at a
+	// time. The oldest steps are dropped when the history grows beyond the memory budget.
 	class Undo final
 	{
 	public:
-		Undo(Emulation::CPUMemory& inCPUMemory, const DriverInfo& inDriverInfo);
+		static const unsigned int DefaultMemoryBudget = 4 * 1024 * 1024;
+
+		Undo(Emulation::CPUMemory& inCPUMemory, const DriverInfo& inDriverInfo, unsigned int inMemoryBudget = DefaultMemoryBudget);
+		~Undo();
 
 		void Clear();
 		void SetOnRestoredStepComponentHandler(std::function<void(int, int)> inHandler);
@@ -31,17 +38,35 @@ namespace Editor
 		void AddUndo(const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction);
 		void DoUndo(CursorControl& inCursorControl);
 		void DoRedo(CursorControl& inCursorControl);
+
+		unsigned int GetStepCount() const;
+		unsigned int GetMemoryUsage() const;
 	
 	private:
-		unsigned int m_Begin;
-		unsigned int m_End;
+		void CaptureData(bool inLockCPU);
+		void AddStep(const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction);
+		void RemoveStepsFrom(unsigned int inIndex);
+		void RemoveOldestSteps();
+		void MoveSnapshotTo(unsigned int inIndex);
+		void RestoreStep(unsigned int inIndex, CursorControl& inCursorControl);
+
+		unsigned int m_Position;
 
 		unsigned short m_DataSnapshotAddressBegin;
 		unsigned short m_DataSnapshotSize;
 
+		const unsigned int m_MemoryBudget;
+		unsigned int m_DeltaMemoryUsage;
+
 		Emulation::CPUMemory& m_CPUMemory;
 
-		std::array<std::shared_ptr<UndoStep>, 256> m_UndoSteps;
+		std::deque<std::unique_ptr<UndoStep>> m_UndoSteps;
 		std::function<void(int, int)> m_RestoredStepComponentHandler;
+
+		// The full data of the step at the snapshot index, and a buffer the data of a new step is captured to
+		unsigned int m_SnapshotIndex;
+		std::vector<unsigned char> m_Snapshot;
+		std::vector<unsigned char> m_CaptureBuffer;
+		std::vector<unsigned char> m_EncodeBuffer;
 	};
-}
\ No newline at end of file
+}
@@ -3,23 +3,34 @@
 
 namespace Editor
 {
-	UndoStep::UndoStep(unsigned char* inData, const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
-		: m_Data(inData)
+	UndoStep::UndoStep(std::vector<unsigned char>&& inDelta, const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction)
+		: m_Delta(std::move(inDelta))
 		, m_ComponentData(inComponentUndoData)
 		, m_RestorePostExecution(inRestorePostFunction)
 	{
-		FOUNDATION_ASSERT(inData != nullptr);
+		FOUNDATION_ASSERT(inComponentUndoData != nullptr);
 	}
 
 	UndoStep::~UndoStep()
 	{
-        delete[] m_Data;
 	}
 
-	const unsigned char* UndoStep::GetData() const
+	const std::vector<unsigned char>& UndoStep::GetDelta() const
 	{
-		FOUNDATION_ASSERT(m_Data != nullptr);
-		return m_Data;
+		return m_Delta;
+	}
+
+
+	void UndoStep::SetDelta(std::vector<unsigned char>&& inDelta)
+	{
+		m_Delta = std::move(inDelta);
+		m_Delta.shrink_to_fit();
+	}
+
+
+	unsigned int UndoStep::GetDeltaSize() const
+	{
+		return static_cast<unsigned int>(m_Delta.capacity());
 	}
 
 
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace Editor
 {
@@ -11,19 +12,23 @@ namespace Editor
 	{
 	public:
 		UndoStep() = delete;
-		UndoStep(unsigned char* inData, const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction);
+		UndoStep(std::vector<unsigned char>&& inDelta, const std::shared_ptr<UndoComponentData>& inComponentUndoData, std::function<void(const UndoComponentData&, CursorControl&)> inRestorePostFunction);
 
 		~UndoStep();
 
-		const unsigned char* GetData() const;
+		// The difference to the data of the previous step in the history, as encoded by the undo system. The oldest step has no delta.
+		const std::vector<unsigned char>& GetDelta() const;
+		void SetDelta(std::vector<unsigned char>&& inDelta);
+		unsigned int GetDeltaSize() const;
+
 		void OnRestored(CursorControl& inCursorControl);
 
 		const UndoComponentData& GetComponentData() const;
 
 	private:
-		unsigned char* m_Data;
+		std::vector<unsigned char> m_Delta;
 
 		std::shared_ptr<UndoComponentData> m_ComponentData;
 		std::function<void(const UndoComponentData&, CursorControl&)> m_RestorePostExecution;
 	};
-}
\ No newline at end of file
+}
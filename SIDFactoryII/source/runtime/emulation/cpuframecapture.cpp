@@ -9,24 +9,48 @@ namespace Emulation
 		, m_usCaptureRangeEnd(usCaptureRangeEnd)
 		, m_uiMaxCycles(inMaxCycles)
 		, m_uiCurrentRead(0)
+		, m_uiWriteCount(0)
 		, m_uiCyclesSpend(0)
 		, m_ReachedMaxCycleCount(false)
+		, m_WriteLogOverflowed(false)
+	{
+		FOUNDATION_ASSERT(usCaptureRangeBegin <= usCaptureRangeEnd);
+
+		// The fastest store to an absolute address takes four cycles, and the last instruction may run a few cycles past the window.
+		// The rest of the room is for writes done directly on the capture.
+		const unsigned int max_write_count = (inMaxCycles >> 2) + 0x100;
+		m_aWrites.resize(max_write_count);
+	}
+
+	CPUFrameCapture::~CPUFrameCapture()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------
+
+	void CPUFrameCapture::Begin()
 	{
 		// Reset the CPU
 		m_CPU->Reset();
 
+		// Clear the write log
+		m_uiCurrentRead = 0;
+		m_uiWriteCount = 0;
+		m_uiCyclesSpend = 0;
+		m_ReachedMaxCycleCount = false;
+		m_WriteLogOverflowed = false;
 
-		// Apply this class as write callback
-		m_CPU->SetWriteCallback(this);
+		// Apply this class as write callback, for the capture range only
+		m_CPU->SetWriteCallback(this, m_usCaptureRangeBegin, m_usCaptureRangeEnd);
 	}
 
-	CPUFrameCapture::~CPUFrameCapture()
+
+	void CPUFrameCapture::End()
 	{
 		// Remove callback
 		m_CPU->SetWriteCallback(nullptr);
 	}
 
-	//------------------------------------------------------------------------------------------------------
 
 	void CPUFrameCapture::Capture(unsigned short inStartAddress, unsigned char inAccumulatorValue)
 	{
@@ -38,8 +62,7 @@ namespace Emulation
 		m_CPU->SetSuspended(false);
 
 		// Execute instructions until suspending!
-		while (!m_CPU->IsSuspended() && static_cast<unsigned int>(m_CPU->CycleCounterGetCurrent()) < m_uiMaxCycles)
-			m_CPU->ExecuteInstruction();
+		m_CPU->Execute(static_cast<int>(m_uiMaxCycles));
 
 		// Record the number of cycles spend on the executing code before the CPU was suspended!
 		m_uiCyclesSpend = static_cast<unsigned int>(m_CPU->CycleCounterGetCurrent());
@@ -51,11 +74,19 @@ namespace Emulation
 	void CPUFrameCapture::Write(unsigned short usAddress, unsigned char ucVal, int iCycle)
 	{
 		if (usAddress >= m_usCaptureRangeBegin && usAddress <= m_usCaptureRangeEnd)
-			m_aWrites.push_back(WriteCapture(usAddress, ucVal, iCycle));
+		{
+			// Never grow the log, as this runs on the emulation thread. Writes past the capacity are dropped, and flagged.
+			if (m_uiWriteCount < static_cast<unsigned int>(m_aWrites.size()))
+				m_aWrites[m_uiWriteCount++] = WriteCapture(usAddress, ucVal, iCycle);
+			else
+				m_WriteLogOverflowed = true;
+		}
 	}
 
 	const CPUFrameCapture::WriteCapture& CPUFrameCapture::GetNext()
 	{
+		FOUNDATION_ASSERT(m_uiCurrentRead < m_uiWriteCount);
+
 		m_uiCurrentRead++;
 		return m_aWrites[m_uiCurrentRead - 1];
 	}
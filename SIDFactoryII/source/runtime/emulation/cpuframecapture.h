@@ -33,10 +33,17 @@ namespace Emulation
 			}
 		};
 
-		// Note: Capture range begin and end values are included 
+		// Note: Capture range begin and end values are included. The capture is meant to be kept for reuse, frame after frame, as
+		// the write log is allocated once, here, with room for the most writes the CPU can do in the cycle window.
 		CPUFrameCapture(CPUmos6510* pCPU, unsigned short usCaptureAddressRangeBegin, unsigned short usCaptureAddressRangeEnd, unsigned int inMaxCycles);
 		~CPUFrameCapture();
 
+		// Resets the CPU, clears the write log and attaches the capture to the CPU, for the next frame
+		void Begin();
+
+		// Detaches the capture from the CPU. The captured writes can still be read after this.
+		void End();
+
 		void Capture(unsigned short inStartAddress, unsigned char inAccumulatorValue);
 
 		virtual void Write(unsigned short usAddress, unsigned char ucVal, int iCycle);
@@ -46,18 +53,21 @@ namespace Emulation
 		const WriteCapture& GetNext();
 
 		bool IsMaxCycleCountReached() const { return m_ReachedMaxCycleCount; }
-		bool HasNext() const { return m_aWrites.size() > m_uiCurrentRead; }
-		bool IsEmpty() const { return m_aWrites.size() == 0; }
+		bool IsWriteLogOverflowed() const { return m_WriteLogOverflowed; }
+		bool HasNext() const { return m_uiWriteCount > m_uiCurrentRead; }
+		bool IsEmpty() const { return m_uiWriteCount == 0; }
 
 	private:
 		CPUmos6510* m_CPU;
 
 		bool m_ReachedMaxCycleCount;
+		bool m_WriteLogOverflowed;
 
 		unsigned short m_usCaptureRangeBegin;
 		unsigned short m_usCaptureRangeEnd;
 
 		unsigned int m_uiCurrentRead;
+		unsigned int m_uiWriteCount;
 
 		unsigned int m_uiMaxCycles;
 		unsigned int m_uiCyclesSpend;
@@ -1,4 +1,5 @@
 #include "cpumemory.h"
+#include "cpumemorypublisher.h"
 
 #include "foundation/base/assert.h"
 #include <string.h>
@@ -8,6 +9,8 @@ namespace Emulation
 	CPUMemory::CPUMemory(unsigned int nSize, Foundation::IPlatform* inPlatform)
 		: m_nSize(nSize)
 		, m_IsLocked(false)
+		, m_LockDepth(0)
+		, m_Publisher(nullptr)
 		, m_MemorySnapshot(nullptr)
 	{
 		FOUNDATION_ASSERT(inPlatform != nullptr);
@@ -31,12 +34,25 @@ namespace Emulation
 	void CPUMemory::Lock()
 	{
 		m_Mutex->Lock();
+
+		if (m_LockDepth++ == 0 && m_Publisher != nullptr)
+			m_Publisher->PullEmulatedState(m_Memory);
+
 		m_IsLocked = true;
 	}
 
 	void CPUMemory::Unlock()
 	{
-		m_IsLocked = false;
+		FOUNDATION_ASSERT(m_LockDepth > 0);
+
+		if (--m_LockDepth == 0)
+		{
+			if (m_Publisher != nullptr)
+				m_Publisher->PublishChanges(m_Memory);
+
+			m_IsLocked = false;
+		}
+
 		m_Mutex->Unlock();
 	}
 
@@ -45,6 +61,13 @@ namespace Emulation
 		return m_IsLocked;
 	}
 
+	void CPUMemory::SetPublisher(CPUMemoryPublisher* inPublisher)
+	{
+		Lock();
+		m_Publisher = inPublisher;
+		Unlock();
+	}
+
 	//------------------------------------------------------------------------------------------------------------------------------
 
 	void CPUMemory::Clear()
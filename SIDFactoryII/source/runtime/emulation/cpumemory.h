@@ -9,6 +9,7 @@
 namespace Emulation
 {
 	class IPlatformFactory;
+	class CPUMemoryPublisher;
 
 	class CPUMemory : public IMemoryRandomReadAccess
 	{
@@ -38,6 +39,10 @@ namespace Emulation
 		void Unlock();
 		bool IsLocked() const;
 
+		// With a publisher, the memory pulls in the emulated state when it is locked, and publishes the changes made to it to the emulation
+		// when it is unlocked. The publishing is only done by the outermost lock, if it is locked more than once.
+		void SetPublisher(CPUMemoryPublisher* inPublisher);
+
 		unsigned int GetSize() const { return m_nSize; }
 
 		void Clear();
@@ -54,6 +59,14 @@ namespace Emulation
 		void SetWord(unsigned int inAddress, unsigned short inWordValue);
 		void SetData(unsigned int inAddress, const void* inSourceBuffer, unsigned int inSourceBufferByteCount);
 
+		// Returns the location of an address in the memory, without accessing it. The location must only be read or written while the memory is locked.
+		const unsigned char* GetLocation(unsigned int inAddress) const
+		{
+			FOUNDATION_ASSERT(inAddress < m_nSize);
+
+			return m_Memory + inAddress;
+		}
+
 		unsigned int GetAddress(const void* inMemoryOffsetPointer) const 
 		{
 			unsigned int iAddress = static_cast<unsigned int>(static_cast<const unsigned char*>(inMemoryOffsetPointer) - m_Memory);
@@ -68,6 +81,9 @@ namespace Emulation
 		std::shared_ptr<Foundation::IMutex> m_Mutex;
 
 		bool m_IsLocked;
+		unsigned int m_LockDepth;
+
+		CPUMemoryPublisher* m_Publisher;
 
 		unsigned int m_nSize;
 		unsigned char* m_Memory;
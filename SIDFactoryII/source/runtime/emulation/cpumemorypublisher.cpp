@@ -0,0 +1,227 @@
+#include "cpumemorypublisher.h"
+#include "cpumemory.h"
+
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace Emulation
+{
+	CPUMemoryPublisher::CPUMemoryPublisher(unsigned int inMemorySize)
+		: m_MemorySize(inMemorySize)
+		, m_PublishedMemory(inMemorySize, 0)
+		, m_PublishedEpoch(0)
+		, m_QueuedEpoch(0)
+		, m_SnapshotReadIndex(0)
+		, m_QueueReadPosition(0)
+		, m_QueueWritePosition(0)
+		, m_AppliedEpoch(0)
+		, m_SnapshotWriteIndex(1)
+		, m_SnapshotExchange(2)
+	{
+		for (Snapshot& snapshot : m_Snapshots)
+		{
+			snapshot.m_Epoch = 0;
+			snapshot.m_Memory.resize(inMemorySize, 0);
+		}
+	}
+
+	CPUMemoryPublisher::~CPUMemoryPublisher()
+	{
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+	// Editor side
+	//----------------------------------------------------------------------------------------------------------------
+
+	void CPUMemoryPublisher::PullEmulatedState(unsigned char* ioMemory)
+	{
+		FOUNDATION_ASSERT(ioMemory != nullptr);
+
+		if ((m_SnapshotExchange.load(std::memory_order_relaxed) & SnapshotFresh) == 0)
+			return;
+
+		m_SnapshotReadIndex = m_SnapshotExchange.exchange(m_SnapshotReadIndex, std::memory_order_acq_rel) & SnapshotIndexMask;
+		const Snapshot& snapshot = m_Snapshots[m_SnapshotReadIndex];
+
+		// The emulation is done with the publications in the snapshot, and the rest are applied on top of it
+		while (!m_Publications.empty() && m_Publications.front()->m_Epoch <= snapshot.m_Epoch)
+			m_Publications.pop_front();
+
+		memcpy(ioMemory, snapshot.m_Memory.data(), m_MemorySize);
+
+		for (const auto& publication : m_Publications)
+			ApplyPublication(*publication, ioMemory);
+
+		memcpy(m_PublishedMemory.data(), ioMemory, m_MemorySize);
+	}
+
+
+	void CPUMemoryPublisher::PublishChanges(const unsigned char* inMemory)
+	{
+		FOUNDATION_ASSERT(inMemory != nullptr);
+
+		unsigned char* published_memory = m_PublishedMemory.data();
+
+		// Find the changed bytes a word at a time. Only ranges of bytes next to each other are joined, as the bytes in between two changes
+		// may have been changed by the driver since the editor pulled the emulated memory, and must not be published.
+		std::vector<Range> ranges;
+
+		auto add_changed_byte = [&ranges](unsigned int inAddress)
+		{
+			if (!ranges.empty() && ranges.back().m_Address + ranges.back().m_Size == inAddress)
+				++ranges.back().m_Size;
+			else
+				ranges.push_back({ inAddress, 1 });
+		};
+
+		const unsigned int word_count = m_MemorySize / sizeof(unsigned long long);
+
+		for (unsigned int word = 0; word < word_count; ++word)
+		{
+			const unsigned int word_address = word * sizeof(unsigned long long);
+
+			if (memcmp(inMemory + word_address, published_memory + word_address, sizeof(unsigned long long)) == 0)
+				continue;
+
+			for (unsigned int address = word_address; address < word_address + sizeof(unsigned long long); ++address)
+			{
+				if (inMemory[address] != published_memory[address])
+					add_changed_byte(address);
+			}
+		}
+
+		for (unsigned int address = word_count * sizeof(unsigned long long); address < m_MemorySize; ++address)
+		{
+			if (inMemory[address] != published_memory[address])
+				add_changed_byte(address);
+		}
+
+		if (!ranges.empty())
+		{
+			// The emulation hasn't seen a publication that is held back from the queue, so rather than holding back one more, the changes
+			// are folded into it. Its bytes are in the memory of the editor as they were published, unless they have been changed since.
+			if (!m_Publications.empty() && m_Publications.back()->m_Epoch > m_QueuedEpoch)
+			{
+				ranges = MergeRanges(m_Publications.back()->m_Ranges, ranges);
+				m_Publications.pop_back();
+			}
+
+			std::unique_ptr<Publication> publication = std::make_unique<Publication>();
+
+			publication->m_Epoch = ++m_PublishedEpoch;
+			publication->m_Ranges = std::move(ranges);
+
+			for (const Range& range : publication->m_Ranges)
+			{
+				publication->m_Data.insert(publication->m_Data.end(), inMemory + range.m_Address, inMemory + range.m_Address + range.m_Size);
+				memcpy(published_memory + range.m_Address, inMemory + range.m_Address, range.m_Size);
+			}
+
+			m_Publications.push_back(std::move(publication));
+		}
+
+		QueuePublications();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+	// Emulation side
+	//----------------------------------------------------------------------------------------------------------------
+
+	void CPUMemoryPublisher::ApplyChanges(CPUMemory& ioMemory)
+	{
+		FOUNDATION_ASSERT(ioMemory.IsLocked());
+		FOUNDATION_ASSERT(ioMemory.GetSize() == m_MemorySize);
+
+		const unsigned int write_position = m_QueueWritePosition.load(std::memory_order_acquire);
+		unsigned int read_position = m_QueueReadPosition.load(std::memory_order_relaxed);
+
+		for (; read_position != write_position; ++read_position)
+		{
+			const Publication& publication = *m_Queue[read_position & (QueueCapacity - 1)];
+
+			ApplyPublication(publication, &ioMemory[0]);
+			m_AppliedEpoch = publication.m_Epoch;
+		}
+
+		m_QueueReadPosition.store(read_position, std::memory_order_release);
+	}
+
+
+	void CPUMemoryPublisher::PublishEmulatedState(const CPUMemory& inMemory)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inMemory.GetSize() == m_MemorySize);
+
+		Snapshot& snapshot = m_Snapshots[m_SnapshotWriteIndex];
+
+		snapshot.m_Epoch = m_AppliedEpoch;
+		memcpy(snapshot.m_Memory.data(), inMemory.GetLocation(0), m_MemorySize);
+
+		m_SnapshotWriteIndex = m_SnapshotExchange.exchange(m_SnapshotWriteIndex | SnapshotFresh, std::memory_order_acq_rel) & SnapshotIndexMask;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void CPUMemoryPublisher::ApplyPublication(const Publication& inPublication, unsigned char* ioMemory)
+	{
+		const unsigned char* data = inPublication.m_Data.data();
+
+		for (const Range& range : inPublication.m_Ranges)
+		{
+			memcpy(ioMemory + range.m_Address, data, range.m_Size);
+			data += range.m_Size;
+		}
+	}
+
+
+	std::vector<CPUMemoryPublisher::Range> CPUMemoryPublisher::MergeRanges(const std::vector<Range>& inRanges1, const std::vector<Range>& inRanges2)
+	{
+		std::vector<Range> merged_ranges;
+		merged_ranges.reserve(inRanges1.size() + inRanges2.size());
+
+		auto it1 = inRanges1.begin();
+		auto it2 = inRanges2.begin();
+
+		// Both lists are in order of address, so the ranges are taken from the one that is furthest behind
+		while (it1 != inRanges1.end() || it2 != inRanges2.end())
+		{
+			const bool take_first = it2 == inRanges2.end() || (it1 != inRanges1.end() && it1->m_Address < it2->m_Address);
+			const Range& range = take_first ? *it1++ : *it2++;
+
+			if (!merged_ranges.empty() && merged_ranges.back().m_Address + merged_ranges.back().m_Size >= range.m_Address)
+			{
+				Range& last_range = merged_ranges.back();
+				last_range.m_Size = std::max(last_range.m_Address + last_range.m_Size, range.m_Address + range.m_Size) - last_range.m_Address;
+			}
+			else
+				merged_ranges.push_back(range);
+		}
+
+		return merged_ranges;
+	}
+
+
+	void CPUMemoryPublisher::QueuePublications()
+	{
+		// Publications that didn't fit in the queue are held back, in order, until the emulation has made room for them
+		const unsigned int read_position = m_QueueReadPosition.load(std::memory_order_acquire);
+		unsigned int write_position = m_QueueWritePosition.load(std::memory_order_relaxed);
+
+		for (const auto& publication : m_Publications)
+		{
+			if (publication->m_Epoch <= m_QueuedEpoch)
+				continue;
+			if (write_position - read_position >= QueueCapacity)
+				break;
+
+			m_Queue[write_position & (QueueCapacity - 1)] = publication.get();
+			m_QueuedEpoch = publication->m_Epoch;
+
+			++write_position;
+		}
+
+		m_QueueWritePosition.store(write_position, std::memory_order_release);
+	}
+}
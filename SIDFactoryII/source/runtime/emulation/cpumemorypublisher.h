@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace Emulation
+{
+	class CPUMemory;
+
+	// Keeps the memory the editor works on, and the memory the emulation runs on, in step without either side ever waiting for the other.
+	//
+	// When the editor unlocks its memory, the bytes it has changed are published as a numbered epoch, which the emulation applies to its own
+	// memory at the start of the next frame. At the end of every frame the emulation publishes a copy of its memory, tagged with the last
+	// epoch applied to it. When the editor locks its memory, it takes the newest copy, and applies the epochs that are not in it yet on top.
+	// That way the editor sees the state of the driver, and the emulation never sees a change half done.
+	//
+	// The editor side must only be used from one thread, and the emulation side from another one.
+	class CPUMemoryPublisher final
+	{
+	public:
+		CPUMemoryPublisher(unsigned int inMemorySize);
+		~CPUMemoryPublisher();
+
+		CPUMemoryPublisher(const CPUMemoryPublisher& inOther) = delete;
+
+		// Editor side, called by the memory of the editor as it is locked and unlocked
+		void PullEmulatedState(unsigned char* ioMemory);
+		void PublishChanges(const unsigned char* inMemory);
+
+		// Emulation side, called with the memory of the emulation locked at the start and the end of a frame
+		void ApplyChanges(CPUMemory& ioMemory);
+		void PublishEmulatedState(const CPUMemory& inMemory);
+
+	private:
+		struct Range
+		{
+			unsigned int m_Address;
+			unsigned int m_Size;
+		};
+
+		// The changes of an epoch. It isn't changed once it has been published, and it is only deleted by the editor side, once it has
+		// pulled a copy of the emulated memory that has it applied.
+		struct Publication
+		{
+			unsigned int m_Epoch;
+			std::vector<Range> m_Ranges;
+			std::vector<unsigned char> m_Data;
+		};
+
+		struct Snapshot
+		{
+			unsigned int m_Epoch;
+			std::vector<unsigned char> m_Memory;
+		};
+
+		static void ApplyPublication(const Publication& inPublication, unsigned char* ioMemory);
+		static std::vector<Range> MergeRanges(const std::vector<Range>& inRanges1, const std::vector<Range>& inRanges2);
+		void QueuePublications();
+
+		const unsigned int m_MemorySize;
+
+		// Editor side
+		std::vector<unsigned char> m_PublishedMemory;					// The memory of the editor, as it was last published or pulled
+		std::deque<std::unique_ptr<Publication>> m_Publications;		// Publications not yet in a pulled snapshot, oldest first. Only the last one may be held back from the queue.
+		unsigned int m_PublishedEpoch;
+		unsigned int m_QueuedEpoch;
+		unsigned int m_SnapshotReadIndex;
+
+		// Queue of publications for the emulation side. Read and write positions are free running, and only masked when accessing the queue.
+		// The emulation takes all of them every frame, and the changes published while it is full are folded together, so it is kept small.
+		static const unsigned int QueueCapacity = 0x100;
+		const Publication* m_Queue[QueueCapacity];
+		std::atomic<unsigned int> m_QueueReadPosition;
+		std::atomic<unsigned int> m_QueueWritePosition;
+
+		// Emulation side
+		unsigned int m_AppliedEpoch;
+		unsigned int m_SnapshotWriteIndex;
+
+		// Copies of the emulated memory, handed from the emulation side to the editor side as a triple buffer. Each side owns the snapshot at
+		// its index, and the third one is exchanged between them along with a flag telling if it is newer than the one the editor side has.
+		static const unsigned int SnapshotIndexMask = 0x03;
+		static const unsigned int SnapshotFresh = 0x04;
+
+		Snapshot m_Snapshots[3];
+		std::atomic<unsigned int> m_SnapshotExchange;
+	};
+}
@@ -1,4 +1,5 @@
 #include "cpumos6510.h"
+#include "cpuprofile.h"
 
 namespace Emulation
 {
@@ -289,6 +290,10 @@ namespace Emulation
 	CPUmos6510::State::State()
 		: m_Memory(nullptr)
 		, m_WriteCallback(nullptr)
+		, m_WriteCallbackAddressBegin(0)
+		, m_WriteCallbackAddressEnd(0)
+		, m_WriteCallbackRangeBegin(nullptr)
+		, m_WriteCallbackRangeEnd(nullptr)
 	{
 		Reset();
 	}
@@ -298,6 +303,42 @@ namespace Emulation
 
 	}
 
+
+	void CPUmos6510::State::SetWriteCallback(ICPUWriteCallback* pCallback, unsigned short inRangeBegin, unsigned short inRangeEnd)
+	{
+		FOUNDATION_ASSERT(inRangeBegin <= inRangeEnd);
+
+		m_WriteCallback = pCallback;
+		m_WriteCallbackAddressBegin = inRangeBegin;
+		m_WriteCallbackAddressEnd = inRangeEnd;
+
+		UpdateWriteCallbackRange();
+	}
+
+
+	void CPUmos6510::State::SetMemory(CPUMemory* pMemory)
+	{
+		m_Memory = pMemory;
+
+		UpdateWriteCallbackRange();
+	}
+
+
+	void CPUmos6510::State::UpdateWriteCallbackRange()
+	{
+		// Without a callback, or without memory, the range is left empty. No memory location compares lower than or equal to null.
+		if (m_WriteCallback != nullptr && m_Memory != nullptr)
+		{
+			m_WriteCallbackRangeBegin = m_Memory->GetLocation(m_WriteCallbackAddressBegin);
+			m_WriteCallbackRangeEnd = m_Memory->GetLocation(m_WriteCallbackAddressEnd);
+		}
+		else
+		{
+			m_WriteCallbackRangeBegin = nullptr;
+			m_WriteCallbackRangeEnd = nullptr;
+		}
+	}
+
 	//------------------------------------------------------------------------------------------------------------------------------
 
 	void CPUmos6510::State::Reset()
@@ -326,6 +367,8 @@ namespace Emulation
 	//------------------------------------------------------------------------------------------------------------------------------
 
 	CPUmos6510::CPUmos6510()
+		: m_ExecutionCore(ExecutionCore::Fast)
+		, m_Profile(nullptr)
 	{
 		m_State.Reset();
 	}
@@ -350,7 +393,8 @@ namespace Emulation
 			int added_cycles = 0;
 
 			// Get the opcode to process
-			unsigned char opcode = m_State.GetMemory()[m_State.m_PC];
+			const unsigned short address = m_State.m_PC;
+			unsigned char opcode = m_State.GetMemory()[address];
 
 			// Get the address of the processing if any, according to the opcode addressing mode
 			const void* inAddress = ms_aInstructions[opcode].m_pmAdressingMode(m_State, added_cycles);
@@ -362,6 +406,9 @@ namespace Emulation
 			// Bump the cycle counter
 			m_State.AddCycles((int)ms_aInstructions[opcode].m_ucBaseCycles + added_cycles);
 
+			if (m_Profile != nullptr)
+				m_Profile->AddInstruction(address, static_cast<unsigned int>(ms_aInstructions[opcode].m_ucBaseCycles + added_cycles));
+
 			// Return instruction cycle count
 			return ms_aInstructions[opcode].m_ucBaseCycles;
 		}
@@ -371,6 +418,18 @@ namespace Emulation
 	}
 
 
+	void CPUmos6510::Execute(int inMaxCycle)
+	{
+		if (m_ExecutionCore == ExecutionCore::Fast && m_Profile == nullptr)
+			ExecuteFast(inMaxCycle);
+		else
+		{
+			while (!IsSuspended() && m_State.GetCycle() < inMaxCycle)
+				ExecuteInstruction();
+		}
+	}
+
+
 	const unsigned char CPUmos6510::GetOpcodeByteSize(const unsigned char inOpcode) 
 	{
 		return ms_aInstructions[inOpcode].m_ucSize;
@@ -383,6 +442,12 @@ namespace Emulation
 	}
 
 
+	const char* CPUmos6510::GetOpcodeMnemonic(const unsigned char inOpcode)
+	{
+		return ms_aInstructions[inOpcode].m_acOpcode;
+	}
+
+
 	//------------------------------------------------------------------------------------------------------------------------------
 
 	//---------------------------------------------------------------------------
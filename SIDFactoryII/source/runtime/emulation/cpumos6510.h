@@ -6,6 +6,8 @@
 
 namespace Emulation
 {
+	class CPUProfile;
+
 	class CPUmos6510
 	{
 	public:
@@ -47,10 +49,10 @@ namespace Emulation
 			State();
 			~State();
 
-			void SetWriteCallback(ICPUWriteCallback* pCallback) { m_WriteCallback = pCallback; }
+			void SetWriteCallback(ICPUWriteCallback* pCallback, unsigned short inRangeBegin, unsigned short inRangeEnd);
 
 			void Reset();
-			void SetMemory(CPUMemory* pMemory) { m_Memory = pMemory; }
+			void SetMemory(CPUMemory* pMemory);
 			
 			inline bool IsValid() const { return m_Memory != nullptr; }
 
@@ -91,11 +93,20 @@ namespace Emulation
 			inline int GetCycle() const { return m_Cycle; }
 			inline void AddCycles(int iCycles) { m_Cycle += iCycles; }
 
+			// Write callback
+			inline ICPUWriteCallback* GetWriteCallback() const { return m_WriteCallback; }
+			inline unsigned short GetWriteCallbackAddressBegin() const { return m_WriteCallbackAddressBegin; }
+			inline unsigned short GetWriteCallbackAddressEnd() const { return m_WriteCallbackAddressEnd; }
+
 			// Memory
 			inline CPUMemory& GetMemory() { FOUNDATION_ASSERT(m_Memory); return *m_Memory; }
 			inline void MemoryWrite(const void* pAddress, unsigned char ucVal)
 			{
-				if(m_WriteCallback != nullptr)
+				// Only writes within the range of the callback are passed on, which is tested on the memory location directly,
+				// so that the much more frequent stores outside of the range cost no more than a compare
+				const unsigned char* location = static_cast<const unsigned char*>(pAddress);
+
+				if(location >= m_WriteCallbackRangeBegin && location <= m_WriteCallbackRangeEnd)
 				{
 					const unsigned int address = m_Memory->GetAddress(pAddress);
 					m_WriteCallback->Write(static_cast<unsigned short>(address), ucVal, m_Cycle);
@@ -120,9 +131,17 @@ namespace Emulation
 			// Suspended
 			bool m_IsSuspended;
 
+			void UpdateWriteCallbackRange();
+
 			// Memory
 			CPUMemory* m_Memory;
+
+			// Write callback, and the range of addresses it is called for (both included)
 			ICPUWriteCallback* m_WriteCallback;
+			unsigned short m_WriteCallbackAddressBegin;
+			unsigned short m_WriteCallbackAddressEnd;
+			const unsigned char* m_WriteCallbackRangeBegin;
+			const unsigned char* m_WriteCallbackRangeEnd;
 
 			// Cycle counter
 			int m_Cycle;
@@ -145,6 +164,14 @@ namespace Emulation
 		// CPU Class implementation
 
 	public:
+		// Execution cores. The reference core executes one instruction at a time through the instruction matrix. The fast core
+		// has a handler for each opcode, with the addressing mode built in, and keeps the registers local while it runs. Both
+		// cores give the exact same results, down to the cycle of each write.
+		enum class ExecutionCore : int
+		{
+			Reference,
+			Fast
+		};
 
 		// Addressing modes
 		static void* imp(State& ioState, int& outAddedCycles);	// Implicit
@@ -277,22 +304,80 @@ namespace Emulation
 			return m_State.m_PC;
 		}
 
-		// Write callback
-		inline void SetWriteCallback(ICPUWriteCallback* pCallback)
+		// All registers at once
+		struct Registers
+		{
+			unsigned char m_RegA;
+			unsigned char m_RegX;
+			unsigned char m_RegY;
+			unsigned char m_SP;
+			unsigned char m_Status;
+			unsigned short m_PC;
+		};
+
+		inline Registers GetRegisters() const
+		{
+			return { m_State.m_RegA, m_State.m_RegX, m_State.m_RegY, m_State.m_SP, m_State.m_Status, m_State.m_PC };
+		}
+
+		inline void SetRegisters(const Registers& inRegisters)
 		{
-			m_State.SetWriteCallback(pCallback);
+			m_State.m_RegA = inRegisters.m_RegA;
+			m_State.m_RegX = inRegisters.m_RegX;
+			m_State.m_RegY = inRegisters.m_RegY;
+			m_State.m_SP = inRegisters.m_SP;
+			m_State.m_Status = inRegisters.m_Status;
+			m_State.m_PC = inRegisters.m_PC;
+		}
+
+		// Write callback. The callback is only called for writes to addresses in the range from begin to end (both included).
+		inline void SetWriteCallback(ICPUWriteCallback* pCallback, unsigned short inRangeBegin = 0x0000, unsigned short inRangeEnd = 0xffff)
+		{
+			m_State.SetWriteCallback(pCallback, inRangeBegin, inRangeEnd);
+		}
+
+		// Execution core
+		inline void SetExecutionCore(ExecutionCore inExecutionCore)
+		{
+			m_ExecutionCore = inExecutionCore;
+		}
+
+		inline ExecutionCore GetExecutionCore() const
+		{
+			return m_ExecutionCore;
+		}
+
+		// Profile. While a profile is set, every instruction is added to it, and instructions are executed by the reference core.
+		// Without a profile, the only cost is a check at the start of each execution.
+		inline void SetProfile(CPUProfile* inProfile)
+		{
+			m_Profile = inProfile;
+		}
+
+		inline CPUProfile* GetProfile() const
+		{
+			return m_Profile;
 		}
 
 		// Execution
 		short ExecuteInstruction();
 
+		// Executes instructions, with the selected core, until the CPU is suspended or the cycle counter has reached the max cycle
+		void Execute(int inMaxCycle);
+
 		// Opcode
 		static const unsigned char GetOpcodeByteSize(const unsigned char inOpcode);
 		static const AddressingMode GetOpcodeAddressingMode(const unsigned char inOpcode);
+		static const char* GetOpcodeMnemonic(const unsigned char inOpcode);
 
 	private:
+		void ExecuteFast(int inMaxCycle);
+
 		// CPU State
 		State m_State;
+
+		ExecutionCore m_ExecutionCore;
+		CPUProfile* m_Profile;
 	};
 }
 
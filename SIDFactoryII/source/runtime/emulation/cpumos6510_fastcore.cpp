@@ -0,0 +1,943 @@
+#include "cpumos6510.h"
+
+// The fast execution core of the 6510. It mirrors the instruction matrix and the instruction implementations of the reference
+// core exactly, including their quirks (the page crossing rules of the indexed modes, the carry of CPX and CPY, the flags of INX
+// and INY on wrap around, and the stack layout of JSR and BRK), as the two must give the same results down to the cycle.
+
+namespace Emulation
+{
+	// The handlers live in a namespace of their own, as the names of the instructions are taken by the reference core
+	namespace FastCore
+	{
+		const unsigned char FlagN = 1 << CPUmos6510::SF_N;
+		const unsigned char FlagV = 1 << CPUmos6510::SF_V;
+		const unsigned char FlagD = 1 << CPUmos6510::SF_D;
+		const unsigned char FlagI = 1 << CPUmos6510::SF_I;
+		const unsigned char FlagZ = 1 << CPUmos6510::SF_Z;
+		const unsigned char FlagC = 1 << CPUmos6510::SF_C;
+
+		// The negative and zero flags of every byte value
+		struct FlagTable
+		{
+			unsigned char m_NZ[0x100];
+		};
+
+		constexpr FlagTable CreateFlagTable()
+		{
+			FlagTable table = {};
+
+			for (int i = 0; i < 0x100; ++i)
+				table.m_NZ[i] = static_cast<unsigned char>((i == 0 ? FlagZ : 0) | ((i & 0x80) != 0 ? FlagN : 0));
+
+			return table;
+		}
+
+		constexpr FlagTable ms_FlagTable = CreateFlagTable();
+
+		// The state of the CPU, held locally while the core runs
+		struct Core
+		{
+			unsigned char* m_Memory;
+
+			unsigned char m_RegA;
+			unsigned char m_RegX;
+			unsigned char m_RegY;
+			unsigned char m_SP;
+			unsigned char m_Status;
+			unsigned short m_PC;
+
+			int m_Cycle;
+			bool m_IsSuspended;
+
+			// The range of the write callback. Without a callback, the range is empty.
+			ICPUWriteCallback* m_WriteCallback;
+			unsigned int m_WriteCallbackAddressBegin;
+			unsigned int m_WriteCallbackAddressEnd;
+		};
+
+		//------------------------------------------------------------------------------------------------------------------------------
+		// Helpers
+		//------------------------------------------------------------------------------------------------------------------------------
+
+		inline void SetNZ(Core& ioCore, unsigned char inValue)
+		{
+			ioCore.m_Status = static_cast<unsigned char>((ioCore.m_Status & ~(FlagN | FlagZ)) | ms_FlagTable.m_NZ[inValue]);
+		}
+
+		inline void SetFlag(Core& ioCore, unsigned char inFlag, bool inSet)
+		{
+			ioCore.m_Status = static_cast<unsigned char>(inSet ? (ioCore.m_Status | inFlag) : (ioCore.m_Status & ~inFlag));
+		}
+
+		inline unsigned char ReadByte(const Core& inCore, unsigned short inAddress)
+		{
+			return inCore.m_Memory[inAddress];
+		}
+
+		inline unsigned short ReadWord(const Core& inCore, unsigned short inAddress)
+		{
+			return static_cast<unsigned short>(inCore.m_Memory[inAddress] | (inCore.m_Memory[static_cast<unsigned short>(inAddress + 1)] << 8));
+		}
+
+		inline unsigned short ReadZeroPageWord(const Core& inCore, unsigned char inAddress)
+		{
+			return static_cast<unsigned short>(inCore.m_Memory[inAddress] | (inCore.m_Memory[static_cast<unsigned char>(inAddress + 1)] << 8));
+		}
+
+		// A store, which is passed on to the write callback if it is in range. The reported cycle is the one the instruction started on.
+		inline void WriteByte(Core& ioCore, unsigned short inAddress, unsigned char inValue)
+		{
+			ioCore.m_Memory[inAddress] = inValue;
+
+			if (inAddress >= ioCore.m_WriteCallbackAddressBegin && inAddress <= ioCore.m_WriteCallbackAddressEnd)
+				ioCore.m_WriteCallback->Write(inAddress, inValue, ioCore.m_Cycle);
+		}
+
+		inline void StackPush(Core& ioCore, unsigned char inValue)
+		{
+			ioCore.m_Memory[0x0100 + ioCore.m_SP] = inValue;
+			ioCore.m_SP--;
+		}
+
+		inline unsigned char StackPull(Core& ioCore)
+		{
+			ioCore.m_SP++;
+			return ioCore.m_Memory[0x0100 + ioCore.m_SP];
+		}
+
+		//------------------------------------------------------------------------------------------------------------------------------
+		// Addressing modes, each returning the effective address and advancing the program counter
+		//------------------------------------------------------------------------------------------------------------------------------
+
+		template<CPUmos6510::AddressingMode Mode>
+		unsigned short GetAddress(Core& ioCore, int& ioAddedCycles);
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_IMM>(Core& ioCore, int&)
+		{
+			const unsigned short address = static_cast<unsigned short>(ioCore.m_PC + 1);
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ZP>(Core& ioCore, int&)
+		{
+			const unsigned short address = ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1));
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ZPX>(Core& ioCore, int&)
+		{
+			const unsigned short address = static_cast<unsigned char>(ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)) + ioCore.m_RegX);
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ZPY>(Core& ioCore, int&)
+		{
+			const unsigned short address = static_cast<unsigned char>(ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)) + ioCore.m_RegY);
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_IZX>(Core& ioCore, int&)
+		{
+			const unsigned char zero_page_address = static_cast<unsigned char>(ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)) + ioCore.m_RegX);
+			ioCore.m_PC += 2;
+
+			return ReadZeroPageWord(ioCore, zero_page_address);
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_IZY>(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short base_address = ReadZeroPageWord(ioCore, ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)));
+			const unsigned short address = static_cast<unsigned short>(base_address + ioCore.m_RegY);
+
+			ioAddedCycles = (base_address & 0xff00) != (address & 0xff00) ? 1 : 0;
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ABS>(Core& ioCore, int&)
+		{
+			const unsigned short address = ReadWord(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1));
+			ioCore.m_PC += 3;
+
+			return address;
+		}
+
+		// Note: The reference core compares the page of the indexed address with the page of the instruction itself
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ABX>(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short address = static_cast<unsigned short>(ReadWord(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)) + ioCore.m_RegX);
+
+			ioAddedCycles = (address & 0xff00) != (ioCore.m_PC & 0xff00) ? 1 : 0;
+			ioCore.m_PC += 3;
+
+			return address;
+		}
+
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_ABY>(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short address = static_cast<unsigned short>(ReadWord(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)) + ioCore.m_RegY);
+
+			ioAddedCycles = (address & 0xff00) != (ioCore.m_PC & 0xff00) ? 1 : 0;
+			ioCore.m_PC += 3;
+
+			return address;
+		}
+
+		// The indirect address does not cross pages when it is fetched, just like on the real thing
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_IND>(Core& ioCore, int&)
+		{
+			const unsigned short pointer_low = ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1));
+			const unsigned short pointer_high = static_cast<unsigned short>(ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 2)) << 8);
+			ioCore.m_PC += 3;
+
+			return static_cast<unsigned short>(ReadByte(ioCore, pointer_low | pointer_high) | (ReadByte(ioCore, ((pointer_low + 1) & 0xff) | pointer_high) << 8));
+		}
+
+		// The page crossing cycle is added whether the branch is taken or not
+		template<>
+		inline unsigned short GetAddress<CPUmos6510::am_REL>(Core& ioCore, int& ioAddedCycles)
+		{
+			const signed char offset = static_cast<signed char>(ReadByte(ioCore, static_cast<unsigned short>(ioCore.m_PC + 1)));
+			const unsigned short address = static_cast<unsigned short>(ioCore.m_PC + 2 + offset);
+
+			ioAddedCycles = (address & 0xff00) != (ioCore.m_PC & 0xff00) ? 1 : 0;
+			ioCore.m_PC += 2;
+
+			return address;
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline unsigned char GetOperand(Core& ioCore, int& ioAddedCycles)
+		{
+			return ReadByte(ioCore, GetAddress<Mode>(ioCore, ioAddedCycles));
+		}
+
+		//------------------------------------------------------------------------------------------------------------------------------
+		// Logical and arithmetic commands
+		//------------------------------------------------------------------------------------------------------------------------------
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void ORA(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegA |= GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void AND(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegA &= GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void EOR(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegA ^= GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		// Decimal mode is not emulated, and the overflow flag is set when bit 7 of the accumulator changes
+		template<CPUmos6510::AddressingMode Mode>
+		inline void ADC(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned int result = ioCore.m_RegA + GetOperand<Mode>(ioCore, ioAddedCycles) + ((ioCore.m_Status & FlagC) != 0 ? 1 : 0);
+
+			SetFlag(ioCore, FlagC, (result & 0xff00) != 0);
+			SetFlag(ioCore, FlagV, ((ioCore.m_RegA ^ result) & 0x80) != 0);
+
+			ioCore.m_RegA = static_cast<unsigned char>(result);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void SBC(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short result = static_cast<unsigned short>(ioCore.m_RegA - (GetOperand<Mode>(ioCore, ioAddedCycles) + ((ioCore.m_Status & FlagC) != 0 ? 0 : 1)));
+
+			SetFlag(ioCore, FlagC, (result & 0xff00) == 0);
+			SetFlag(ioCore, FlagV, ((ioCore.m_RegA ^ result) & 0x80) != 0);
+
+			ioCore.m_RegA = static_cast<unsigned char>(result);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void CMP(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned char result = static_cast<unsigned char>(ioCore.m_RegA - GetOperand<Mode>(ioCore, ioAddedCycles));
+
+			SetNZ(ioCore, result);
+			SetFlag(ioCore, FlagC, (result & 0x80) == 0);
+		}
+
+		// Note: The reference core sets the carry of CPX and CPY along with the negative flag
+		template<CPUmos6510::AddressingMode Mode>
+		inline void CPX(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned char result = static_cast<unsigned char>(ioCore.m_RegX - GetOperand<Mode>(ioCore, ioAddedCycles));
+
+			SetNZ(ioCore, result);
+			SetFlag(ioCore, FlagC, (result & 0x80) != 0);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void CPY(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned char result = static_cast<unsigned char>(ioCore.m_RegY - GetOperand<Mode>(ioCore, ioAddedCycles));
+
+			SetNZ(ioCore, result);
+			SetFlag(ioCore, FlagC, (result & 0x80) != 0);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void DEC(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short address = GetAddress<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = static_cast<unsigned char>(ReadByte(ioCore, address) - 1);
+
+			SetNZ(ioCore, value);
+			WriteByte(ioCore, address, value);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void INC(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short address = GetAddress<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = static_cast<unsigned char>(ReadByte(ioCore, address) + 1);
+
+			SetNZ(ioCore, value);
+			WriteByte(ioCore, address, value);
+		}
+
+		inline void DEX(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegX--;
+			SetNZ(ioCore, ioCore.m_RegX);
+		}
+
+		inline void DEY(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegY--;
+			SetNZ(ioCore, ioCore.m_RegY);
+		}
+
+		// Note: The reference core clears both the zero and the negative flag, when the register wraps around to zero
+		inline void INX(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegX++;
+			SetNZ(ioCore, ioCore.m_RegX);
+
+			if (ioCore.m_RegX == 0)
+				ioCore.m_Status &= ~FlagZ;
+		}
+
+		inline void INY(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegY++;
+			SetNZ(ioCore, ioCore.m_RegY);
+
+			if (ioCore.m_RegY == 0)
+				ioCore.m_Status &= ~FlagZ;
+		}
+
+		// The shifts and rotations work on the accumulator in implied mode. They do not call the write callback on memory.
+		template<CPUmos6510::AddressingMode Mode>
+		inline unsigned char& GetReadModifyWriteOperand(Core& ioCore, int& ioAddedCycles)
+		{
+			return ioCore.m_Memory[GetAddress<Mode>(ioCore, ioAddedCycles)];
+		}
+
+		template<>
+		inline unsigned char& GetReadModifyWriteOperand<CPUmos6510::am_IMP>(Core& ioCore, int&)
+		{
+			ioCore.m_PC += 1;
+			return ioCore.m_RegA;
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void ASL(Core& ioCore, int& ioAddedCycles)
+		{
+			unsigned char& operand = GetReadModifyWriteOperand<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = operand;
+
+			SetFlag(ioCore, FlagC, (value & 0x80) != 0);
+			operand = static_cast<unsigned char>(value << 1);
+			SetNZ(ioCore, operand);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void ROL(Core& ioCore, int& ioAddedCycles)
+		{
+			unsigned char& operand = GetReadModifyWriteOperand<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = operand;
+			const unsigned char insert_bit = (ioCore.m_Status & FlagC) != 0 ? 0x01 : 0x00;
+
+			SetFlag(ioCore, FlagC, (value & 0x80) != 0);
+			operand = static_cast<unsigned char>((value << 1) | insert_bit);
+			SetNZ(ioCore, operand);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void LSR(Core& ioCore, int& ioAddedCycles)
+		{
+			unsigned char& operand = GetReadModifyWriteOperand<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = operand;
+
+			SetFlag(ioCore, FlagC, (value & 0x01) != 0);
+			operand = static_cast<unsigned char>(value >> 1);
+			SetNZ(ioCore, operand);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void ROR(Core& ioCore, int& ioAddedCycles)
+		{
+			unsigned char& operand = GetReadModifyWriteOperand<Mode>(ioCore, ioAddedCycles);
+			const unsigned char value = operand;
+			const unsigned char insert_bit = (ioCore.m_Status & FlagC) != 0 ? 0x80 : 0x00;
+
+			SetFlag(ioCore, FlagC, (value & 0x01) != 0);
+			operand = static_cast<unsigned char>((value >> 1) | insert_bit);
+			SetNZ(ioCore, operand);
+		}
+
+		//------------------------------------------------------------------------------------------------------------------------------
+		// Move commands
+		//------------------------------------------------------------------------------------------------------------------------------
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void LDA(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegA = GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void LDX(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegX = GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegX);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void LDY(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_RegY = GetOperand<Mode>(ioCore, ioAddedCycles);
+			SetNZ(ioCore, ioCore.m_RegY);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void STA(Core& ioCore, int& ioAddedCycles)
+		{
+			WriteByte(ioCore, GetAddress<Mode>(ioCore, ioAddedCycles), ioCore.m_RegA);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void STX(Core& ioCore, int& ioAddedCycles)
+		{
+			WriteByte(ioCore, GetAddress<Mode>(ioCore, ioAddedCycles), ioCore.m_RegX);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void STY(Core& ioCore, int& ioAddedCycles)
+		{
+			WriteByte(ioCore, GetAddress<Mode>(ioCore, ioAddedCycles), ioCore.m_RegY);
+		}
+
+		inline void TAX(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegX = ioCore.m_RegA;
+			SetNZ(ioCore, ioCore.m_RegX);
+		}
+
+		inline void TXA(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegA = ioCore.m_RegX;
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		inline void TAY(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegY = ioCore.m_RegA;
+			SetNZ(ioCore, ioCore.m_RegY);
+		}
+
+		inline void TYA(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegA = ioCore.m_RegY;
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		inline void TSX(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegX = ioCore.m_SP;
+			SetNZ(ioCore, ioCore.m_RegX);
+		}
+
+		inline void TXS(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_SP = ioCore.m_RegX;
+		}
+
+		inline void PLA(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_RegA = StackPull(ioCore);
+			SetNZ(ioCore, ioCore.m_RegA);
+		}
+
+		inline void PHA(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			StackPush(ioCore, ioCore.m_RegA);
+		}
+
+		inline void PLP(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_Status = StackPull(ioCore);
+		}
+
+		inline void PHP(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			StackPush(ioCore, ioCore.m_Status);
+		}
+
+		//------------------------------------------------------------------------------------------------------------------------------
+		// Jump / Flag commands
+		//------------------------------------------------------------------------------------------------------------------------------
+
+		template<unsigned char Flag, bool IsSet>
+		inline void Branch(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned short address = GetAddress<CPUmos6510::am_REL>(ioCore, ioAddedCycles);
+
+			if (((ioCore.m_Status & Flag) != 0) == IsSet)
+			{
+				ioCore.m_PC = address;
+				ioAddedCycles++;
+			}
+		}
+
+		// Note: Both BRK and JSR push the return address with the low byte first. BRK suspends the CPU.
+		inline void BRK(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+
+			StackPush(ioCore, static_cast<unsigned char>(ioCore.m_PC & 0xff));
+			StackPush(ioCore, static_cast<unsigned char>(ioCore.m_PC >> 8));
+			StackPush(ioCore, ioCore.m_Status);
+
+			ioCore.m_PC = 0xfffe;
+			ioCore.m_IsSuspended = true;
+		}
+
+		inline void RTI(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+			ioCore.m_Status = StackPull(ioCore);
+
+			const unsigned short high = StackPull(ioCore);
+			const unsigned short low = StackPull(ioCore);
+
+			ioCore.m_PC = static_cast<unsigned short>((high << 8) | low);
+		}
+
+		inline void JSR(Core& ioCore)
+		{
+			int added_cycles = 0;
+			const unsigned short address = GetAddress<CPUmos6510::am_ABS>(ioCore, added_cycles);
+
+			StackPush(ioCore, static_cast<unsigned char>(ioCore.m_PC & 0xff));
+			StackPush(ioCore, static_cast<unsigned char>(ioCore.m_PC >> 8));
+
+			ioCore.m_PC = address;
+		}
+
+		// A return with an empty stack suspends the CPU, which is how a call from the frame capture ends
+		inline void RTS(Core& ioCore)
+		{
+			ioCore.m_PC += 1;
+
+			if (ioCore.m_SP != 0x00)
+			{
+				const unsigned short high = StackPull(ioCore);
+				const unsigned short low = StackPull(ioCore);
+
+				ioCore.m_PC = static_cast<unsigned short>((high << 8) | low);
+			}
+			else
+				ioCore.m_IsSuspended = true;
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void JMP(Core& ioCore, int& ioAddedCycles)
+		{
+			ioCore.m_PC = GetAddress<Mode>(ioCore, ioAddedCycles);
+		}
+
+		template<CPUmos6510::AddressingMode Mode>
+		inline void BIT(Core& ioCore, int& ioAddedCycles)
+		{
+			const unsigned char value = GetOperand<Mode>(ioCore, ioAddedCycles);
+
+			SetFlag(ioCore, FlagN, (value & 0x80) != 0);
+			SetFlag(ioCore, FlagV, (value & 0x40) != 0);
+			SetFlag(ioCore, FlagZ, (ioCore.m_RegA & value) == 0);
+		}
+
+		inline void CLC(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status &= ~FlagC; }
+		inline void SEC(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status |= FlagC; }
+		inline void CLD(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status &= ~FlagD; }
+		inline void SED(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status |= FlagD; }
+		inline void CLI(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status &= ~FlagI; }
+		inline void SEI(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status |= FlagI; }
+		inline void CLV(Core& ioCore) { ioCore.m_PC += 1; ioCore.m_Status &= ~FlagV; }
+		inline void NOP(Core& ioCore) { ioCore.m_PC += 1; }
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	// Execution
+	//------------------------------------------------------------------------------------------------------------------------------
+
+	void CPUmos6510::ExecuteFast(int inMaxCycle)
+	{
+		if (!m_State.IsValid() || m_State.IsSuspended())
+			return;
+
+		CPUMemory& memory = m_State.GetMemory();
+
+		// The handlers address the memory directly with 16 bit addresses, which requires the full 64K
+		if (memory.GetSize() < 0x10000)
+		{
+			while (!IsSuspended() && m_State.GetCycle() < inMaxCycle)
+				ExecuteInstruction();
+
+			return;
+		}
+
+		ICPUWriteCallback* write_callback = m_State.GetWriteCallback();
+
+		FastCore::Core core;
+
+		core.m_Memory = &memory[0];
+		core.m_RegA = m_State.m_RegA;
+		core.m_RegX = m_State.m_RegX;
+		core.m_RegY = m_State.m_RegY;
+		core.m_SP = m_State.m_SP;
+		core.m_Status = m_State.m_Status;
+		core.m_PC = m_State.m_PC;
+		core.m_Cycle = m_State.GetCycle();
+		core.m_IsSuspended = false;
+		core.m_WriteCallback = write_callback;
+		core.m_WriteCallbackAddressBegin = write_callback != nullptr ? m_State.GetWriteCallbackAddressBegin() : 0x10000;
+		core.m_WriteCallbackAddressEnd = write_callback != nullptr ? m_State.GetWriteCallbackAddressEnd() : 0;
+
+		while (!core.m_IsSuspended && core.m_Cycle < inMaxCycle)
+		{
+			const unsigned char opcode = core.m_Memory[core.m_PC];
+			int added_cycles = 0;
+
+			switch (opcode)
+			{
+				case 0x00: FastCore::BRK(core); break;
+				case 0x01: FastCore::ORA<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0x02: FastCore::BRK(core); break;
+				case 0x03: FastCore::BRK(core); break;
+				case 0x04: FastCore::BRK(core); break;
+				case 0x05: FastCore::ORA<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x06: FastCore::ASL<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x07: FastCore::BRK(core); break;
+				case 0x08: FastCore::PHP(core); break;
+				case 0x09: FastCore::ORA<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0x0a: FastCore::ASL<CPUmos6510::am_IMP>(core, added_cycles); break;
+				case 0x0b: FastCore::BRK(core); break;
+				case 0x0c: FastCore::BRK(core); break;
+				case 0x0d: FastCore::ORA<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x0e: FastCore::ASL<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x0f: FastCore::BRK(core); break;
+				case 0x10: FastCore::Branch<FastCore::FlagN, false>(core, added_cycles); break;
+				case 0x11: FastCore::ORA<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0x12: FastCore::BRK(core); break;
+				case 0x13: FastCore::BRK(core); break;
+				case 0x14: FastCore::BRK(core); break;
+				case 0x15: FastCore::ORA<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x16: FastCore::ASL<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x17: FastCore::BRK(core); break;
+				case 0x18: FastCore::CLC(core); break;
+				case 0x19: FastCore::ORA<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0x1a: FastCore::BRK(core); break;
+				case 0x1b: FastCore::BRK(core); break;
+				case 0x1c: FastCore::BRK(core); break;
+				case 0x1d: FastCore::ORA<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x1e: FastCore::ASL<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x1f: FastCore::BRK(core); break;
+				case 0x20: FastCore::JSR(core); break;
+				case 0x21: FastCore::AND<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0x22: FastCore::BRK(core); break;
+				case 0x23: FastCore::BRK(core); break;
+				case 0x24: FastCore::BIT<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x25: FastCore::AND<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x26: FastCore::ROL<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x27: FastCore::BRK(core); break;
+				case 0x28: FastCore::PLP(core); break;
+				case 0x29: FastCore::AND<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0x2a: FastCore::ROL<CPUmos6510::am_IMP>(core, added_cycles); break;
+				case 0x2b: FastCore::BRK(core); break;
+				case 0x2c: FastCore::BIT<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x2d: FastCore::AND<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x2e: FastCore::ROL<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x2f: FastCore::BRK(core); break;
+				case 0x30: FastCore::Branch<FastCore::FlagN, true>(core, added_cycles); break;
+				case 0x31: FastCore::AND<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0x32: FastCore::BRK(core); break;
+				case 0x33: FastCore::BRK(core); break;
+				case 0x34: FastCore::BRK(core); break;
+				case 0x35: FastCore::AND<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x36: FastCore::ROL<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x37: FastCore::BRK(core); break;
+				case 0x38: FastCore::SEC(core); break;
+				case 0x39: FastCore::AND<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0x3a: FastCore::BRK(core); break;
+				case 0x3b: FastCore::BRK(core); break;
+				case 0x3c: FastCore::BRK(core); break;
+				case 0x3d: FastCore::AND<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x3e: FastCore::ROL<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x3f: FastCore::BRK(core); break;
+				case 0x40: FastCore::RTI(core); break;
+				case 0x41: FastCore::EOR<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0x42: FastCore::BRK(core); break;
+				case 0x43: FastCore::BRK(core); break;
+				case 0x44: FastCore::BRK(core); break;
+				case 0x45: FastCore::EOR<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x46: FastCore::LSR<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x47: FastCore::BRK(core); break;
+				case 0x48: FastCore::PHA(core); break;
+				case 0x49: FastCore::EOR<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0x4a: FastCore::LSR<CPUmos6510::am_IMP>(core, added_cycles); break;
+				case 0x4b: FastCore::BRK(core); break;
+				case 0x4c: FastCore::JMP<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x4d: FastCore::EOR<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x4e: FastCore::LSR<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x4f: FastCore::BRK(core); break;
+				case 0x50: FastCore::Branch<FastCore::FlagV, false>(core, added_cycles); break;
+				case 0x51: FastCore::EOR<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0x52: FastCore::BRK(core); break;
+				case 0x53: FastCore::BRK(core); break;
+				case 0x54: FastCore::BRK(core); break;
+				case 0x55: FastCore::EOR<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x56: FastCore::LSR<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x57: FastCore::BRK(core); break;
+				case 0x58: FastCore::CLI(core); break;
+				case 0x59: FastCore::EOR<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0x5a: FastCore::BRK(core); break;
+				case 0x5b: FastCore::BRK(core); break;
+				case 0x5c: FastCore::BRK(core); break;
+				case 0x5d: FastCore::EOR<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x5e: FastCore::LSR<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x5f: FastCore::BRK(core); break;
+				case 0x60: FastCore::RTS(core); break;
+				case 0x61: FastCore::ADC<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0x62: FastCore::BRK(core); break;
+				case 0x63: FastCore::BRK(core); break;
+				case 0x64: FastCore::BRK(core); break;
+				case 0x65: FastCore::ADC<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x66: FastCore::ROR<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x67: FastCore::BRK(core); break;
+				case 0x68: FastCore::PLA(core); break;
+				case 0x69: FastCore::ADC<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0x6a: FastCore::ROR<CPUmos6510::am_IMP>(core, added_cycles); break;
+				case 0x6b: FastCore::BRK(core); break;
+				case 0x6c: FastCore::JMP<CPUmos6510::am_IND>(core, added_cycles); break;
+				case 0x6d: FastCore::ADC<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x6e: FastCore::ROR<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x6f: FastCore::BRK(core); break;
+				case 0x70: FastCore::Branch<FastCore::FlagV, true>(core, added_cycles); break;
+				case 0x71: FastCore::ADC<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0x72: FastCore::BRK(core); break;
+				case 0x73: FastCore::BRK(core); break;
+				case 0x74: FastCore::BRK(core); break;
+				case 0x75: FastCore::ADC<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x76: FastCore::ROR<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x77: FastCore::BRK(core); break;
+				case 0x78: FastCore::SEI(core); break;
+				case 0x79: FastCore::ADC<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0x7a: FastCore::BRK(core); break;
+				case 0x7b: FastCore::BRK(core); break;
+				case 0x7c: FastCore::BRK(core); break;
+				case 0x7d: FastCore::ADC<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x7e: FastCore::ROR<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x7f: FastCore::BRK(core); break;
+				case 0x80: FastCore::BRK(core); break;
+				case 0x81: FastCore::STA<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0x82: FastCore::BRK(core); break;
+				case 0x83: FastCore::BRK(core); break;
+				case 0x84: FastCore::STY<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x85: FastCore::STA<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x86: FastCore::STX<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0x87: FastCore::BRK(core); break;
+				case 0x88: FastCore::DEY(core); break;
+				case 0x89: FastCore::BRK(core); break;
+				case 0x8a: FastCore::TXA(core); break;
+				case 0x8b: FastCore::BRK(core); break;
+				case 0x8c: FastCore::STY<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x8d: FastCore::STA<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x8e: FastCore::STX<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0x8f: FastCore::BRK(core); break;
+				case 0x90: FastCore::Branch<FastCore::FlagC, false>(core, added_cycles); break;
+				case 0x91: FastCore::STA<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0x92: FastCore::BRK(core); break;
+				case 0x93: FastCore::BRK(core); break;
+				case 0x94: FastCore::STY<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x95: FastCore::STA<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0x96: FastCore::STX<CPUmos6510::am_ZPY>(core, added_cycles); break;
+				case 0x97: FastCore::BRK(core); break;
+				case 0x98: FastCore::TYA(core); break;
+				case 0x99: FastCore::STA<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0x9a: FastCore::TXS(core); break;
+				case 0x9b: FastCore::BRK(core); break;
+				case 0x9c: FastCore::BRK(core); break;
+				case 0x9d: FastCore::STA<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0x9e: FastCore::BRK(core); break;
+				case 0x9f: FastCore::BRK(core); break;
+				case 0xa0: FastCore::LDY<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xa1: FastCore::LDA<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0xa2: FastCore::LDX<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xa3: FastCore::BRK(core); break;
+				case 0xa4: FastCore::LDY<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xa5: FastCore::LDA<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xa6: FastCore::LDX<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xa7: FastCore::BRK(core); break;
+				case 0xa8: FastCore::TAY(core); break;
+				case 0xa9: FastCore::LDA<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xaa: FastCore::TAX(core); break;
+				case 0xab: FastCore::BRK(core); break;
+				case 0xac: FastCore::LDY<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xad: FastCore::LDA<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xae: FastCore::LDX<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xaf: FastCore::BRK(core); break;
+				case 0xb0: FastCore::Branch<FastCore::FlagC, true>(core, added_cycles); break;
+				case 0xb1: FastCore::LDA<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0xb2: FastCore::BRK(core); break;
+				case 0xb3: FastCore::BRK(core); break;
+				case 0xb4: FastCore::LDY<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xb5: FastCore::LDA<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xb6: FastCore::LDX<CPUmos6510::am_ZPY>(core, added_cycles); break;
+				case 0xb7: FastCore::BRK(core); break;
+				case 0xb8: FastCore::CLV(core); break;
+				case 0xb9: FastCore::LDA<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0xba: FastCore::TSX(core); break;
+				case 0xbb: FastCore::BRK(core); break;
+				case 0xbc: FastCore::LDY<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xbd: FastCore::LDA<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xbe: FastCore::LDX<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0xbf: FastCore::BRK(core); break;
+				case 0xc0: FastCore::CPY<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xc1: FastCore::CMP<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0xc2: FastCore::BRK(core); break;
+				case 0xc3: FastCore::BRK(core); break;
+				case 0xc4: FastCore::CPY<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xc5: FastCore::CMP<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xc6: FastCore::DEC<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xc7: FastCore::BRK(core); break;
+				case 0xc8: FastCore::INY(core); break;
+				case 0xc9: FastCore::CMP<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xca: FastCore::DEX(core); break;
+				case 0xcb: FastCore::BRK(core); break;
+				case 0xcc: FastCore::CPY<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xcd: FastCore::CMP<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xce: FastCore::DEC<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xcf: FastCore::BRK(core); break;
+				case 0xd0: FastCore::Branch<FastCore::FlagZ, false>(core, added_cycles); break;
+				case 0xd1: FastCore::CMP<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0xd2: FastCore::BRK(core); break;
+				case 0xd3: FastCore::BRK(core); break;
+				case 0xd4: FastCore::BRK(core); break;
+				case 0xd5: FastCore::CMP<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xd6: FastCore::DEC<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xd7: FastCore::BRK(core); break;
+				case 0xd8: FastCore::CLD(core); break;
+				case 0xd9: FastCore::CMP<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0xda: FastCore::BRK(core); break;
+				case 0xdb: FastCore::BRK(core); break;
+				case 0xdc: FastCore::BRK(core); break;
+				case 0xdd: FastCore::CMP<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xde: FastCore::DEC<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xdf: FastCore::BRK(core); break;
+				case 0xe0: FastCore::CPX<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xe1: FastCore::SBC<CPUmos6510::am_IZX>(core, added_cycles); break;
+				case 0xe2: FastCore::BRK(core); break;
+				case 0xe3: FastCore::BRK(core); break;
+				case 0xe4: FastCore::CPX<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xe5: FastCore::SBC<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xe6: FastCore::INC<CPUmos6510::am_ZP>(core, added_cycles); break;
+				case 0xe7: FastCore::BRK(core); break;
+				case 0xe8: FastCore::INX(core); break;
+				case 0xe9: FastCore::SBC<CPUmos6510::am_IMM>(core, added_cycles); break;
+				case 0xea: FastCore::NOP(core); break;
+				case 0xeb: FastCore::BRK(core); break;
+				case 0xec: FastCore::CPX<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xed: FastCore::SBC<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xee: FastCore::INC<CPUmos6510::am_ABS>(core, added_cycles); break;
+				case 0xef: FastCore::BRK(core); break;
+				case 0xf0: FastCore::Branch<FastCore::FlagZ, true>(core, added_cycles); break;
+				case 0xf1: FastCore::SBC<CPUmos6510::am_IZY>(core, added_cycles); break;
+				case 0xf2: FastCore::BRK(core); break;
+				case 0xf3: FastCore::BRK(core); break;
+				case 0xf4: FastCore::BRK(core); break;
+				case 0xf5: FastCore::SBC<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xf6: FastCore::INC<CPUmos6510::am_ZPX>(core, added_cycles); break;
+				case 0xf7: FastCore::BRK(core); break;
+				case 0xf8: FastCore::SED(core); break;
+				case 0xf9: FastCore::SBC<CPUmos6510::am_ABY>(core, added_cycles); break;
+				case 0xfa: FastCore::BRK(core); break;
+				case 0xfb: FastCore::BRK(core); break;
+				case 0xfc: FastCore::BRK(core); break;
+				case 0xfd: FastCore::SBC<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xfe: FastCore::INC<CPUmos6510::am_ABX>(core, added_cycles); break;
+				case 0xff: FastCore::BRK(core); break;
+			}
+
+			core.m_Cycle += static_cast<int>(ms_aInstructions[opcode].m_ucBaseCycles) + added_cycles;
+		}
+
+		m_State.m_RegA = core.m_RegA;
+		m_State.m_RegX = core.m_RegX;
+		m_State.m_RegY = core.m_RegY;
+		m_State.m_SP = core.m_SP;
+		m_State.m_Status = core.m_Status;
+		m_State.m_PC = core.m_PC;
+		m_State.SetCycle(core.m_Cycle);
+		m_State.SetSuspended(core.m_IsSuspended);
+	}
+}
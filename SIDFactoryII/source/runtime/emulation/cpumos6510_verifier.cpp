@@ -0,0 +1,294 @@
+#include "runtime/emulation/cpumos6510_verifier.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpuframecapture.h"
+
+#include "foundation/base/assert.h"
+
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <string.h>
+
+namespace Emulation
+{
+	namespace
+	{
+		const unsigned int MemorySize = 0x10000;
+
+		// Records every write passed on by the CPU
+		class WriteRecorder final : public ICPUWriteCallback
+		{
+		public:
+			struct Entry
+			{
+				unsigned short m_Address;
+				unsigned char m_Value;
+				int m_Cycle;
+
+				bool operator==(const Entry& inOther) const
+				{
+					return m_Address == inOther.m_Address && m_Value == inOther.m_Value && m_Cycle == inOther.m_Cycle;
+				}
+			};
+
+			void Write(unsigned short usAddress, unsigned char ucVal, int iCycle) override
+			{
+				m_Entries.push_back({ usAddress, ucVal, iCycle });
+			}
+
+			std::vector<Entry> m_Entries;
+		};
+
+		std::string ToHex(unsigned int inValue, int inDigits)
+		{
+			std::stringstream stream;
+			stream << "$" << std::hex << std::setw(inDigits) << std::setfill('0') << inValue;
+
+			return stream.str();
+		}
+
+		std::string RegistersToString(const CPUmos6510::Registers& inRegisters, int inCycle)
+		{
+			return "PC=" + ToHex(inRegisters.m_PC, 4)
+				+ " A=" + ToHex(inRegisters.m_RegA, 2)
+				+ " X=" + ToHex(inRegisters.m_RegX, 2)
+				+ " Y=" + ToHex(inRegisters.m_RegY, 2)
+				+ " SP=" + ToHex(inRegisters.m_SP, 2)
+				+ " P=" + ToHex(inRegisters.m_Status, 2)
+				+ " cycle=" + std::to_string(inCycle);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+
+	CPUmos6510Verifier::CPUmos6510Verifier(Foundation::IPlatform* inPlatform)
+		: m_Platform(inPlatform)
+		, m_InstructionCount(0)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+
+		m_ReferenceMemory = std::make_unique<CPUMemory>(MemorySize, inPlatform);
+		m_FastMemory = std::make_unique<CPUMemory>(MemorySize, inPlatform);
+
+		m_ReferenceCPU.SetExecutionCore(CPUmos6510::ExecutionCore::Reference);
+		m_FastCPU.SetExecutionCore(CPUmos6510::ExecutionCore::Fast);
+	}
+
+	CPUmos6510Verifier::~CPUmos6510Verifier()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+
+	bool CPUmos6510Verifier::VerifyInstructions(unsigned int inIterationsPerOpcode, unsigned int inSeed)
+	{
+		std::mt19937 random(inSeed);
+		auto random_byte = [&random]() { return static_cast<unsigned char>(random() & 0xff); };
+
+		WriteRecorder reference_writes;
+		WriteRecorder fast_writes;
+
+		m_ReferenceMemory->Lock();
+		m_FastMemory->Lock();
+
+		bool success = true;
+
+		for (unsigned int opcode = 0; opcode < 0x100 && success; ++opcode)
+		{
+			// Start every opcode from random memory, and let the results of each iteration carry over to the next
+			for (unsigned int address = 0; address < MemorySize; ++address)
+				(*m_ReferenceMemory)[address] = random_byte();
+
+			memcpy(&(*m_FastMemory)[0], &(*m_ReferenceMemory)[0], MemorySize);
+
+			for (unsigned int i = 0; i < inIterationsPerOpcode && success; ++i)
+			{
+				// Keep the instruction away from the end of the memory, which the reference core does not wrap around
+				const unsigned short pc = static_cast<unsigned short>(0x0200 + random() % 0xfd00);
+				const unsigned char operand_low = random_byte();
+				const unsigned char operand_high = random_byte();
+
+				CPUmos6510::Registers registers = { random_byte(), random_byte(), random_byte(), random_byte(), random_byte(), pc };
+
+				// Cover the suspending return on an empty stack as well
+				if ((i & 7) == 0)
+					registers.m_SP = 0;
+
+				// Alternate between a write callback for the SID range only, and one for the entire memory
+				const unsigned short range_begin = (i & 1) == 0 ? 0xd400 : 0x0000;
+				const unsigned short range_end = (i & 1) == 0 ? 0xd418 : 0xffff;
+				const int cycle = static_cast<int>(random() % 100);
+
+				for (CPUMemory* memory : { m_ReferenceMemory.get(), m_FastMemory.get() })
+				{
+					(*memory)[pc] = static_cast<unsigned char>(opcode);
+					(*memory)[pc + 1] = operand_low;
+					(*memory)[pc + 2] = operand_high;
+				}
+
+				reference_writes.m_Entries.clear();
+				fast_writes.m_Entries.clear();
+
+				for (CPUmos6510* cpu : { &m_ReferenceCPU, &m_FastCPU })
+				{
+					cpu->Reset();
+					cpu->SetMemory(cpu == &m_ReferenceCPU ? m_ReferenceMemory.get() : m_FastMemory.get());
+					cpu->SetWriteCallback(cpu == &m_ReferenceCPU ? &reference_writes : &fast_writes, range_begin, range_end);
+					cpu->SetRegisters(registers);
+					cpu->CycleCounterSetCurrent(cycle);
+					cpu->SetSuspended(false);
+
+					// Stop after a single instruction
+					cpu->Execute(cycle + 1);
+					cpu->SetWriteCallback(nullptr);
+				}
+
+				++m_InstructionCount;
+
+				std::string context = "Opcode " + ToHex(opcode, 2) + " from " + RegistersToString(registers, cycle);
+
+				if (reference_writes.m_Entries != fast_writes.m_Entries)
+				{
+					m_ErrorMessage = context + ": the writes differ";
+					success = false;
+				}
+				else
+					success = Compare(context);
+			}
+		}
+
+		m_FastMemory->Unlock();
+		m_ReferenceMemory->Unlock();
+
+		return success;
+	}
+
+
+	bool CPUmos6510Verifier::VerifyDriver(const CPUMemory& inMemory, unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned int inFrameCount, unsigned int inCyclesPerFrame)
+	{
+		FOUNDATION_ASSERT(inMemory.IsLocked());
+		FOUNDATION_ASSERT(inMemory.GetSize() == MemorySize);
+
+		m_ReferenceMemory->Lock();
+		m_FastMemory->Lock();
+
+		inMemory.GetData(0, &(*m_ReferenceMemory)[0], MemorySize);
+		inMemory.GetData(0, &(*m_FastMemory)[0], MemorySize);
+
+		m_ReferenceCPU.SetMemory(m_ReferenceMemory.get());
+		m_FastCPU.SetMemory(m_FastMemory.get());
+
+		CPUFrameCapture reference_capture(&m_ReferenceCPU, 0xd400, 0xd418, inCyclesPerFrame);
+		CPUFrameCapture fast_capture(&m_FastCPU, 0xd400, 0xd418, inCyclesPerFrame);
+
+		bool success = true;
+
+		for (unsigned int frame = 0; frame < inFrameCount && success; ++frame)
+		{
+			for (CPUFrameCapture* capture : { &reference_capture, &fast_capture })
+			{
+				capture->Begin();
+
+				if (frame == 0)
+					capture->Capture(inInitAddress, 0);
+
+				if (!capture->IsMaxCycleCountReached())
+					capture->Capture(inUpdateAddress, 0);
+
+				capture->End();
+			}
+
+			const std::string context = "Frame " + std::to_string(frame);
+
+			while (success && (reference_capture.HasNext() || fast_capture.HasNext()))
+			{
+				if (reference_capture.HasNext() != fast_capture.HasNext())
+				{
+					m_ErrorMessage = context + ": the number of writes differs";
+					success = false;
+					break;
+				}
+
+				const CPUFrameCapture::WriteCapture& reference_write = reference_capture.GetNext();
+				const CPUFrameCapture::WriteCapture& fast_write = fast_capture.GetNext();
+
+				if (reference_write.m_usReg != fast_write.m_usReg || reference_write.m_ucVal != fast_write.m_ucVal || reference_write.m_iCycle != fast_write.m_iCycle)
+				{
+					m_ErrorMessage = context + ": write of " + ToHex(reference_write.m_ucVal, 2) + " to " + ToHex(reference_write.m_usReg, 4) + " on cycle " + std::to_string(reference_write.m_iCycle)
+						+ " differs from write of " + ToHex(fast_write.m_ucVal, 2) + " to " + ToHex(fast_write.m_usReg, 4) + " on cycle " + std::to_string(fast_write.m_iCycle);
+					success = false;
+				}
+			}
+
+			if (success)
+				success = Compare(context);
+
+			// Stop at a cycle window overrun, as the editor would
+			if (reference_capture.IsMaxCycleCountReached())
+				break;
+		}
+
+		m_FastMemory->Unlock();
+		m_ReferenceMemory->Unlock();
+
+		return success;
+	}
+
+
+	unsigned long long CPUmos6510Verifier::GetInstructionCount() const
+	{
+		return m_InstructionCount;
+	}
+
+
+	const std::string& CPUmos6510Verifier::GetErrorMessage() const
+	{
+		return m_ErrorMessage;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------------------
+
+	bool CPUmos6510Verifier::Compare(const std::string& inContext)
+	{
+		const CPUmos6510::Registers reference_registers = m_ReferenceCPU.GetRegisters();
+		const CPUmos6510::Registers fast_registers = m_FastCPU.GetRegisters();
+
+		const int reference_cycle = m_ReferenceCPU.CycleCounterGetCurrent();
+		const int fast_cycle = m_FastCPU.CycleCounterGetCurrent();
+
+		const bool registers_match = reference_registers.m_RegA == fast_registers.m_RegA
+			&& reference_registers.m_RegX == fast_registers.m_RegX
+			&& reference_registers.m_RegY == fast_registers.m_RegY
+			&& reference_registers.m_SP == fast_registers.m_SP
+			&& reference_registers.m_Status == fast_registers.m_Status
+			&& reference_registers.m_PC == fast_registers.m_PC;
+
+		if (!registers_match || reference_cycle != fast_cycle || m_ReferenceCPU.IsSuspended() != m_FastCPU.IsSuspended())
+		{
+			m_ErrorMessage = inContext + ": reference " + RegistersToString(reference_registers, reference_cycle)
+				+ (m_ReferenceCPU.IsSuspended() ? " (suspended)" : "")
+				+ ", fast " + RegistersToString(fast_registers, fast_cycle)
+				+ (m_FastCPU.IsSuspended() ? " (suspended)" : "");
+
+			return false;
+		}
+
+		const unsigned char* reference_memory = &(*m_ReferenceMemory)[0];
+		const unsigned char* fast_memory = &(*m_FastMemory)[0];
+
+		if (memcmp(reference_memory, fast_memory, MemorySize) != 0)
+		{
+			unsigned int address = 0;
+
+			while (reference_memory[address] == fast_memory[address])
+				++address;
+
+			m_ErrorMessage = inContext + ": memory differs at " + ToHex(address, 4) + ", reference " + ToHex(reference_memory[address], 2) + ", fast " + ToHex(fast_memory[address], 2);
+
+			return false;
+		}
+
+		return true;
+	}
+}
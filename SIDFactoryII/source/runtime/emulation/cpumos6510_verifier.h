@@ -0,0 +1,48 @@
+#pragma once
+
+#include "runtime/emulation/cpumos6510.h"
+
+#include <memory>
+#include <string>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUMemory;
+
+	// Runs the reference and the fast execution core of the 6510 side by side, each with its own memory, and compares the registers,
+	// the cycle counter, the memory and the writes passed to the write callback. Any difference is reported as an error.
+	class CPUmos6510Verifier final
+	{
+	public:
+		CPUmos6510Verifier(Foundation::IPlatform* inPlatform);
+		~CPUmos6510Verifier();
+
+		// Executes every opcode from a number of random states, one instruction at a time
+		bool VerifyInstructions(unsigned int inIterationsPerOpcode, unsigned int inSeed);
+
+		// Runs a driver frame by frame, the same way the frame capture does, starting from a copy of the given memory. The memory must be locked.
+		bool VerifyDriver(const CPUMemory& inMemory, unsigned short inInitAddress, unsigned short inUpdateAddress, unsigned int inFrameCount, unsigned int inCyclesPerFrame);
+
+		unsigned long long GetInstructionCount() const;
+		const std::string& GetErrorMessage() const;
+
+	private:
+		bool Compare(const std::string& inContext);
+
+		Foundation::IPlatform* m_Platform;
+
+		std::unique_ptr<CPUMemory> m_ReferenceMemory;
+		std::unique_ptr<CPUMemory> m_FastMemory;
+
+		CPUmos6510 m_ReferenceCPU;
+		CPUmos6510 m_FastCPU;
+
+		unsigned long long m_InstructionCount;
+		std::string m_ErrorMessage;
+	};
+}
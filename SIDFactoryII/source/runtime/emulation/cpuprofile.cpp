@@ -0,0 +1,123 @@
+#include "runtime/emulation/cpuprofile.h"
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+
+namespace Emulation
+{
+	CPUProfile::CPUProfile()
+		: m_Cycles(RoutineCount * AddressCount, 0)
+		, m_ExecutionCounts(RoutineCount * AddressCount, 0)
+		, m_RoutineCallCounts(RoutineCount, 0)
+		, m_RoutineOffset(static_cast<unsigned int>(Routine::Update) * AddressCount)
+	{
+	}
+
+	CPUProfile::~CPUProfile()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void CPUProfile::Clear()
+	{
+		std::fill(m_Cycles.begin(), m_Cycles.end(), 0);
+		std::fill(m_ExecutionCounts.begin(), m_ExecutionCounts.end(), 0);
+		std::fill(m_RoutineCallCounts.begin(), m_RoutineCallCounts.end(), 0);
+	}
+
+
+	void CPUProfile::BeginRoutine(Routine inRoutine)
+	{
+		FOUNDATION_ASSERT(inRoutine != Routine::Count);
+
+		const unsigned int routine_index = static_cast<unsigned int>(inRoutine);
+
+		m_RoutineOffset = routine_index * AddressCount;
+		++m_RoutineCallCounts[routine_index];
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	unsigned long long CPUProfile::GetCycles(unsigned short inAddress) const
+	{
+		unsigned long long cycles = 0;
+
+		for (unsigned int i = 0; i < RoutineCount; ++i)
+			cycles += m_Cycles[i * AddressCount + inAddress];
+
+		return cycles;
+	}
+
+
+	unsigned long long CPUProfile::GetCycles(Routine inRoutine, unsigned short inAddress) const
+	{
+		return m_Cycles[static_cast<unsigned int>(inRoutine) * AddressCount + inAddress];
+	}
+
+
+	unsigned long long CPUProfile::GetExecutionCount(unsigned short inAddress) const
+	{
+		unsigned long long execution_count = 0;
+
+		for (unsigned int i = 0; i < RoutineCount; ++i)
+			execution_count += m_ExecutionCounts[i * AddressCount + inAddress];
+
+		return execution_count;
+	}
+
+
+	unsigned long long CPUProfile::GetTotalCycles() const
+	{
+		unsigned long long cycles = 0;
+
+		for (unsigned int i = 0; i < RoutineCount; ++i)
+			cycles += GetRoutineCycles(static_cast<Routine>(i));
+
+		return cycles;
+	}
+
+
+	unsigned long long CPUProfile::GetRoutineCycles(Routine inRoutine) const
+	{
+		const auto begin = m_Cycles.begin() + static_cast<unsigned int>(inRoutine) * AddressCount;
+		unsigned long long cycles = 0;
+
+		for (auto it = begin; it != begin + AddressCount; ++it)
+			cycles += *it;
+
+		return cycles;
+	}
+
+
+	unsigned long long CPUProfile::GetRoutineCallCount(Routine inRoutine) const
+	{
+		return m_RoutineCallCounts[static_cast<unsigned int>(inRoutine)];
+	}
+
+
+	std::vector<CPUProfile::AddressEntry> CPUProfile::GetHotAddresses(unsigned int inMaxCount) const
+	{
+		std::vector<AddressEntry> entries;
+
+		for (unsigned int address = 0; address < AddressCount; ++address)
+		{
+			const unsigned short address_word = static_cast<unsigned short>(address);
+			const unsigned long long execution_count = GetExecutionCount(address_word);
+
+			if (execution_count > 0)
+				entries.push_back({ address_word, GetCycles(address_word), execution_count });
+		}
+
+		const size_t count = std::min<size_t>(inMaxCount, entries.size());
+
+		std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), [](const AddressEntry& inEntryA, const AddressEntry& inEntryB)
+		{
+			return inEntryA.m_Cycles > inEntryB.m_Cycles || (inEntryA.m_Cycles == inEntryB.m_Cycles && inEntryA.m_Address < inEntryB.m_Address);
+		});
+
+		entries.resize(count);
+
+		return entries;
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+namespace Emulation
+{
+	// The cycles spent and the number of times executed, for every address an instruction is executed from. The figures are kept
+	// separately for each routine of the driver, so the cost of the init, the update and the fast forward updates can be told apart.
+	class CPUProfile final
+	{
+	public:
+		enum class Routine : int
+		{
+			Init,
+			Stop,
+			Update,
+			FastForwardUpdate,
+
+			Count
+		};
+
+		static const unsigned int AddressCount = 0x10000;
+		static const unsigned int RoutineCount = static_cast<unsigned int>(Routine::Count);
+
+		struct AddressEntry
+		{
+			unsigned short m_Address;
+			unsigned long long m_Cycles;
+			unsigned long long m_ExecutionCount;
+		};
+
+		CPUProfile();
+		~CPUProfile();
+
+		void Clear();
+
+		// Makes the following instructions count towards the routine, and counts a call to it
+		void BeginRoutine(Routine inRoutine);
+
+		inline void AddInstruction(unsigned short inAddress, unsigned int inCycles)
+		{
+			const unsigned int index = m_RoutineOffset + inAddress;
+
+			m_Cycles[index] += inCycles;
+			++m_ExecutionCounts[index];
+		}
+
+		unsigned long long GetCycles(unsigned short inAddress) const;
+		unsigned long long GetCycles(Routine inRoutine, unsigned short inAddress) const;
+		unsigned long long GetExecutionCount(unsigned short inAddress) const;
+
+		unsigned long long GetTotalCycles() const;
+		unsigned long long GetRoutineCycles(Routine inRoutine) const;
+		unsigned long long GetRoutineCallCount(Routine inRoutine) const;
+
+		// The addresses taking the most cycles over all routines, the most first
+		std::vector<AddressEntry> GetHotAddresses(unsigned int inMaxCount) const;
+
+	private:
+		// The tables hold the address count entries of each routine, one routine after the other
+		std::vector<unsigned long long> m_Cycles;
+		std::vector<unsigned int> m_ExecutionCounts;
+		std::vector<unsigned long long> m_RoutineCallCounts;
+
+		unsigned int m_RoutineOffset;
+	};
+}
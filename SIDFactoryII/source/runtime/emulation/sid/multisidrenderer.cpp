@@ -0,0 +1,423 @@
+#include "multisidrenderer.h"
+#include "sidproxy.h"
+
+#include "runtime/emulation/cpuframecapture.h"
+#include "runtime/environmentdefines.h"
+
+#include "foundation/platform/iplatform.h"
+#include "foundation/platform/isemaphore.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/base/assert.h"
+
+#include <algorithm>
+#include <string>
+
+namespace Emulation
+{
+	static bool IsValidChipBaseAddress(int inAddress)
+	{
+		if ((inAddress & (SID_CHIP_ADDRESS_RANGE - 1)) != 0)
+			return false;
+
+		return (inAddress >= 0xd400 && inAddress < 0xd800) || (inAddress >= 0xde00 && inAddress < 0xe000);
+	}
+
+	static bool IsSameConfiguration(const SIDConfiguration& inConfigurationA, const SIDConfiguration& inConfigurationB)
+	{
+		return inConfigurationA.m_eModel == inConfigurationB.m_eModel
+			&& inConfigurationA.m_eEnvironment == inConfigurationB.m_eEnvironment
+			&& inConfigurationA.m_eSampleMethod == inConfigurationB.m_eSampleMethod
+			&& inConfigurationA.m_nSampleFrequency == inConfigurationB.m_nSampleFrequency;
+	}
+
+	static unsigned int GetMaxSamplesPerFrame(int inSampleFrequency)
+	{
+		// A frame yields the most samples at the slower PAL clock. The resampler does not deliver the exact same number of samples every frame, so leave plenty of room.
+		return 2 * (static_cast<unsigned int>((static_cast<unsigned long long>(EMULATION_CYCLES_PER_FRAME_PAL) * inSampleFrequency) / EMULATION_CYCLES_PER_SECOND_PAL) + 1);
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	MultiSIDRenderer::Chip::Chip(const SIDChipSetup& inSetup)
+		: m_Setup(inSetup)
+		, m_SIDProxy(nullptr)
+		, m_SampleCount(0)
+		, m_LeftGain(1.0f)
+		, m_RightGain(1.0f)
+	{
+	}
+
+
+	MultiSIDRenderer::Chip::~Chip()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	MultiSIDRenderer::MultiSIDRenderer(Foundation::IPlatform* inPlatform, SIDProxy* inPrimarySIDProxy, const std::vector<SIDChipSetup>& inChipSetups)
+		: m_Platform(inPlatform)
+		, m_CyclesPerFrame(0)
+		, m_IsStopping(false)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+		FOUNDATION_ASSERT(inPrimarySIDProxy != nullptr);
+		FOUNDATION_ASSERT(!inChipSetups.empty() && inChipSetups.size() <= SID_MAX_CHIP_COUNT);
+
+		const unsigned int max_samples_per_frame = GetMaxSamplesPerFrame(inPrimarySIDProxy->GetSampleFrequency());
+
+		m_CaptureRangeBegin = 0xffff;
+		m_CaptureRangeEnd = 0x0000;
+
+		for (const SIDChipSetup& setup : inChipSetups)
+		{
+			FOUNDATION_ASSERT(IsValidChipBaseAddress(setup.m_usBaseAddress));
+
+			std::unique_ptr<Chip> chip = std::make_unique<Chip>(setup);
+
+			if (m_Chips.empty())
+				chip->m_SIDProxy = inPrimarySIDProxy;
+			else
+			{
+				chip->m_OwnedSIDProxy = std::make_unique<SIDProxy>(inPrimarySIDProxy->GetConfiguration());
+				chip->m_SIDProxy = chip->m_OwnedSIDProxy.get();
+			}
+
+			// Room for as many writes as the write log of the frame capture holds, so that no memory is allocated when rendering
+			chip->m_Writes.reserve((EMULATION_CYCLES_PER_FRAME_PAL >> 2) + 0x100);
+			chip->m_Samples.resize(max_samples_per_frame);
+
+			m_CaptureRangeBegin = std::min<unsigned short>(m_CaptureRangeBegin, setup.m_usBaseAddress);
+			m_CaptureRangeEnd = std::max<unsigned short>(m_CaptureRangeEnd, setup.m_usBaseAddress + SID_REGISTER_COUNT - 1);
+
+			m_Chips.push_back(std::move(chip));
+		}
+
+		if (m_Chips.size() > 1)
+		{
+			// Pan each chip by turning down the opposite side, so a chip in the center plays at full level on both sides. Then scale the
+			// sides so that the chips on a side add up to no more than full level.
+			float left_gain_sum = 0.0f;
+			float right_gain_sum = 0.0f;
+
+			for (auto& chip : m_Chips)
+			{
+				const float position = static_cast<float>(std::max(0, std::min(100, chip->m_Setup.m_nPanning)) - 50) / 50.0f;
+
+				chip->m_LeftGain = std::min(1.0f, 1.0f - position);
+				chip->m_RightGain = std::min(1.0f, 1.0f + position);
+
+				left_gain_sum += chip->m_LeftGain;
+				right_gain_sum += chip->m_RightGain;
+			}
+
+			for (auto& chip : m_Chips)
+			{
+				chip->m_LeftGain /= std::max(1.0f, left_gain_sum);
+				chip->m_RightGain /= std::max(1.0f, right_gain_sum);
+			}
+		}
+	}
+
+
+	MultiSIDRenderer::~MultiSIDRenderer()
+	{
+		m_IsStopping = true;
+
+		for (auto& chip : m_Chips)
+		{
+			if (chip->m_Thread != nullptr)
+			{
+				chip->m_Start->Post();
+				chip->m_Thread->Join();
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	std::vector<SIDChipSetup> MultiSIDRenderer::CreateChipSetups(const std::vector<int>& inBaseAddresses, const std::vector<int>& inPannings)
+	{
+		std::vector<SIDChipSetup> chip_setups;
+		std::vector<size_t> address_indices;
+
+		for (size_t i = 0; i < inBaseAddresses.size() && chip_setups.size() < SID_MAX_CHIP_COUNT; ++i)
+		{
+			const int address = inBaseAddresses[i];
+			const bool is_taken = std::any_of(chip_setups.begin(), chip_setups.end(), [address](const SIDChipSetup& inSetup) { return inSetup.m_usBaseAddress == address; });
+
+			if (IsValidChipBaseAddress(address) && !is_taken)
+			{
+				chip_setups.push_back(SIDChipSetup(static_cast<unsigned short>(address), 50));
+				address_indices.push_back(i);
+			}
+			else if (i == 0)
+			{
+				chip_setups.push_back(SIDChipSetup(0xd400, 50));
+				address_indices.push_back(i);
+			}
+		}
+
+		if (chip_setups.empty())
+			chip_setups.push_back(SIDChipSetup(0xd400, 50));
+
+		const bool has_pannings = inPannings.size() == inBaseAddresses.size();
+		const size_t chip_count = chip_setups.size();
+
+		for (size_t i = 0; i < chip_count; ++i)
+		{
+			if (has_pannings)
+				chip_setups[i].m_nPanning = std::max(0, std::min(100, inPannings[address_indices[i]]));
+			else if (chip_count > 1)
+				chip_setups[i].m_nPanning = static_cast<int>((100 * i) / (chip_count - 1));
+		}
+
+		return chip_setups;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	unsigned int MultiSIDRenderer::GetChipCount() const
+	{
+		return static_cast<unsigned int>(m_Chips.size());
+	}
+
+
+	unsigned int MultiSIDRenderer::GetChannelCount() const
+	{
+		return m_Chips.size() > 1 ? 2 : 1;
+	}
+
+
+	const SIDChipSetup& MultiSIDRenderer::GetChipSetup(unsigned int inIndex) const
+	{
+		FOUNDATION_ASSERT(inIndex < m_Chips.size());
+		return m_Chips[inIndex]->m_Setup;
+	}
+
+
+	unsigned short MultiSIDRenderer::GetCaptureRangeBegin() const
+	{
+		return m_CaptureRangeBegin;
+	}
+
+
+	unsigned short MultiSIDRenderer::GetCaptureRangeEnd() const
+	{
+		return m_CaptureRangeEnd;
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void MultiSIDRenderer::Reset()
+	{
+		ApplyPrimaryConfiguration();
+
+		for (auto& chip : m_Chips)
+			chip->m_SIDProxy->Reset();
+	}
+
+
+	unsigned int MultiSIDRenderer::RenderFrame(CPUFrameCapture& inFrameCapture, int inCyclesPerFrame, short* outSampleBuffer, unsigned int inSampleBufferSize)
+	{
+		ApplyPrimaryConfiguration();
+		DistributeWrites(inFrameCapture);
+
+		Chip& primary_chip = *m_Chips[0];
+
+		if (m_Chips.size() == 1)
+			return ClockChip(primary_chip, inCyclesPerFrame, outSampleBuffer, inSampleBufferSize);
+
+		if (m_Chips[1]->m_Thread == nullptr)
+			StartWorkers();
+
+		// Clock the other chips on their workers, while clocking the first one here
+		m_CyclesPerFrame = inCyclesPerFrame;
+
+		for (size_t i = 1; i < m_Chips.size(); ++i)
+			m_Chips[i]->m_Start->Post();
+
+		primary_chip.m_SampleCount = ClockChip(primary_chip, inCyclesPerFrame, &primary_chip.m_Samples[0], static_cast<unsigned int>(primary_chip.m_Samples.size()));
+
+		for (size_t i = 1; i < m_Chips.size(); ++i)
+			m_Chips[i]->m_Done->Wait();
+
+		// The chips are clocked at the same rate from the same reset, so they all yield the same number of samples
+		unsigned int sample_count = primary_chip.m_SampleCount;
+
+		for (const auto& chip : m_Chips)
+		{
+			FOUNDATION_ASSERT(chip->m_SampleCount == primary_chip.m_SampleCount);
+			sample_count = std::min(sample_count, chip->m_SampleCount);
+		}
+
+		sample_count = std::min(sample_count, inSampleBufferSize >> 1);
+
+		// Mix to interleaved stereo
+		for (unsigned int i = 0; i < sample_count; ++i)
+		{
+			float left = 0.0f;
+			float right = 0.0f;
+
+			for (const auto& chip : m_Chips)
+			{
+				const float sample = static_cast<float>(chip->m_Samples[i]);
+
+				left += sample * chip->m_LeftGain;
+				right += sample * chip->m_RightGain;
+			}
+
+			outSampleBuffer[i << 1] = static_cast<short>(std::max(-32768.0f, std::min(32767.0f, left)));
+			outSampleBuffer[(i << 1) + 1] = static_cast<short>(std::max(-32768.0f, std::min(32767.0f, right)));
+		}
+
+		return sample_count << 1;
+	}
+
+
+	void MultiSIDRenderer::ClockFrameNoOutput(CPUFrameCapture& inFrameCapture, int inCyclesPerFrame)
+	{
+		ApplyPrimaryConfiguration();
+		DistributeWrites(inFrameCapture);
+
+		for (auto& chip : m_Chips)
+		{
+			SIDProxy& sid_proxy = *chip->m_SIDProxy;
+			int cycle = 0;
+
+			for (const Write& write : chip->m_Writes)
+			{
+				FOUNDATION_ASSERT(cycle <= write.m_Cycle);
+
+				sid_proxy.ClockNoOutput(write.m_Cycle - cycle);
+				sid_proxy.Write(write.m_Register, write.m_Value);
+				cycle = write.m_Cycle;
+			}
+
+			if (cycle < inCyclesPerFrame)
+				sid_proxy.ClockNoOutput(inCyclesPerFrame - cycle);
+		}
+	}
+
+
+	void MultiSIDRenderer::GetState(std::vector<reSIDfp::SIDState>& outStates) const
+	{
+		outStates.resize(m_Chips.size());
+
+		for (size_t i = 0; i < m_Chips.size(); ++i)
+			m_Chips[i]->m_SIDProxy->GetState(outStates[i]);
+	}
+
+
+	void MultiSIDRenderer::SetState(const std::vector<reSIDfp::SIDState>& inStates)
+	{
+		FOUNDATION_ASSERT(inStates.size() == m_Chips.size());
+
+		ApplyPrimaryConfiguration();
+
+		for (size_t i = 0; i < m_Chips.size(); ++i)
+			m_Chips[i]->m_SIDProxy->SetState(inStates[i]);
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void MultiSIDRenderer::ApplyPrimaryConfiguration()
+	{
+		const SIDConfiguration& configuration = m_Chips[0]->m_SIDProxy->GetConfiguration();
+
+		for (auto& chip : m_Chips)
+		{
+			if (chip->m_OwnedSIDProxy != nullptr && !IsSameConfiguration(chip->m_SIDProxy->GetConfiguration(), configuration))
+				chip->m_SIDProxy->SetConfiguration(configuration);
+
+			const unsigned int max_samples_per_frame = GetMaxSamplesPerFrame(configuration.m_nSampleFrequency);
+
+			if (chip->m_Samples.size() < max_samples_per_frame)
+				chip->m_Samples.resize(max_samples_per_frame);
+		}
+	}
+
+
+	void MultiSIDRenderer::DistributeWrites(CPUFrameCapture& inFrameCapture)
+	{
+		// Hand out the writes to the chips they were done to
+		for (auto& chip : m_Chips)
+			chip->m_Writes.clear();
+
+		while (inFrameCapture.HasNext())
+		{
+			const CPUFrameCapture::WriteCapture& capture = inFrameCapture.GetNext();
+
+			for (auto& chip : m_Chips)
+			{
+				const unsigned short chip_register = capture.m_usReg - chip->m_Setup.m_usBaseAddress;
+
+				if (chip_register < SID_REGISTER_COUNT)
+				{
+					chip->m_Writes.push_back({ capture.m_iCycle, static_cast<unsigned char>(chip_register), capture.m_ucVal });
+					break;
+				}
+			}
+		}
+	}
+
+
+	void MultiSIDRenderer::StartWorkers()
+	{
+		// Start a worker for each chip but the first, which is clocked on the thread calling RenderFrame
+		for (size_t i = 1; i < m_Chips.size(); ++i)
+		{
+			Chip* chip = m_Chips[i].get();
+
+			chip->m_Start = m_Platform->CreateSemaphore(0);
+			chip->m_Done = m_Platform->CreateSemaphore(0);
+			chip->m_Thread = m_Platform->CreateThread("SF2 SID " + std::to_string(i + 1), [this, chip]() { WorkerThread(*chip); });
+		}
+	}
+
+
+	void MultiSIDRenderer::WorkerThread(Chip& inChip)
+	{
+		while (true)
+		{
+			inChip.m_Start->Wait();
+
+			if (m_IsStopping)
+				break;
+
+			inChip.m_SampleCount = ClockChip(inChip, m_CyclesPerFrame, &inChip.m_Samples[0], static_cast<unsigned int>(inChip.m_Samples.size()));
+			inChip.m_Done->Post();
+		}
+	}
+
+
+	unsigned int MultiSIDRenderer::ClockChip(Chip& inChip, int inCyclesPerFrame, short* outSampleBuffer, unsigned int inSampleBufferSize)
+	{
+		SIDProxy& sid_proxy = *inChip.m_SIDProxy;
+
+		unsigned int sample_count = 0;
+		int cycle = 0;
+
+		auto clock_sid = [&](int inDeltaCycles)
+		{
+			const int samples_written = sid_proxy.Clock(inDeltaCycles, outSampleBuffer + sample_count, static_cast<int>(inSampleBufferSize - sample_count));
+			FOUNDATION_ASSERT(samples_written >= 0);
+
+			sample_count += static_cast<unsigned int>(samples_written);
+			FOUNDATION_ASSERT(sample_count <= inSampleBufferSize);
+		};
+
+		for (const Write& write : inChip.m_Writes)
+		{
+			FOUNDATION_ASSERT(cycle <= write.m_Cycle);
+
+			clock_sid(write.m_Cycle - cycle);
+			sid_proxy.Write(write.m_Register, write.m_Value);
+			cycle = write.m_Cycle;
+		}
+
+		if (cycle < inCyclesPerFrame)
+			clock_sid(inCyclesPerFrame - cycle);
+
+		return sample_count;
+	}
+}
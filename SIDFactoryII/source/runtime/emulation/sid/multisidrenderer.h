@@ -0,0 +1,107 @@
+#pragma once
+
+#include "sidproxydefines.h"
+#include "libraries/residfp/SIDState.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Foundation
+{
+	class IPlatform;
+	class ISemaphore;
+	class IThread;
+}
+
+namespace Emulation
+{
+	class SIDProxy;
+	class CPUFrameCapture;
+
+	// Plays the SID writes captured in a frame on one or more SID chips, each at its own base address. The first chip is the SID proxy
+	// handed in, which the rest of the editor configures, resets and restores the state of. The other chips are created here, and follow
+	// the configuration of the first one. A single chip gives its mono output as it is. With more chips, every chip but the first is
+	// clocked through the frame on a worker thread of its own, while the first one is clocked by the caller, and the outputs of all of
+	// them are panned into interleaved stereo. The workers are started the first time a frame is rendered.
+	class MultiSIDRenderer final
+	{
+	public:
+		MultiSIDRenderer(Foundation::IPlatform* inPlatform, SIDProxy* inPrimarySIDProxy, const std::vector<SIDChipSetup>& inChipSetups);
+		~MultiSIDRenderer();
+
+		MultiSIDRenderer(const MultiSIDRenderer& inOther) = delete;
+
+		// Makes chip setups from lists of base addresses and pannings, as given in the config file. Addresses outside of the I/O areas a SID
+		// can be placed in, or used twice, are left out. The first chip is always there, at $d400 if its address is not valid. If there isn't a
+		// panning for each address, the chips are spread out evenly from left to right.
+		static std::vector<SIDChipSetup> CreateChipSetups(const std::vector<int>& inBaseAddresses, const std::vector<int>& inPannings);
+
+		unsigned int GetChipCount() const;
+		unsigned int GetChannelCount() const;
+		const SIDChipSetup& GetChipSetup(unsigned int inIndex) const;
+
+		// The address range a frame capture must cover, for the writes to all the chips to be captured. Both ends are included.
+		unsigned short GetCaptureRangeBegin() const;
+		unsigned short GetCaptureRangeEnd() const;
+
+		void Reset();
+
+		// Clocks the chips through a frame, doing the captured writes at the cycles they were done at. Writes outside of the chips are
+		// ignored. Returns the number of samples written, counting each channel of stereo output.
+		unsigned int RenderFrame(CPUFrameCapture& inFrameCapture, int inCyclesPerFrame, short* outSampleBuffer, unsigned int inSampleBufferSize);
+
+		// Clocks the chips through a frame one after the other, doing the captured writes, without producing any output
+		void ClockFrameNoOutput(CPUFrameCapture& inFrameCapture, int inCyclesPerFrame);
+
+		// The states of the chips, in the order of their setups
+		void GetState(std::vector<reSIDfp::SIDState>& outStates) const;
+		void SetState(const std::vector<reSIDfp::SIDState>& inStates);
+
+	private:
+		struct Write
+		{
+			int m_Cycle;
+			unsigned char m_Register;
+			unsigned char m_Value;
+		};
+
+		struct Chip
+		{
+			SIDChipSetup m_Setup;
+			SIDProxy* m_SIDProxy;
+			std::unique_ptr<SIDProxy> m_OwnedSIDProxy;
+
+			std::vector<Write> m_Writes;
+			std::vector<short> m_Samples;
+			unsigned int m_SampleCount;
+
+			float m_LeftGain;
+			float m_RightGain;
+
+			std::shared_ptr<Foundation::IThread> m_Thread;
+			std::shared_ptr<Foundation::ISemaphore> m_Start;
+			std::shared_ptr<Foundation::ISemaphore> m_Done;
+
+			Chip(const SIDChipSetup& inSetup);
+			~Chip();
+		};
+
+		void ApplyPrimaryConfiguration();
+		void DistributeWrites(CPUFrameCapture& inFrameCapture);
+		void StartWorkers();
+		void WorkerThread(Chip& inChip);
+
+		static unsigned int ClockChip(Chip& inChip, int inCyclesPerFrame, short* outSampleBuffer, unsigned int inSampleBufferSize);
+
+		Foundation::IPlatform* m_Platform;
+		std::vector<std::unique_ptr<Chip>> m_Chips;
+
+		unsigned short m_CaptureRangeBegin;
+		unsigned short m_CaptureRangeEnd;
+
+		// The frame the workers are clocking their chips through
+		int m_CyclesPerFrame;
+		std::atomic<bool> m_IsStopping;
+	};
+}
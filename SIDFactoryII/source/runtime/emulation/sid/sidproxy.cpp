@@ -2,6 +2,7 @@
 #include "runtime/environmentdefines.h"
 
 #include "libraries/residfp/SID.h"
+#include "libraries/residfp/TableCache.h"
 
 #include "foundation/base/assert.h"
 #include <cmath>
@@ -24,6 +25,12 @@ namespace Emulation
 		delete m_pSID;
 	}
 
+
+	void SIDProxy::SetTableCacheFolder(const std::string& inFolder)
+	{
+		reSIDfp::TableCache::setDirectory(inFolder);
+	}
+
 	//------------------------------------------------------------------------------------------------------------
 
 	void SIDProxy::SetEnvironment(SIDEnvironment eEnvironment)
@@ -73,6 +80,12 @@ namespace Emulation
 		return m_sConfiguration.m_nSampleFrequency;
 	}
 
+
+	const SIDConfiguration& SIDProxy::GetConfiguration() const
+	{
+		return m_sConfiguration;
+	}
+
 	//------------------------------------------------------------------------------------------------------------
 
 	void SIDProxy::SetConfiguration(const SIDConfiguration& sConfiguration)
@@ -111,61 +124,6 @@ namespace Emulation
 
 	//------------------------------------------------------------------------------------------------------------
 
-	void SIDProxy::StartRecordToFile(const std::string& inFileName)
-	{
-		FOUNDATION_ASSERT(m_FileName.empty());
-		m_FileName = inFileName;
-	}
-
-	void SIDProxy::StopRecordToFile()
-	{
-		FOUNDATION_ASSERT(!m_FileName.empty());
-
-		if (m_FileOutput.size() > 0)
-		{
-			FILE* file = fopen(m_FileName.c_str(), "wb");
-
-			struct wave_header
-			{
-				char chunk_id[4] = { 'R', 'I', 'F', 'F' };
-				int chunk_size;
-				char format[4] = { 'W', 'A', 'V', 'E' }; 
-				char sub_chunk1_id[4] = { 'f', 'm', 't', ' ' };
-				int sub_chunk1_size;
-				short audio_format = 1;
-				short num_channels = 1;			//    Mono = 1, Stereo = 2, etc.
-				int sample_rate = 44100;		//      8000, 44100, etc.
-				int byte_rate = 88200;			//== SampleRate * NumChannels * BitsPerSample / 8
-				short block_align = 2;			// == NumChannels * BitsPerSample / 8
-				short bits_per_sample = 16;		//    8 bits = 8, 16 bits = 16, etc.
-				char sub_chunk2_id[4] = { 'd', 'a', 't', 'a' };
-				int sub_chunk2_size;
-			} header;
-
-			const int data_size = static_cast<int>(m_FileOutput.size()) * 2;
-			header.chunk_size = 36 + data_size;
-			header.sub_chunk1_size = 16;
-			header.sub_chunk2_size = data_size;
-
-			fwrite(&header, sizeof(wave_header), 1, file);
-
-			for (short sample : m_FileOutput)
-				fwrite(&sample, 2, 1, file);
-
-			fclose(file);
-		}
-
-		m_FileOutput.clear();
-		m_FileName.clear();
-	}
-
-	bool SIDProxy::IsRecordingToFile() const
-	{
-		return !m_FileName.empty();
-	}
-
-	//------------------------------------------------------------------------------------------------------------
-
 	void SIDProxy::Reset()
 	{
 		FOUNDATION_ASSERT(m_pSID != nullptr);
@@ -194,13 +152,6 @@ namespace Emulation
 //			m_SampleCounter++;
 //		}
 
-		if (IsRecordingToFile())
-		{
-			m_FileOutput.push_back(0);
-			for (int i = 0; i < nSamplesWritten; ++i)
-				m_FileOutput.push_back(pBuffer[i]);
-		}
-
 		// Cast back to int
 		nDeltaCycles = static_cast<int>(nInternalDeltaCycles);
 
@@ -213,4 +164,26 @@ namespace Emulation
 		FOUNDATION_ASSERT(m_pSID != nullptr);
 		m_pSID->write(static_cast<int>(ucReg), static_cast<unsigned char>(ucValue));
 	}
+
+	void SIDProxy::ClockNoOutput(int inDeltaCycles)
+	{
+		FOUNDATION_ASSERT(m_pSID != nullptr);
+		FOUNDATION_ASSERT(inDeltaCycles >= 0);
+
+		m_pSID->clockNoOutput(static_cast<unsigned int>(inDeltaCycles));
+	}
+
+	//------------------------------------------------------------------------------------------------------------
+
+	void SIDProxy::GetState(reSIDfp::SIDState& outState) const
+	{
+		FOUNDATION_ASSERT(m_pSID != nullptr);
+		m_pSID->getState(outState);
+	}
+
+	void SIDProxy::SetState(const reSIDfp::SIDState& inState)
+	{
+		FOUNDATION_ASSERT(m_pSID != nullptr);
+		m_pSID->setState(inState);
+	}
 }
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "sidproxydefines.h"
-#include <stdio.h>
-#include <vector>
+
 #include <string>
 
 namespace reSIDfp
 {
 	class SID;
+	struct SIDState;
 }
 
 namespace Emulation
@@ -18,6 +18,10 @@ namespace Emulation
 		SIDProxy(const SIDConfiguration& sConfiguration);
 		~SIDProxy();
 
+		// Keeps the lookup tables of the SID emulation in files in the given folder, so that they are only calculated the first time a
+		// SID is created, rather than every time the application starts. An empty folder leaves them uncached.
+		static void SetTableCacheFolder(const std::string& inFolder);
+
 		void SetEnvironment(SIDEnvironment eEnvironment);
 		void SetModel(SIDModel eModel);
 		void SetSampleMethod(SIDSampleMethod eSampleMethod);
@@ -27,24 +31,25 @@ namespace Emulation
 		SIDModel GetModel() const;
 		SIDSampleMethod GetSampleMethod() const;
 		int GetSampleFrequency() const;
+		const SIDConfiguration& GetConfiguration() const;
 
 		void SetConfiguration(const SIDConfiguration& sConfiguration);
 		void ApplySettings();
 
-		void StartRecordToFile(const std::string& inFileName);
-		void StopRecordToFile();
-		bool IsRecordingToFile() const;
-
 		// Runtime
 		void Reset();
 
 		int Clock(int& nDeltaCycles, short* pBuffer, int nBufferSize);
 		void Write(unsigned char ucReg, unsigned char ucValue);
 
-	private:
-		std::string m_FileName;
-		std::vector<short> m_FileOutput;
+		// Clocks the SID exactly as Clock does, without producing any samples
+		void ClockNoOutput(int inDeltaCycles);
+
+		// The state can only be restored to a SID with the same model and environment as the one it was taken from
+		void GetState(reSIDfp::SIDState& outState) const;
+		void SetState(const reSIDfp::SIDState& inState);
 
+	private:
 		SIDConfiguration m_sConfiguration;
 
 		reSIDfp::SID* m_pSID;
@@ -40,6 +40,24 @@ namespace Emulation
 
 		}
 	};
+
+	// The most SID chips emulated side by side, the address range each chip occupies, and the number of write registers in it
+	static const unsigned int SID_MAX_CHIP_COUNT = 4;
+	static const unsigned short SID_CHIP_ADDRESS_RANGE = 0x20;
+	static const unsigned short SID_REGISTER_COUNT = 0x19;
+
+	struct SIDChipSetup
+	{
+		unsigned short m_usBaseAddress;
+		int m_nPanning;											// 0 is left, 50 is center and 100 is right
+
+		SIDChipSetup(unsigned short usBaseAddress, int nPanning)
+			: m_usBaseAddress(usBaseAddress)
+			, m_nPanning(nPanning)
+		{
+
+		}
+	};
 }
 
 
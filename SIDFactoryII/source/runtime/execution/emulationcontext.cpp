@@ -0,0 +1,42 @@
+#include "emulationcontext.h"
+
+#include "runtime/emulation/cpumos6510.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumemorypublisher.h"
+#include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/execution/executionhandler.h"
+#include "runtime/execution/flightrecorder.h"
+
+#include "foundation/base/assert.h"
+
+namespace Emulation
+{
+	EmulationContext::EmulationContext(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration)
+	{
+		FOUNDATION_ASSERT(inPlatform != nullptr);
+
+		m_CPUMemory = std::make_unique<CPUMemory>(0x10000, inPlatform);
+		m_CPU = std::make_unique<CPUmos6510>();
+		m_SIDProxy = std::make_unique<SIDProxy>(inSIDConfiguration);
+	}
+
+	EmulationContext::EmulationContext(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration, unsigned int inFlightRecorderCapacity, unsigned int inLookaheadFrameCount)
+		: EmulationContext(inPlatform, inSIDConfiguration)
+	{
+		m_EmulationMemory = std::make_unique<CPUMemory>(m_CPUMemory->GetSize(), inPlatform);
+		m_MemoryPublisher = std::make_unique<CPUMemoryPublisher>(m_CPUMemory->GetSize());
+		m_CPUMemory->SetPublisher(m_MemoryPublisher.get());
+
+		m_FlightRecorder = std::make_unique<FlightRecorder>(inPlatform, inFlightRecorderCapacity);
+		m_ExecutionHandler = std::make_unique<ExecutionHandler>(inPlatform, m_CPU.get(), m_EmulationMemory.get(), m_MemoryPublisher.get(), m_SIDProxy.get(), m_FlightRecorder.get(), inLookaheadFrameCount);
+	}
+
+	EmulationContext::~EmulationContext()
+	{
+		// The execution handler goes first, and the memory must not publish to the publisher after it is gone
+		m_ExecutionHandler = nullptr;
+
+		if (m_MemoryPublisher != nullptr)
+			m_CPUMemory->SetPublisher(nullptr);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "runtime/emulation/sid/sidproxydefines.h"
+
+#include <memory>
+
+namespace Foundation
+{
+	class IPlatform;
+}
+
+namespace Emulation
+{
+	class CPUmos6510;
+	class CPUMemory;
+	class CPUMemoryPublisher;
+	class SIDProxy;
+	class FlightRecorder;
+	class ExecutionHandler;
+
+	// Everything needed to emulate a song, bundled so that any number of independent instances can exist side by side.
+	// An offline context holds the CPU, the memory and the SID. A realtime context also holds the flight recorder and an
+	// execution handler, which feeds an audio stream. The execution handler runs on a memory of its own, which the memory
+	// of the context is kept in step with through a publisher, so that the editor and the emulation never wait for each other.
+	class EmulationContext final
+	{
+	public:
+		EmulationContext(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration);
+		EmulationContext(Foundation::IPlatform* inPlatform, const SIDConfiguration& inSIDConfiguration, unsigned int inFlightRecorderCapacity, unsigned int inLookaheadFrameCount);
+		~EmulationContext();
+
+		EmulationContext(const EmulationContext& inOther) = delete;
+
+		CPUmos6510* GetCPU() const { return m_CPU.get(); }
+		CPUMemory* GetCPUMemory() const { return m_CPUMemory.get(); }
+		SIDProxy* GetSIDProxy() const { return m_SIDProxy.get(); }
+		FlightRecorder* GetFlightRecorder() const { return m_FlightRecorder.get(); }			// nullptr in an offline context
+		ExecutionHandler* GetExecutionHandler() const { return m_ExecutionHandler.get(); }		// nullptr in an offline context
+
+	private:
+		// Declaration order matters: the execution handler is destroyed first, as it refers to all of the others
+		std::unique_ptr<CPUMemory> m_CPUMemory;
+		std::unique_ptr<CPUMemory> m_EmulationMemory;
+		std::unique_ptr<CPUMemoryPublisher> m_MemoryPublisher;
+		std::unique_ptr<CPUmos6510> m_CPU;
+		std::unique_ptr<SIDProxy> m_SIDProxy;
+		std::unique_ptr<FlightRecorder> m_FlightRecorder;
+		std::unique_ptr<ExecutionHandler> m_ExecutionHandler;
+	};
+}
@@ -2,15 +2,25 @@
 
 #include "runtime/emulation/cpumos6510.h"
 #include "runtime/emulation/cpuframecapture.h"
+#include "runtime/emulation/cpumemory.h"
+#include "runtime/emulation/cpumemorypublisher.h"
+#include "runtime/emulation/cpuprofile.h"
 #include "runtime/emulation/sid/sidproxy.h"
+#include "runtime/emulation/sid/multisidrenderer.h"
 
 #include "runtime/execution/flightrecorder.h"
 #include "runtime/environmentdefines.h"
 
 #include "foundation/platform/iplatform.h"
 #include "foundation/platform/imutex.h"
+#include "foundation/platform/isemaphore.h"
+#include "foundation/platform/ithread.h"
+#include "foundation/sound/pcmringbuffer.h"
 #include "foundation/base/assert.h"
 
+#include "SDL.h"
+#include <string.h>
+
 using namespace Foundation;
 
 namespace Emulation
@@ -19,20 +29,35 @@ namespace Emulation
 		IPlatform* inPlatform, 
 		CPUmos6510* inCPU, 
 		CPUMemory* pMemory, 
+		CPUMemoryPublisher* pMemoryPublisher,
 		SIDProxy* pSIDProxy,
-		FlightRecorder* inFlightRecorder
+		FlightRecorder* inFlightRecorder,
+		unsigned int inLookaheadFrameCount
 	)
-		: m_CPU(inCPU)
-		, m_Memory(pMemory)
-		, m_SIDProxy(pSIDProxy)
-		, m_SIDRegisterFlightRecorder(inFlightRecorder)
-		, m_IsStarted(false)
-		, m_FeedCount(0)
+		: m_FeedCount(0)
 		, m_BytesFedCount(0)
-		, m_SampleBufferReadCursor(0)
-		, m_SampleBufferWriteCursor(0)
+		, m_UnderrunCount(0)
+		, m_LargestFeedSampleCount(0)
 		, m_CPUFrameCounter(0)
+		, m_SampleBufferWriteCursor(0)
+		, m_IsStarted(false)
+		, m_ErrorState(false)
 		, m_UpdateEnabled(false)
+		, m_FastForwardUpdateCount(0)
+		, m_RenderedSampleFrameCount(0)
+		, m_PlayedSampleFrameCount(0)
+		, m_AudioClockSequence(0)
+		, m_AudioClockPlayedSampleFrameCount(0)
+		, m_AudioClockFeedSampleFrameCount(0)
+		, m_AudioClockTime(0)
+		, m_SIDProxy(pSIDProxy)
+		, m_CPU(inCPU)
+		, m_Memory(pMemory)
+		, m_MemoryPublisher(pMemoryPublisher)
+		, m_Platform(inPlatform)
+		, m_LookaheadFrameCount(inLookaheadFrameCount)
+		, m_SIDRegisterFlightRecorder(inFlightRecorder)
+		, m_CPUProfileEnabled(false)
 	{
 		m_CyclesPerFrame = EMULATION_CYCLES_PER_FRAME_PAL;
 
@@ -40,15 +65,21 @@ namespace Emulation
 		m_SampleBufferSize = (static_cast<unsigned int>(pSIDProxy->GetSampleFrequency()) << 8);
 		m_SampleBuffer = new short[m_SampleBufferSize];
 		m_Mutex = inPlatform->CreateMutex();
+		m_EmulationWakeUp = inPlatform->CreateSemaphore(0);
 
 		// Set default action vector
 		m_InitVector = 0x1000;
 		m_StopVector = 0x1003;
 		m_UpdateVector = 0x1006;
+
+		// A single SID, at the default address
+		SetSIDChips({ SIDChipSetup(0xd400, 50) });
 	}
 
 	ExecutionHandler::~ExecutionHandler()
 	{
+		Stop();
+
 		m_Mutex = nullptr;
 
 		if (m_SampleBuffer != nullptr)
@@ -65,11 +96,11 @@ namespace Emulation
 		{
 			m_FeedCount = 0;
 			m_BytesFedCount = 0;
+			m_UnderrunCount = 0;
 			m_CPUCyclesSpend = 0;
 			m_CPUFrameCounter = 0;
 
-			if (m_SIDProxy != nullptr)
-				m_SIDProxy->Reset();
+			m_SIDRenderer->Reset();
 
 			if (m_SIDRegisterFlightRecorder != nullptr)
 			{
@@ -79,6 +110,9 @@ namespace Emulation
 			}
 
 			m_IsStarted = true;
+
+			// Start rendering ahead
+			m_EmulationThread = m_Platform->CreateThread("SF2 Emulation", [this]() { EmulationThread(); });
 		}
 	}
 
@@ -86,10 +120,17 @@ namespace Emulation
 	{
 		if (m_IsStarted)
 		{
-			m_SampleBufferReadCursor = 0;
+			m_IsStarted = false;
+
+			// Wake the emulation thread and wait for it to finish the frame it may be working on
+			m_EmulationWakeUp->Post();
+			m_EmulationThread->Join();
+			m_EmulationThread = nullptr;
+
 			m_SampleBufferWriteCursor = 0;
 
-			m_IsStarted = false;
+			// The samples left in the ring buffer are never played, and neither are their frames
+			m_PlaybackFrameQueue->Flush();
 		}
 	}
 
@@ -112,6 +153,11 @@ namespace Emulation
 		return m_FeedCount;
 	}
 
+	unsigned int ExecutionHandler::GetUnderrunCount() const
+	{
+		return m_UnderrunCount;
+	}
+
 	//----------------------------------------------------------------------------------------------------------------
 
 	void ExecutionHandler::PreFeedPCM(void* inBuffer, unsigned int inByteCount)
@@ -124,42 +170,91 @@ namespace Emulation
 		m_FeedCount++;
 		m_BytesFedCount += inByteCount;
 
+		const unsigned int channel_count = m_SIDRenderer->GetChannelCount();
+		const unsigned int sample_count = inByteCount >> 1;
+		const unsigned long long played_sample_frame_count = m_PlayedSampleFrameCount;
+
 		if (!m_IsStarted)
 		{
+			// Flushed samples are counted as played, to keep in line with the count of rendered samples
+			m_PlayedSampleFrameCount += m_PCMRingBuffer->GetAvailableForRead() / channel_count;
+			m_PCMRingBuffer->Flush();
 			memset(inBuffer, 0, inByteCount);
 		}
 		else
 		{
-			unsigned int uiRemainingSamples = (inByteCount >> 1);
+			// This is called from the audio thread, so nothing in here may lock or wait. The emulation thread has the frames ready in the ring buffer.
+			if (sample_count > m_LargestFeedSampleCount)
+				m_LargestFeedSampleCount = sample_count;
 
-			short* pSource = static_cast<short*>(m_SampleBuffer);
-			short* pTarget = static_cast<short*>(inBuffer);
+			const unsigned int samples_read = m_PCMRingBuffer->Read(static_cast<short*>(inBuffer), sample_count);
+			m_PlayedSampleFrameCount += samples_read / channel_count;
 
-			while (uiRemainingSamples > 0)
+			if (samples_read < sample_count)
 			{
-				FOUNDATION_ASSERT(m_SampleBufferReadCursor <= m_SampleBufferWriteCursor);
+				memset(static_cast<short*>(inBuffer) + samples_read, 0, (sample_count - samples_read) << 1);
+				m_UnderrunCount++;
+			}
 
-				if (m_SampleBufferReadCursor >= m_SampleBufferWriteCursor)
-				{
-					// Capture a single frame of audio
-					CaptureNewFrame();
-				}
+			// Let the emulation thread refill the ring buffer
+			m_EmulationWakeUp->Post();
+		}
+
+		PublishAudioClock(played_sample_frame_count, sample_count / channel_count);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+	// Audio clock
+	//----------------------------------------------------------------------------------------------------------------
 
-				unsigned int uiRemainingSourceSamples = m_SampleBufferWriteCursor - m_SampleBufferReadCursor;
-				unsigned int uiSamplesToCopy = uiRemainingSamples > uiRemainingSourceSamples ? uiRemainingSourceSamples : uiRemainingSamples;
+	void ExecutionHandler::PublishAudioClock(unsigned long long inPlayedSampleFrameCount, unsigned int inFeedSampleFrameCount)
+	{
+		const unsigned int sequence = m_AudioClockSequence.load(std::memory_order_relaxed);
 
-				memcpy(pTarget, pSource + m_SampleBufferReadCursor, uiSamplesToCopy << 1);
+		m_AudioClockSequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
 
-				// Forward the read cursor
-				m_SampleBufferReadCursor += uiSamplesToCopy;
+		m_AudioClockPlayedSampleFrameCount.store(inPlayedSampleFrameCount, std::memory_order_relaxed);
+		m_AudioClockFeedSampleFrameCount.store(inFeedSampleFrameCount, std::memory_order_relaxed);
+		m_AudioClockTime.store(SDL_GetPerformanceCounter(), std::memory_order_relaxed);
 
-				// Forward the target pointer
-				pTarget += uiSamplesToCopy;
+		m_AudioClockSequence.store(sequence + 2, std::memory_order_release);
+	}
 
-				// Decrement the remaining number of samples
-				uiRemainingSamples -= uiSamplesToCopy;
-			}
+	unsigned long long ExecutionHandler::GetAudibleSampleOffset() const
+	{
+		unsigned int sequence;
+		unsigned long long played_sample_frame_count;
+		unsigned int feed_sample_frame_count;
+		unsigned long long time;
+
+		// Read until the values weren't written while reading them
+		for (;;)
+		{
+			sequence = m_AudioClockSequence.load(std::memory_order_acquire);
+
+			played_sample_frame_count = m_AudioClockPlayedSampleFrameCount.load(std::memory_order_relaxed);
+			feed_sample_frame_count = m_AudioClockFeedSampleFrameCount.load(std::memory_order_relaxed);
+			time = m_AudioClockTime.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if ((sequence & 1) == 0 && m_AudioClockSequence.load(std::memory_order_relaxed) == sequence)
+				break;
 		}
+
+		// The audio device plays one buffer while the next one is fed, so the buffer before the last feed starts playing at the time of the
+		// feed, and the samples of the last feed follow it. The position can't go past the end of the samples that have been fed.
+		const unsigned long long now = SDL_GetPerformanceCounter();
+		const unsigned long long elapsed_sample_frame_count = now > time
+			? static_cast<unsigned long long>(static_cast<double>(now - time) * m_SIDProxy->GetSampleFrequency() / static_cast<double>(SDL_GetPerformanceFrequency()))
+			: 0;
+
+		const unsigned long long playing_sample_frame_count = played_sample_frame_count > feed_sample_frame_count ? played_sample_frame_count - feed_sample_frame_count : 0;
+		const unsigned long long audible_sample_offset = playing_sample_frame_count + elapsed_sample_frame_count;
+		const unsigned long long fed_sample_frame_count = played_sample_frame_count + feed_sample_frame_count;
+
+		return audible_sample_offset < fed_sample_frame_count ? audible_sample_offset : fed_sample_frame_count;
 	}
 
 	//----------------------------------------------------------------------------------------------------------------
@@ -257,6 +352,15 @@ namespace Emulation
 	}
 
 
+	void ExecutionHandler::QueueRestoreState(const std::function<void(CPUMemory*)>& inRestoreStateCallback)
+	{
+		// The callback is called on the emulation thread, with the memory locked, before any of the SID writes of the frame are done
+		Lock();
+		m_ActionQueue.push_back({ ActionType::RestoreState, 0, inRestoreStateCallback });
+		Unlock();
+	}
+
+
 	void ExecutionHandler::SetInitVector(unsigned short inVector)
 	{
 		Lock();
@@ -285,26 +389,170 @@ namespace Emulation
 		Unlock();
 	}
 
-	void ExecutionHandler::StartWriteOutputToFile(const std::string& inFilename)
+	void ExecutionHandler::SetPlaybackFrameCallback(const std::function<void(CPUMemory*, PlaybackFrame&)>& inPlaybackFrameCallback)
+	{
+		Lock();
+		m_PlaybackFrameCallback = inPlaybackFrameCallback;
+		Unlock();
+	}
+
+	bool ExecutionHandler::GetAudiblePlaybackFrame(PlaybackFrame& outFrame)
+	{
+		const unsigned long long audible_sample_offset = GetAudibleSampleOffset();
+
+		// Take out every frame that has started to play, and hand back the last of them
+		bool has_frame = false;
+		PlaybackFrame frame;
+
+		while (m_PlaybackFrameQueue->Peek(frame) && frame.m_SampleOffset <= audible_sample_offset)
+		{
+			m_PlaybackFrameQueue->Pop();
+
+			outFrame = frame;
+			has_frame = true;
+		}
+
+		return has_frame;
+	}
+
+	unsigned long long ExecutionHandler::GetNextPlaybackFrameSampleOffset()
+	{
+		// Frames emulated after this has been called, start at or after the sample offset
+		Lock();
+		const unsigned long long sample_offset = m_RenderedSampleFrameCount;
+		Unlock();
+
+		return sample_offset;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool ExecutionHandler::StartWriteOutputToFile(const std::string& inFilename, WaveFileWriter::SampleFormat inSampleFormat)
 	{
-		FOUNDATION_ASSERT(m_SIDProxy != nullptr);
 		Lock();
-		m_SIDProxy->StartRecordToFile(inFilename);
+
+		FOUNDATION_ASSERT(m_FileWriter == nullptr);
+
+		// The output of all the SID chips is written, just as it is fed to the audio stream
+		m_FileWriter = std::make_unique<WaveFileWriter>(m_Platform, static_cast<unsigned int>(m_SIDProxy->GetSampleFrequency()), static_cast<unsigned short>(GetChannelCount()), inSampleFormat, true);
+
+		if (!m_FileWriter->Open(inFilename))
+			m_FileWriter = nullptr;
+
+		const bool success = m_FileWriter != nullptr;
+
 		Unlock();
+
+		return success;
 	}
 
 	void ExecutionHandler::StopWriteOutputToFile()
 	{
-		FOUNDATION_ASSERT(m_SIDProxy != nullptr);
 		Lock();
-		m_SIDProxy->StopRecordToFile();
+
+		FOUNDATION_ASSERT(m_FileWriter != nullptr);
+
+		// Flushes the remaining samples and patches the header
+		m_FileWriter->Close();
+		m_FileWriter = nullptr;
+
 		Unlock();
 	}
 
 	bool ExecutionHandler::IsWritingOutputToFile() const
 	{
-		FOUNDATION_ASSERT(m_SIDProxy != nullptr);
-		return m_SIDProxy->IsRecordingToFile();
+		return m_FileWriter != nullptr;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void ExecutionHandler::SetSIDChips(const std::vector<SIDChipSetup>& inChipSetups)
+	{
+		FOUNDATION_ASSERT(!m_IsStarted);
+		FOUNDATION_ASSERT(m_FileWriter == nullptr);
+
+		// Let the workers of the current chips finish, before starting those of the new ones
+		m_SIDRenderer = nullptr;
+		m_SIDRenderer = std::make_unique<MultiSIDRenderer>(m_Platform, m_SIDProxy, inChipSetups);
+
+		// Create the ring buffer between the emulation thread and the audio stream. A frame yields the most samples, when the SID is clocked
+		// at the slower PAL rate. Room is left for the largest buffer the audio device is expected to ask for in one go. Samples are
+		// counted for each channel, as they are interleaved in the ring buffer.
+		const unsigned int channel_count = m_SIDRenderer->GetChannelCount();
+		const unsigned int max_audio_device_sample_count = 0x8000 * channel_count;
+
+		m_MaxSamplesPerFrame = (static_cast<unsigned int>((static_cast<unsigned long long>(m_CyclesPerFrame) * m_SIDProxy->GetSampleFrequency()) / EMULATION_CYCLES_PER_SECOND_PAL) + 1) * channel_count;
+		m_PCMRingBuffer = std::make_unique<PCMRingBuffer>(max_audio_device_sample_count + (m_LookaheadFrameCount + 2) * m_MaxSamplesPerFrame);
+
+		// The playback frame queue holds the frames of a full ring buffer, as well as those of the buffer the audio device is playing. Samples
+		// left in the old ring buffer are never played, so the counts are lined up again.
+		m_PlaybackFrameQueue = std::make_unique<PlaybackFrameQueue>(2 * m_PCMRingBuffer->GetCapacity() / m_MaxSamplesPerFrame + 1);
+		m_PlayedSampleFrameCount = m_RenderedSampleFrameCount;
+
+		// Create the frame capture up front, so that no memory is allocated when capturing frames on the emulation thread. It covers the
+		// addresses of all the chips.
+		m_FrameCapture = std::make_unique<CPUFrameCapture>(m_CPU, m_SIDRenderer->GetCaptureRangeBegin(), m_SIDRenderer->GetCaptureRangeEnd(), m_CyclesPerFrame);
+
+		if (m_SIDRegisterFlightRecorder != nullptr)
+		{
+			std::vector<unsigned short> sid_addresses;
+
+			for (unsigned int i = 0; i < m_SIDRenderer->GetChipCount(); ++i)
+				sid_addresses.push_back(m_SIDRenderer->GetChipSetup(i).m_usBaseAddress);
+
+			m_SIDRegisterFlightRecorder->Lock();
+			m_SIDRegisterFlightRecorder->SetSIDAddresses(sid_addresses);
+			m_SIDRegisterFlightRecorder->Reset();
+			m_SIDRegisterFlightRecorder->Unlock();
+		}
+	}
+
+	unsigned int ExecutionHandler::GetSIDChipCount() const
+	{
+		return m_SIDRenderer->GetChipCount();
+	}
+
+	unsigned int ExecutionHandler::GetChannelCount() const
+	{
+		return m_SIDRenderer->GetChannelCount();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void ExecutionHandler::SetCPUProfileEnabled(bool inEnabled)
+	{
+		Lock();
+
+		if (inEnabled)
+		{
+			if (m_CPUProfile == nullptr)
+				m_CPUProfile = std::make_unique<CPUProfile>();
+			else
+				m_CPUProfile->Clear();
+		}
+
+		m_CPUProfileEnabled = inEnabled;
+
+		Unlock();
+	}
+
+	bool ExecutionHandler::IsCPUProfileEnabled() const
+	{
+		return m_CPUProfileEnabled;
+	}
+
+	bool ExecutionHandler::GetCPUProfile(CPUProfile& outProfile)
+	{
+		Lock();
+
+		const bool has_profile = m_CPUProfile != nullptr;
+
+		if (has_profile)
+			outProfile = *m_CPUProfile;
+
+		Unlock();
+
+		return has_profile;
 	}
 
 	//----------------------------------------------------------------------------------------------------------------
@@ -330,29 +578,22 @@ namespace Emulation
 
 	//----------------------------------------------------------------------------------------------------------------
 
-	void ExecutionHandler::SimulateSID(int inDeltaCycles)
+	void ExecutionHandler::BeginProfileRoutine(ActionType inActionType, bool inIsFastForward)
 	{
-		short* pSampleBuffer = static_cast<short*>(m_SampleBuffer);
+		if (!m_CPUProfileEnabled)
+			return;
 
-		//while (inDeltaCycles > 0)
+		switch (inActionType)
 		{
-			// Get offset pointer inside the sample buffer
-			short* sample_buffer_write_location = pSampleBuffer + m_SampleBufferWriteCursor;
-
-			// Calculate remaining samples in the buffer, so that we do not overflow it!
-			const int uiRemainingSamplesInBuffer = m_SampleBufferSize - m_SampleBufferWriteCursor;
-
-			// Clock the sid
-			const int nSamplesWritten = m_SIDProxy->Clock(inDeltaCycles, sample_buffer_write_location, uiRemainingSamplesInBuffer);
-
-			// Negative sample count written is invalid!
-			FOUNDATION_ASSERT(nSamplesWritten >= 0);
-
-			// Move the write cursor 
-			m_SampleBufferWriteCursor += static_cast<unsigned int>(nSamplesWritten);
-
-			// Make sure there's no overflow
-			FOUNDATION_ASSERT(m_SampleBufferWriteCursor <= m_SampleBufferSize);
+		case ActionType::Init:
+			m_CPUProfile->BeginRoutine(CPUProfile::Routine::Init);
+			break;
+		case ActionType::Stop:
+			m_CPUProfile->BeginRoutine(CPUProfile::Routine::Stop);
+			break;
+		default:
+			m_CPUProfile->BeginRoutine(inIsFastForward ? CPUProfile::Routine::FastForwardUpdate : CPUProfile::Routine::Update);
+			break;
 		}
 	}
 
@@ -363,18 +604,20 @@ namespace Emulation
 		// Lock execution handler
 		Lock();
 
-		// Lock memory access
+		// Lock memory access. The memory is only used by the emulation, so this never waits for the editor.
 		m_Memory->Lock();
 
-		// Reset read/write cursor, and run simulation of the SID
-		m_SampleBufferReadCursor = 0;
-		m_SampleBufferWriteCursor = 0;
+		// Apply the changes the editor has published since the last frame, before any of the queued actions are done
+		if (m_MemoryPublisher != nullptr)
+			m_MemoryPublisher->ApplyChanges(*m_Memory);
 
 		// Attach memory to cpu
 		m_CPU->SetMemory(m_Memory);
+		m_CPU->SetProfile(m_CPUProfileEnabled ? m_CPUProfile.get() : nullptr);
 
 		// Capture the frame (this will run the CPU )
-		CPUFrameCapture frameCapture(m_CPU, 0xd400, 0xd418, m_CyclesPerFrame);
+		CPUFrameCapture& frameCapture = *m_FrameCapture;
+		frameCapture.Begin();
 
 		// Execute queued actions
 		for (const Action& action : m_ActionQueue)
@@ -383,22 +626,33 @@ namespace Emulation
 			{
 			case ActionType::ApplyMuteState:
 				{
-					const unsigned short offset = action.m_ActionArgument * 7;
-					const unsigned short address = 0xd400 + offset;
+					// Each chip plays three channels, in order of the chip setups, with seven registers for each channel
+					const unsigned int chip_index = action.m_ActionArgument / 3;
+
+					if (chip_index < m_SIDRenderer->GetChipCount())
+					{
+						const unsigned short offset = (action.m_ActionArgument % 3) * 7;
+						const unsigned short address = m_SIDRenderer->GetChipSetup(chip_index).m_usBaseAddress + offset;
 
-					for (int i = 0; i < 7; ++i)
-						frameCapture.Write(address + i, 0, 0);
+						for (int i = 0; i < 7; ++i)
+							frameCapture.Write(address + i, 0, 0);
+					}
 				}
 				break;
 			case ActionType::ClearMuteAllState:
+			case ActionType::RestoreState:
 				break;
 			case ActionType::Init:
 			case ActionType::Stop:
+				BeginProfileRoutine(action.m_ActionType, false);
 				frameCapture.Capture(GetAddressFromActionType(action.m_ActionType), action.m_ActionArgument);
 				break;
 			case ActionType::Update:
-				if(!m_ErrorState)
+				if (!m_ErrorState)
+				{
+					BeginProfileRoutine(action.m_ActionType, false);
 					frameCapture.Capture(GetAddressFromActionType(action.m_ActionType), action.m_ActionArgument);
+				}
 			default:
 				break;
 			}
@@ -416,6 +670,7 @@ namespace Emulation
 
 			if (!error)
 			{
+				BeginProfileRoutine(ActionType::Update, false);
 				frameCapture.Capture(GetAddressFromActionType(ActionType::Update), 0);
 				error = frameCapture.IsMaxCycleCountReached();
 
@@ -431,6 +686,7 @@ namespace Emulation
 					if (m_CyclesPerFrame - frameCapture.GetCyclesSpend() < m_CyclesPerFrame >> 2)
 						break;
 
+					BeginProfileRoutine(ActionType::Update, true);
 					frameCapture.Capture(GetAddressFromActionType(ActionType::Update), 0);
 					if (m_PostUpdateCallback)
 						m_PostUpdateCallback(m_Memory);
@@ -452,6 +708,12 @@ namespace Emulation
 		// Increment frame counter
 		m_CPUFrameCounter++;
 
+		// Let the driver state of the frame be filled in
+		PlaybackFrame playback_frame = { m_CPUFrameCounter, m_RenderedSampleFrameCount, 0, -1 };
+
+		if (m_PlaybackFrameCallback)
+			m_PlaybackFrameCallback(m_Memory, playback_frame);
+
 		// Run the flight recorder
 		if (m_SIDRegisterFlightRecorder != nullptr && m_SIDRegisterFlightRecorder->IsRecording())
 		{
@@ -460,34 +722,32 @@ namespace Emulation
 			m_SIDRegisterFlightRecorder->Unlock();
 		}
 
+		frameCapture.End();
+
+		// Let the editor see the state of the driver after the frame
+		if (m_MemoryPublisher != nullptr)
+			m_MemoryPublisher->PublishEmulatedState(*m_Memory);
+
 		// Unlock memory access
 		m_Memory->Unlock();
 
 		// Grab the cycle count of the CPU here, as this will be the number of cycles spend on the driver update
 		m_CPUCyclesSpend = frameCapture.GetCyclesSpend();
 
-		// Do all writes to the SID and emulate cycles spend
-		int nCycle = 0;
-
-		while (frameCapture.HasNext())
-		{
-			const CPUFrameCapture::WriteCapture& capture = frameCapture.GetNext();
+		// Do all writes to the SID chips and emulate cycles spend
+		m_SampleBufferWriteCursor = m_SIDRenderer->RenderFrame(frameCapture, static_cast<int>(m_CyclesPerFrame), m_SampleBuffer, m_SampleBufferSize);
 
-			FOUNDATION_ASSERT(nCycle <= capture.m_iCycle);
+		if (m_FileWriter != nullptr && m_SampleBufferWriteCursor > 0)
+			m_FileWriter->Write(m_SampleBuffer, m_SampleBufferWriteCursor);
 
-			const int deltaCycles = capture.m_iCycle - nCycle;
-			SimulateSID(deltaCycles);
-			m_SIDProxy->Write((unsigned char)(capture.m_usReg & 0xff), capture.m_ucVal);
-			nCycle += deltaCycles;
-		}
+		// Hand the samples to the audio stream, and queue the playback frame. This is done while locked, so that the next sample offset is
+		// never read in between.
+		// A frame is only captured when the ring buffer has room for all of its samples
+		const unsigned int samples_written = m_PCMRingBuffer->Write(m_SampleBuffer, m_SampleBufferWriteCursor);
+		FOUNDATION_ASSERT(samples_written == m_SampleBufferWriteCursor);
 
-		// Do the rest of the frame
-		while (nCycle < (int)m_CyclesPerFrame)
-		{
-			const int deltaCycles = m_CyclesPerFrame - nCycle;
-			SimulateSID(deltaCycles);
-			nCycle += deltaCycles;
-		}
+		m_RenderedSampleFrameCount += samples_written / m_SIDRenderer->GetChannelCount();
+		m_PlaybackFrameQueue->Push(playback_frame);
 
 		// Reset cycle counter
 		m_CurrentCycle = 0;
@@ -495,4 +755,26 @@ namespace Emulation
 		// Unlock execution handler
 		Unlock();
 	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	void ExecutionHandler::EmulationThread()
+	{
+		while (m_IsStarted)
+		{
+			// Keep enough samples buffered for the largest request from the audio device, plus the configured number of frames
+			const unsigned int target_sample_count = m_LargestFeedSampleCount + m_LookaheadFrameCount * m_MaxSamplesPerFrame;
+			const bool needs_frame = m_PCMRingBuffer->GetAvailableForRead() < target_sample_count;
+
+			if (needs_frame && m_PCMRingBuffer->GetAvailableForWrite() >= m_MaxSamplesPerFrame)
+			{
+				CaptureNewFrame();
+			}
+			else
+			{
+				// Sleep until the audio stream has consumed data. The timeout is only a safety net.
+				m_EmulationWakeUp->WaitTimeout(10);
+			}
+		}
+	}
 }
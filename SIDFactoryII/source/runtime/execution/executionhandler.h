@@ -2,6 +2,10 @@
 #define __EXECUTIONHANDLER_H__
 
 #include "foundation/sound/audiostream.h"
+#include "foundation/sound/wavefilewriter.h"
+#include "runtime/emulation/sid/sidproxydefines.h"
+#include "runtime/execution/playbackframequeue.h"
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -10,15 +14,22 @@
 namespace Foundation
 {
 	class IMutex;
+	class ISemaphore;
+	class IThread;
 	class IPlatform;
+	class PCMRingBuffer;
 }
 
 namespace Emulation
 {
 	class CPUmos6510;
 	class CPUMemory;
+	class CPUMemoryPublisher;
+	class CPUFrameCapture;
 	class SIDProxy;
+	class MultiSIDRenderer;
 	class FlightRecorder;
+	class CPUProfile;
 
 	class ExecutionHandler : public Foundation::IAudioStreamFeeder
 	{
@@ -27,8 +38,10 @@ namespace Emulation
 			Foundation::IPlatform* pPlatformFactory, 
 			CPUmos6510* pCPU, 
 			CPUMemory* pMemory, 
+			CPUMemoryPublisher* pMemoryPublisher,
 			SIDProxy* pSIDProxy,
-			FlightRecorder* inFlightRecorder
+			FlightRecorder* inFlightRecorder,
+			unsigned int inLookaheadFrameCount
 		);
 		~ExecutionHandler();
 
@@ -41,6 +54,7 @@ namespace Emulation
 
 		virtual unsigned int GetFeedCount() const;
 		virtual unsigned int GetBytesFed() const;
+		virtual unsigned int GetUnderrunCount() const;
 
 		virtual void PreFeedPCM(void* inBuffer, unsigned int inByteCount);
 		virtual void FeedPCM(void* inBuffer, unsigned int inByteCount);
@@ -63,12 +77,20 @@ namespace Emulation
 		void QueueStop();
 		void QueueMuteChannel(unsigned char inChannel, const std::function<void(CPUMemory*)>& inMuteCallback);
 		void QueueClearAllMuteState(const std::function<void(CPUMemory*)>& inClearMuteStateCallback);
+		void QueueRestoreState(const std::function<void(CPUMemory*)>& inRestoreStateCallback);
 
 		void SetInitVector(unsigned short inVector);
 		void SetStopVector(unsigned short inVector);
 		void SetUpdateVector(unsigned short inVector);
 		void SetPostUpdateCallback(const std::function<void(CPUMemory*)>& inPostUpdateCallback);
 
+		// Playback frames. The callback is called once for every frame on the emulation thread, with the memory locked, to fill in the state
+		// of the driver after the frame. The frames are then queued, for the audible one to be picked by the clock of the audio stream, which
+		// runs a full audio buffer and the lookahead frames behind the emulation.
+		void SetPlaybackFrameCallback(const std::function<void(CPUMemory*, PlaybackFrame&)>& inPlaybackFrameCallback);
+		bool GetAudiblePlaybackFrame(PlaybackFrame& outFrame);
+		unsigned long long GetNextPlaybackFrameSampleOffset();
+
 		// Cycles
 		unsigned int GetCPUCyclesSpendLastFrame() const { return m_CPUCyclesSpend; }
 		unsigned int GetCPUFrameUpdateCount() const { return m_CPUFrameCounter; }
@@ -78,8 +100,21 @@ namespace Emulation
 
 		FlightRecorder* GetFlightRecorder() const { return m_SIDRegisterFlightRecorder; }
 
+		// SID chips. The first chip is the SID proxy given to the execution handler, and it plays on its own in mono by default. With more
+		// chips the output is stereo. The chips can only be set up while the execution handler is stopped, and before the audio stream is
+		// created, as the stream must be opened with the channel count of the output.
+		void SetSIDChips(const std::vector<SIDChipSetup>& inChipSetups);
+		unsigned int GetSIDChipCount() const;
+		unsigned int GetChannelCount() const;
+		MultiSIDRenderer* GetSIDRenderer() const { return m_SIDRenderer.get(); }
+
+		// CPU profile. Enabling the profile clears it. The profile is copied out, as it is added to on the emulation thread.
+		void SetCPUProfileEnabled(bool inEnabled);
+		bool IsCPUProfileEnabled() const;
+		bool GetCPUProfile(CPUProfile& outProfile);
+
 		// Write output to file
-		void StartWriteOutputToFile(const std::string& inFilename);
+		bool StartWriteOutputToFile(const std::string& inFilename, Foundation::WaveFileWriter::SampleFormat inSampleFormat);
 		void StopWriteOutputToFile();
 		bool IsWritingOutputToFile() const;
 
@@ -90,7 +125,8 @@ namespace Emulation
 			Stop,
 			Update,
 			ApplyMuteState,
-			ClearMuteAllState
+			ClearMuteAllState,
+			RestoreState
 		};
 
 		struct Action
@@ -102,24 +138,31 @@ namespace Emulation
 
 		const unsigned short GetAddressFromActionType(ActionType inActionType) const;
 
-		void SimulateSID(int inDeltaCycles);
+		void BeginProfileRoutine(ActionType inActionType, bool inIsFastForward);
 		void CaptureNewFrame();
 
+		void PublishAudioClock(unsigned long long inPlayedSampleFrameCount, unsigned int inFeedSampleFrameCount);
+		unsigned long long GetAudibleSampleOffset() const;
+
+		void EmulationThread();
+
 		// Audio stream feeding
 
 		unsigned int m_FeedCount;
 		unsigned int m_BytesFedCount;
 
+		std::atomic<unsigned int> m_UnderrunCount;
+		std::atomic<unsigned int> m_LargestFeedSampleCount;
+
 		unsigned int m_CurrentCycle;		// Current cycle being processed
 		unsigned int m_CyclesPerFrame;		// Number of cycles per frame
 		unsigned int m_CPUCyclesSpend;		// Cycles spend on code during the last update (frame)
 
 		unsigned int m_CPUFrameCounter;
 
-		unsigned int m_SampleBufferReadCursor;
 		unsigned int m_SampleBufferWriteCursor;
 
-		bool m_IsStarted;
+		std::atomic<bool> m_IsStarted;
 
 		// Error state
 		bool m_ErrorState;
@@ -133,6 +176,19 @@ namespace Emulation
 		unsigned int m_FastForwardUpdateCount;
 		std::function<void(CPUMemory*)> m_PostUpdateCallback;
 
+		// Playback frames, queued by the emulation thread for the playback clock to pick from. Sample frames are counted as they are put in,
+		// and taken out of, the PCM ring buffer, so that the two counts line up.
+		std::function<void(CPUMemory*, PlaybackFrame&)> m_PlaybackFrameCallback;
+		std::unique_ptr<PlaybackFrameQueue> m_PlaybackFrameQueue;
+		unsigned long long m_RenderedSampleFrameCount;
+		unsigned long long m_PlayedSampleFrameCount;
+
+		// Audio clock, published by the audio thread on every feed as a sequence lock: The sequence is odd while the values are written.
+		std::atomic<unsigned int> m_AudioClockSequence;
+		std::atomic<unsigned long long> m_AudioClockPlayedSampleFrameCount;
+		std::atomic<unsigned int> m_AudioClockFeedSampleFrameCount;
+		std::atomic<unsigned long long> m_AudioClockTime;
+
 		// Driver vectors
 		unsigned short m_InitVector;
 		unsigned short m_StopVector;
@@ -140,17 +196,37 @@ namespace Emulation
 
 		// SID and CPU
 		SIDProxy* m_SIDProxy;
+		std::unique_ptr<MultiSIDRenderer> m_SIDRenderer;
 		CPUmos6510* m_CPU;
 		CPUMemory* m_Memory;
+		CPUMemoryPublisher* m_MemoryPublisher;
+
+		// Frame capture, reused for every frame
+		std::unique_ptr<CPUFrameCapture> m_FrameCapture;
 
 		std::shared_ptr<Foundation::IMutex> m_Mutex;
 
+		// Emulation thread, rendering frames ahead of the audio stream into the PCM ring buffer
+		Foundation::IPlatform* m_Platform;
+		std::shared_ptr<Foundation::IThread> m_EmulationThread;
+		std::shared_ptr<Foundation::ISemaphore> m_EmulationWakeUp;
+		std::unique_ptr<Foundation::PCMRingBuffer> m_PCMRingBuffer;
+
+		unsigned int m_LookaheadFrameCount;
+		unsigned int m_MaxSamplesPerFrame;
+
 		// Flight recorder
 		FlightRecorder* m_SIDRegisterFlightRecorder;
 
+		// CPU profile, only created once it is enabled
+		std::unique_ptr<CPUProfile> m_CPUProfile;
+		bool m_CPUProfileEnabled;
+
 		// Audio output
 		unsigned int m_SampleBufferSize;
 		short* m_SampleBuffer;
+
+		std::unique_ptr<Foundation::WaveFileWriter> m_FileWriter;
 	};
 }
 
@@ -15,6 +15,7 @@ namespace Emulation
 		, m_TopIndex(0)
 		, m_RecordedFrameCount(0)
 		, m_DriverSyncAddress(0x0000)
+		, m_SIDAddresses({ 0xd400 })
 	{
 		m_Mutex = inPlatform->CreateMutex();
 
@@ -55,6 +56,14 @@ namespace Emulation
 		m_DriverTempoCounterAddress = inDriverTempoCounterReadAddress;
 	}
 
+	void FlightRecorder::SetSIDAddresses(const std::vector<unsigned short>& inSIDAddresses)
+	{
+		FOUNDATION_ASSERT(m_Locked);
+		FOUNDATION_ASSERT(!inSIDAddresses.empty() && inSIDAddresses.size() <= SID_MAX_CHIP_COUNT);
+
+		m_SIDAddresses = inSIDAddresses;
+	}
+
 	//------------------------------------------------------------------------------------------------
 
 	void FlightRecorder::SetRecording(bool inRecording)
@@ -141,7 +150,10 @@ namespace Emulation
 		inFrameData.m_nFrameNumber = inFrame;
 		inFrameData.m_nCyclesSpend = inCyclesSpend;
 
-		inMemory->GetData(0xd400, &inFrameData.m_SIDData, 0x19);
+		inFrameData.m_SIDCount = static_cast<unsigned char>(m_SIDAddresses.size());
+
+		for (size_t i = 0; i < m_SIDAddresses.size(); ++i)
+			inMemory->GetData(m_SIDAddresses[i], &inFrameData.m_SIDData[i], SID_REGISTER_COUNT);
 
 		inFrameData.m_TempoCounter = (*inMemory)[m_DriverTempoCounterAddress];
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "runtime/emulation/sid/sidproxydefines.h"
+
 #include <memory>
+#include <vector>
 
 namespace Foundation
 {
@@ -21,18 +24,23 @@ namespace Emulation
 			unsigned int m_nCyclesSpend;
 			unsigned char m_TempoCounter;
 			unsigned char m_DriverSync[3];
-			unsigned char m_SIDData[0x19];
+			unsigned char m_SIDCount;
+			unsigned char m_SIDData[SID_MAX_CHIP_COUNT][SID_REGISTER_COUNT];		// The registers of each SID chip, the first chip first
 
 			void Reset()
 			{
 				m_nFrameNumber = 0;
 				m_nCyclesSpend = 0;
 				m_TempoCounter = 0;
+				m_SIDCount = 1;
 
 				for (int i = 0; i < 3; ++i)
 					m_DriverSync[i] = 0;
-				for (int i = 0; i < 0x19; ++i)
-					m_SIDData[i] = 0;
+				for (unsigned int i = 0; i < SID_MAX_CHIP_COUNT; ++i)
+				{
+					for (int j = 0; j < SID_REGISTER_COUNT; ++j)
+						m_SIDData[i][j] = 0;
+				}
 			}
 		};
 
@@ -44,6 +52,7 @@ namespace Emulation
 
 		void SetDriverSyncReadAddress(unsigned short inDriverSyncReadAddress);
 		void SetDriverTempoCounterReadAddress(unsigned short inDriverTempoCounterReadAddress);
+		void SetSIDAddresses(const std::vector<unsigned short>& inSIDAddresses);
 
 		void SetRecording(bool inRecord);
 		bool IsRecording() const;
@@ -65,6 +74,7 @@ namespace Emulation
 
 		unsigned short m_DriverSyncAddress;
 		unsigned short m_DriverTempoCounterAddress;
+		std::vector<unsigned short> m_SIDAddresses;
 
 		unsigned int m_TopIndex;
 		unsigned int m_RecordedFrameCount;
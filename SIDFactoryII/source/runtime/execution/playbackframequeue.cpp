@@ -0,0 +1,69 @@
+#include "playbackframequeue.h"
+#include "foundation/base/assert.h"
+
+namespace Emulation
+{
+	PlaybackFrameQueue::PlaybackFrameQueue(unsigned int inMinimumCapacity)
+		: m_ReadPosition(0)
+		, m_WritePosition(0)
+	{
+		FOUNDATION_ASSERT(inMinimumCapacity > 0);
+
+		m_Capacity = 1;
+		while (m_Capacity < inMinimumCapacity)
+			m_Capacity <<= 1;
+
+		m_CapacityMask = m_Capacity - 1;
+		m_Frames = new PlaybackFrame[m_Capacity];
+	}
+
+	PlaybackFrameQueue::~PlaybackFrameQueue()
+	{
+		delete[] m_Frames;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool PlaybackFrameQueue::Push(const PlaybackFrame& inFrame)
+	{
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_acquire);
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_relaxed);
+
+		if (write_position - read_position >= m_Capacity)
+			return false;
+
+		m_Frames[write_position & m_CapacityMask] = inFrame;
+		m_WritePosition.store(write_position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool PlaybackFrameQueue::Peek(PlaybackFrame& outFrame) const
+	{
+		const unsigned int write_position = m_WritePosition.load(std::memory_order_acquire);
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_relaxed);
+
+		if (write_position == read_position)
+			return false;
+
+		outFrame = m_Frames[read_position & m_CapacityMask];
+
+		return true;
+	}
+
+	void PlaybackFrameQueue::Pop()
+	{
+		const unsigned int read_position = m_ReadPosition.load(std::memory_order_relaxed);
+
+		FOUNDATION_ASSERT(m_WritePosition.load(std::memory_order_acquire) != read_position);
+
+		m_ReadPosition.store(read_position + 1, std::memory_order_release);
+	}
+
+	void PlaybackFrameQueue::Flush()
+	{
+		m_ReadPosition.store(m_WritePosition.load(std::memory_order_acquire), std::memory_order_release);
+	}
+}
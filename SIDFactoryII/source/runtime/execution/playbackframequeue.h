@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+
+namespace Emulation
+{
+	// The state of the driver after an emulated frame, and where the samples of the frame start in the output of the execution handler
+	struct PlaybackFrame
+	{
+		unsigned int m_FrameNumber;
+		unsigned long long m_SampleOffset;		// Counted in sample frames, which is one sample for each channel
+		unsigned char m_TempoCounter;
+		int m_EventPosition;
+	};
+
+	// Single producer, single consumer queue of playback frames, in the order they were emulated. The producer and the consumer may run on
+	// separate threads without any locking, as long as there's only one of each.
+	class PlaybackFrameQueue final
+	{
+	public:
+		PlaybackFrameQueue(unsigned int inMinimumCapacity);		// Capacity is rounded up to the nearest power of two
+		~PlaybackFrameQueue();
+
+		PlaybackFrameQueue(const PlaybackFrameQueue& inOther) = delete;
+
+		// Producer. Returns false, and leaves the frame out, if the queue is full.
+		bool Push(const PlaybackFrame& inFrame);
+
+		// Consumer
+		bool Peek(PlaybackFrame& outFrame) const;
+		void Pop();
+		void Flush();
+
+	private:
+		unsigned int m_Capacity;
+		unsigned int m_CapacityMask;
+
+		PlaybackFrame* m_Frames;
+
+		// Read and write positions are free running, and only masked when accessing the queue
+		std::atomic<unsigned int> m_ReadPosition;
+		std::atomic<unsigned int> m_WritePosition;
+	};
+}
@@ -0,0 +1,82 @@
+#include "utils/delta_encoding.h"
+#include "foundation/base/assert.h"
+
+namespace Utility
+{
+	// Runs of unchanged bytes shorter than this are kept in the literal run around them, as a new run would cost more than the bytes
+	static const unsigned int DeltaRunHeaderSize = 4;
+
+	void EncodeXORDelta(const unsigned char* inData1, const unsigned char* inData2, unsigned int inSize, std::vector<unsigned char>& outDelta)
+	{
+		FOUNDATION_ASSERT(inSize <= 0x10000);
+
+		outDelta.clear();
+
+		unsigned int run_end = 0;
+		unsigned int i = 0;
+
+		while (i < inSize)
+		{
+			if (inData1[i] == inData2[i])
+			{
+				++i;
+				continue;
+			}
+
+			const unsigned int start = i;
+			unsigned int last_changed = i;
+
+			while (i < inSize && i - last_changed <= DeltaRunHeaderSize && i - start < 0xffff)
+			{
+				if (inData1[i] != inData2[i])
+					last_changed = i;
+				++i;
+			}
+
+			const unsigned int skip = start - run_end;
+			const unsigned int length = last_changed + 1 - start;
+
+			FOUNDATION_ASSERT(skip <= 0xffff && length <= 0xffff);
+
+			outDelta.push_back(static_cast<unsigned char>(skip & 0xff));
+			outDelta.push_back(static_cast<unsigned char>(skip >> 8));
+			outDelta.push_back(static_cast<unsigned char>(length & 0xff));
+			outDelta.push_back(static_cast<unsigned char>(length >> 8));
+
+			for (unsigned int j = start; j <= last_changed; ++j)
+				outDelta.push_back(inData1[j] ^ inData2[j]);
+
+			run_end = last_changed + 1;
+			i = run_end;
+		}
+	}
+
+
+	void ApplyXORDelta(const std::vector<unsigned char>& inDelta, unsigned char* ioData, unsigned int inSize)
+	{
+		const unsigned int delta_size = static_cast<unsigned int>(inDelta.size());
+
+		unsigned int position = 0;
+		unsigned int i = 0;
+
+		while (i < delta_size)
+		{
+			FOUNDATION_ASSERT(i + DeltaRunHeaderSize <= delta_size);
+
+			const unsigned int skip = static_cast<unsigned int>(inDelta[i]) | (static_cast<unsigned int>(inDelta[i + 1]) << 8);
+			const unsigned int length = static_cast<unsigned int>(inDelta[i + 2]) | (static_cast<unsigned int>(inDelta[i + 3]) << 8);
+
+			i += DeltaRunHeaderSize;
+			position += skip;
+
+			FOUNDATION_ASSERT(position + length <= inSize);
+			FOUNDATION_ASSERT(i + length <= delta_size);
+
+			for (unsigned int j = 0; j < length; ++j)
+				ioData[position + j] ^= inDelta[i + j];
+
+			position += length;
+			i += length;
+		}
+	}
+}
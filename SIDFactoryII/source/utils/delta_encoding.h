@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+
+namespace Utility
+{
+	// Encodes the difference between two buffers of the same size as runs of XOR'ed bytes. Each run is the number of unchanged bytes
+	// to skip and the number of changed bytes following them, 16 bit little endian each, followed by the changed bytes XOR'ed together.
+	// The delta works both ways: applying it to either of the buffers gives the other one. Buffers can be at most 64KB.
+	void EncodeXORDelta(const unsigned char* inData1, const unsigned char* inData2, unsigned int inSize, std::vector<unsigned char>& outDelta);
+	void ApplyXORDelta(const std::vector<unsigned char>& inDelta, unsigned char* ioData, unsigned int inSize);
+}
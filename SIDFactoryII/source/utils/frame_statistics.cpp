@@ -0,0 +1,77 @@
+#include "frame_statistics.h"
+#include "foundation/base/assert.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace Utility
+{
+	FrameStatistics::FrameStatistics(double inPeriodInMilliseconds)
+		: m_PeriodInMilliseconds(inPeriodInMilliseconds)
+		, m_UpdateCount(0)
+		, m_RenderCount(0)
+		, m_WaitTimeInMilliseconds(0.0)
+		, m_FrameTimeInMilliseconds(0.0)
+		, m_MaxFrameTimeInMilliseconds(0.0)
+		, m_Summary({ 0, 0, 0.0, 0.0, 0.0, 0.0 })
+	{
+		FOUNDATION_ASSERT(inPeriodInMilliseconds > 0.0);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------
+
+	bool FrameStatistics::AddFrame(double inWaitTimeInMilliseconds, double inFrameTimeInMilliseconds, bool inRendered)
+	{
+		++m_UpdateCount;
+
+		if (inRendered)
+			++m_RenderCount;
+
+		m_WaitTimeInMilliseconds += inWaitTimeInMilliseconds;
+		m_FrameTimeInMilliseconds += inFrameTimeInMilliseconds;
+
+		if (inFrameTimeInMilliseconds > m_MaxFrameTimeInMilliseconds)
+			m_MaxFrameTimeInMilliseconds = inFrameTimeInMilliseconds;
+
+		const double period = m_WaitTimeInMilliseconds + m_FrameTimeInMilliseconds;
+
+		if (period < m_PeriodInMilliseconds)
+			return false;
+
+		m_Summary.m_UpdateCount = m_UpdateCount;
+		m_Summary.m_RenderCount = m_RenderCount;
+		m_Summary.m_PeriodInMilliseconds = period;
+		m_Summary.m_AverageFrameTimeInMilliseconds = m_FrameTimeInMilliseconds / static_cast<double>(m_UpdateCount);
+		m_Summary.m_MaxFrameTimeInMilliseconds = m_MaxFrameTimeInMilliseconds;
+		m_Summary.m_BusyRatio = m_FrameTimeInMilliseconds / period;
+
+		m_UpdateCount = 0;
+		m_RenderCount = 0;
+		m_WaitTimeInMilliseconds = 0.0;
+		m_FrameTimeInMilliseconds = 0.0;
+		m_MaxFrameTimeInMilliseconds = 0.0;
+
+		return true;
+	}
+
+
+	const FrameStatistics::Summary& FrameStatistics::GetSummary() const
+	{
+		return m_Summary;
+	}
+
+
+	std::string FrameStatistics::GetSummaryText() const
+	{
+		std::stringstream stream;
+
+		stream << std::fixed << std::setprecision(2)
+			<< m_Summary.m_UpdateCount << " updates, "
+			<< m_Summary.m_RenderCount << " redraws in " << m_Summary.m_PeriodInMilliseconds << " ms, frame time "
+			<< m_Summary.m_AverageFrameTimeInMilliseconds << " ms avg, "
+			<< m_Summary.m_MaxFrameTimeInMilliseconds << " ms max, busy "
+			<< (m_Summary.m_BusyRatio * 100.0) << "%";
+
+		return stream.str();
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+namespace Utility
+{
+	// Collects the time the main loop spends updating and drawing the editor, and the time it spends waiting in between, and sums
+	// it up over periods of a fixed length.
+	class FrameStatistics final
+	{
+	public:
+		struct Summary
+		{
+			unsigned int m_UpdateCount;
+			unsigned int m_RenderCount;						// Updates, in which the window was redrawn
+			double m_PeriodInMilliseconds;
+			double m_AverageFrameTimeInMilliseconds;
+			double m_MaxFrameTimeInMilliseconds;
+			double m_BusyRatio;								// The part of the period spent updating and drawing, in the range 0 to 1
+		};
+
+		FrameStatistics(double inPeriodInMilliseconds);
+
+		// Returns true, if the frame completed a period, and a new summary is available
+		bool AddFrame(double inWaitTimeInMilliseconds, double inFrameTimeInMilliseconds, bool inRendered);
+
+		const Summary& GetSummary() const;
+		std::string GetSummaryText() const;
+
+	private:
+		const double m_PeriodInMilliseconds;
+
+		unsigned int m_UpdateCount;
+		unsigned int m_RenderCount;
+		double m_WaitTimeInMilliseconds;
+		double m_FrameTimeInMilliseconds;
+		double m_MaxFrameTimeInMilliseconds;
+
+		Summary m_Summary;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstring>
+#include <cstddef>
 #include "foundation/base/assert.h"
 
 namespace Utility
@@ -81,6 +82,33 @@ namespace Utility
 	}
 
 
+	bool PSIDFile::ReadHeaderInfo(const unsigned char* inData, unsigned int inDataSize, std::string& outTitle, std::string& outAuthor)
+	{
+		FOUNDATION_ASSERT(inData != nullptr);
+
+		// Version 1 headers are shorter, but have the strings at the same place
+		if (inDataSize < offsetof(Header, m_Copyright))
+			return false;
+
+		const Header& header = *reinterpret_cast<const Header*>(inData);
+
+		if (memcmp(header.m_MagicNumber, "PSID", 4) != 0 && memcmp(header.m_MagicNumber, "RSID", 4) != 0)
+			return false;
+
+		// The strings are not zero terminated, if they fill the whole field
+		auto read_string = [](const char* inCharArray)
+		{
+			const char* end = static_cast<const char*>(memchr(inCharArray, 0, 0x20));
+			return std::string(inCharArray, end != nullptr ? end : inCharArray + 0x20);
+		};
+
+		outTitle = read_string(header.m_Title);
+		outAuthor = read_string(header.m_Author);
+
+		return true;
+	}
+
+
 	void PSIDFile::CopyString(const std::string& inString, char* outCharArray)
 	{
 		const char* string = inString.c_str();
@@ -50,6 +50,9 @@ namespace Utility
 		const unsigned char* GetData() const;
 		unsigned int GetDataSize() const;
 
+		// Reads the title and the author from the header of PSID or RSID file data. Returns false, if the data does not start with a header.
+		static bool ReadHeaderInfo(const unsigned char* inData, unsigned int inDataSize, std::string& outTitle, std::string& outAuthor);
+
 	private:
 		void CopyString(const std::string& inString, char* outCharArray);
 
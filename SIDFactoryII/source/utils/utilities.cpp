@@ -1,7 +1,14 @@
 #include "utilities.h"
 #include "c64file.h"
+#include "libraries/ghc/fs_std.h"
 #include <cctype>
 #include <algorithm>
+#ifdef _SF2_WINDOWS
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace Utility
 {
@@ -96,6 +103,21 @@ namespace Utility
 	}
 
 
+	unsigned int ReadFileStart(const std::string& inFileName, void* outBuffer, unsigned int inBufferSize)
+	{
+		FILE* file_read = fopen(inFileName.c_str(), "rb");
+
+		if (file_read == nullptr)
+			return 0;
+
+		const size_t bytes_read = fread(outBuffer, 1, inBufferSize, file_read);
+
+		fclose(file_read);
+
+		return static_cast<unsigned int>(bytes_read);
+	}
+
+
 	bool WriteFile(const std::string& inFileName, const void* inData, long inDataSize)
 	{
 		FILE* file_write = fopen(inFileName.c_str(), "wb");
@@ -103,10 +125,10 @@ namespace Utility
 		if (file_write == nullptr)
             return false;
 
-		fwrite(inData, 1, inDataSize, file_write);
-		fclose(file_write);
+		const bool data_written = fwrite(inData, 1, inDataSize, file_write) == static_cast<size_t>(inDataSize);
+		const bool file_closed = fclose(file_write) == 0;
 
-		return true;
+		return data_written && file_closed;
 	}
 
 
@@ -123,6 +145,71 @@ namespace Utility
 	}
 
 
+	// Makes sure the data written to the file has reached the disk, and not just the buffers of the C library and the operating system
+	static bool FlushFileToDisk(FILE* inFile)
+	{
+		if (fflush(inFile) != 0)
+			return false;
+
+#ifdef _SF2_WINDOWS
+		return _commit(_fileno(inFile)) == 0;
+#else
+		return fsync(fileno(inFile)) == 0;
+#endif
+	}
+
+
+	// Makes sure a rename in the folder has reached the disk. This is only possible, and needed, where folders can be opened as files.
+	static void FlushFolderToDisk(const std::string& inFileName)
+	{
+#ifndef _SF2_WINDOWS
+		const fs::path folder = fs::path(inFileName).parent_path();
+		const int folder_descriptor = open(folder.empty() ? "." : folder.string().c_str(), O_RDONLY);
+
+		if (folder_descriptor >= 0)
+		{
+			fsync(folder_descriptor);
+			close(folder_descriptor);
+		}
+#endif
+	}
+
+
+	bool WriteFileAtomic(const std::string& inFileName, const void* inData, long inDataSize)
+	{
+		const std::string temporary_file_name = inFileName + ".tmp";
+
+		// The temporary file must be on the disk before it replaces the destination, or a power loss could leave a truncated file behind
+		FILE* file_write = fopen(temporary_file_name.c_str(), "wb");
+
+		if (file_write == nullptr)
+			return false;
+
+		const bool data_written = fwrite(inData, 1, inDataSize, file_write) == static_cast<size_t>(inDataSize) && FlushFileToDisk(file_write);
+		const bool file_closed = fclose(file_write) == 0;
+
+		if (!data_written || !file_closed)
+		{
+			remove(temporary_file_name.c_str());
+			return false;
+		}
+
+		// Replaces an existing file, also on platforms where renaming onto an existing file fails by default
+		std::error_code error_code;
+		fs::rename(temporary_file_name, inFileName, error_code);
+
+		if (error_code)
+		{
+			remove(temporary_file_name.c_str());
+			return false;
+		}
+
+		FlushFolderToDisk(inFileName);
+
+		return true;
+	}
+
+
 	void TrimStringInPlace(std::string& inString)
 	{
 		inString.erase(inString.begin(), std::find_if(inString.begin(), inString.end(), [](int character)
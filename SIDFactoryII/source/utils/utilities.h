@@ -10,9 +10,18 @@ namespace Utility
 
 	void MakeBinaryResourceIncludeFile(const std::string& inReadFileName, const std::string& inWriteFileName, const std::string& inDataName, const std::string& inNamespace);
 	bool ReadFile(const std::string& inFileName, int inMaxFileSize, void** outData, long& outDataSize);
+
+	// Reads no more than the buffer size from the start of the file, for files where only a header is needed. Returns the number of
+	// bytes read, which is less than the buffer size if the file is shorter, or 0 if the file can't be read.
+	unsigned int ReadFileStart(const std::string& inFileName, void* outBuffer, unsigned int inBufferSize);
+
 	bool WriteFile(const std::string& inFileName, const void* inData, long inDataSize);
 	bool WriteFile(const std::string& inFileName, std::shared_ptr<Utility::C64File> inFile);
 
+	// Writes the data to a temporary file next to the destination, and renames it over the destination once it has been written
+	// completely. If writing fails half way, the existing file at the destination is left untouched.
+	bool WriteFileAtomic(const std::string& inFileName, const void* inData, long inDataSize);
+
 	void TrimStringInPlace(std::string& inString);
 	std::string TrimString(const std::string& inString);
 	void StringToLowerCaseInPlace(std::string& inString);